@@ -0,0 +1,319 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Generation of synthetic, full-size 128T gpubox and voltage files for the benchmarks.
+
+The files in `test_files/` only contain a single (tiny) timestep, so these helpers write files
+with the real dimensions of each format, using the metafits files from `test_files/` for the
+observation metadata. Files are written once to `$MWALIB_BENCH_DATA_DIR` (default
+`target/bench_data`) and reused by later runs. A full run needs roughly 9 GB of disk: 24 coarse
+channels x 2 timesteps of legacy and MWAX gpubox files, plus a 1 second legacy voltage file and
+an 8 second MWAX `.sub` file.
+ */
+#![allow(dead_code)]
+use mwalib::fitsio::images::{ImageDescription, ImageType};
+use mwalib::fitsio::FitsFile;
+use mwalib::{MWAVersion, MetafitsContext};
+use std::fs::{self, File};
+use std::io::{BufWriter, Write};
+use std::path::{Path, PathBuf};
+
+pub const LEGACY_METAFITS: &str = concat!(
+    env!("CARGO_MANIFEST_DIR"),
+    "/test_files/1101503312_1_timestep/1101503312.metafits"
+);
+pub const MWAX_METAFITS: &str = concat!(
+    env!("CARGO_MANIFEST_DIR"),
+    "/test_files/1244973688_1_timestep/1244973688.metafits"
+);
+
+/// Number of coarse channels written for the gpubox benchmarks (a full 128T observation).
+pub const NUM_BENCH_COARSE_CHANS: usize = 24;
+/// Number of timesteps written into each gpubox file for the benchmarks.
+pub const NUM_BENCH_TIMESTEPS: usize = 2;
+
+/// Returns the directory benchmark data is written to, creating it if needed.
+pub fn bench_data_dir() -> PathBuf {
+    let dir = match std::env::var_os("MWALIB_BENCH_DATA_DIR") {
+        Some(d) => PathBuf::from(d),
+        None => PathBuf::from(env!("CARGO_MANIFEST_DIR"))
+            .join("target")
+            .join("bench_data"),
+    };
+    fs::create_dir_all(&dir).expect("Cannot create benchmark data directory");
+
+    dir
+}
+
+/// Helper to fill a buffer with a repeating, non-trivial pattern of values.
+fn pattern_f32(len: usize) -> Vec<f32> {
+    (0..len)
+        .map(|i| ((i * 7919) % 65_521) as f32 - 32_760.0)
+        .collect()
+}
+
+/// Helper to fill a buffer with a repeating pattern of bytes.
+fn pattern_u8(len: usize) -> Vec<u8> {
+    (0..len).map(|i| (i % 251) as u8).collect()
+}
+
+/// Write one gpubox file. It is written to a temporary name first, so an interrupted run never
+/// leaves a partial file behind.
+///
+/// # Arguments
+///
+/// * `filename` - the gpubox file to create.
+///
+/// * `metafits_context` - the metafits of the observation.
+///
+/// * `mwa_version` - CorrLegacy or CorrMWAXv2.
+///
+/// * `num_timesteps` - number of timesteps (visibility HDUs) to write.
+///
+/// * `visibilities` - the data written to every visibility HDU.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+fn write_gpubox_file(
+    filename: &Path,
+    metafits_context: &MetafitsContext,
+    mwa_version: MWAVersion,
+    num_timesteps: usize,
+    visibilities: &[f32],
+) {
+    let num_baselines = metafits_context.num_baselines;
+    let num_fine_chans = metafits_context.num_corr_fine_chans_per_coarse;
+    let num_pols = metafits_context.num_visibility_pols;
+
+    let temp_filename = filename.with_extension("fits.tmp");
+    let _ = fs::remove_file(&temp_filename);
+
+    let mut fptr = FitsFile::create(&temp_filename)
+        .open()
+        .expect("Cannot create gpubox file");
+    let primary_hdu = fptr.primary_hdu().unwrap();
+    let start_unix_time_ms = metafits_context.sched_start_unix_time_ms;
+    primary_hdu
+        .write_key(&mut fptr, "TIME", (start_unix_time_ms / 1000) as i64)
+        .unwrap();
+    primary_hdu
+        .write_key(&mut fptr, "MILLITIM", (start_unix_time_ms % 1000) as i64)
+        .unwrap();
+    primary_hdu
+        .write_key(&mut fptr, "OBSID", metafits_context.obs_id as i64)
+        .unwrap();
+    primary_hdu
+        .write_key(
+            &mut fptr,
+            "INTTIME",
+            metafits_context.corr_int_time_ms as f64 / 1000.0,
+        )
+        .unwrap();
+    if mwa_version == MWAVersion::CorrMWAXv2 {
+        primary_hdu.write_key(&mut fptr, "CORR_VER", 2i64).unwrap();
+        primary_hdu
+            .write_key(&mut fptr, "NFINECHS", num_fine_chans as i64)
+            .unwrap();
+        primary_hdu
+            .write_key(&mut fptr, "NINPUTS", metafits_context.num_rf_inputs as i64)
+            .unwrap();
+    }
+
+    // Legacy HDUs are [fine_chan][baseline][pol][r][i], MWAX HDUs are [baseline][fine_chan][pol][r][i]
+    let visibility_dimensions = match mwa_version {
+        MWAVersion::CorrMWAXv2 => [num_baselines, num_fine_chans * num_pols * 2],
+        _ => [num_fine_chans, num_baselines * num_pols * 2],
+    };
+    let visibility_description = ImageDescription {
+        data_type: ImageType::Float,
+        dimensions: &visibility_dimensions,
+    };
+    let weights_description = ImageDescription {
+        data_type: ImageType::Float,
+        dimensions: &[num_baselines, num_pols],
+    };
+    let weights = vec![1.0f32; num_baselines * num_pols];
+
+    for t in 0..num_timesteps {
+        let hdu_unix_time_ms = start_unix_time_ms + t as u64 * metafits_context.corr_int_time_ms;
+
+        let mut descriptions: Vec<(&str, &ImageDescription, &[f32])> =
+            vec![("VISIBILITIES", &visibility_description, visibilities)];
+        if mwa_version == MWAVersion::CorrMWAXv2 {
+            descriptions.push(("WEIGHTS", &weights_description, &weights[..]));
+        }
+
+        for (extname, description, data) in descriptions {
+            let hdu = fptr.create_image(extname, description).unwrap();
+            hdu.write_key(&mut fptr, "TIME", (hdu_unix_time_ms / 1000) as i64)
+                .unwrap();
+            hdu.write_key(&mut fptr, "MILLITIM", (hdu_unix_time_ms % 1000) as i64)
+                .unwrap();
+            hdu.write_image(&mut fptr, data).unwrap();
+        }
+    }
+    drop(fptr);
+
+    fs::rename(&temp_filename, filename).expect("Cannot rename gpubox file");
+}
+
+/// Generate (or reuse previously generated) full-size gpubox files.
+///
+/// # Arguments
+///
+/// * `metafits_filename` - metafits of the observation (`LEGACY_METAFITS` or `MWAX_METAFITS`).
+///
+/// * `mwa_version` - CorrLegacy or CorrMWAXv2.
+///
+/// * `num_coarse_chans` - number of coarse channels (gpubox files) to write.
+///
+/// * `num_timesteps` - number of timesteps in each file.
+///
+///
+/// # Returns
+///
+/// * The gpubox filenames
+///
+pub fn generate_gpubox_files(
+    metafits_filename: &str,
+    mwa_version: MWAVersion,
+    num_coarse_chans: usize,
+    num_timesteps: usize,
+) -> Vec<String> {
+    let metafits_context = MetafitsContext::new(&metafits_filename, mwa_version).unwrap();
+    let obs_id = metafits_context.obs_id;
+    let datetime = metafits_context.sched_start_utc.format("%Y%m%d%H%M%S");
+
+    let dir = bench_data_dir().join(format!("{}_{:?}_{}ts", obs_id, mwa_version, num_timesteps));
+    fs::create_dir_all(&dir).unwrap();
+
+    let mut visibilities: Option<Vec<f32>> = None;
+    let mut filenames = Vec::with_capacity(num_coarse_chans);
+
+    for coarse_chan in metafits_context
+        .metafits_coarse_chans
+        .iter()
+        .take(num_coarse_chans)
+    {
+        let filename = match mwa_version {
+            MWAVersion::CorrMWAXv2 => dir.join(format!(
+                "{}_{}_ch{:03}_000.fits",
+                obs_id, datetime, coarse_chan.rec_chan_number
+            )),
+            _ => dir.join(format!(
+                "{}_{}_gpubox{:02}_00.fits",
+                obs_id, datetime, coarse_chan.gpubox_number
+            )),
+        };
+
+        if !filename.exists() {
+            eprintln!("Generating {}", filename.display());
+            let visibilities = visibilities.get_or_insert_with(|| {
+                pattern_f32(
+                    metafits_context.num_baselines
+                        * metafits_context.num_corr_fine_chans_per_coarse
+                        * metafits_context.num_visibility_pols
+                        * 2,
+                )
+            });
+            write_gpubox_file(
+                &filename,
+                &metafits_context,
+                mwa_version,
+                num_timesteps,
+                visibilities,
+            );
+        }
+
+        filenames.push(filename.to_string_lossy().into_owned());
+    }
+
+    filenames
+}
+
+/// Generate (or reuse previously generated) full-size voltage files for the legacy 128T
+/// observation in `LEGACY_METAFITS`. The sizes match those `VoltageContext` expects for 256
+/// rf_inputs: 327,680,000 bytes per legacy `.dat` file (1 second) and 5,275,652,096 bytes per
+/// MWAX `.sub` file (8 seconds).
+///
+/// # Arguments
+///
+/// * `mwa_version` - VCSLegacyRecombined or VCSMWAXv2.
+///
+/// * `num_coarse_chans` - number of coarse channels to write files for.
+///
+/// * `num_timesteps` - number of files to write for each coarse channel.
+///
+///
+/// # Returns
+///
+/// * The voltage filenames
+///
+pub fn generate_voltage_files(
+    mwa_version: MWAVersion,
+    num_coarse_chans: usize,
+    num_timesteps: usize,
+) -> Vec<String> {
+    let metafits_context = MetafitsContext::new(&LEGACY_METAFITS, mwa_version).unwrap();
+    let obs_id = metafits_context.obs_id as u64;
+    let num_rf_inputs = metafits_context.num_rf_inputs;
+
+    // (header bytes, delay block bytes, voltage block bytes, voltage blocks per file, seconds per file)
+    let (header_bytes, delay_block_bytes, voltage_block_bytes, num_voltage_blocks, file_seconds) =
+        match mwa_version {
+            MWAVersion::VCSMWAXv2 => {
+                let block = 64_000 * num_rf_inputs * 2;
+                (4096, block, block, 160, 8)
+            }
+            _ => (0, 0, 10_000 * num_rf_inputs * 128, 1, 1),
+        };
+
+    let dir = bench_data_dir().join(format!("{}_{:?}", obs_id, mwa_version));
+    fs::create_dir_all(&dir).unwrap();
+
+    let voltage_block = pattern_u8(voltage_block_bytes);
+    let mut filenames = Vec::with_capacity(num_coarse_chans * num_timesteps);
+
+    for coarse_chan in metafits_context
+        .metafits_coarse_chans
+        .iter()
+        .take(num_coarse_chans)
+    {
+        for t in 0..num_timesteps as u64 {
+            let gps_time = obs_id + t * file_seconds;
+            let filename = match mwa_version {
+                MWAVersion::VCSMWAXv2 => dir.join(format!(
+                    "{}_{}_{:03}.sub",
+                    obs_id, gps_time, coarse_chan.rec_chan_number
+                )),
+                _ => dir.join(format!(
+                    "{}_{}_ch{:03}.dat",
+                    obs_id, gps_time, coarse_chan.rec_chan_number
+                )),
+            };
+
+            if !filename.exists() {
+                eprintln!("Generating {}", filename.display());
+                let temp_filename = filename.with_extension("tmp");
+                let mut writer = BufWriter::new(File::create(&temp_filename).unwrap());
+                writer.write_all(&vec![0x01; header_bytes]).unwrap();
+                writer.write_all(&vec![0x02; delay_block_bytes]).unwrap();
+                for _ in 0..num_voltage_blocks {
+                    writer.write_all(&voltage_block).unwrap();
+                }
+                writer.flush().unwrap();
+                drop(writer);
+                fs::rename(&temp_filename, &filename).unwrap();
+            }
+
+            filenames.push(filename.to_string_lossy().into_owned());
+        }
+    }
+
+    filenames
+}
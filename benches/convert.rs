@@ -0,0 +1,109 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Benchmarks of the visibility reordering kernels in isolation, on full-size 128T HDUs held in
+memory (so no I/O is timed).
+
+Run with `cargo bench --features benchmarks --bench convert`.
+ */
+mod common;
+
+use criterion::{black_box, criterion_group, criterion_main, Criterion, Throughput};
+use mwalib::bench_support::{self, LegacyConversionTable};
+use mwalib::{MWAVersion, MetafitsContext};
+
+/// Helper to build a buffer the size of one HDU of the given observation, filled with a pattern.
+fn get_hdu_buffer(metafits_context: &MetafitsContext) -> Vec<f32> {
+    let len = metafits_context.num_baselines
+        * metafits_context.num_corr_fine_chans_per_coarse
+        * metafits_context.num_visibility_pols
+        * 2;
+
+    (0..len).map(|i| (i % 1021) as f32).collect()
+}
+
+fn bench_generate_conversion_array(c: &mut Criterion) {
+    let metafits_context =
+        MetafitsContext::new(&common::LEGACY_METAFITS, MWAVersion::CorrLegacy).unwrap();
+
+    c.bench_function("convert::generate_conversion_array", |b| {
+        b.iter(|| LegacyConversionTable::new(black_box(&metafits_context.rf_inputs)))
+    });
+}
+
+fn bench_convert_legacy(c: &mut Criterion) {
+    let metafits_context =
+        MetafitsContext::new(&common::LEGACY_METAFITS, MWAVersion::CorrLegacy).unwrap();
+    let num_fine_chans = metafits_context.num_corr_fine_chans_per_coarse;
+    let conversion_table = LegacyConversionTable::new(&metafits_context.rf_inputs);
+    let input = get_hdu_buffer(&metafits_context);
+    let mut output = vec![0.0f32; input.len()];
+
+    let mut group = c.benchmark_group("convert::legacy");
+    group.throughput(Throughput::Bytes(
+        (input.len() * std::mem::size_of::<f32>()) as u64,
+    ));
+
+    group.bench_function("convert_legacy_hdu_to_mwax_baseline_order", |b| {
+        b.iter(|| {
+            bench_support::convert_legacy_hdu_to_mwax_baseline_order(
+                &conversion_table,
+                &input,
+                &mut output,
+                num_fine_chans,
+            );
+            black_box(&output);
+        })
+    });
+
+    group.bench_function("convert_legacy_hdu_to_mwax_frequency_order", |b| {
+        b.iter(|| {
+            bench_support::convert_legacy_hdu_to_mwax_frequency_order(
+                &conversion_table,
+                &input,
+                &mut output,
+                num_fine_chans,
+            );
+            black_box(&output);
+        })
+    });
+
+    group.finish();
+}
+
+fn bench_convert_mwax(c: &mut Criterion) {
+    let metafits_context =
+        MetafitsContext::new(&common::MWAX_METAFITS, MWAVersion::CorrMWAXv2).unwrap();
+    let input = get_hdu_buffer(&metafits_context);
+    let mut output = vec![0.0f32; input.len()];
+
+    let mut group = c.benchmark_group("convert::mwax");
+    group.throughput(Throughput::Bytes(
+        (input.len() * std::mem::size_of::<f32>()) as u64,
+    ));
+
+    group.bench_function("convert_mwax_hdu_to_frequency_order", |b| {
+        b.iter(|| {
+            bench_support::convert_mwax_hdu_to_frequency_order(
+                &input,
+                &mut output,
+                metafits_context.num_baselines,
+                metafits_context.num_corr_fine_chans_per_coarse,
+                metafits_context.num_visibility_pols,
+            );
+            black_box(&output);
+        })
+    });
+
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_generate_conversion_array,
+    bench_convert_legacy,
+    bench_convert_mwax
+);
+criterion_main!(benches);
@@ -0,0 +1,109 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Benchmarks of CorrelatorContext creation and reads, on synthetic full-size 128T gpubox files.
+
+Run with `cargo bench --bench correlator_context`.
+ */
+mod common;
+
+use criterion::{black_box, criterion_group, criterion_main, Criterion, Throughput};
+use mwalib::{CorrelatorContext, MWAVersion};
+
+/// The observations benchmarked: (name, metafits, correlator version).
+const OBSERVATIONS: [(&str, &str, MWAVersion); 2] = [
+    ("legacy", common::LEGACY_METAFITS, MWAVersion::CorrLegacy),
+    ("mwax", common::MWAX_METAFITS, MWAVersion::CorrMWAXv2),
+];
+
+/// Helper to generate the gpubox files for an observation and return its metafits and gpubox
+/// filenames.
+fn get_observation(metafits: &str, mwa_version: MWAVersion) -> (String, Vec<String>) {
+    let gpubox_filenames = common::generate_gpubox_files(
+        metafits,
+        mwa_version,
+        common::NUM_BENCH_COARSE_CHANS,
+        common::NUM_BENCH_TIMESTEPS,
+    );
+
+    (metafits.to_string(), gpubox_filenames)
+}
+
+fn bench_context_new(c: &mut Criterion) {
+    let mut group = c.benchmark_group("CorrelatorContext::new");
+    group.sample_size(10);
+
+    for (name, metafits, mwa_version) in OBSERVATIONS.iter() {
+        let (metafits, gpubox_filenames) = get_observation(metafits, *mwa_version);
+
+        group.bench_function(*name, |b| {
+            b.iter(|| CorrelatorContext::new(&metafits, &gpubox_filenames).unwrap())
+        });
+    }
+
+    group.finish();
+}
+
+fn bench_read_by_baseline(c: &mut Criterion) {
+    let mut group = c.benchmark_group("CorrelatorContext::read_by_baseline_into_buffer");
+    group.sample_size(20);
+
+    for (name, metafits, mwa_version) in OBSERVATIONS.iter() {
+        let (metafits, gpubox_filenames) = get_observation(metafits, *mwa_version);
+        let context = CorrelatorContext::new(&metafits, &gpubox_filenames).unwrap();
+        let mut buffer = vec![0.0f32; context.num_timestep_coarse_chan_floats];
+        let timestep_index = context.provided_timestep_indices[0];
+        let coarse_chan_index = context.provided_coarse_chan_indices[0];
+
+        group.throughput(Throughput::Bytes(
+            context.num_timestep_coarse_chan_bytes as u64,
+        ));
+        group.bench_function(*name, |b| {
+            b.iter(|| {
+                context
+                    .read_by_baseline_into_buffer(timestep_index, coarse_chan_index, &mut buffer)
+                    .unwrap();
+                black_box(&buffer);
+            })
+        });
+    }
+
+    group.finish();
+}
+
+fn bench_read_by_frequency(c: &mut Criterion) {
+    let mut group = c.benchmark_group("CorrelatorContext::read_by_frequency_into_buffer");
+    group.sample_size(20);
+
+    for (name, metafits, mwa_version) in OBSERVATIONS.iter() {
+        let (metafits, gpubox_filenames) = get_observation(metafits, *mwa_version);
+        let context = CorrelatorContext::new(&metafits, &gpubox_filenames).unwrap();
+        let mut buffer = vec![0.0f32; context.num_timestep_coarse_chan_floats];
+        let timestep_index = context.provided_timestep_indices[0];
+        let coarse_chan_index = context.provided_coarse_chan_indices[0];
+
+        group.throughput(Throughput::Bytes(
+            context.num_timestep_coarse_chan_bytes as u64,
+        ));
+        group.bench_function(*name, |b| {
+            b.iter(|| {
+                context
+                    .read_by_frequency_into_buffer(timestep_index, coarse_chan_index, &mut buffer)
+                    .unwrap();
+                black_box(&buffer);
+            })
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_context_new,
+    bench_read_by_baseline,
+    bench_read_by_frequency
+);
+criterion_main!(benches);
@@ -0,0 +1,86 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Benchmarks of VoltageContext reads, on synthetic full-size 128T voltage files.
+
+Run with `cargo bench --bench voltage_context`.
+ */
+mod common;
+
+use criterion::{black_box, criterion_group, criterion_main, Criterion, Throughput};
+use mwalib::{MWAVersion, VoltageContext};
+
+/// The voltage versions benchmarked: (name, VCS version).
+const VERSIONS: [(&str, MWAVersion); 2] = [
+    ("legacy", MWAVersion::VCSLegacyRecombined),
+    ("mwax", MWAVersion::VCSMWAXv2),
+];
+
+/// Helper to generate one full-size voltage file of the given version and open a context on it.
+fn get_context(mwa_version: MWAVersion) -> VoltageContext {
+    let voltage_filenames = common::generate_voltage_files(mwa_version, 1, 1);
+
+    VoltageContext::new(&common::LEGACY_METAFITS.to_string(), &voltage_filenames).unwrap()
+}
+
+fn bench_read_file(c: &mut Criterion) {
+    let mut group = c.benchmark_group("VoltageContext::read_file");
+    group.sample_size(10);
+
+    // An MWAX file is 8 seconds (over 5 GB), so only the 1 second legacy file is read whole.
+    // MWAX reads are covered per second by `bench_read_second`.
+    let context = get_context(MWAVersion::VCSLegacyRecombined);
+    let mut buffer = vec![
+        0u8;
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep)
+            as usize
+    ];
+    let timestep_index = context.provided_timestep_indices[0];
+    let coarse_chan_index = context.provided_coarse_chan_indices[0];
+
+    group.throughput(Throughput::Bytes(buffer.len() as u64));
+    group.bench_function("legacy", |b| {
+        b.iter(|| {
+            context
+                .read_file(timestep_index, coarse_chan_index, &mut buffer)
+                .unwrap();
+            black_box(&buffer);
+        })
+    });
+
+    group.finish();
+}
+
+fn bench_read_second(c: &mut Criterion) {
+    let mut group = c.benchmark_group("VoltageContext::read_second");
+    group.sample_size(10);
+
+    for (name, mwa_version) in VERSIONS.iter() {
+        let context = get_context(*mwa_version);
+        let mut buffer = vec![
+            0u8;
+            (context.voltage_block_size_bytes * context.num_voltage_blocks_per_second)
+                as usize
+        ];
+        let timestep_index = context.provided_timestep_indices[0];
+        let coarse_chan_index = context.provided_coarse_chan_indices[0];
+        let gps_second = context.timesteps[timestep_index].gps_time_ms / 1000;
+
+        group.throughput(Throughput::Bytes(buffer.len() as u64));
+        group.bench_function(*name, |b| {
+            b.iter(|| {
+                context
+                    .read_second(gps_second, 1, coarse_chan_index, &mut buffer)
+                    .unwrap();
+                black_box(&buffer);
+            })
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_read_file, bench_read_second);
+criterion_main!(benches);
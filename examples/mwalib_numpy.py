@@ -0,0 +1,395 @@
+#!/usr/bin/env python
+
+# NumPy bindings for reading MWA correlator data with mwalib.
+#
+# This module wraps the mwalib C API with ctypes. Visibilities are read directly
+# into NumPy arrays, which may be supplied by the caller and reused between reads,
+# and the metadata (antennas, rf inputs, timesteps and coarse channels) is
+# returned as NumPy structured arrays.
+#
+# ctypes releases the GIL for the duration of every call into mwalib, so reads
+# (including the I/O and the conversion/reordering of the data) from several
+# Python threads, e.g. a ThreadPoolExecutor or the dask threaded scheduler, run
+# in parallel. Each thread must read into its own buffer.
+#
+# Example:
+#
+#     import mwalib_numpy
+#
+#     with mwalib_numpy.CorrelatorContext(metafits, gpuboxes) as context:
+#         data = np.empty(context.hdu_shape("baseline"), dtype=np.float32)
+#         for t in range(len(context.timesteps)):
+#             context.read_by_baseline(t, 0, out=data)
+#
+# The location of the mwalib shared library can be given with the
+# MWALIB_LIBRARY environment variable, otherwise it is found on the normal
+# library search path.
+#
+# Additional documentation:
+# https://docs.python.org/3.8/library/ctypes.html#module-ctypes
+
+import os
+import sys
+import ctypes as ct
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+
+MWALIB_SUCCESS = 0
+MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN = -1
+
+ERROR_MESSAGE_LEN = 1024
+
+# The MWA correlator always produces 4 visibility pols (xx, xy, yx, yy)
+NUM_VISIBILITY_POLS = 4
+
+
+class MwalibError(Exception):
+    """An error returned by mwalib."""
+
+
+class NoDataError(MwalibError):
+    """There is no data for the requested timestep and coarse channel."""
+
+
+class CorrelatorContextS(ct.Structure):
+    pass
+
+
+class MetafitsContextS(ct.Structure):
+    pass
+
+
+# These mirror the structs of the same name in the C API. The string fields are
+# declared as plain pointers so the structs convert to NumPy dtypes.
+class AntennaS(ct.Structure):
+    _fields_ = [("ant", ct.c_uint32),
+                ("tile_id", ct.c_uint32),
+                ("tile_name", ct.c_void_p),
+                ("rfinput_x", ct.c_size_t),
+                ("rfinput_y", ct.c_size_t),
+                ("electrical_length_m", ct.c_double),
+                ("north_m", ct.c_double),
+                ("east_m", ct.c_double),
+                ("height_m", ct.c_double)]
+
+
+class RfinputS(ct.Structure):
+    _fields_ = [("input", ct.c_uint32),
+                ("ant", ct.c_uint32),
+                ("tile_id", ct.c_uint32),
+                ("tile_name", ct.c_void_p),
+                ("pol", ct.c_void_p),
+                ("electrical_length_m", ct.c_double),
+                ("north_m", ct.c_double),
+                ("east_m", ct.c_double),
+                ("height_m", ct.c_double),
+                ("vcs_order", ct.c_uint32),
+                ("subfile_order", ct.c_uint32),
+                ("flagged", ct.c_bool),
+                ("rec_number", ct.c_uint32),
+                ("rec_slot_number", ct.c_uint32)]
+
+
+class TimeStepS(ct.Structure):
+    _fields_ = [("unix_time_ms", ct.c_uint64),
+                ("gps_time_ms", ct.c_uint64)]
+
+
+class CoarseChannelS(ct.Structure):
+    _fields_ = [("corr_chan_number", ct.c_size_t),
+                ("rec_chan_number", ct.c_size_t),
+                ("gpubox_number", ct.c_size_t),
+                ("chan_width_hz", ct.c_uint32),
+                ("chan_start_hz", ct.c_uint32),
+                ("chan_centre_hz", ct.c_uint32),
+                ("chan_end_hz", ct.c_uint32)]
+
+
+def _load_library():
+    filename = os.environ.get("MWALIB_LIBRARY")
+    if filename is None:
+        prefix = {"win32": ""}.get(sys.platform, "lib")
+        extension = {"darwin": ".dylib", "win32": ".dll"}.get(sys.platform, ".so")
+        filename = prefix + "mwalib" + extension
+    return ct.cdll.LoadLibrary(filename)
+
+
+mwalib = _load_library()
+
+_c_float_p = ct.POINTER(ct.c_float)
+_c_size_t_p = ct.POINTER(ct.c_size_t)
+
+
+def _declare(name, *argtypes):
+    # Every function we use returns an i32 status and ends with the error message buffer and its length
+    function = getattr(mwalib, name)
+    function.argtypes = argtypes + (ct.c_char_p, ct.c_size_t)
+    function.restype = ct.c_int32
+
+
+_declare("mwalib_set_num_threads", ct.c_size_t)
+_declare("mwalib_correlator_context_new",
+         ct.c_char_p,                                 # metafits
+         ct.POINTER(ct.c_char_p),                     # gpuboxes
+         ct.c_size_t,                                 # gpubox count
+         ct.POINTER(ct.POINTER(CorrelatorContextS)))  # Pointer to pointer to CorrelatorContext
+_declare("mwalib_correlator_context_get_metafits_context",
+         ct.POINTER(CorrelatorContextS),
+         ct.POINTER(ct.POINTER(MetafitsContextS)))
+_declare("mwalib_correlator_context_get_timesteps",
+         ct.POINTER(CorrelatorContextS), ct.POINTER(ct.POINTER(TimeStepS)), _c_size_t_p)
+_declare("mwalib_correlator_context_get_coarse_chans",
+         ct.POINTER(CorrelatorContextS), ct.POINTER(ct.POINTER(CoarseChannelS)), _c_size_t_p)
+_declare("mwalib_metafits_context_get_antennas",
+         ct.POINTER(MetafitsContextS), ct.POINTER(ct.POINTER(AntennaS)), _c_size_t_p)
+_declare("mwalib_metafits_context_get_rf_inputs",
+         ct.POINTER(MetafitsContextS), ct.POINTER(ct.POINTER(RfinputS)), _c_size_t_p)
+_declare("mwalib_metafits_context_get_num_baselines", ct.POINTER(MetafitsContextS), _c_size_t_p)
+_declare("mwalib_metafits_context_get_num_corr_fine_chans_per_coarse",
+         ct.POINTER(MetafitsContextS), _c_size_t_p)
+
+for _order in ("baseline", "frequency"):
+    _declare(f"mwalib_correlator_context_read_by_{_order}",
+             ct.POINTER(CorrelatorContextS),
+             ct.c_size_t,   # timestep index
+             ct.c_size_t,   # coarse chan index
+             _c_float_p,    # buffer_ptr
+             ct.c_size_t)   # buffer_len
+    _declare(f"mwalib_correlator_context_read_by_{_order}_batch",
+             ct.POINTER(CorrelatorContextS),
+             _c_size_t_p,   # timestep indices
+             ct.c_size_t,   # number of timestep indices
+             _c_size_t_p,   # coarse chan indices
+             ct.c_size_t,   # number of coarse chan indices
+             _c_float_p,    # buffer_ptr
+             ct.c_size_t)   # buffer_len
+
+mwalib.mwalib_correlator_context_free.argtypes = (ct.POINTER(CorrelatorContextS), )
+mwalib.mwalib_correlator_context_free.restype = ct.c_int32
+
+
+def _call(function, *args):
+    error_message = ct.create_string_buffer(ERROR_MESSAGE_LEN)
+    retval = function(*args, error_message, ERROR_MESSAGE_LEN)
+
+    if retval == MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN:
+        raise NoDataError(error_message.value.decode("utf-8").rstrip())
+    elif retval != MWALIB_SUCCESS:
+        raise MwalibError(error_message.value.decode("utf-8").rstrip())
+
+
+def _struct_dtype(struct):
+    # The NumPy equivalent of a ctypes struct, with the same field offsets and padding
+    formats = [np.dtype(np.uintp) if ctype is ct.c_void_p else np.dtype(ctype) for _, ctype in struct._fields_]
+    return np.dtype({"names": [name for name, _ in struct._fields_],
+                     "formats": formats,
+                     "offsets": [getattr(struct, name).offset for name, _ in struct._fields_],
+                     "itemsize": ct.sizeof(struct)})
+
+
+def _borrowed_array(getter, owner_ptr, struct, string_fields=()):
+    # Copy a borrowed C array of structs into a single structured array, with the
+    # string pointers decoded into fixed width string fields
+    items_ptr = ct.POINTER(struct)()
+    num_items = ct.c_size_t()
+    _call(getter, owner_ptr, ct.byref(items_ptr), ct.byref(num_items))
+
+    raw_dtype = _struct_dtype(struct)
+    if num_items.value == 0:
+        raw = np.empty(0, dtype=raw_dtype)
+    else:
+        raw = np.frombuffer((ct.c_char * (num_items.value * ct.sizeof(struct))).from_address(
+            ct.addressof(items_ptr.contents)), dtype=raw_dtype)
+
+    strings = {name: [ct.string_at(int(ptr)).decode("utf-8") for ptr in raw[name]] for name in string_fields}
+
+    dtype = []
+    for name in raw_dtype.names:
+        if name in strings:
+            dtype.append((name, f"U{max([1] + [len(s) for s in strings[name]])}"))
+        else:
+            dtype.append((name, raw_dtype.fields[name][0]))
+
+    items = np.empty(num_items.value, dtype=dtype)
+    for name in raw_dtype.names:
+        items[name] = strings[name] if name in strings else raw[name]
+    return items
+
+
+def _indices(indices):
+    return np.ascontiguousarray(indices, dtype=np.uintp)
+
+
+def _check_buffer(out, num_floats):
+    if not isinstance(out, np.ndarray) or out.dtype != np.float32:
+        raise ValueError("out must be a numpy array of float32")
+    if not out.flags.c_contiguous or not out.flags.writeable:
+        raise ValueError("out must be C contiguous and writeable")
+    if out.size != num_floats:
+        raise ValueError(f"out has {out.size} floats, but {num_floats} are needed")
+
+
+def set_num_threads(num_threads):
+    """Set the number of threads mwalib spreads its parallel work (including batch reads) over.
+    0 goes back to the default of one thread per core."""
+    _call(mwalib.mwalib_set_num_threads, num_threads)
+
+
+class CorrelatorContext:
+    """An MWA correlator observation: a metafits file and its gpubox files.
+
+    The metadata attributes are structured arrays, copied from mwalib when the context is
+    created, so they remain valid after the context is closed:
+
+    * `antennas` - ant, tile_id, tile_name, rfinput_x, rfinput_y, electrical_length_m, north_m, east_m, height_m
+    * `rf_inputs` - input, ant, tile_id, tile_name, pol, electrical_length_m, north_m, east_m, height_m,
+      vcs_order, subfile_order, flagged, rec_number, rec_slot_number
+    * `timesteps` - unix_time_ms, gps_time_ms
+    * `coarse_chans` - corr_chan_number, rec_chan_number, gpubox_number, chan_width_hz, chan_start_hz,
+      chan_centre_hz, chan_end_hz
+    """
+
+    def __init__(self, metafits, gpuboxes):
+        # Encode all inputs as UTF-8.
+        m = ct.c_char_p(metafits.encode("utf-8"))
+        encoded = [ct.c_char_p(g.encode("utf-8")) for g in gpuboxes]
+        g = (ct.c_char_p * len(encoded))(*encoded)
+
+        self._context = ct.POINTER(CorrelatorContextS)()
+        _call(mwalib.mwalib_correlator_context_new, m, g, len(encoded), ct.byref(self._context))
+
+        try:
+            # The metafits context is owned by the correlator context and must not be freed
+            metafits_context = ct.POINTER(MetafitsContextS)()
+            _call(mwalib.mwalib_correlator_context_get_metafits_context, self._context,
+                  ct.byref(metafits_context))
+
+            num_baselines = ct.c_size_t()
+            _call(mwalib.mwalib_metafits_context_get_num_baselines, metafits_context,
+                  ct.byref(num_baselines))
+            num_fine_chans = ct.c_size_t()
+            _call(mwalib.mwalib_metafits_context_get_num_corr_fine_chans_per_coarse, metafits_context,
+                  ct.byref(num_fine_chans))
+            self.num_baselines = num_baselines.value
+            self.num_fine_chans = num_fine_chans.value
+
+            self.antennas = _borrowed_array(mwalib.mwalib_metafits_context_get_antennas, metafits_context,
+                                            AntennaS, ("tile_name",))
+            self.rf_inputs = _borrowed_array(mwalib.mwalib_metafits_context_get_rf_inputs, metafits_context,
+                                             RfinputS, ("tile_name", "pol"))
+            self.timesteps = _borrowed_array(mwalib.mwalib_correlator_context_get_timesteps, self._context,
+                                             TimeStepS)
+            self.coarse_chans = _borrowed_array(mwalib.mwalib_correlator_context_get_coarse_chans, self._context,
+                                                CoarseChannelS)
+        except MwalibError:
+            self.close()
+            raise
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+    def close(self):
+        """Free the underlying mwalib context. No reads may be made afterwards."""
+        if self._context:
+            mwalib.mwalib_correlator_context_free(self._context)
+            self._context = ct.POINTER(CorrelatorContextS)()
+
+    @property
+    def num_floats(self):
+        """Number of floats in one timestep and coarse channel (one HDU) of visibilities."""
+        return self.num_baselines * self.num_fine_chans * NUM_VISIBILITY_POLS * 2
+
+    def hdu_shape(self, order):
+        """Shape of one timestep and coarse channel of visibilities read in `order` ("baseline" or "frequency")."""
+        if order == "baseline":
+            return (self.num_baselines, self.num_fine_chans, NUM_VISIBILITY_POLS, 2)
+        elif order == "frequency":
+            return (self.num_fine_chans, self.num_baselines, NUM_VISIBILITY_POLS, 2)
+        raise ValueError(f"order must be 'baseline' or 'frequency', not {order!r}")
+
+    def _read(self, order, timestep_index, coarse_chan_index, out):
+        if out is None:
+            out = np.empty(self.hdu_shape(order), dtype=np.float32)
+        _check_buffer(out, self.num_floats)
+
+        _call(getattr(mwalib, f"mwalib_correlator_context_read_by_{order}"), self._context,
+              timestep_index, coarse_chan_index, out.ctypes.data_as(_c_float_p), out.size)
+        return out
+
+    def _read_batch(self, order, timestep_indices, coarse_chan_indices, out):
+        timestep_indices = _indices(timestep_indices)
+        coarse_chan_indices = _indices(coarse_chan_indices)
+        if out is None:
+            out = np.empty((timestep_indices.size, coarse_chan_indices.size) + self.hdu_shape(order),
+                           dtype=np.float32)
+        _check_buffer(out, timestep_indices.size * coarse_chan_indices.size * self.num_floats)
+
+        _call(getattr(mwalib, f"mwalib_correlator_context_read_by_{order}_batch"), self._context,
+              timestep_indices.ctypes.data_as(_c_size_t_p), timestep_indices.size,
+              coarse_chan_indices.ctypes.data_as(_c_size_t_p), coarse_chan_indices.size,
+              out.ctypes.data_as(_c_float_p), out.size)
+        return out
+
+    def read_by_baseline(self, timestep_index, coarse_chan_index, out=None):
+        """Read one timestep and coarse channel in [baseline][frequency][pol][r][i] order.
+
+        `out`, if given, must be a C contiguous float32 array of `num_floats` elements (of any shape),
+        and is filled and returned. Otherwise a new array of shape `hdu_shape("baseline")` is returned.
+        Raises NoDataError if there is no data for this timestep and coarse channel."""
+        return self._read("baseline", timestep_index, coarse_chan_index, out)
+
+    def read_by_frequency(self, timestep_index, coarse_chan_index, out=None):
+        """Read one timestep and coarse channel in [frequency][baseline][pol][r][i] order.
+
+        `out` is as for `read_by_baseline`."""
+        return self._read("frequency", timestep_index, coarse_chan_index, out)
+
+    def read_by_baseline_batch(self, timestep_indices, coarse_chan_indices, out=None):
+        """Read many timesteps and coarse channels at once, in parallel on mwalib's thread pool, in
+        [timestep][coarse_chan][baseline][frequency][pol][r][i] order.
+
+        `out`, if given, must be a C contiguous float32 array of
+        `len(timestep_indices) * len(coarse_chan_indices) * num_floats` elements."""
+        return self._read_batch("baseline", timestep_indices, coarse_chan_indices, out)
+
+    def read_by_frequency_batch(self, timestep_indices, coarse_chan_indices, out=None):
+        """Read many timesteps and coarse channels at once, in parallel on mwalib's thread pool, in
+        [timestep][coarse_chan][frequency][baseline][pol][r][i] order.
+
+        `out` is as for `read_by_baseline_batch`."""
+        return self._read_batch("frequency", timestep_indices, coarse_chan_indices, out)
+
+    def iter_timesteps(self, timestep_indices=None, coarse_chan_indices=None, order="baseline"):
+        """Iterate over timesteps, yielding (timestep_index, data) where data holds all of the coarse
+        channels of that timestep, with shape (len(coarse_chan_indices),) + hdu_shape(order).
+
+        The next timestep is read in the background while the current one is being processed. Only
+        two buffers are used, so each yielded array is overwritten once the iteration moves on: copy
+        it if it is needed for longer."""
+        if timestep_indices is None:
+            timestep_indices = range(len(self.timesteps))
+        if coarse_chan_indices is None:
+            coarse_chan_indices = range(len(self.coarse_chans))
+        timestep_indices = list(timestep_indices)
+        coarse_chan_indices = _indices(coarse_chan_indices)
+        if not timestep_indices:
+            return
+
+        shape = (coarse_chan_indices.size,) + self.hdu_shape(order)
+        buffers = [np.empty(shape, dtype=np.float32) for _ in range(2)]
+
+        def read(i):
+            return self._read_batch(order, [timestep_indices[i]], coarse_chan_indices, buffers[i % 2])
+
+        # Leaving the executor waits for any read in flight, including when iteration stops early
+        with ThreadPoolExecutor(max_workers=1) as executor:
+            pending = executor.submit(read, 0)
+            for i, timestep_index in enumerate(timestep_indices):
+                data = pending.result()
+                if i + 1 < len(timestep_indices):
+                    pending = executor.submit(read, i + 1)
+                yield timestep_index, data
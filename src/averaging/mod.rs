@@ -0,0 +1,118 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Kernels for averaging visibilities in time and frequency as they are read.
+
+Each HDU (in baseline,frequency,pol,r,i order) is added into running weighted sums of the
+averaged output as soon as it has been read, so only one full resolution HDU is ever held in
+memory. Once every HDU for an averaged timestep has been added, the sums are divided by the sum
+of the weights.
+ */
+use rayon::prelude::*;
+
+#[cfg(test)]
+mod test;
+
+/// Add the visibilities of one HDU into the weighted sums of the averaged output.
+///
+/// # Arguments
+///
+/// * `hdu` - the visibilities of the HDU in [baseline][frequency][pol][r][i] order.
+///
+/// * `hdu_weights` - the weights of the HDU in [baseline][pol] order, or None to weight every visibility by 1.
+///
+/// * `vis_sums` - the running weighted sums of the visibilities in [baseline][averaged frequency][pol][r][i] order.
+///
+/// * `weight_sums` - the running sums of the weights in [baseline][averaged frequency][pol] order.
+///
+/// * `num_fine_chans` - number of fine channels in the HDU.
+///
+/// * `num_visibility_pols` - number of visibility pols (always 4 for MWA).
+///
+/// * `freq_factor` - number of fine channels averaged into each output channel. Must divide `num_fine_chans`.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+pub(crate) fn accumulate_hdu(
+    hdu: &[f32],
+    hdu_weights: Option<&[f32]>,
+    vis_sums: &mut [f32],
+    weight_sums: &mut [f32],
+    num_fine_chans: usize,
+    num_visibility_pols: usize,
+    freq_factor: usize,
+) {
+    let num_averaged_fine_chans = num_fine_chans / freq_factor;
+    let chan_floats = num_visibility_pols * 2;
+
+    vis_sums
+        .par_chunks_mut(num_averaged_fine_chans * chan_floats)
+        .zip(weight_sums.par_chunks_mut(num_averaged_fine_chans * num_visibility_pols))
+        .zip(hdu.par_chunks(num_fine_chans * chan_floats))
+        .enumerate()
+        .for_each(
+            |(baseline_index, ((baseline_sums, baseline_weights), baseline_hdu))| {
+                // MWAX weights have no frequency axis, so there is one per pol for the whole baseline
+                let pol_weights = hdu_weights.map(|w| {
+                    &w[baseline_index * num_visibility_pols
+                        ..(baseline_index + 1) * num_visibility_pols]
+                });
+
+                for (fine_chan_index, chan_hdu) in
+                    baseline_hdu.chunks_exact(chan_floats).enumerate()
+                {
+                    let averaged_chan_index = fine_chan_index / freq_factor;
+                    let chan_sums = &mut baseline_sums[averaged_chan_index * chan_floats
+                        ..(averaged_chan_index + 1) * chan_floats];
+                    let chan_weights = &mut baseline_weights[averaged_chan_index
+                        * num_visibility_pols
+                        ..(averaged_chan_index + 1) * num_visibility_pols];
+
+                    for pol in 0..num_visibility_pols {
+                        let weight = match pol_weights {
+                            Some(w) => w[pol],
+                            None => 1.0,
+                        };
+
+                        chan_sums[pol * 2] += weight * chan_hdu[pol * 2];
+                        chan_sums[pol * 2 + 1] += weight * chan_hdu[pol * 2 + 1];
+                        chan_weights[pol] += weight;
+                    }
+                }
+            },
+        );
+}
+
+/// Turn the weighted sums built by `accumulate_hdu` into weighted averages. Visibilities whose
+/// weights sum to zero (or less) are set to zero.
+///
+/// # Arguments
+///
+/// * `vis_sums` - the weighted sums of the visibilities in [baseline][averaged frequency][pol][r][i] order. These are replaced by the averages.
+///
+/// * `weight_sums` - the sums of the weights in [baseline][averaged frequency][pol] order.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+pub(crate) fn normalise_averages(vis_sums: &mut [f32], weight_sums: &[f32]) {
+    vis_sums
+        .par_chunks_mut(2)
+        .zip(weight_sums.par_iter())
+        .for_each(|(vis, &weight)| {
+            if weight > 0.0 {
+                vis[0] /= weight;
+                vis[1] /= weight;
+            } else {
+                vis[0] = 0.0;
+                vis[1] = 0.0;
+            }
+        });
+}
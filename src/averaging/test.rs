@@ -0,0 +1,67 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for time and frequency averaging
+*/
+#[cfg(test)]
+use super::*;
+
+#[test]
+fn test_accumulate_hdu_unweighted() {
+    // 2 baselines, 4 fine chans, 1 pol
+    let hdu: Vec<f32> = (0..16).map(|i| i as f32).collect();
+    let mut vis_sums = vec![0.0; 8];
+    let mut weight_sums = vec![0.0; 4];
+
+    // Average pairs of fine chans, twice (as if two timesteps)
+    accumulate_hdu(&hdu, None, &mut vis_sums, &mut weight_sums, 4, 1, 2);
+    accumulate_hdu(&hdu, None, &mut vis_sums, &mut weight_sums, 4, 1, 2);
+    assert_eq!(vis_sums, vec![4.0, 8.0, 20.0, 24.0, 36.0, 40.0, 52.0, 56.0]);
+    assert_eq!(weight_sums, vec![4.0; 4]);
+
+    normalise_averages(&mut vis_sums, &weight_sums);
+    assert_eq!(vis_sums, vec![1.0, 2.0, 5.0, 6.0, 9.0, 10.0, 13.0, 14.0]);
+}
+
+#[test]
+fn test_accumulate_hdu_weighted() {
+    // 1 baseline, 2 fine chans, 2 pols
+    let hdu: Vec<f32> = vec![1.0, 1.0, 2.0, 2.0, 3.0, 3.0, 4.0, 4.0];
+    let mut vis_sums = vec![0.0; 4];
+    let mut weight_sums = vec![0.0; 2];
+
+    // The second pol is flagged in the first timestep
+    accumulate_hdu(
+        &hdu,
+        Some(&[1.0, 0.0]),
+        &mut vis_sums,
+        &mut weight_sums,
+        2,
+        2,
+        2,
+    );
+    let hdu2: Vec<f32> = hdu.iter().map(|v| v * 10.0).collect();
+    accumulate_hdu(
+        &hdu2,
+        Some(&[0.5, 1.0]),
+        &mut vis_sums,
+        &mut weight_sums,
+        2,
+        2,
+        2,
+    );
+    assert_eq!(weight_sums, vec![3.0, 2.0]);
+
+    normalise_averages(&mut vis_sums, &weight_sums);
+    // pol 0: (1 + 3 + 0.5 * (10 + 30)) / 3, pol 1: (20 + 40) / 2
+    assert_eq!(vis_sums, vec![8.0, 8.0, 30.0, 30.0]);
+}
+
+#[test]
+fn test_normalise_averages_zero_weight() {
+    let mut vis_sums = vec![2.0, 4.0, 6.0, 8.0];
+    normalise_averages(&mut vis_sums, &[2.0, 0.0]);
+    assert_eq!(vis_sums, vec![1.0, 2.0, 0.0, 0.0]);
+}
@@ -5,13 +5,16 @@
 /*!
 Structs and helper methods for baseline metadata
 */
+use crate::antenna::Antenna;
 use crate::misc;
+use std::collections::HashMap;
 use std::fmt;
 
 #[cfg(test)]
 mod test;
 /// This is a struct for our baselines, so callers know the antenna ordering
 #[derive(Clone)]
+#[repr(C)]
 pub struct Baseline {
     /// Index in the mwalibContext.antenna array for antenna1 for this baseline
     pub ant1_index: usize,
@@ -72,3 +75,109 @@ impl fmt::Debug for Baseline {
         write!(f, "{},{}", self.ant1_index, self.ant2_index,)
     }
 }
+
+/// Precomputed lookups from antennas to their index, and from pairs of antennas to their
+/// baseline, so that callers working per visibility do not need to search `antennas` or
+/// `baselines`. Built once for each `MetafitsContext`.
+#[derive(Clone)]
+pub(crate) struct BaselineLookup {
+    /// Number of antennas (the table is num_ants * num_ants).
+    num_ants: usize,
+    /// Index of each antenna in `MetafitsContext.antennas`, by tile name.
+    tile_name_indices: HashMap<String, usize>,
+    /// Index of each antenna in `MetafitsContext.antennas`, by tile id.
+    tile_id_indices: HashMap<u32, usize>,
+    /// Baseline index of every pair of antennas, structured:
+    /// `baseline_table[ant1_index * num_ants + ant2_index]`. Pairs with ant1_index > ant2_index
+    /// are not baselines and hold `u32::MAX`.
+    baseline_table: Vec<u32>,
+}
+
+impl BaselineLookup {
+    /// Creates the lookups for a set of antennas. Where tile names or ids are repeated, the
+    /// first antenna with them is used.
+    ///
+    /// # Arguments
+    ///
+    /// * `antennas` - the antennas of the observation, in `MetafitsContext.antennas` order.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A populated BaselineLookup struct
+    ///
+    pub(crate) fn new(antennas: &[Antenna]) -> Self {
+        let num_ants = antennas.len();
+
+        let mut tile_name_indices: HashMap<String, usize> = HashMap::with_capacity(num_ants);
+        let mut tile_id_indices: HashMap<u32, usize> = HashMap::with_capacity(num_ants);
+        for (index, antenna) in antennas.iter().enumerate() {
+            tile_name_indices
+                .entry(antenna.tile_name.clone())
+                .or_insert(index);
+            tile_id_indices.entry(antenna.tile_id).or_insert(index);
+        }
+
+        let mut baseline_table: Vec<u32> = vec![u32::MAX; num_ants * num_ants];
+        let mut bl_index: u32 = 0;
+        for a1 in 0..num_ants {
+            for a2 in a1..num_ants {
+                baseline_table[a1 * num_ants + a2] = bl_index;
+                bl_index += 1;
+            }
+        }
+
+        Self {
+            num_ants,
+            tile_name_indices,
+            tile_id_indices,
+            baseline_table,
+        }
+    }
+
+    /// Returns the antenna index of a tile name, or None if there is no such tile.
+    pub(crate) fn get_antenna_index_from_tile_name(&self, tile_name: &str) -> Option<usize> {
+        self.tile_name_indices.get(tile_name).copied()
+    }
+
+    /// Returns the antenna index of a tile id, or None if there is no such tile.
+    pub(crate) fn get_antenna_index_from_tile_id(&self, tile_id: u32) -> Option<usize> {
+        self.tile_id_indices.get(&tile_id).copied()
+    }
+
+    /// Returns the baseline index of a pair of antenna indices, or None if they are out of range
+    /// or ant1_index > ant2_index.
+    pub(crate) fn get_baseline_index(&self, ant1_index: usize, ant2_index: usize) -> Option<usize> {
+        if ant1_index >= self.num_ants || ant2_index >= self.num_ants {
+            return None;
+        }
+
+        match self.baseline_table[ant1_index * self.num_ants + ant2_index] {
+            u32::MAX => None,
+            bl_index => Some(bl_index as usize),
+        }
+    }
+
+    /// Returns the whole baseline table, see `MetafitsContext::get_baseline_table`.
+    pub(crate) fn baseline_table(&self) -> &[u32] {
+        &self.baseline_table
+    }
+}
+
+/// Implements fmt::Debug for BaselineLookup struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for BaselineLookup {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "BaselineLookup {{ num_ants: {} }}", self.num_ants)
+    }
+}
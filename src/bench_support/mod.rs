@@ -0,0 +1,128 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Thin public wrappers around internal kernels, so the criterion benchmarks in `benches/` can time
+them in isolation. Only compiled with the `benchmarks` feature; not part of the supported API.
+ */
+use crate::convert::{self, LegacyConversionBaseline};
+use crate::Rfinput;
+
+/// An opaque, precalculated legacy to MWAX baseline conversion table.
+pub struct LegacyConversionTable(Vec<LegacyConversionBaseline>);
+
+impl LegacyConversionTable {
+    /// Generate the conversion table for a legacy observation (bypassing the shared table cache,
+    /// so this can be used to time the generation itself).
+    ///
+    /// # Arguments
+    ///
+    /// * `rf_inputs` - A slice containing all 256 `RFInput`s from the metafits.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A LegacyConversionTable
+    ///
+    pub fn new(rf_inputs: &[Rfinput]) -> Self {
+        Self(convert::generate_conversion_array(&mut rf_inputs.to_vec()))
+    }
+}
+
+/// See `convert::convert_legacy_hdu_to_mwax_baseline_order`.
+///
+/// # Arguments
+///
+/// * `conversion_table` - the table for this observation.
+///
+/// * `input_buffer` - a legacy HDU (one row per fine channel).
+///
+/// * `output_buffer` - buffer to write the data in [baseline][freq][pol][r][i] order into.
+///
+/// * `num_fine_chans` - Number of fine channels in this observation.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+pub fn convert_legacy_hdu_to_mwax_baseline_order(
+    conversion_table: &LegacyConversionTable,
+    input_buffer: &[f32],
+    output_buffer: &mut [f32],
+    num_fine_chans: usize,
+) {
+    convert::convert_legacy_hdu_to_mwax_baseline_order(
+        &conversion_table.0,
+        input_buffer,
+        output_buffer,
+        num_fine_chans,
+    )
+}
+
+/// See `convert::convert_legacy_hdu_to_mwax_frequency_order`.
+///
+/// # Arguments
+///
+/// * `conversion_table` - the table for this observation.
+///
+/// * `input_buffer` - a legacy HDU (one row per fine channel).
+///
+/// * `output_buffer` - buffer to write the data in [freq][baseline][pol][r][i] order into.
+///
+/// * `num_fine_chans` - Number of fine channels in this observation.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+pub fn convert_legacy_hdu_to_mwax_frequency_order(
+    conversion_table: &LegacyConversionTable,
+    input_buffer: &[f32],
+    output_buffer: &mut [f32],
+    num_fine_chans: usize,
+) {
+    convert::convert_legacy_hdu_to_mwax_frequency_order(
+        &conversion_table.0,
+        input_buffer,
+        output_buffer,
+        num_fine_chans,
+    )
+}
+
+/// See `convert::convert_mwax_hdu_to_frequency_order`.
+///
+/// # Arguments
+///
+/// * `input_buffer` - an MWAX HDU, in [baseline][freq][pol][r][i] order.
+///
+/// * `output_buffer` - buffer to write the data in [freq][baseline][pol][r][i] order into.
+///
+/// * `num_baselines` - Number of baselines in this observation.
+///
+/// * `num_fine_chans` - Number of fine channels in this observation.
+///
+/// * `num_visibility_pols` - Number of visibility polarisations (always 4 for MWA).
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+pub fn convert_mwax_hdu_to_frequency_order(
+    input_buffer: &[f32],
+    output_buffer: &mut [f32],
+    num_baselines: usize,
+    num_fine_chans: usize,
+    num_visibility_pols: usize,
+) {
+    convert::convert_mwax_hdu_to_frequency_order(
+        input_buffer,
+        output_buffer,
+        num_baselines,
+        num_fine_chans,
+        num_visibility_pols,
+    )
+}
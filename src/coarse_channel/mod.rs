@@ -17,6 +17,7 @@ mod test;
 
 /// This is a struct for our coarse channels
 #[derive(Clone)]
+#[repr(C)]
 pub struct CoarseChannel {
     /// Correlator channel is 0 indexed (0..N-1)
     pub corr_chan_number: usize,
@@ -10,7 +10,10 @@ Major contributor: Brian Crosse (Curtin Institute for Radio Astronomy)
 */
 use crate::misc::*;
 use crate::rfinput::*;
+use rayon::prelude::*;
+use std::collections::HashMap;
 use std::fmt;
+use std::sync::{Arc, Mutex};
 
 #[cfg(test)]
 mod test;
@@ -35,19 +38,41 @@ fn fine_pfb_reorder(input: usize) -> usize {
 }
 
 /// Structure for storing where in the input visibilities to get the specified baseline when converting
+#[derive(Clone)]
 pub(crate) struct LegacyConversionBaseline {
-    pub baseline: usize,    // baseline index
-    pub ant1: usize,        // antenna1 index
-    pub ant2: usize,        // antenna2 index
-    pub xx_index: usize,    // index of where complex xx is in the input buffer
-    pub xx_conjugate: bool, // if true, we need to conjugate this visibility
-    pub xy_index: usize,    // index of where complex xx is in the input buffer
-    pub xy_conjugate: bool, // if true, we need to conjugate this visibility
-    pub yx_index: usize,    // index of where complex xx is in the input buffer
-    pub yx_conjugate: bool, // if true, we need to conjugate this visibility
-    pub yy_index: usize,    // index of where complex xx is in the input buffer
-    pub yy_conjugate: bool, // if true, we need to conjugate this visibility
-    pub is_cross: bool,     // if true, we need to conjugate this visibility AGAIN
+    pub baseline: usize,           // baseline index
+    pub ant1: usize,               // antenna1 index
+    pub ant2: usize,               // antenna2 index
+    pub xx_index: usize,           // index of where complex xx is in the input buffer
+    pub xy_index: usize,           // index of where complex xx is in the input buffer
+    pub yx_index: usize,           // index of where complex xx is in the input buffer
+    pub yy_index: usize,           // index of where complex xx is in the input buffer
+    pub is_cross: bool,            // if true, we need to conjugate this visibility AGAIN
+    pub imag_sign_masks: [u32; 4], // bits to XOR into the xx, xy, yx, yy imaginary parts (see `imag_sign_mask`)
+}
+
+/// The sign bit of an IEEE754 32 bit float. XORing a float's bits with this negates it.
+const F32_SIGN_MASK: u32 = 0x8000_0000;
+
+/// Returns the bits to XOR into the imaginary part of a legacy visibility during conversion.
+/// Every output visibility is conjugated to put it in the correct triangle, so visibilities which
+/// need conjugating in the input end up unchanged, and all others are negated.
+///
+/// # Arguments
+///
+/// * `conjugate` - true if the input visibility needs to be conjugated.
+///
+///
+/// # Returns
+///
+/// * The XOR mask to apply to the bits of the imaginary part.
+///
+fn imag_sign_mask(conjugate: bool) -> u32 {
+    if conjugate {
+        0
+    } else {
+        F32_SIGN_MASK
+    }
 }
 
 impl LegacyConversionBaseline {
@@ -73,14 +98,16 @@ impl LegacyConversionBaseline {
             ant1,
             ant2,
             xx_index: xx.abs() as usize,
-            xx_conjugate: xx < 0,
             xy_index: xy.abs() as usize,
-            xy_conjugate: xy < 0,
             yx_index: yx.abs() as usize,
-            yx_conjugate: yx < 0,
             yy_index: yy.abs() as usize,
-            yy_conjugate: yy < 0,
             is_cross: ant1 != ant2,
+            imag_sign_masks: [
+                imag_sign_mask(xx < 0),
+                imag_sign_mask(xy < 0),
+                imag_sign_mask(yx < 0),
+                imag_sign_mask(yy < 0),
+            ],
         }
     }
 }
@@ -187,6 +214,45 @@ fn generate_full_matrix(mwax_order: Vec<usize>) -> Vec<i32> {
     full_matrix
 }
 
+lazy_static::lazy_static! {
+    /// Legacy conversion tables already generated by `get_conversion_array`, keyed by the
+    /// subfile order of the rf_inputs (sorted by input), which is all a table depends on.
+    static ref LEGACY_CONVERSION_TABLES: Mutex<HashMap<Vec<u32>, Arc<Vec<LegacyConversionBaseline>>>> =
+        Mutex::new(HashMap::new());
+}
+
+/// As per `generate_conversion_array`, but returning a shared table from a process-wide cache,
+/// so the table is only generated once for every observation with the same rf_input ordering.
+///
+/// # Arguments
+///
+/// * `rf_inputs` - A slice containing all of the `RFInput`s from the metafits.
+///
+///
+/// # Returns
+///
+/// * A shared Vector of `LegacyConversionBaseline`s, as per `generate_conversion_array`.
+///
+pub(crate) fn get_conversion_array(rf_inputs: &[Rfinput]) -> Arc<Vec<LegacyConversionBaseline>> {
+    let mut sorted_rf_inputs: Vec<&Rfinput> = rf_inputs.iter().collect();
+    sorted_rf_inputs.sort_by(|a, b| a.input.cmp(&b.input));
+    let key: Vec<u32> = sorted_rf_inputs.iter().map(|r| r.subfile_order).collect();
+
+    let lock_tables = || match LEGACY_CONVERSION_TABLES.lock() {
+        Ok(tables) => tables,
+        Err(poisoned) => poisoned.into_inner(),
+    };
+
+    if let Some(table) = lock_tables().get(&key) {
+        return Arc::clone(table);
+    }
+
+    // Generate without holding the lock, as this is the slow part
+    let table = Arc::new(generate_conversion_array(&mut rf_inputs.to_vec()));
+
+    Arc::clone(lock_tables().entry(key).or_insert(table))
+}
+
 /// This takes the rf_inputs from the metafis and generates the conversion array for use when we convert legacy HDUs.
 ///
 /// # Arguments
@@ -262,14 +328,27 @@ pub(crate) fn generate_conversion_array(
     conversion_table
 }
 
+/// Number of baselines converted by each task of `convert_legacy_hdu_to_mwax_baseline_order`. With
+/// 128 fine channels this is 64 baselines x 128 fine channels x 32 bytes = 256 KiB of output per task.
+const LEGACY_CONVERT_BASELINE_TILE: usize = 64;
+/// HDUs with fewer floats than this are converted on the calling thread, as splitting them over
+/// the thread pool costs more than it saves (and callers such as the batch reads are already
+/// converting several HDUs in parallel).
+const CONVERT_MIN_PARALLEL_FLOATS: usize = 1 << 20;
+
 /// Using the precalculated conversion table, reorder the legacy visibilities into our preferred output order
 /// [time][baseline][freq][pol] in a standard triangle of 0,0 .. 0,N 1,1..1,N baseline order.
+///
+/// Each tile of `LEGACY_CONVERT_BASELINE_TILE` output baselines is written to a disjoint part of
+/// the output, so for large HDUs the tiles are converted in parallel on the rayon thread pool.
+///
 /// # Arguments
 ///
 /// * `conversion_table` - A vector containing all of the `
-///LegacyConversionBaseline`s we have pre-calculated.
+///LegacyConversionBaseline`s we have pre-calculated. This may also be a subset of them,
+/// in which case only those baselines are written to the output, in the order of the table.
 ///
-/// * `input_buffer` - Float vector read from legacy MWA HDUs.
+/// * `input_buffer` - Float vector read from legacy MWA HDUs (one row per fine channel).
 ///
 /// * `output_buffer` - Float vector to write converted data into.
 ///
@@ -298,82 +377,57 @@ pub(crate) fn convert_legacy_hdu_to_mwax_baseline_order(
     // Striding for output array
     let floats_per_baseline = floats_per_baseline_fine_chan * num_fine_chans;
 
-    // Read from the input buffer and write into the temp buffer
-    for fine_chan_index in 0..num_fine_chans {
-        // convert one fine channel at a time
-        for (baseline_index, baseline) in conversion_table.iter().enumerate() {
-            // Input visibilities are in [fine_chan][baseline][pol][real][imag] order so we need to stride
-            // through it.
-            // source index =
-            // (fine_chan_index * num_baselines * floats per baseline_chan) +
-            // (baseline_index * floats per baseline_chan)
-
-            // We need to work out where to start indexing the source data
-            // Go "down" the fine channels as if they are rows
-            // Go "across" the baselines as if they are columns
-            let source_index = fine_chan_index * floats_per_fine_chan;
-            // We need to work out where to start indexing the destination data
-            // Go "down" the baselines as if they are rows
-            // Go "across" the fine channels as if they are columns
-            let destination_index = (baseline_index * floats_per_baseline)
-                + (fine_chan_index * floats_per_baseline_fine_chan);
-            // xx_r
-            output_buffer[destination_index] = input_buffer[source_index + baseline.xx_index];
-            // xx_i
-            output_buffer[destination_index + 1] = if baseline.xx_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.xx_index + 1]
-            } else {
-                input_buffer[source_index + baseline.xx_index + 1]
-            };
-
-            // xy_r
-            output_buffer[destination_index + 2] = input_buffer[source_index + baseline.xy_index];
-            // xy_i
-            output_buffer[destination_index + 3] = if baseline.xy_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.xy_index + 1]
-            } else {
-                input_buffer[source_index + baseline.xy_index + 1]
-            };
-
-            // yx_r
-            output_buffer[destination_index + 4] = input_buffer[source_index + baseline.yx_index];
-            // yx_i
-            output_buffer[destination_index + 5] = if baseline.yx_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.yx_index + 1]
-            } else {
-                input_buffer[source_index + baseline.yx_index + 1]
-            };
-
-            // yy_r
-            output_buffer[destination_index + 6] = input_buffer[source_index + baseline.yy_index];
-            // yy_i
-            output_buffer[destination_index + 7] = if baseline.yy_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.yy_index + 1]
-            } else {
-                input_buffer[source_index + baseline.yy_index + 1]
-            };
-
-            // Finally take the conjugate so we are in the correct triangle
-            output_buffer[destination_index + 1] = -output_buffer[destination_index + 1];
-            output_buffer[destination_index + 3] = -output_buffer[destination_index + 3];
-            output_buffer[destination_index + 5] = -output_buffer[destination_index + 5];
-            output_buffer[destination_index + 7] = -output_buffer[destination_index + 7];
-        }
+    if floats_per_baseline == 0 {
+        return;
+    }
+
+    // Within each tile, read from the input buffer and write into the output buffer one
+    // baseline at a time, so the output is written sequentially
+    let convert_tile =
+        |(output_tile, conversion_tile): (&mut [f32], &[LegacyConversionBaseline])| {
+            for (baseline, output_baseline) in conversion_tile
+                .iter()
+                .zip(output_tile.chunks_exact_mut(floats_per_baseline))
+            {
+                // Input visibilities are in [fine_chan][baseline][pol][real][imag] order so we need to
+                // stride "down" the fine channels as if they are rows.
+                // Output visibilities are in [baseline][fine_chan][pol][real][imag] order.
+                for (input_fine_chan, output_fine_chan) in input_buffer
+                    .chunks_exact(floats_per_fine_chan)
+                    .zip(output_baseline.chunks_exact_mut(floats_per_baseline_fine_chan))
+                {
+                    convert_legacy_baseline(baseline, input_fine_chan, output_fine_chan);
+                }
+            }
+        };
+
+    let floats_per_tile = LEGACY_CONVERT_BASELINE_TILE * floats_per_baseline;
+    if output_buffer.len() < CONVERT_MIN_PARALLEL_FLOATS {
+        output_buffer
+            .chunks_mut(floats_per_tile)
+            .zip(conversion_table.chunks(LEGACY_CONVERT_BASELINE_TILE))
+            .for_each(convert_tile);
+    } else {
+        output_buffer
+            .par_chunks_mut(floats_per_tile)
+            .zip(conversion_table.par_chunks(LEGACY_CONVERT_BASELINE_TILE))
+            .for_each(convert_tile);
     }
 }
 
 /// Using the precalculated conversion table, reorder the legacy visibilities into our preferred output order
 /// [time][freq][baseline][pol] in a standard triangle of 0,0 .. 0,N 1,1..1,N baseline order.
+///
+/// Each fine channel is written to a disjoint part of the output, so for large HDUs the fine
+/// channels are converted in parallel on the rayon thread pool.
+///
 /// # Arguments
 ///
 /// * `conversion_table` - A vector containing all of the `
-///LegacyConversionBaseline`s we have pre-calculated.
+///LegacyConversionBaseline`s we have pre-calculated. This may also be a subset of them,
+/// in which case only those baselines are written to the output, in the order of the table.
 ///
-/// * `input_buffer` - Float vector read from legacy MWA HDUs.
+/// * `input_buffer` - Float vector read from legacy MWA HDUs (one row per fine channel).
 ///
 /// * `output_buffer` - Float vector to write converted data into.
 ///
@@ -398,70 +452,101 @@ pub(crate) fn convert_legacy_hdu_to_mwax_frequency_order(
     // Striding for input array
     let floats_per_baseline_fine_chan = 8; // xx_r,xx_i,xy_r,xy_i,yx_r,yx_i,yy_r,yy_i
     let floats_per_fine_chan = num_baselines * floats_per_baseline_fine_chan; // All floats for all baselines and 1 fine channel
-                                                                              // Read from the input buffer and write into the temp buffer
-    for fine_chan_index in 0..num_fine_chans {
-        // convert one fine channel at a time
-        for (baseline_index, baseline) in conversion_table.iter().enumerate() {
-            // Input visibilities are in [fine_chan][baseline][pol][real][imag] order
-            // We need to work out where to start indexing the source data
-            // Go "down" the fine channels as if they are rows
-            // Go "across" the baselines as if they are columns
-            let source_index = fine_chan_index * floats_per_fine_chan;
-            // Since the destination is also to be in [fine_chan][baseline][pol][real][imag] order
-            // For the destination, we have to stride along each baseline for this channel
-            let destination_index = source_index + (baseline_index * floats_per_baseline_fine_chan);
-
-            // xx_r
-            output_buffer[destination_index] = input_buffer[source_index + baseline.xx_index];
-            // xx_i
-            output_buffer[destination_index + 1] = if baseline.xx_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.xx_index + 1]
-            } else {
-                input_buffer[source_index + baseline.xx_index + 1]
-            };
-
-            // xy_r
-            output_buffer[destination_index + 2] = input_buffer[source_index + baseline.xy_index];
-            // xy_i
-            output_buffer[destination_index + 3] = if baseline.xy_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.xy_index + 1]
-            } else {
-                input_buffer[source_index + baseline.xy_index + 1]
-            };
-
-            // yx_r
-            output_buffer[destination_index + 4] = input_buffer[source_index + baseline.yx_index];
-            // yx_i
-            output_buffer[destination_index + 5] = if baseline.yx_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.yx_index + 1]
-            } else {
-                input_buffer[source_index + baseline.yx_index + 1]
-            };
-
-            // yy_r
-            output_buffer[destination_index + 6] = input_buffer[source_index + baseline.yy_index];
-            // yy_i
-            output_buffer[destination_index + 7] = if baseline.yy_conjugate {
-                // We have to conjugate the visibility
-                -input_buffer[source_index + baseline.yy_index + 1]
-            } else {
-                input_buffer[source_index + baseline.yy_index + 1]
-            };
-
-            // Finally take the conjugate so we are in the correct triangle
-            output_buffer[destination_index + 1] = -output_buffer[destination_index + 1];
-            output_buffer[destination_index + 3] = -output_buffer[destination_index + 3];
-            output_buffer[destination_index + 5] = -output_buffer[destination_index + 5];
-            output_buffer[destination_index + 7] = -output_buffer[destination_index + 7];
+
+    // Striding for output array. The conversion table may only contain a subset of the baselines
+    let output_floats_per_fine_chan = conversion_table.len() * floats_per_baseline_fine_chan;
+
+    if output_floats_per_fine_chan == 0 {
+        return;
+    }
+
+    // Only the first num_fine_chans rows of the input are converted
+    let input_len = (num_fine_chans * floats_per_fine_chan).min(input_buffer.len());
+
+    // Read from the input buffer and write into the output buffer one fine channel at a time
+    let convert_fine_chan = |(input_fine_chan, output_fine_chan): (&[f32], &mut [f32])| {
+        // Input visibilities are in [fine_chan][baseline][pol][real][imag] order.
+        // Since the destination is also to be in [fine_chan][baseline][pol][real][imag] order
+        // we just have to stride along each baseline for this channel.
+        for (baseline, output_baseline) in conversion_table
+            .iter()
+            .zip(output_fine_chan.chunks_exact_mut(floats_per_baseline_fine_chan))
+        {
+            convert_legacy_baseline(baseline, input_fine_chan, output_baseline);
         }
+    };
+
+    if output_buffer.len() < CONVERT_MIN_PARALLEL_FLOATS {
+        input_buffer[..input_len]
+            .chunks_exact(floats_per_fine_chan)
+            .zip(output_buffer.chunks_exact_mut(output_floats_per_fine_chan))
+            .for_each(convert_fine_chan);
+    } else {
+        input_buffer[..input_len]
+            .par_chunks_exact(floats_per_fine_chan)
+            .zip(output_buffer.par_chunks_exact_mut(output_floats_per_fine_chan))
+            .for_each(convert_fine_chan);
     }
 }
 
+/// Convert the 4 polarisations of one baseline, for one fine channel, of a legacy HDU.
+///
+/// Each complex visibility is copied from wherever the conversion table says it lives in the
+/// input and its imaginary part has the precomputed sign mask applied. There are no data
+/// dependent branches, and because negating an IEEE754 float only flips its sign bit the
+/// result is bit-for-bit identical to conditionally negating and then conjugating.
+///
+/// # Arguments
+///
+/// * `baseline` - the `LegacyConversionBaseline` for the output baseline.
+///
+/// * `input_fine_chan` - all of the input floats for one fine channel (all baselines).
+///
+/// * `output` - the 8 output floats (xx_r,xx_i,xy_r,xy_i,yx_r,yx_i,yy_r,yy_i) for this baseline and fine channel.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+///
+#[inline(always)]
+fn convert_legacy_baseline(
+    baseline: &LegacyConversionBaseline,
+    input_fine_chan: &[f32],
+    output: &mut [f32],
+) {
+    let source_indices = [
+        baseline.xx_index,
+        baseline.xy_index,
+        baseline.yx_index,
+        baseline.yy_index,
+    ];
+
+    for ((output_pol, source_index), imag_sign_mask) in output
+        .chunks_exact_mut(2)
+        .zip(source_indices.iter())
+        .zip(baseline.imag_sign_masks.iter())
+    {
+        let input_pol = &input_fine_chan[*source_index..*source_index + 2];
+        output_pol[0] = input_pol[0];
+        output_pol[1] = f32::from_bits(input_pol[1].to_bits() ^ imag_sign_mask);
+    }
+}
+
+/// Number of fine channels in each block of the MWAX baseline to frequency order transpose.
+const MWAX_TRANSPOSE_FINE_CHAN_BLOCK: usize = 16;
+
 /// Reorder correlator v2 (MWAX) visibilities into our preferred output order
 /// [time][freq][baseline][pol]. The antennas/baselines are already in our preferred order.
+///
+/// This is a transpose of [baseline][freq] to [freq][baseline] (where each element is all of the
+/// pols for one baseline and fine channel). The output is split into blocks of
+/// `MWAX_TRANSPOSE_FINE_CHAN_BLOCK` fine channels, each of which is written to a disjoint part of
+/// the output, so for large HDUs the blocks are converted in parallel on the rayon thread pool.
+/// Within a block each baseline's fine channels are read contiguously and written to
+/// `MWAX_TRANSPOSE_FINE_CHAN_BLOCK` output rows at once.
+///
 /// # Arguments
 ///
 /// * `input_buffer` - Float vector read from MWAX HDUs.
@@ -472,6 +557,8 @@ pub(crate) fn convert_legacy_hdu_to_mwax_frequency_order(
 ///
 /// * `num_fine_chans` - Number of file channels in this observation.
 ///
+/// * `num_visibility_pols` - Number of visibility polarisations (always 4 for MWA).
+///
 ///
 /// # Returns
 ///
@@ -485,31 +572,90 @@ pub(crate) fn convert_mwax_hdu_to_frequency_order(
     num_fine_chans: usize,
     num_visibility_pols: usize,
 ) {
-    // Striding for input array
     let floats_per_baseline_fine_chan = num_visibility_pols * 2; // xx_r,xx_i,xy_r,xy_i,yx_r,yx_i,yy_r,yy_i
+    let floats_per_fine_chan_block =
+        MWAX_TRANSPOSE_FINE_CHAN_BLOCK * num_baselines * floats_per_baseline_fine_chan;
+
+    if floats_per_fine_chan_block == 0 {
+        return;
+    }
+
+    let transpose_block = |(block_index, output_block): (usize, &mut [f32])| {
+        transpose_mwax_fine_chan_block(
+            input_buffer,
+            output_block,
+            block_index * MWAX_TRANSPOSE_FINE_CHAN_BLOCK,
+            num_baselines,
+            num_fine_chans,
+            floats_per_baseline_fine_chan,
+        )
+    };
+
+    if input_buffer.len() < CONVERT_MIN_PARALLEL_FLOATS {
+        output_buffer
+            .chunks_mut(floats_per_fine_chan_block)
+            .enumerate()
+            .for_each(transpose_block);
+    } else {
+        output_buffer
+            .par_chunks_mut(floats_per_fine_chan_block)
+            .enumerate()
+            .for_each(transpose_block);
+    }
+}
+
+/// Transpose one block of fine channels (for all baselines) of an MWAX HDU from
+/// [baseline][freq][pol] into [freq][baseline][pol] order.
+///
+/// # Arguments
+///
+/// * `input_buffer` - The whole HDU, in [baseline][freq][pol][r][i] order.
+///
+/// * `output_block` - The output for this block of fine channels, in [freq][baseline][pol][r][i] order.
+///                    The last block may contain fewer than `MWAX_TRANSPOSE_FINE_CHAN_BLOCK` fine channels.
+///
+/// * `first_fine_chan` - The index of the first fine channel in this block.
+///
+/// * `num_baselines` - Number of baselines in this observation.
+///
+/// * `num_fine_chans` - Number of file channels in this observation.
+///
+/// * `floats_per_baseline_fine_chan` - Number of floats for one baseline and fine channel (pols * 2).
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+///
+fn transpose_mwax_fine_chan_block(
+    input_buffer: &[f32],
+    output_block: &mut [f32],
+    first_fine_chan: usize,
+    num_baselines: usize,
+    num_fine_chans: usize,
+    floats_per_baseline_fine_chan: usize,
+) {
     let floats_per_baseline = num_fine_chans * floats_per_baseline_fine_chan; // All floats for 1 baseline and all fine channels
     let floats_per_fine_chan = num_baselines * floats_per_baseline_fine_chan; // All floats for all baselines and 1 fine channel
-                                                                              // Read from the input buffer and write into the temp buffer
+    let block_fine_chans = output_block.len() / floats_per_fine_chan;
+
     for baseline_index in 0..num_baselines {
-        // convert one baseline at a time
-        for fine_chan_index in 0..num_fine_chans {
-            // Input visibilities are in [baseline][fine_chan][pol][real][imag] order
-            //
-            // We need to work out where to start indexing the source data
-            // Go "down" the baselines as if they are rows
-            // Go "across" the fine_chans as if they are columns
-            let source_index = (baseline_index * floats_per_baseline)
-                + (fine_chan_index * floats_per_baseline_fine_chan);
+        // Input visibilities for this baseline and block of fine channels are contiguous
+        let source_start =
+            baseline_index * floats_per_baseline + first_fine_chan * floats_per_baseline_fine_chan;
+        let source = &input_buffer
+            [source_start..source_start + block_fine_chans * floats_per_baseline_fine_chan];
+
+        for (block_fine_chan_index, source_vis) in source
+            .chunks_exact(floats_per_baseline_fine_chan)
+            .enumerate()
+        {
             // The destination is to be in [fine_chan][baseline][pol][real][imag] order
-            // For the destination, we have to stride along each fine channel for this baseline
-            let destination_index = (fine_chan_index * floats_per_fine_chan)
-                + (baseline_index * floats_per_baseline_fine_chan);
-            // for each polarisation (r,i) => xx_r, xx_i, xy_r, xy_i, ... copy input to output
-            // Copy source into dest
-            output_buffer[destination_index..(floats_per_baseline_fine_chan + destination_index)]
-                .clone_from_slice(
-                    &input_buffer[source_index..(floats_per_baseline_fine_chan + source_index)],
-                );
+            let destination_index = block_fine_chan_index * floats_per_fine_chan
+                + baseline_index * floats_per_baseline_fine_chan;
+            output_block[destination_index..destination_index + floats_per_baseline_fine_chan]
+                .copy_from_slice(source_vis);
         }
     }
 }
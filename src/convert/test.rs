@@ -41,15 +41,12 @@ fn test_legacy_conversion_baseline_debug() {
         baseline: 1,
         ant1: 0,
         ant2: 1,
-        xx_conjugate: false,
         xx_index: 2,
-        xy_conjugate: false,
         xy_index: 3,
-        yx_conjugate: false,
         yx_index: 4,
-        yy_conjugate: false,
         yy_index: 5,
         is_cross: true,
+        imag_sign_masks: [F32_SIGN_MASK; 4],
     };
 
     assert_eq!(format!("{:?}", lcb), "1 0v1 2 3 4 5");
@@ -668,3 +665,314 @@ fn test_mwax_conversion_to_frequency_order() {
         }
     }
 }
+
+#[test]
+fn test_legacy_conversion_baseline_sign_masks() {
+    // Negative source indices mean the input visibility needs to be conjugated
+    let lcb = LegacyConversionBaseline::new(1, 0, 1, 2, -4, 6, -8);
+
+    assert_eq!(lcb.xx_index, 2);
+    assert_eq!(lcb.xy_index, 4);
+    assert_eq!(lcb.yx_index, 6);
+    assert_eq!(lcb.yy_index, 8);
+    // Every output is conjugated once more, so inputs which were conjugated are left alone
+    assert_eq!(lcb.imag_sign_masks, [F32_SIGN_MASK, 0, F32_SIGN_MASK, 0]);
+}
+
+/// Build the signed source indices (xx, xy, yx, yy) of a synthetic legacy conversion table, as
+/// passed to `LegacyConversionBaseline::new`, where a negative index means conjugate.
+#[cfg(test)]
+fn get_synthetic_legacy_source_indices() -> Vec<[i32; 4]> {
+    let num_baselines = get_baseline_count(128);
+    let num_complex_per_fine_chan = num_baselines * 4;
+
+    // Pseudo-random but deterministic source positions and conjugations
+    let mut state: u64 = 0x2545_f491_4f6c_dd1d;
+    let mut next = || {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        state
+    };
+
+    (0..num_baselines)
+        .map(|_| {
+            let mut index = || {
+                let r = next();
+                let i = ((r % num_complex_per_fine_chan as u64) * 2) as i32;
+                if r & (1 << 40) != 0 {
+                    -i
+                } else {
+                    i
+                }
+            };
+            [index(), index(), index(), index()]
+        })
+        .collect()
+}
+
+/// Build a synthetic legacy conversion table and HDU (including signed zeros, NaNs and
+/// infinities) for checking converted output bit-for-bit.
+#[cfg(test)]
+fn get_synthetic_legacy_conversion_data(
+    num_fine_chans: usize,
+) -> (Vec<LegacyConversionBaseline>, Vec<f32>) {
+    let num_baselines = get_baseline_count(128);
+
+    let table: Vec<LegacyConversionBaseline> = get_synthetic_legacy_source_indices()
+        .iter()
+        .enumerate()
+        .map(|(bl, [xx, xy, yx, yy])| LegacyConversionBaseline::new(bl, 0, 0, *xx, *xy, *yx, *yy))
+        .collect();
+
+    let specials = [0., -0., f32::NAN, f32::INFINITY, f32::NEG_INFINITY];
+    let input: Vec<f32> = (0..num_fine_chans * num_baselines * 8)
+        .map(|i| {
+            if i % 101 == 0 {
+                specials[(i / 101) % specials.len()]
+            } else {
+                (i as f32) * 0.25 - 1000.
+            }
+        })
+        .collect();
+
+    (table, input)
+}
+
+/// A copy of the original (branching, two pass) legacy conversion, kept as the reference the
+/// branch-free conversion must reproduce exactly. It works from the signed source indices given
+/// to `LegacyConversionBaseline::new` (negative means conjugate), not from the sign masks.
+///
+/// `by_baseline` selects [baseline][freq][pol] output order, otherwise [freq][baseline][pol].
+#[cfg(test)]
+fn reference_convert_legacy_hdu(
+    source_indices: &[[i32; 4]],
+    input_buffer: &[f32],
+    output_buffer: &mut [f32],
+    num_fine_chans: usize,
+    by_baseline: bool,
+) {
+    let num_baselines = get_baseline_count(128);
+    let floats_per_baseline_fine_chan = 8;
+    let floats_per_fine_chan = num_baselines * floats_per_baseline_fine_chan;
+    let floats_per_baseline = floats_per_baseline_fine_chan * num_fine_chans;
+
+    for fine_chan_index in 0..num_fine_chans {
+        for (baseline_index, baseline) in source_indices.iter().enumerate() {
+            let source_index = fine_chan_index * floats_per_fine_chan;
+            let destination_index = if by_baseline {
+                (baseline_index * floats_per_baseline)
+                    + (fine_chan_index * floats_per_baseline_fine_chan)
+            } else {
+                source_index + (baseline_index * floats_per_baseline_fine_chan)
+            };
+
+            for (pol, signed_index) in baseline.iter().enumerate() {
+                let index = signed_index.abs() as usize;
+                let conjugate = *signed_index < 0;
+                let destination = destination_index + pol * 2;
+
+                output_buffer[destination] = input_buffer[source_index + index];
+                output_buffer[destination + 1] = if conjugate {
+                    // We have to conjugate the visibility
+                    -input_buffer[source_index + index + 1]
+                } else {
+                    input_buffer[source_index + index + 1]
+                };
+            }
+
+            // Finally take the conjugate so we are in the correct triangle
+            output_buffer[destination_index + 1] = -output_buffer[destination_index + 1];
+            output_buffer[destination_index + 3] = -output_buffer[destination_index + 3];
+            output_buffer[destination_index + 5] = -output_buffer[destination_index + 5];
+            output_buffer[destination_index + 7] = -output_buffer[destination_index + 7];
+        }
+    }
+}
+
+#[test]
+fn test_convert_legacy_hdu_bit_identical() {
+    let num_fine_chans = 4;
+    let (table, input) = get_synthetic_legacy_conversion_data(num_fine_chans);
+
+    // Build the expected output in both orders using the original conversion, from the signed
+    // indices the table was built from (so the sign masks under test are not used)
+    let source_indices = get_synthetic_legacy_source_indices();
+    let mut expected_by_bl = vec![0.; input.len()];
+    reference_convert_legacy_hdu(
+        &source_indices,
+        &input,
+        &mut expected_by_bl,
+        num_fine_chans,
+        true,
+    );
+    let mut expected_by_freq = vec![0.; input.len()];
+    reference_convert_legacy_hdu(
+        &source_indices,
+        &input,
+        &mut expected_by_freq,
+        num_fine_chans,
+        false,
+    );
+
+    let mut output_by_bl = vec![0.; input.len()];
+    convert_legacy_hdu_to_mwax_baseline_order(&table, &input, &mut output_by_bl, num_fine_chans);
+
+    let mut output_by_freq = vec![0.; input.len()];
+    convert_legacy_hdu_to_mwax_frequency_order(&table, &input, &mut output_by_freq, num_fine_chans);
+
+    let to_bits = |v: &[f32]| v.iter().map(|f| f.to_bits()).collect::<Vec<u32>>();
+    assert_eq!(to_bits(&output_by_bl), to_bits(&expected_by_bl));
+    assert_eq!(to_bits(&output_by_freq), to_bits(&expected_by_freq));
+}
+
+#[test]
+fn test_mwax_conversion_to_frequency_order_synthetic() {
+    // Sizes which are not multiples of the transpose block size, so partial blocks are exercised.
+    // The last is large enough to be transposed in parallel.
+    for &(num_baselines, num_fine_chans) in &[(130, 35), (1, 1), (64, 16), (3, 17), (8256, 17)] {
+        let num_visibility_pols = 4;
+        let floats_per_baseline_fine_chan = num_visibility_pols * 2;
+        let num_floats = num_baselines * num_fine_chans * floats_per_baseline_fine_chan;
+
+        // Input is in [baseline][freq][pol][r][i] order
+        let input: Vec<f32> = (0..num_floats).map(|i| i as f32).collect();
+        let mut output = vec![-1.0f32; num_floats];
+
+        convert_mwax_hdu_to_frequency_order(
+            &input,
+            &mut output,
+            num_baselines,
+            num_fine_chans,
+            num_visibility_pols,
+        );
+
+        for b in 0..num_baselines {
+            for f in 0..num_fine_chans {
+                let input_index = (b * num_fine_chans + f) * floats_per_baseline_fine_chan;
+                let output_index = (f * num_baselines + b) * floats_per_baseline_fine_chan;
+
+                assert_eq!(
+                    input[input_index..input_index + floats_per_baseline_fine_chan],
+                    output[output_index..output_index + floats_per_baseline_fine_chan]
+                );
+            }
+        }
+    }
+}
+
+#[test]
+fn test_get_conversion_array_is_shared() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let context = MetafitsContext::new(&metafits_filename, MWAVersion::CorrLegacy).unwrap();
+
+    let table1 = get_conversion_array(&context.rf_inputs);
+    let table2 = get_conversion_array(&context.rf_inputs);
+
+    // The table is only generated once, and is the same as an unshared one
+    assert!(std::sync::Arc::ptr_eq(&table1, &table2));
+    let unshared = generate_conversion_array(&mut context.rf_inputs.clone());
+    assert_eq!(format!("{:?}", table1), format!("{:?}", unshared));
+
+    // The table only depends on the rf_inputs, not the order they are supplied in
+    let mut reversed = context.rf_inputs.clone();
+    reversed.reverse();
+    assert!(std::sync::Arc::ptr_eq(
+        &table1,
+        &get_conversion_array(&reversed)
+    ));
+}
+
+#[test]
+fn test_convert_legacy_hdu_subset_on_thread_pool() {
+    let num_fine_chans = 4;
+    let floats_per_fine_chan = get_baseline_count(128) * 8;
+    let (table, input) = get_synthetic_legacy_conversion_data(num_fine_chans);
+
+    let mut full_by_bl = vec![0.; input.len()];
+    convert_legacy_hdu_to_mwax_baseline_order(&table, &input, &mut full_by_bl, num_fine_chans);
+    let mut full_by_freq = vec![0.; input.len()];
+    convert_legacy_hdu_to_mwax_frequency_order(&table, &input, &mut full_by_freq, num_fine_chans);
+
+    // A subset which is not a multiple of the tile size, converted across several threads
+    let num_subset_baselines = 70;
+    let subset = &table[..num_subset_baselines];
+    let thread_pool = rayon::ThreadPoolBuilder::new()
+        .num_threads(4)
+        .build()
+        .unwrap();
+
+    let mut subset_by_bl = vec![0.; num_subset_baselines * num_fine_chans * 8];
+    let mut subset_by_freq = vec![0.; num_subset_baselines * num_fine_chans * 8];
+    thread_pool.install(|| {
+        convert_legacy_hdu_to_mwax_baseline_order(
+            subset,
+            &input,
+            &mut subset_by_bl,
+            num_fine_chans,
+        );
+        convert_legacy_hdu_to_mwax_frequency_order(
+            subset,
+            &input,
+            &mut subset_by_freq,
+            num_fine_chans,
+        );
+    });
+
+    // The synthetic input includes NaNs, so compare bits
+    let to_bits = |v: &[f32]| v.iter().map(|f| f.to_bits()).collect::<Vec<u32>>();
+    assert_eq!(
+        to_bits(&subset_by_bl),
+        to_bits(&full_by_bl[..subset_by_bl.len()])
+    );
+    for (fine_chan, subset_fine_chan) in subset_by_freq
+        .chunks_exact(num_subset_baselines * 8)
+        .enumerate()
+    {
+        let full_start = fine_chan * floats_per_fine_chan;
+        assert_eq!(
+            to_bits(subset_fine_chan),
+            to_bits(&full_by_freq[full_start..full_start + num_subset_baselines * 8])
+        );
+    }
+}
+
+#[test]
+fn test_convert_legacy_hdu_serial_and_parallel_match() {
+    // 32 fine channels is large enough to be converted in parallel, while each fine channel on
+    // its own is converted on the calling thread
+    let num_fine_chans = 32;
+    let floats_per_fine_chan = get_baseline_count(128) * 8;
+    let (table, input) = get_synthetic_legacy_conversion_data(num_fine_chans);
+    assert!(input.len() >= CONVERT_MIN_PARALLEL_FLOATS);
+    assert!(floats_per_fine_chan < CONVERT_MIN_PARALLEL_FLOATS);
+
+    let mut output_by_bl = vec![0.; input.len()];
+    convert_legacy_hdu_to_mwax_baseline_order(&table, &input, &mut output_by_bl, num_fine_chans);
+    let mut output_by_freq = vec![0.; input.len()];
+    convert_legacy_hdu_to_mwax_frequency_order(&table, &input, &mut output_by_freq, num_fine_chans);
+
+    // The synthetic input includes NaNs, so compare bits
+    let to_bits = |v: &[f32]| v.iter().map(|f| f.to_bits()).collect::<Vec<u32>>();
+    for (fine_chan, input_fine_chan) in input.chunks_exact(floats_per_fine_chan).enumerate() {
+        let mut fine_chan_by_bl = vec![0.; floats_per_fine_chan];
+        convert_legacy_hdu_to_mwax_baseline_order(&table, input_fine_chan, &mut fine_chan_by_bl, 1);
+        let mut fine_chan_by_freq = vec![0.; floats_per_fine_chan];
+        convert_legacy_hdu_to_mwax_frequency_order(
+            &table,
+            input_fine_chan,
+            &mut fine_chan_by_freq,
+            1,
+        );
+
+        let expected_by_bl: Vec<f32> = output_by_bl
+            .chunks_exact(num_fine_chans * 8)
+            .flat_map(|baseline| baseline[fine_chan * 8..(fine_chan + 1) * 8].to_vec())
+            .collect();
+        assert_eq!(to_bits(&fine_chan_by_bl), to_bits(&expected_by_bl));
+        assert_eq!(
+            to_bits(&fine_chan_by_freq),
+            to_bits(&output_by_freq[fine_chan * floats_per_fine_chan..][..floats_per_fine_chan])
+        );
+    }
+}
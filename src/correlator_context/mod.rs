@@ -7,13 +7,27 @@ The main interface to MWA data.
  */
 use std::collections::BTreeMap;
 use std::fmt;
+use std::ops::Range;
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+use std::time::Instant;
+
+use fitsio::{hdu::FitsHdu, FitsFile};
+use rayon::prelude::*;
+use rayon::ThreadPool;
 
 use crate::coarse_channel::*;
 use crate::convert::*;
 use crate::error::*;
+use crate::fits_handle_cache::*;
 use crate::gpubox_files::*;
+use crate::gpubox_index_cache::*;
 use crate::metafits_context::*;
+use crate::prefetch::*;
+use crate::read_stats::*;
+use crate::thread_pool;
 use crate::timestep::*;
+use crate::visibility_cache::*;
 use crate::*;
 
 #[cfg(test)]
@@ -25,7 +39,7 @@ mod test;
 #[derive(Debug)]
 pub struct CorrelatorContext {
     /// Observation Metadata obtained from the metafits file
-    pub metafits_context: MetafitsContext,
+    pub metafits_context: Arc<MetafitsContext>,
     /// MWA version, derived from the files passed in
     pub mwa_version: MWAVersion,
     /// This is an array of all known timesteps (union of metafits and provided timesteps from data files)
@@ -37,7 +51,9 @@ pub struct CorrelatorContext {
     /// Number of coarse channels in the coarse channel vector
     pub num_coarse_chans: usize,
 
-    /// Vector of (in)common timestep indices
+    /// Vector of (in)common timestep indices. With lazy validation (see
+    /// `CorrelatorContextBuilder::with_lazy_validation`) this assumes every gpubox file of a batch
+    /// has the HDU times of the first one, until `validate_gpubox_files` succeeds.
     pub common_timestep_indices: Vec<usize>,
     /// Number of common timesteps
     pub num_common_timesteps: usize,
@@ -60,7 +76,9 @@ pub struct CorrelatorContext {
     /// Total bandwidth of the common coarse channels
     pub common_bandwidth_hz: u32,
 
-    /// Vector of (in)common timestep indices only including timesteps after the quack time
+    /// Vector of (in)common timestep indices only including timesteps after the quack time. As
+    /// with `common_timestep_indices`, with lazy validation this is only as correct as the
+    /// assumption that every gpubox file of a batch has the same HDU times.
     pub common_good_timestep_indices: Vec<usize>,
     /// Number of common timesteps only including timesteps after the quack time
     pub num_common_good_timesteps: usize,
@@ -96,6 +114,9 @@ pub struct CorrelatorContext {
     pub num_timestep_coarse_chan_bytes: usize,
     /// The number of floats in each gpubox HDU.
     pub num_timestep_coarse_chan_floats: usize,
+    /// The number of floats in each gpubox weights HDU (baseline,pol). This is 0 for
+    /// legacy correlator observations, which have no weights HDUs.
+    pub num_timestep_coarse_chan_weight_floats: usize,
     /// This is the number of gpubox files *per batch*.
     pub num_gpubox_files: usize,
     /// `gpubox_batches` *must* be sorted appropriately. See
@@ -110,9 +131,181 @@ pub struct CorrelatorContext {
     /// gpubox number with a gpubox batch number and HDU index. The gpubox
     /// number, batch number and HDU index are everything needed to find the
     /// correct HDU out of all gpubox files.
+    ///
+    /// With lazy validation (see `CorrelatorContextBuilder::with_lazy_validation`), only the
+    /// first gpubox file of each batch was read, and its entries are copied for the other gpubox
+    /// files of the batch. A read of a file which does not match returns
+    /// `GpuboxError::LazyValidationMismatch`; this map is not updated.
     pub gpubox_time_map: BTreeMap<u64, BTreeMap<usize, (usize, usize)>>,
+    /// Where the data for each timestep and coarse channel is, resolved from `gpubox_time_map`,
+    /// the weights HDUs of MWAX v2 files and `gpubox_batches` when the context is created. Structured:
+    /// `gpubox_hdu_locations[timestep_index * num_coarse_chans + coarse_chan_index]`, with None
+    /// where we have no data.
+    pub(crate) gpubox_hdu_locations: Vec<Option<GpuboxHduLocation>>,
     /// A conversion table to optimise reading of legacy MWA HDUs
-    pub(crate) legacy_conversion_table: Vec<LegacyConversionBaseline>,
+    pub(crate) legacy_conversion_table: Arc<Vec<LegacyConversionBaseline>>,
+    /// Indices (within `metafits_context.baselines`) of the autocorrelations, in antenna order
+    pub(crate) auto_baseline_indices: Vec<usize>,
+    /// The entries of `legacy_conversion_table` for the autocorrelations only, in antenna order
+    pub(crate) legacy_auto_conversion_table: Vec<LegacyConversionBaseline>,
+    /// Optional cache of open gpubox file handles, see `enable_fits_handle_cache`.
+    pub(crate) gpubox_fits_handle_cache: Option<FitsHandleCache>,
+    /// Reusable HDU sized buffers, so that reads which need to reorder data do not allocate.
+    pub(crate) scratch_buffers: ScratchBufferPool<f32>,
+    /// Counters and timings of the reads of this context, see `get_stats`.
+    pub(crate) read_counters: Arc<ReadCounters>,
+    /// The thread pool for this context's parallel work, see `set_thread_pool`.
+    pub(crate) thread_pool: Option<Arc<ThreadPool>>,
+    /// With lazy validation, the gpubox files still to be validated when first read.
+    pub(crate) deferred_gpubox_validation: Option<DeferredGpuboxValidation>,
+    /// Where the gpubox files are read from, if not the filesystem (see `CorrelatorContextBuilder::with_data_sources`).
+    pub(crate) data_sources: DataSources,
+    /// Optional cache file of reordered visibilities which reads are served from, see `enable_visibility_cache`.
+    pub(crate) visibility_cache: Option<VisibilityCache>,
+}
+
+/// Options for creating a `CorrelatorContext`, for when `CorrelatorContext::new` and its
+/// variants are not enough. Create one with `new`, set options with the `with_` methods and then
+/// create contexts with `build` or `build_from_metafits_context`.
+#[derive(Clone, Debug, Default)]
+pub struct CorrelatorContextBuilder {
+    /// Filename of the on-disk gpubox index, see `with_gpubox_index_cache`.
+    index_cache_filename: Option<PathBuf>,
+    /// See `with_lazy_validation`.
+    lazy_validation: bool,
+    /// See `with_data_sources`.
+    data_sources: DataSources,
+}
+
+impl CorrelatorContextBuilder {
+    /// Creates a builder with the default options, i.e. those of `CorrelatorContext::new`.
+    ///
+    /// # Arguments
+    ///
+    /// None
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A CorrelatorContextBuilder
+    ///
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Use an on-disk index of the gpubox files, as per `CorrelatorContext::new_with_gpubox_index_cache`.
+    ///
+    /// # Arguments
+    ///
+    /// * `index_cache_filename` - filename of the index file to read (if it exists) and write.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The updated CorrelatorContextBuilder
+    ///
+    pub fn with_gpubox_index_cache<P: AsRef<Path>>(mut self, index_cache_filename: &P) -> Self {
+        self.index_cache_filename = Some(index_cache_filename.as_ref().to_path_buf());
+        self
+    }
+
+    /// Enable or disable lazy validation. Normally every gpubox file is opened, validated and has
+    /// the times of all of its HDUs read when the context is created. With lazy validation, only
+    /// one gpubox file of each batch is, and the other gpubox files of the batch are assumed to
+    /// have the same HDU times and HDU size (which is how the correlators write them). Each of
+    /// those files is validated the first time it is read, and a read of a file which turns out not
+    /// to match returns `GpuboxError::LazyValidationMismatch`.
+    ///
+    /// This makes creating a context for only a few channels of a large observation much faster,
+    /// but the timesteps and "common" attributes of the context are only as correct as this
+    /// assumption. In particular `timesteps`, `gpubox_time_map`, `common_timestep_indices`,
+    /// `common_good_timestep_indices` (and the durations and bandwidths derived from them) and
+    /// `provided_timestep_indices` are computed as if every gpubox file of a batch has the HDU
+    /// times of the file which was scanned. They are not recomputed if a file turns out not to
+    /// match: `GpuboxError::LazyValidationMismatch` means they may be wrong, and the context should
+    /// be recreated without lazy validation. Use `CorrelatorContext::validate_gpubox_files` to
+    /// check every file up front if these attributes need to be relied on.
+    ///
+    /// # Arguments
+    ///
+    /// * `lazy_validation` - true to enable lazy validation, false to validate every gpubox file up front (the default).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The updated CorrelatorContextBuilder
+    ///
+    pub fn with_lazy_validation(mut self, lazy_validation: bool) -> Self {
+        self.lazy_validation = lazy_validation;
+        self
+    }
+
+    /// Read gpubox files from data sources rather than the filesystem, e.g. from memory or from
+    /// within a tar archive (see `TarArchive::data_sources`). Any gpubox file given to `build`
+    /// which has a source is read from it. Gpubox files from sources are not added to the gpubox
+    /// index cache.
+    ///
+    /// # Arguments
+    ///
+    /// * `data_sources` - the sources of the gpubox files, by filename.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The updated CorrelatorContextBuilder
+    ///
+    pub fn with_data_sources(mut self, data_sources: DataSources) -> Self {
+        self.data_sources = data_sources;
+        self
+    }
+
+    /// From a path to a metafits file and paths to gpubox files, create a `CorrelatorContext`
+    /// with these options.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_filename` - filename of metafits file as a path or string.
+    ///
+    /// * `gpubox_filenames` - slice of filenames of gpubox files as paths or strings.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated CorrelatorContext object if Ok.
+    ///
+    pub fn build<T: AsRef<Path>>(
+        &self,
+        metafits_filename: &T,
+        gpubox_filenames: &[T],
+    ) -> Result<CorrelatorContext, MwalibError> {
+        CorrelatorContext::new_internal(
+            Arc::new(MetafitsContext::new_internal(metafits_filename)?),
+            gpubox_filenames,
+            self,
+        )
+    }
+
+    /// As per `build`, but using an existing (possibly shared) `MetafitsContext`, as per
+    /// `CorrelatorContext::new_from_metafits_context`.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the MetafitsContext of the observation.
+    ///
+    /// * `gpubox_filenames` - slice of filenames of gpubox files as paths or strings.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated CorrelatorContext object if Ok.
+    ///
+    pub fn build_from_metafits_context<T: AsRef<Path>>(
+        &self,
+        metafits_context: Arc<MetafitsContext>,
+        gpubox_filenames: &[T],
+    ) -> Result<CorrelatorContext, MwalibError> {
+        CorrelatorContext::new_internal(metafits_context, gpubox_filenames, self)
+    }
 }
 
 impl CorrelatorContext {
@@ -136,22 +329,125 @@ impl CorrelatorContext {
         metafits_filename: &T,
         gpubox_filenames: &[T],
     ) -> Result<Self, MwalibError> {
-        let mut metafits_context = MetafitsContext::new_internal(metafits_filename)?;
+        CorrelatorContextBuilder::new().build(metafits_filename, gpubox_filenames)
+    }
+
+    /// As per `new`, but using an existing (possibly shared) `MetafitsContext` rather than
+    /// parsing the metafits file again, e.g. one from `MetafitsContext::new_shared` or from
+    /// another context of the same observation. If it was populated for a different MWAVersion
+    /// than the gpubox files are, a copy with the correct coarse channels and timesteps is made.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the MetafitsContext of the observation.
+    ///
+    /// * `gpubox_filenames` - slice of filenames of gpubox files as paths or strings.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated CorrelatorContext object if Ok.
+    ///
+    ///
+    pub fn new_from_metafits_context<T: AsRef<std::path::Path>>(
+        metafits_context: Arc<MetafitsContext>,
+        gpubox_filenames: &[T],
+    ) -> Result<Self, MwalibError> {
+        CorrelatorContextBuilder::new()
+            .build_from_metafits_context(metafits_context, gpubox_filenames)
+    }
+
+    /// As per `new`, but using an on-disk index of the gpubox files to avoid opening and scanning
+    /// every HDU of every gpubox file when the same observation is opened again.
+    ///
+    /// Gpubox files with an entry in the index which matches their current size and modification
+    /// time are not opened at all. Any other gpubox files are scanned as normal and the index is
+    /// then rewritten to include them. The index is only an optimisation, so a missing or corrupt
+    /// index is ignored, and failing to write the index does not cause this method to fail.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_filename` - filename of metafits file as a path or string.
+    ///
+    /// * `gpubox_filenames` - slice of filenames of gpubox files as paths or strings.
+    ///
+    /// * `index_cache_filename` - filename of the index file to read (if it exists) and write.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated CorrelatorContext object if Ok.
+    ///
+    ///
+    pub fn new_with_gpubox_index_cache<T: AsRef<std::path::Path>, P: AsRef<std::path::Path>>(
+        metafits_filename: &T,
+        gpubox_filenames: &[T],
+        index_cache_filename: &P,
+    ) -> Result<Self, MwalibError> {
+        CorrelatorContextBuilder::new()
+            .with_gpubox_index_cache(index_cache_filename)
+            .build(metafits_filename, gpubox_filenames)
+    }
 
+    /// Create a `CorrelatorContext` with the options of a `CorrelatorContextBuilder`.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the (populated or unpopulated) MetafitsContext of the observation.
+    ///
+    /// * `gpubox_filenames` - slice of filenames of gpubox files as paths or strings.
+    ///
+    /// * `options` - the options to create the context with.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated CorrelatorContext object if Ok.
+    ///
+    ///
+    fn new_internal<T: AsRef<std::path::Path>>(
+        metafits_context: Arc<MetafitsContext>,
+        gpubox_filenames: &[T],
+        options: &CorrelatorContextBuilder,
+    ) -> Result<Self, MwalibError> {
         if gpubox_filenames.is_empty() {
             return Err(MwalibError::Gpubox(
                 gpubox_files::error::GpuboxError::NoGpuboxes,
             ));
         }
+        let read_counters = Arc::new(ReadCounters::new());
+
         // Do gpubox stuff only if we have gpubox files.
-        let gpubox_info = examine_gpubox_files(&gpubox_filenames, metafits_context.obs_id)?;
+        let time_map_start = Instant::now();
+        let gpubox_info = match &options.index_cache_filename {
+            Some(index_cache_filename) => {
+                let mut index_cache = GpuboxIndexCache::load(index_cache_filename);
+                let gpubox_info = examine_gpubox_files_with_index_cache(
+                    &gpubox_filenames,
+                    metafits_context.obs_id,
+                    Some(&mut index_cache),
+                    options.lazy_validation,
+                    &options.data_sources,
+                )?;
+                // The index is only an optimisation, so not being able to write it is not an error
+                if index_cache.is_modified() {
+                    let _ = index_cache.save(index_cache_filename);
+                }
+                gpubox_info
+            }
+            None => examine_gpubox_files(
+                &gpubox_filenames,
+                metafits_context.obs_id,
+                options.lazy_validation,
+                &options.data_sources,
+            )?,
+        };
+        read_counters.add_time_map_time(time_map_start.elapsed());
 
         // Populate metafits coarse channels and timesteps now that we know what MWA Version we are dealing with
-        // Populate the coarse channels
-        metafits_context.populate_expected_coarse_channels(gpubox_info.mwa_version)?;
-
-        // Populate the timesteps
-        metafits_context.populate_expected_timesteps(gpubox_info.mwa_version)?;
+        // (if the metafits context was not already populated for it)
+        let metafits_context =
+            MetafitsContext::populated_for_version(metafits_context, gpubox_info.mwa_version)?;
 
         // We can unwrap here because the `gpubox_time_map` can't be empty if
         // `gpuboxes` isn't empty.
@@ -185,7 +481,9 @@ impl CorrelatorContext {
 
         // We have enough information to validate HDU matches metafits for the first batch/first coarse channel we have data for
         if !gpubox_filenames.is_empty() {
-            let mut fptr = fits_open!(&gpubox_info.batches[0].gpubox_files[0].filename)?;
+            let mut fptr = options
+                .data_sources
+                .open_fits(&gpubox_info.batches[0].gpubox_files[0].filename)?;
 
             CorrelatorContext::validate_first_hdu(
                 gpubox_info.mwa_version,
@@ -308,11 +606,48 @@ impl CorrelatorContext {
 
         // Prepare the conversion array to convert legacy correlator format into mwax format
         // or just leave it empty if we're in any other format
-        let legacy_conversion_table: Vec<LegacyConversionBaseline> = match gpubox_info.mwa_version {
-            MWAVersion::CorrOldLegacy | MWAVersion::CorrLegacy => {
-                convert::generate_conversion_array(&mut metafits_context.rf_inputs.clone())
+        // (the table is shared with any other observation with the same rf_input ordering)
+        let legacy_conversion_table: Arc<Vec<LegacyConversionBaseline>> =
+            match gpubox_info.mwa_version {
+                MWAVersion::CorrOldLegacy | MWAVersion::CorrLegacy => {
+                    convert::get_conversion_array(&metafits_context.rf_inputs)
+                }
+                _ => Arc::new(Vec::new()),
+            };
+
+        // Find the autocorrelations once, so reading only them does not need to search the baselines
+        let auto_baseline_indices: Vec<usize> = metafits_context
+            .baselines
+            .iter()
+            .enumerate()
+            .filter(|(_, b)| b.ant1_index == b.ant2_index)
+            .map(|(i, _)| i)
+            .collect();
+        let legacy_auto_conversion_table: Vec<LegacyConversionBaseline> =
+            if legacy_conversion_table.is_empty() {
+                Vec::new()
+            } else {
+                auto_baseline_indices
+                    .iter()
+                    .map(|&b| legacy_conversion_table[b].clone())
+                    .collect()
+            };
+
+        // Resolve where every timestep/coarse channel is up front, so reads don't need to search
+        let gpubox_hdu_locations = build_gpubox_hdu_location_table(
+            &gpubox_info.time_map,
+            &gpubox_info.weights_hdu_map,
+            &gpubox_info.batches,
+            &timesteps,
+            &corr_coarse_chans,
+        );
+
+        // Only MWAX v2 has weights HDUs, which contain one float per baseline and pol
+        let num_timestep_coarse_chan_weight_floats = match gpubox_info.mwa_version {
+            MWAVersion::CorrMWAXv2 => {
+                metafits_context.num_baselines * metafits_context.num_visibility_pols
             }
-            _ => Vec::new(),
+            _ => 0,
         };
 
         Ok(CorrelatorContext {
@@ -348,285 +683,1874 @@ impl CorrelatorContext {
             num_provided_coarse_chans: num_provided_coarse_chan_indices,
             gpubox_batches: gpubox_info.batches,
             gpubox_time_map: gpubox_info.time_map,
+            gpubox_hdu_locations,
             num_timestep_coarse_chan_bytes: gpubox_info.hdu_size * 4,
             num_timestep_coarse_chan_floats: gpubox_info.hdu_size,
+            num_timestep_coarse_chan_weight_floats,
             num_gpubox_files: gpubox_filenames.len(),
             legacy_conversion_table,
+            auto_baseline_indices,
+            legacy_auto_conversion_table,
+            gpubox_fits_handle_cache: None,
+            scratch_buffers: ScratchBufferPool::new(),
+            read_counters,
+            thread_pool: None,
+            deferred_gpubox_validation: gpubox_info.deferred_validation,
+            data_sources: options.data_sources.clone(),
+            visibility_cache: None,
         })
     }
 
-    /// Read a single timestep for a single coarse channel
-    /// The output visibilities are in order:
-    /// baseline,frequency,pol,r,i
+    /// Keep gpubox files open between reads, rather than opening and closing the gpubox file
+    /// on every call to one of the `read_*` methods. Up to `max_open_files` files are kept open;
+    /// when more are needed the least recently used file is closed. The cache is safe to use
+    /// from multiple threads. Calling this again replaces (and closes) any existing cache.
     ///
     /// # Arguments
     ///
-    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep. This corresponds
-    ///                      to the element within mwalibContext.timesteps.
-    ///
-    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel. This corresponds
-    ///                      to the element within mwalibContext.coarse_chans.
+    /// * `max_open_files` - maximum number of gpubox files to keep open at once (e.g. the number of coarse channels).
+    ///                      See `DEFAULT_MAX_OPEN_FITS_FILES` for a sensible default.
     ///
     ///
     /// # Returns
     ///
-    /// * A Result containing vector of 32 bit floats containing the data in [baseline][frequency][pol][r][i] order, if Ok.
-    ///
+    /// * Nothing
     ///
-    pub fn read_by_baseline(
-        &self,
-        corr_timestep_index: usize,
-        corr_coarse_chan_index: usize,
-    ) -> Result<Vec<f32>, GpuboxError> {
-        let mut return_buffer: Vec<f32> = vec![0.; self.num_timestep_coarse_chan_floats];
-
-        self.read_by_baseline_into_buffer(
-            corr_timestep_index,
-            corr_coarse_chan_index,
-            &mut return_buffer,
-        )?;
+    pub fn enable_fits_handle_cache(&mut self, max_open_files: usize) {
+        self.gpubox_fits_handle_cache = Some(
+            FitsHandleCache::new(max_open_files)
+                .with_read_counters(Arc::clone(&self.read_counters))
+                .with_data_sources(self.data_sources.clone()),
+        );
+    }
 
-        Ok(return_buffer)
+    /// Stop caching gpubox file handles and close any cached files. This is the default.
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn disable_fits_handle_cache(&mut self) {
+        self.gpubox_fits_handle_cache = None;
     }
 
-    /// Read a single timestep for a single coarse channel
-    /// The output visibilities are in order:
-    /// frequency,baseline,pol,r,i
+    /// Write every timestep and coarse channel which has data, already converted to `order`, to a
+    /// visibility cache file, replacing any existing file. Pass the file to
+    /// `enable_visibility_cache` (on this or any later context for the same observation) to serve
+    /// reads from it. The file is as large as all of the visibilities of the observation.
     ///
     /// # Arguments
     ///
-    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep. This corresponds
-    ///                      to the element within mwalibContext.timesteps.
+    /// * `filename` - filename of the cache file, e.g. next to the gpubox files.
     ///
-    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel. This corresponds
-    ///                      to the element within mwalibContext.coarse_chans.
+    /// * `order` - order to store the visibilities in. `ByBaseline` caches serve both `read_by_baseline*`
+    ///             and `read_by_frequency*` reads (the latter still need a transpose), `ByFrequency`
+    ///             caches only serve `read_by_frequency*` reads without any conversion.
     ///
     ///
     /// # Returns
     ///
-    /// * A Result containing vector of 32 bit floats containing the data in frequency,baseline,pol,r,i order, if Ok.
-    ///
+    /// * A Result of Ok if the cache was written, or a VisibilityCacheError on failure.
     ///
-    pub fn read_by_frequency(
+    pub fn write_visibility_cache<P: AsRef<Path>>(
         &self,
-        corr_timestep_index: usize,
-        corr_coarse_chan_index: usize,
-    ) -> Result<Vec<f32>, GpuboxError> {
-        let mut return_buffer: Vec<f32> = vec![0.; self.num_timestep_coarse_chan_floats];
-
-        self.read_by_frequency_into_buffer(
-            corr_timestep_index,
-            corr_coarse_chan_index,
-            &mut return_buffer,
-        )?;
-
-        Ok(return_buffer)
+        filename: &P,
+        order: ReadOrder,
+    ) -> Result<(), VisibilityCacheError> {
+        write_visibility_cache(
+            filename,
+            &self.visibility_cache_header(order),
+            |corr_timestep_index, corr_coarse_chan_index, buffer| match order {
+                ReadOrder::ByBaseline => self.read_by_baseline_into_buffer(
+                    corr_timestep_index,
+                    corr_coarse_chan_index,
+                    buffer,
+                ),
+                ReadOrder::ByFrequency => self.read_by_frequency_into_buffer(
+                    corr_timestep_index,
+                    corr_coarse_chan_index,
+                    buffer,
+                ),
+            },
+        )
     }
 
-    /// Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
+    /// Serve reads from a visibility cache file written by `write_visibility_cache`, rather than
+    /// from the gpubox files. The cache is memory mapped, and must have been written from this
+    /// observation with the same gpubox files, unchanged since. `read_by_baseline*` and
+    /// `read_by_frequency*` reads (including the batched ones) then copy straight from the cache
+    /// where it is in the order asked for, and `read_by_frequency*` reads of a `ByBaseline`
+    /// cache only need the transpose. Other reads, and reads of a `ByFrequency` cache by
+    /// baseline, still read the gpubox files. See `visibility_cache` for access to the cached
+    /// visibilities without any copy. Calling this again replaces any existing cache.
     ///
     /// # Arguments
     ///
-    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    /// * `filename` - filename of the cache file.
     ///
-    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
     ///
     /// # Returns
     ///
-    /// * A Result of Ok wrapping the fits_filename, batch_index and hdu_index if success or a GpuboxError on failure.
+    /// * A Result of Ok if the cache can be used, or a VisibilityCacheError if it cannot be read or does not match this observation.
     ///
-    fn get_fits_filename_and_batch_and_hdu(
-        &self,
-        corr_timestep_index: usize,
-        corr_coarse_chan_index: usize,
-    ) -> Result<(&str, usize, usize), GpuboxError> {
-        // Validate the timestep
-        if corr_timestep_index > self.num_timesteps - 1 {
-            return Err(GpuboxError::InvalidTimeStepIndex(self.num_timesteps - 1));
-        }
-
-        // Validate the coarse chan
-        if corr_coarse_chan_index > self.num_coarse_chans - 1 {
-            return Err(GpuboxError::InvalidCoarseChanIndex(
-                self.num_coarse_chans - 1,
-            ));
-        }
-
-        if self.gpubox_batches.is_empty() {
-            return Err(GpuboxError::NoGpuboxes);
-        }
+    pub fn enable_visibility_cache<P: AsRef<Path>>(
+        &mut self,
+        filename: &P,
+    ) -> Result<(), VisibilityCacheError> {
+        // The order of the expected header is ignored when checking the cache
+        let expected = self.visibility_cache_header(ReadOrder::ByBaseline);
+        self.visibility_cache = Some(VisibilityCache::open(filename, &expected)?);
 
-        // Lookup the coarse channel we need
-        let channel_identifier = self.coarse_chans[corr_coarse_chan_index].gpubox_number;
-
-        // Get the batch index & hdu based on unix time of the timestep
-        let (batch_index, hdu_index) = match self
-            .gpubox_time_map
-            .get(&self.timesteps[corr_timestep_index].unix_time_ms)
-        {
-            Some(t) => match t.get(&channel_identifier) {
-                Some(c) => c,
-                None => {
-                    return Err(GpuboxError::NoDataForTimeStepCoarseChannel {
-                        timestep_index: corr_timestep_index,
-                        coarse_chan_index: corr_coarse_chan_index,
-                    })
-                }
-            },
-            None => {
-                return Err(GpuboxError::NoDataForTimeStepCoarseChannel {
-                    timestep_index: corr_timestep_index,
-                    coarse_chan_index: corr_coarse_chan_index,
-                })
-            }
-        };
+        Ok(())
+    }
 
-        // For the batch number and coarse channel identifier, find the fits filename we need
-        let fits_filename = match &self.gpubox_batches[*batch_index]
-            .gpubox_files
-            .iter()
-            .find(|&gf| gf.channel_identifier == channel_identifier)
-        {
-            Some(gpuboxfile) => &gpuboxfile.filename,
-            None => {
-                return Err(GpuboxError::NoDataForTimeStepCoarseChannel {
-                    timestep_index: corr_timestep_index,
-                    coarse_chan_index: corr_coarse_chan_index,
-                })
-            }
-        };
+    /// Stop serving reads from a visibility cache file and unmap it. This is the default.
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn disable_visibility_cache(&mut self) {
+        self.visibility_cache = None;
+    }
 
-        Ok((fits_filename, *batch_index, *hdu_index))
+    /// Get the visibility cache enabled with `enable_visibility_cache`, whose `visibilities`
+    /// method returns the visibilities of a timestep and coarse channel in place in the mapped
+    /// file.
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the visibility cache, or None if it is not enabled
+    ///
+    pub fn visibility_cache(&self) -> Option<&VisibilityCache> {
+        self.visibility_cache.as_ref()
     }
 
-    /// Read a single timestep for a single coarse channel
-    /// The output visibilities are in order:
-    /// baseline,frequency,pol,r,i
+    /// Describe this observation as the header of a visibility cache file.
     ///
     /// # Arguments
     ///
-    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
-    ///
-    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    /// * `order` - order of the visibilities in the cache.
     ///
-    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU read in [baseline][frequency][pol][r][i] order.
     ///
     /// # Returns
     ///
-    /// * A Result of Ok if success or a GpuboxError on failure.
+    /// * A VisibilityCacheHeader
     ///
-    pub fn read_by_baseline_into_buffer(
+    fn visibility_cache_header(&self, order: ReadOrder) -> VisibilityCacheHeader {
+        let mut num_chunks: usize = 0;
+        let chunk_indices = self
+            .gpubox_hdu_locations
+            .iter()
+            .map(|location| {
+                location.map(|_| {
+                    num_chunks += 1;
+                    num_chunks - 1
+                })
+            })
+            .collect();
+
+        VisibilityCacheHeader {
+            order,
+            mwa_version: self.mwa_version,
+            obs_id: self.metafits_context.obs_id,
+            num_baselines: self.metafits_context.num_baselines,
+            num_fine_chans: self.metafits_context.num_corr_fine_chans_per_coarse,
+            num_visibility_pols: self.metafits_context.num_visibility_pols,
+            source_fingerprint: fingerprint_gpubox_files(
+                self.gpubox_batches
+                    .iter()
+                    .flat_map(|b| b.gpubox_files.iter().map(|g| g.filename.as_str())),
+                &self.data_sources,
+            ),
+            timestep_unix_times_ms: self.timesteps.iter().map(|t| t.unix_time_ms).collect(),
+            coarse_chan_rec_numbers: self
+                .coarse_chans
+                .iter()
+                .map(|c| c.rec_chan_number)
+                .collect(),
+            chunk_indices,
+        }
+    }
+
+    /// Start or stop collecting read stats (see `get_stats`). Collection is off by default. While
+    /// it is on, every read (including those on prefetch threads) adds to the bytes read, file
+    /// opens and HDU seeks counters, and to the time spent reading HDUs and reordering
+    /// visibilities. This can be called at any time, from any thread.
+    ///
+    /// # Arguments
+    ///
+    /// * `enabled` - true to collect read stats, false to stop. The counters keep their values either way.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn set_stats_enabled(&self, enabled: bool) {
+        self.read_counters.set_enabled(enabled);
+    }
+
+    /// Get the read stats collected so far. `time_map_time_ns` (the time taken to examine the
+    /// gpubox files when this context was created) is always recorded; the other counters are only
+    /// updated while collection is enabled with `set_stats_enabled`.
+    ///
+    /// # Returns
+    ///
+    /// * A ReadStats struct containing a snapshot of the counters
+    ///
+    pub fn get_stats(&self) -> ReadStats {
+        self.read_counters.snapshot()
+    }
+
+    /// Set the read stats counters back to zero (apart from `time_map_time_ns`).
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn reset_stats(&self) {
+        self.read_counters.reset();
+    }
+
+    /// Give this context its own rayon thread pool, which its reordering of visibilities, batched
+    /// reads, averaging and prefetching are then spread over instead of the library-wide pool
+    /// (see `thread_pool::set_num_threads`). Several contexts may share one pool.
+    ///
+    /// # Arguments
+    ///
+    /// * `thread_pool` - the pool to use, or None to use the library-wide pool (the default).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn set_thread_pool(&mut self, thread_pool: Option<Arc<ThreadPool>>) {
+        self.thread_pool = thread_pool;
+    }
+
+    /// Run a function on this context's thread pool (see `set_thread_pool`).
+    fn install<R, F>(&self, f: F) -> R
+    where
+        R: Send,
+        F: FnOnce() -> R + Send,
+    {
+        thread_pool::install(self.thread_pool.as_ref(), f)
+    }
+
+    /// Run a reordering function on this context's thread pool, adding the time it takes to the
+    /// read stats.
+    fn convert<F: FnOnce() + Send>(&self, f: F) {
+        self.read_counters
+            .time(ReadTimer::Convert, || self.install(f))
+    }
+
+    /// Validate every gpubox file which has not been validated yet, if the context was created
+    /// with lazy validation (see `CorrelatorContextBuilder::with_lazy_validation`), so that the
+    /// timesteps and "common" attributes of the context can be relied on. Otherwise (or once
+    /// they have all been validated) this does nothing. If this returns
+    /// `GpuboxError::LazyValidationMismatch`, those attributes were computed from a wrong
+    /// assumption and are not corrected, so the context should be recreated without lazy
+    /// validation.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if every gpubox file is valid, or the GpuboxError of the first which is not.
+    ///
+    pub fn validate_gpubox_files(&self) -> Result<(), GpuboxError> {
+        match &self.deferred_gpubox_validation {
+            Some(deferred_validation) => {
+                let filenames = deferred_validation.pending_filenames();
+                self.install(|| {
+                    filenames
+                        .par_iter()
+                        .try_for_each(|filename| deferred_validation.validate(filename))
+                })
+            }
+            None => Ok(()),
+        }
+    }
+
+    /// Run a function against an open gpubox file, using the gpubox file handle cache if it
+    /// has been enabled, or opening (and then closing) the file otherwise. With lazy validation,
+    /// the file is validated first if it has not been already.
+    ///
+    /// # Arguments
+    ///
+    /// * `fits_filename` - the gpubox file to open.
+    ///
+    /// * `read_fn` - function which reads from the open gpubox file.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    fn with_gpubox_fits_file<F>(&self, fits_filename: &str, read_fn: F) -> Result<(), GpuboxError>
+    where
+        F: FnOnce(&mut FitsFile) -> Result<(), GpuboxError>,
+    {
+        if let Some(deferred_validation) = &self.deferred_gpubox_validation {
+            deferred_validation.validate(fits_filename)?;
+        }
+
+        match &self.gpubox_fits_handle_cache {
+            Some(cache) => {
+                let handle = cache.get_or_open(fits_filename)?;
+                // A panic while another thread held this lock leaves nothing for us to clean
+                // up, as the HDU is always re-selected before reading.
+                let mut fptr = match handle.lock() {
+                    Ok(guard) => guard,
+                    Err(poisoned) => poisoned.into_inner(),
+                };
+                read_fn(&mut fptr)
+            }
+            None => {
+                let mut fptr = self.data_sources.open_fits(fits_filename)?;
+                self.read_counters.add_file_open();
+                read_fn(&mut fptr)
+            }
+        }
+    }
+
+    /// Move to a HDU of an open gpubox file, counting the seek in the read stats.
+    ///
+    /// # Arguments
+    ///
+    /// * `fptr` - the open gpubox file.
+    ///
+    /// * `hdu_index` - the index of the HDU to move to.
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the HDU or a FitsError on failure.
+    ///
+    fn open_gpubox_hdu(&self, fptr: &mut FitsFile, hdu_index: usize) -> Result<FitsHdu, FitsError> {
+        self.read_counters.add_hdu_seek();
+        fits_open_hdu!(fptr, hdu_index)
+    }
+
+    /// Read the floats of an already opened HDU into a supplied buffer, adding the time taken
+    /// and bytes read to the read stats.
+    ///
+    /// # Arguments
+    ///
+    /// * `fptr` - the open gpubox file.
+    ///
+    /// * `hdu` - the HDU to read.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU as it is stored in the file.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a FitsError on failure.
+    ///
+    fn read_gpubox_hdu_into_buffer(
+        &self,
+        fptr: &mut FitsFile,
+        hdu: &FitsHdu,
+        buffer: &mut [f32],
+    ) -> Result<(), FitsError> {
+        self.read_counters.time(ReadTimer::FitsRead, || {
+            get_fits_float_image_into_buffer!(fptr, hdu, buffer)
+        })?;
+        self.read_counters
+            .add_bytes_read(buffer.len() * std::mem::size_of::<f32>());
+
+        Ok(())
+    }
+
+    /// Read the raw floats of a HDU of a gpubox file into a supplied buffer, using the
+    /// gpubox file handle cache if it has been enabled.
+    ///
+    /// # Arguments
+    ///
+    /// * `fits_filename` - the gpubox file to read from.
+    ///
+    /// * `hdu_index` - the index of the HDU to read.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU as it is stored in the file.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    fn read_hdu_into_buffer(
+        &self,
+        fits_filename: &str,
+        hdu_index: usize,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        self.with_gpubox_fits_file(fits_filename, |fptr| {
+            let hdu = self.open_gpubox_hdu(fptr, hdu_index)?;
+            self.read_gpubox_hdu_into_buffer(fptr, &hdu, buffer)?;
+            Ok(())
+        })
+    }
+
+    /// Read the raw floats of a visibility HDU and its weights HDU from a gpubox file into
+    /// supplied buffers, opening the file (or taking it from the gpubox file handle cache) once
+    /// for both.
+    ///
+    /// # Arguments
+    ///
+    /// * `fits_filename` - the gpubox file to read from.
+    ///
+    /// * `hdu_index` - the index of the visibility HDU to read.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data from the visibility HDU as it is stored in the file.
+    ///
+    /// * `weights_hdu_index` - the index of the weights HDU to read.
+    ///
+    /// * `weights_buffer` - Float buffer as a slice which will be filled with data from the weights HDU.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    fn read_hdu_and_weights_into_buffers(
+        &self,
+        fits_filename: &str,
+        hdu_index: usize,
+        buffer: &mut [f32],
+        weights_hdu_index: usize,
+        weights_buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        self.with_gpubox_fits_file(fits_filename, |fptr| {
+            let hdu = self.open_gpubox_hdu(fptr, hdu_index)?;
+            self.read_gpubox_hdu_into_buffer(fptr, &hdu, buffer)?;
+            let weights_hdu = self.open_gpubox_hdu(fptr, weights_hdu_index)?;
+            self.read_gpubox_hdu_into_buffer(fptr, &weights_hdu, weights_buffer)?;
+            Ok(())
+        })
+    }
+
+    /// Read a single timestep for a single coarse channel
+    /// The output visibilities are in order:
+    /// baseline,frequency,pol,r,i
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep. This corresponds
+    ///                      to the element within mwalibContext.timesteps.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel. This corresponds
+    ///                      to the element within mwalibContext.coarse_chans.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing vector of 32 bit floats containing the data in [baseline][frequency][pol][r][i] order, if Ok.
+    ///
+    ///
+    pub fn read_by_baseline(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+    ) -> Result<Vec<f32>, GpuboxError> {
+        let mut return_buffer: Vec<f32> = vec![0.; self.num_timestep_coarse_chan_floats];
+
+        self.read_by_baseline_into_buffer(
+            corr_timestep_index,
+            corr_coarse_chan_index,
+            &mut return_buffer,
+        )?;
+
+        Ok(return_buffer)
+    }
+
+    /// Read a single timestep for a single coarse channel
+    /// The output visibilities are in order:
+    /// frequency,baseline,pol,r,i
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep. This corresponds
+    ///                      to the element within mwalibContext.timesteps.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel. This corresponds
+    ///                      to the element within mwalibContext.coarse_chans.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing vector of 32 bit floats containing the data in frequency,baseline,pol,r,i order, if Ok.
+    ///
+    ///
+    pub fn read_by_frequency(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+    ) -> Result<Vec<f32>, GpuboxError> {
+        let mut return_buffer: Vec<f32> = vec![0.; self.num_timestep_coarse_chan_floats];
+
+        self.read_by_frequency_into_buffer(
+            corr_timestep_index,
+            corr_coarse_chan_index,
+            &mut return_buffer,
+        )?;
+
+        Ok(return_buffer)
+    }
+
+    /// Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index, hdu and weights hdu (MWAX v2 only) of the corresponding data
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok wrapping the fits_filename, batch_index, hdu_index and weights_hdu_index if success or a GpuboxError on failure.
+    ///
+    fn get_fits_filename_and_batch_and_hdu(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+    ) -> Result<(&str, usize, usize, Option<usize>), GpuboxError> {
+        // Validate the timestep
+        if corr_timestep_index > self.num_timesteps - 1 {
+            return Err(GpuboxError::InvalidTimeStepIndex(self.num_timesteps - 1));
+        }
+
+        // Validate the coarse chan
+        if corr_coarse_chan_index > self.num_coarse_chans - 1 {
+            return Err(GpuboxError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        if self.gpubox_batches.is_empty() {
+            return Err(GpuboxError::NoGpuboxes);
+        }
+
+        // Lookup where the data is
+        match self.gpubox_hdu_locations
+            [corr_timestep_index * self.num_coarse_chans + corr_coarse_chan_index]
+        {
+            Some(location) => Ok((
+                &self.gpubox_batches[location.batch_index].gpubox_files[location.file_index]
+                    .filename,
+                location.batch_index,
+                location.hdu_index,
+                location.weights_hdu_index,
+            )),
+            None => Err(GpuboxError::NoDataForTimeStepCoarseChannel {
+                timestep_index: corr_timestep_index,
+                coarse_chan_index: corr_coarse_chan_index,
+            }),
+        }
+    }
+
+    /// Get the visibilities of a timestep and coarse channel from the visibility cache, if it is
+    /// enabled, has data for them and is in the order asked for.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `order` - the order the visibilities are wanted in.
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the cached visibilities, or None if they must be read from the gpubox files.
+    ///
+    fn get_cached_visibilities(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        order: ReadOrder,
+    ) -> Option<&[f32]> {
+        self.visibility_cache
+            .as_ref()
+            .filter(|cache| cache.order() == order)?
+            .visibilities(corr_timestep_index, corr_coarse_chan_index)
+    }
+
+    /// Check that a buffer is the size of one HDU, as it would otherwise only be checked when
+    /// reading it from a gpubox file.
+    ///
+    /// # Arguments
+    ///
+    /// * `buffer` - the buffer to check.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if it is `num_timestep_coarse_chan_floats` long, or a GpuboxError::InvalidBufferSize.
+    ///
+    fn check_hdu_buffer_size(&self, buffer: &[f32]) -> Result<(), GpuboxError> {
+        if buffer.len() != self.num_timestep_coarse_chan_floats {
+            return Err(GpuboxError::InvalidBufferSize(
+                buffer.len(),
+                self.num_timestep_coarse_chan_floats,
+            ));
+        }
+
+        Ok(())
+    }
+
+    /// Read a single timestep for a single coarse channel
+    /// The output visibilities are in order:
+    /// baseline,frequency,pol,r,i
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU read in [baseline][frequency][pol][r][i] order.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_by_baseline_into_buffer(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        // Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
+        let (fits_filename, _, hdu_index, _) =
+            self.get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?;
+
+        // Copy from the visibility cache, if it has this data in baseline order
+        if let Some(cached) = self.get_cached_visibilities(
+            corr_timestep_index,
+            corr_coarse_chan_index,
+            ReadOrder::ByBaseline,
+        ) {
+            self.check_hdu_buffer_size(buffer)?;
+            buffer.copy_from_slice(cached);
+
+            return Ok(());
+        }
+
+        // If legacy correlator, then convert the HDU into the correct output format
+        if self.mwa_version == MWAVersion::CorrOldLegacy
+            || self.mwa_version == MWAVersion::CorrLegacy
+        {
+            // Get a temporary buffer, if we are reading legacy correlator files
+            let mut temp_buffer = self.scratch_buffers.take(
+                self.metafits_context.num_corr_fine_chans_per_coarse
+                    * self.metafits_context.num_visibility_pols
+                    * self.metafits_context.num_baselines
+                    * 2,
+            );
+
+            // Read into temp buffer
+            self.read_hdu_into_buffer(fits_filename, hdu_index, &mut temp_buffer)?;
+
+            self.convert(|| {
+                convert::convert_legacy_hdu_to_mwax_baseline_order(
+                    &self.legacy_conversion_table,
+                    &temp_buffer,
+                    buffer,
+                    self.metafits_context.num_corr_fine_chans_per_coarse,
+                );
+            });
+
+            Ok(())
+        } else {
+            // Read into caller's buffer
+            self.read_hdu_into_buffer(fits_filename, hdu_index, buffer)?;
+
+            Ok(())
+        }
+    }
+
+    /// Read a single timestep for a single coarse channel into a supplied buffer
+    /// The output visibilities are in order:
+    /// frequency,baseline,pol,r,i
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU read in [baseline][frequency][pol][r][i] order.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_by_frequency_into_buffer(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        // Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
+        let (fits_filename, _, hdu_index, _) =
+            self.get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?;
+
+        // Serve from the visibility cache if it has this data: as is if it is in frequency
+        // order, or transposed if it is in baseline order
+        if let Some(cache) = &self.visibility_cache {
+            if let Some(cached) = cache.visibilities(corr_timestep_index, corr_coarse_chan_index) {
+                self.check_hdu_buffer_size(buffer)?;
+                match cache.order() {
+                    ReadOrder::ByFrequency => buffer.copy_from_slice(cached),
+                    ReadOrder::ByBaseline => self.convert(|| {
+                        convert::convert_mwax_hdu_to_frequency_order(
+                            cached,
+                            buffer,
+                            self.metafits_context.num_baselines,
+                            self.metafits_context.num_corr_fine_chans_per_coarse,
+                            self.metafits_context.num_visibility_pols,
+                        );
+                    }),
+                }
+
+                return Ok(());
+            }
+        }
+
+        // Get a temporary buffer
+        let mut temp_buffer = self.scratch_buffers.take(
+            self.metafits_context.num_corr_fine_chans_per_coarse
+                * self.metafits_context.num_visibility_pols
+                * self.metafits_context.num_baselines
+                * 2,
+        );
+
+        // Read the hdu into our temp buffer
+        self.read_hdu_into_buffer(fits_filename, hdu_index, &mut temp_buffer)?;
+
+        // If legacy correlator, then convert the HDU into the correct output format
+        if self.mwa_version == MWAVersion::CorrOldLegacy
+            || self.mwa_version == MWAVersion::CorrLegacy
+        {
+            self.convert(|| {
+                convert::convert_legacy_hdu_to_mwax_frequency_order(
+                    &self.legacy_conversion_table,
+                    &temp_buffer,
+                    buffer,
+                    self.metafits_context.num_corr_fine_chans_per_coarse,
+                );
+            });
+
+            Ok(())
+        } else {
+            // Do conversion for mwax (it is in baseline order, we want it in freq order)
+            self.convert(|| {
+                convert::convert_mwax_hdu_to_frequency_order(
+                    &temp_buffer,
+                    buffer,
+                    self.metafits_context.num_baselines,
+                    self.metafits_context.num_corr_fine_chans_per_coarse,
+                    self.metafits_context.num_visibility_pols,
+                );
+            });
+
+            Ok(())
+        }
+    }
+
+    /// Read a single timestep for a single coarse channel into a supplied buffer of raw integers,
+    /// exactly as they are stored in the gpubox file. cfitsio does not scale or convert them to
+    /// floats, and mwalib does not reorder them, so this is the cheapest way to get visibilities
+    /// off disk (e.g. to hand to a GPU). Multiply by the returned BSCALE and add BZERO to get the
+    /// values `read_by_baseline_into_buffer` would return.
+    ///
+    /// MWAX visibilities are stored in order:
+    /// baseline,frequency,pol,r,i
+    ///
+    /// Files which store visibilities as floats (all legacy correlator files, and MWAX files written
+    /// with float compression) return a `FitsError::NotIntegerImage` error.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `buffer` - i32 buffer as a slice which will be filled with data from the HDU in the order it is stored.
+    ///              It must be `num_timestep_coarse_chan_floats` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the BITPIX, BSCALE and BZERO of the HDU if success or a GpuboxError on failure.
+    ///
+    pub fn read_raw_into_buffer(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        buffer: &mut [i32],
+    ) -> Result<FitsImageScaling, GpuboxError> {
+        // Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
+        let (fits_filename, _, hdu_index, _) =
+            self.get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?;
+
+        if buffer.len() != self.num_timestep_coarse_chan_floats {
+            return Err(GpuboxError::InvalidBufferSize(
+                buffer.len(),
+                self.num_timestep_coarse_chan_floats,
+            ));
+        }
+
+        let mut scaling = None;
+        self.with_gpubox_fits_file(fits_filename, |fptr| {
+            let hdu = self.open_gpubox_hdu(fptr, hdu_index)?;
+            scaling = Some(self.read_counters.time(ReadTimer::FitsRead, || {
+                get_fits_raw_i32_image_into_buffer!(fptr, &hdu, buffer)
+            })?);
+            self.read_counters
+                .add_bytes_read(buffer.len() * std::mem::size_of::<i32>());
+            Ok(())
+        })?;
+
+        // We can unwrap here as the scaling is always set if the read succeeded
+        Ok(scaling.unwrap())
+    }
+
+    /// Read a single timestep for a single coarse channel, along with its weights, into supplied
+    /// buffers. The visibility and weights HDUs are read from one open gpubox file.
+    /// The output visibilities are in order:
+    /// baseline,frequency,pol,r,i
+    /// The output weights are in order:
+    /// baseline,pol
+    ///
+    /// Weights are only present in MWAX v2 observations.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU read in [baseline][frequency][pol][r][i] order.
+    ///              It must be `num_timestep_coarse_chan_floats` long.
+    ///
+    /// * `weights_buffer` - Float buffer as a slice which will be filled with the weights read in [baseline][pol] order.
+    ///                      It must be `num_timestep_coarse_chan_weight_floats` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_by_baseline_with_weights_into_buffer(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        buffer: &mut [f32],
+        weights_buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        let (fits_filename, hdu_index, weights_hdu_index) = self
+            .get_fits_filename_and_hdus_with_weights(
+                corr_timestep_index,
+                corr_coarse_chan_index,
+                buffer,
+                weights_buffer,
+            )?;
+
+        // MWAX data is already in baseline order, so read straight into the caller's buffers
+        self.read_hdu_and_weights_into_buffers(
+            fits_filename,
+            hdu_index,
+            buffer,
+            weights_hdu_index,
+            weights_buffer,
+        )
+    }
+
+    /// Read a single timestep for a single coarse channel, along with its weights, into supplied
+    /// buffers. The visibility and weights HDUs are read from one open gpubox file.
+    /// The output visibilities are in order:
+    /// frequency,baseline,pol,r,i
+    /// The output weights are in order:
+    /// baseline,pol
+    ///
+    /// Weights are only present in MWAX v2 observations.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU read in [frequency][baseline][pol][r][i] order.
+    ///              It must be `num_timestep_coarse_chan_floats` long.
+    ///
+    /// * `weights_buffer` - Float buffer as a slice which will be filled with the weights read in [baseline][pol] order.
+    ///                      It must be `num_timestep_coarse_chan_weight_floats` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_by_frequency_with_weights_into_buffer(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        buffer: &mut [f32],
+        weights_buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        let (fits_filename, hdu_index, weights_hdu_index) = self
+            .get_fits_filename_and_hdus_with_weights(
+                corr_timestep_index,
+                corr_coarse_chan_index,
+                buffer,
+                weights_buffer,
+            )?;
+
+        // Get a temporary buffer
+        let mut temp_buffer = self
+            .scratch_buffers
+            .take(self.num_timestep_coarse_chan_floats);
+
+        // Read the hdu into our temp buffer, and the weights (which have no frequency axis) straight into the caller's buffer
+        self.read_hdu_and_weights_into_buffers(
+            fits_filename,
+            hdu_index,
+            &mut temp_buffer,
+            weights_hdu_index,
+            weights_buffer,
+        )?;
+
+        // Do conversion for mwax (it is in baseline order, we want it in freq order)
+        self.convert(|| {
+            convert::convert_mwax_hdu_to_frequency_order(
+                &temp_buffer,
+                buffer,
+                self.metafits_context.num_baselines,
+                self.metafits_context.num_corr_fine_chans_per_coarse,
+                self.metafits_context.num_visibility_pols,
+            );
+        });
+
+        Ok(())
+    }
+
+    /// Validate the inputs to a read with weights and return the fits_filename, hdu and weights hdu of the corresponding data
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `buffer` - Float buffer which will be filled with visibilities.
+    ///
+    /// * `weights_buffer` - Float buffer which will be filled with weights.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok wrapping the fits_filename, hdu_index and weights_hdu_index if success or a GpuboxError on failure.
+    ///
+    fn get_fits_filename_and_hdus_with_weights(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        buffer: &[f32],
+        weights_buffer: &[f32],
+    ) -> Result<(&str, usize, usize), GpuboxError> {
+        if self.mwa_version != MWAVersion::CorrMWAXv2 {
+            return Err(GpuboxError::NoWeightsForMwaVersion {
+                mwa_version: self.mwa_version,
+            });
+        }
+
+        if buffer.len() != self.num_timestep_coarse_chan_floats {
+            return Err(GpuboxError::InvalidBufferSize(
+                buffer.len(),
+                self.num_timestep_coarse_chan_floats,
+            ));
+        }
+
+        if weights_buffer.len() != self.num_timestep_coarse_chan_weight_floats {
+            return Err(GpuboxError::InvalidBufferSize(
+                weights_buffer.len(),
+                self.num_timestep_coarse_chan_weight_floats,
+            ));
+        }
+
+        // Validate input timestep_index and coarse_chan_index and return the fits_filename and hdus of the corresponding data
+        match self
+            .get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?
+        {
+            (fits_filename, _, hdu_index, Some(weights_hdu_index)) => {
+                Ok((fits_filename, hdu_index, weights_hdu_index))
+            }
+            // The file was truncated before the weights HDU for this timestep
+            (_, _, _, None) => Err(GpuboxError::NoDataForTimeStepCoarseChannel {
+                timestep_index: corr_timestep_index,
+                coarse_chan_index: corr_coarse_chan_index,
+            }),
+        }
+    }
+
+    /// Read a subset of the baselines and fine channels of a single timestep for a single coarse
+    /// channel into a supplied buffer. Only the requested part of the HDU is read from disk for
+    /// MWAX observations. Legacy HDUs are stored in frequency order, so the requested fine channel
+    /// rows are read in full and then only the requested baselines are converted.
+    /// The output visibilities are in order:
+    /// baseline,frequency,pol,r,i
+    /// where baseline is in the order of `baseline_indices`.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `baseline_indices` - indices of the baselines (within the metafits_context baselines array) to read. Runs of
+    ///                        consecutive, ascending indices are read together.
+    ///
+    /// * `fine_chan_range` - range of fine channels (within the coarse channel) to read.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the data read in [baseline][frequency][pol][r][i] order.
+    ///              It must be `baseline_indices.len() * fine_chan_range.len() * num_visibility_pols * 2` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_by_baseline_subset_into_buffer(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        baseline_indices: &[usize],
+        fine_chan_range: Range<usize>,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        // Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
+        let (fits_filename, _, hdu_index, _) =
+            self.get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?;
+
+        self.validate_subset(baseline_indices, &fine_chan_range, buffer.len())?;
+
+        if buffer.is_empty() {
+            return Ok(());
+        }
+
+        if self.mwa_version == MWAVersion::CorrOldLegacy
+            || self.mwa_version == MWAVersion::CorrLegacy
+        {
+            // Read the fine channel rows we need into a temp buffer
+            let mut temp_buffer = self.scratch_buffers.take(
+                self.num_timestep_coarse_chan_floats
+                    / self.metafits_context.num_corr_fine_chans_per_coarse
+                    * fine_chan_range.len(),
+            );
+            self.read_legacy_hdu_fine_chans_into_buffer(
+                fits_filename,
+                hdu_index,
+                &fine_chan_range,
+                &mut temp_buffer,
+            )?;
+
+            self.convert(|| {
+                convert::convert_legacy_hdu_to_mwax_baseline_order(
+                    &self.get_legacy_conversion_table_subset(baseline_indices),
+                    &temp_buffer,
+                    buffer,
+                    fine_chan_range.len(),
+                );
+            });
+
+            Ok(())
+        } else {
+            // Read into caller's buffer
+            self.read_mwax_hdu_subset_into_buffer(
+                fits_filename,
+                hdu_index,
+                baseline_indices,
+                &fine_chan_range,
+                buffer,
+            )
+        }
+    }
+
+    /// Read a subset of the baselines and fine channels of a single timestep for a single coarse
+    /// channel into a supplied buffer. See `read_by_baseline_subset_into_buffer` for details of
+    /// what is read from disk.
+    /// The output visibilities are in order:
+    /// frequency,baseline,pol,r,i
+    /// where baseline is in the order of `baseline_indices`.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `baseline_indices` - indices of the baselines (within the metafits_context baselines array) to read.
+    ///
+    /// * `fine_chan_range` - range of fine channels (within the coarse channel) to read.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the data read in [frequency][baseline][pol][r][i] order.
+    ///              It must be `baseline_indices.len() * fine_chan_range.len() * num_visibility_pols * 2` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_by_frequency_subset_into_buffer(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+        baseline_indices: &[usize],
+        fine_chan_range: Range<usize>,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        // Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
+        let (fits_filename, _, hdu_index, _) =
+            self.get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?;
+
+        self.validate_subset(baseline_indices, &fine_chan_range, buffer.len())?;
+
+        if buffer.is_empty() {
+            return Ok(());
+        }
+
+        if self.mwa_version == MWAVersion::CorrOldLegacy
+            || self.mwa_version == MWAVersion::CorrLegacy
+        {
+            // Read the fine channel rows we need into a temp buffer
+            let mut temp_buffer = self.scratch_buffers.take(
+                self.num_timestep_coarse_chan_floats
+                    / self.metafits_context.num_corr_fine_chans_per_coarse
+                    * fine_chan_range.len(),
+            );
+            self.read_legacy_hdu_fine_chans_into_buffer(
+                fits_filename,
+                hdu_index,
+                &fine_chan_range,
+                &mut temp_buffer,
+            )?;
+
+            self.convert(|| {
+                convert::convert_legacy_hdu_to_mwax_frequency_order(
+                    &self.get_legacy_conversion_table_subset(baseline_indices),
+                    &temp_buffer,
+                    buffer,
+                    fine_chan_range.len(),
+                );
+            });
+
+            Ok(())
+        } else {
+            // Read the subset in baseline order into a temp buffer, then transpose it
+            let mut temp_buffer = self.scratch_buffers.take(buffer.len());
+            self.read_mwax_hdu_subset_into_buffer(
+                fits_filename,
+                hdu_index,
+                baseline_indices,
+                &fine_chan_range,
+                &mut temp_buffer,
+            )?;
+
+            self.convert(|| {
+                convert::convert_mwax_hdu_to_frequency_order(
+                    &temp_buffer,
+                    buffer,
+                    baseline_indices.len(),
+                    fine_chan_range.len(),
+                    self.metafits_context.num_visibility_pols,
+                );
+            });
+
+            Ok(())
+        }
+    }
+
+    /// Read only the autocorrelations of a single timestep for a single coarse channel into a
+    /// supplied buffer. For MWAX observations only the autocorrelation rows of the HDU are read
+    /// from disk. Legacy HDUs are stored in frequency order, so the whole HDU is read, but only the
+    /// autocorrelations are converted.
+    /// The output visibilities are in order:
+    /// antenna,frequency,pol,r,i
+    /// where antenna is in the order of `metafits_context.antennas`.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the autocorrelations in [antenna][frequency][pol][r][i] order.
+    ///              It must be `num_ants * num_corr_fine_chans_per_coarse * num_visibility_pols * 2` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_autos_into_buffer(
         &self,
         corr_timestep_index: usize,
         corr_coarse_chan_index: usize,
         buffer: &mut [f32],
     ) -> Result<(), GpuboxError> {
         // Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
-        let (fits_filename, _, hdu_index) =
+        let (fits_filename, _, hdu_index, _) =
             self.get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?;
 
-        // Open the fits file
-        let mut fptr = fits_open!(&fits_filename)?;
-        let hdu = fits_open_hdu!(&mut fptr, hdu_index)?;
+        let num_fine_chans = self.metafits_context.num_corr_fine_chans_per_coarse;
+        self.validate_subset(
+            &self.auto_baseline_indices,
+            &(0..num_fine_chans),
+            buffer.len(),
+        )?;
 
-        // If legacy correlator, then convert the HDU into the correct output format
         if self.mwa_version == MWAVersion::CorrOldLegacy
             || self.mwa_version == MWAVersion::CorrLegacy
         {
-            // Prepare temporary buffer, if we are reading legacy correlator files
-            let mut temp_buffer = vec![
-                0.;
-                self.metafits_context.num_corr_fine_chans_per_coarse
-                    * self.metafits_context.num_visibility_pols
-                    * self.metafits_context.num_baselines
-                    * 2
-            ];
-
-            // Read into temp buffer
-            get_fits_float_image_into_buffer!(&mut fptr, &hdu, &mut temp_buffer)?;
+            // Read the whole HDU into a temp buffer
+            let mut temp_buffer = self
+                .scratch_buffers
+                .take(self.num_timestep_coarse_chan_floats);
+            self.read_hdu_into_buffer(fits_filename, hdu_index, &mut temp_buffer)?;
+
+            self.convert(|| {
+                convert::convert_legacy_hdu_to_mwax_baseline_order(
+                    &self.legacy_auto_conversion_table,
+                    &temp_buffer,
+                    buffer,
+                    num_fine_chans,
+                );
+            });
 
-            convert::convert_legacy_hdu_to_mwax_baseline_order(
-                &self.legacy_conversion_table,
-                &temp_buffer,
+            Ok(())
+        } else {
+            // Read only the auto rows into the caller's buffer
+            self.read_mwax_hdu_subset_into_buffer(
+                fits_filename,
+                hdu_index,
+                &self.auto_baseline_indices,
+                &(0..num_fine_chans),
                 buffer,
-                self.metafits_context.num_corr_fine_chans_per_coarse,
-            );
+            )
+        }
+    }
+
+    /// Validate the baselines, fine channels and buffer size requested for a subset read.
+    ///
+    /// # Arguments
+    ///
+    /// * `baseline_indices` - indices of the baselines (within the metafits_context baselines array) to read.
+    ///
+    /// * `fine_chan_range` - range of fine channels (within the coarse channel) to read.
+    ///
+    /// * `buffer_len` - length of the buffer the caller supplied.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if the subset is valid or a GpuboxError on failure.
+    ///
+    fn validate_subset(
+        &self,
+        baseline_indices: &[usize],
+        fine_chan_range: &Range<usize>,
+        buffer_len: usize,
+    ) -> Result<(), GpuboxError> {
+        let num_fine_chans = self.metafits_context.num_corr_fine_chans_per_coarse;
+        if fine_chan_range.start > fine_chan_range.end || fine_chan_range.end > num_fine_chans {
+            return Err(GpuboxError::InvalidFineChanRange {
+                start: fine_chan_range.start,
+                end: fine_chan_range.end,
+                num_fine_chans,
+            });
+        }
+
+        let num_baselines = self.metafits_context.num_baselines;
+        if baseline_indices.iter().any(|&b| b >= num_baselines) {
+            return Err(GpuboxError::InvalidBaselineIndex(num_baselines - 1));
+        }
+
+        let expected_buffer_len = baseline_indices.len()
+            * fine_chan_range.len()
+            * self.metafits_context.num_visibility_pols
+            * 2;
+        if buffer_len != expected_buffer_len {
+            return Err(GpuboxError::InvalidBufferSize(
+                buffer_len,
+                expected_buffer_len,
+            ));
+        }
+
+        Ok(())
+    }
+
+    /// Read a subset of the baselines and fine channels of a MWAX HDU with image section reads.
+    /// MWAX HDUs have one row per baseline, so each run of consecutive baselines is read with one
+    /// section read, touching only the requested fine channels of each row.
+    ///
+    /// # Arguments
+    ///
+    /// * `fits_filename` - the gpubox file to read from.
+    ///
+    /// * `hdu_index` - the index of the HDU to read.
+    ///
+    /// * `baseline_indices` - indices of the baselines to read. These must already have been validated.
+    ///
+    /// * `fine_chan_range` - range of fine channels to read. This must already have been validated.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the data in [baseline][frequency][pol][r][i] order.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    fn read_mwax_hdu_subset_into_buffer(
+        &self,
+        fits_filename: &str,
+        hdu_index: usize,
+        baseline_indices: &[usize],
+        fine_chan_range: &Range<usize>,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        let floats_per_baseline_fine_chan = self.metafits_context.num_visibility_pols * 2;
+        let floats_per_baseline = fine_chan_range.len() * floats_per_baseline_fine_chan;
+        let row_range = fine_chan_range.start * floats_per_baseline_fine_chan
+            ..fine_chan_range.end * floats_per_baseline_fine_chan;
+
+        self.with_gpubox_fits_file(fits_filename, |fptr| {
+            let hdu = self.open_gpubox_hdu(fptr, hdu_index)?;
+
+            let mut output_buffer = buffer;
+            let mut remaining_baselines = baseline_indices;
+            while let Some(&first_baseline) = remaining_baselines.first() {
+                // Find the run of consecutive baselines starting here
+                let run_len = remaining_baselines
+                    .iter()
+                    .enumerate()
+                    .take_while(|(i, &b)| b == first_baseline + i)
+                    .count();
+
+                let (run_buffer, rest) = output_buffer.split_at_mut(run_len * floats_per_baseline);
+                self.read_counters.time(ReadTimer::FitsRead, || {
+                    get_fits_float_image_section_into_buffer!(
+                        fptr,
+                        &hdu,
+                        &[row_range.clone(), first_baseline..first_baseline + run_len],
+                        run_buffer
+                    )
+                })?;
+                self.read_counters
+                    .add_bytes_read(run_buffer.len() * std::mem::size_of::<f32>());
+
+                output_buffer = rest;
+                remaining_baselines = &remaining_baselines[run_len..];
+            }
 
             Ok(())
-        } else {
-            // Read into caller's buffer
-            get_fits_float_image_into_buffer!(&mut fptr, &hdu, buffer)?;
+        })
+    }
 
+    /// Read a range of fine channels (all baselines) of a legacy HDU with an image section read.
+    /// Legacy HDUs have one row per fine channel.
+    ///
+    /// # Arguments
+    ///
+    /// * `fits_filename` - the gpubox file to read from.
+    ///
+    /// * `hdu_index` - the index of the HDU to read.
+    ///
+    /// * `fine_chan_range` - range of fine channels to read. This must already have been validated.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the data as it is stored in the file.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    fn read_legacy_hdu_fine_chans_into_buffer(
+        &self,
+        fits_filename: &str,
+        hdu_index: usize,
+        fine_chan_range: &Range<usize>,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        let floats_per_fine_chan = self.num_timestep_coarse_chan_floats
+            / self.metafits_context.num_corr_fine_chans_per_coarse;
+
+        self.with_gpubox_fits_file(fits_filename, |fptr| {
+            let hdu = self.open_gpubox_hdu(fptr, hdu_index)?;
+            self.read_counters.time(ReadTimer::FitsRead, || {
+                get_fits_float_image_section_into_buffer!(
+                    fptr,
+                    &hdu,
+                    &[0..floats_per_fine_chan, fine_chan_range.clone()],
+                    buffer
+                )
+            })?;
+            self.read_counters
+                .add_bytes_read(buffer.len() * std::mem::size_of::<f32>());
             Ok(())
+        })
+    }
+
+    /// Build a legacy conversion table containing only the requested baselines, in the order requested.
+    ///
+    /// # Arguments
+    ///
+    /// * `baseline_indices` - indices of the baselines to convert. These must already have been validated.
+    ///
+    /// # Returns
+    ///
+    /// * A vector of `LegacyConversionBaseline`s, one per requested baseline.
+    ///
+    fn get_legacy_conversion_table_subset(
+        &self,
+        baseline_indices: &[usize],
+    ) -> Vec<LegacyConversionBaseline> {
+        baseline_indices
+            .iter()
+            .map(|&b| self.legacy_conversion_table[b].clone())
+            .collect()
+    }
+
+    /// Returns the dimensions of the output of `read_by_baseline_averaged_into_buffer` for the
+    /// given averaging factors.
+    ///
+    /// # Arguments
+    ///
+    /// * `time_factor` - number of common good timesteps averaged into each output timestep.
+    ///
+    /// * `freq_factor` - number of fine channels averaged into each output fine channel. Must divide `num_corr_fine_chans_per_coarse`.
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the number of averaged timesteps and the number of averaged fine channels per coarse channel,
+    ///   or a GpuboxError if the factors are invalid.
+    ///
+    pub fn get_averaged_dimensions(
+        &self,
+        time_factor: usize,
+        freq_factor: usize,
+    ) -> Result<(usize, usize), GpuboxError> {
+        self.get_averaged_dimensions_for_timesteps(
+            self.num_common_good_timesteps,
+            time_factor,
+            freq_factor,
+        )
+    }
+
+    /// Returns the dimensions of averaged output for a number of input timesteps.
+    ///
+    /// # Arguments
+    ///
+    /// * `num_timesteps` - number of timesteps being averaged.
+    ///
+    /// * `time_factor` - number of timesteps averaged into each output timestep.
+    ///
+    /// * `freq_factor` - number of fine channels averaged into each output fine channel.
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the number of averaged timesteps and fine channels, or a GpuboxError if the factors are invalid.
+    ///
+    fn get_averaged_dimensions_for_timesteps(
+        &self,
+        num_timesteps: usize,
+        time_factor: usize,
+        freq_factor: usize,
+    ) -> Result<(usize, usize), GpuboxError> {
+        let num_fine_chans = self.metafits_context.num_corr_fine_chans_per_coarse;
+
+        if time_factor == 0 || freq_factor == 0 || num_fine_chans % freq_factor != 0 {
+            return Err(GpuboxError::InvalidAveragingFactor {
+                time_factor,
+                freq_factor,
+                num_fine_chans,
+            });
         }
+
+        // A final partial group of timesteps becomes its own (shorter) averaged timestep
+        Ok((
+            (num_timesteps + time_factor - 1) / time_factor,
+            num_fine_chans / freq_factor,
+        ))
     }
 
-    /// Read a single timestep for a single coarse channel into a supplied buffer
+    /// Read a coarse channel over all of the common good timesteps (see
+    /// `common_good_timestep_indices`), averaging in time and frequency as it is read. Each HDU is
+    /// added into the averaged output as soon as it has been read, so memory use scales with the
+    /// size of the output rather than the input.
+    ///
+    /// Every `time_factor` consecutive common good timesteps become one output timestep (if the
+    /// number of common good timesteps is not a multiple of `time_factor`, the last output
+    /// timestep averages the remainder), and every `freq_factor` fine channels become one output
+    /// fine channel.
+    ///
+    /// For MWAX v2 observations the average is weighted by the weights HDU of each timestep.
+    /// Otherwise every visibility has a weight of 1.
+    ///
     /// The output visibilities are in order:
-    /// frequency,baseline,pol,r,i
+    /// [averaged timestep][baseline][averaged frequency][pol][r][i]
+    /// The output weights (the sum of the weights of the visibilities in each average) are in order:
+    /// [averaged timestep][baseline][averaged frequency][pol]
     ///
     /// # Arguments
     ///
-    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    /// * `time_factor` - number of common good timesteps averaged into each output timestep.
+    ///
+    /// * `freq_factor` - number of fine channels averaged into each output fine channel. Must divide `num_corr_fine_chans_per_coarse`.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the averaged visibilities. It must be
+    ///              `num_averaged_timesteps * num_baselines * num_averaged_fine_chans * num_visibility_pols * 2` long
+    ///              (see `get_averaged_dimensions`).
+    ///
+    /// * `weights_buffer` - Float buffer as a slice which will be filled with the summed weights. It must be
+    ///                      `num_averaged_timesteps * num_baselines * num_averaged_fine_chans * num_visibility_pols` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    pub fn read_by_baseline_averaged_into_buffer(
+        &self,
+        corr_coarse_chan_index: usize,
+        time_factor: usize,
+        freq_factor: usize,
+        buffer: &mut [f32],
+        weights_buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        self.read_timesteps_averaged_into_buffer(
+            &self.common_good_timestep_indices,
+            corr_coarse_chan_index,
+            time_factor,
+            freq_factor,
+            buffer,
+            weights_buffer,
+        )
+    }
+
+    /// Read a coarse channel over the supplied timesteps, averaging in time and frequency as it
+    /// is read. See `read_by_baseline_averaged_into_buffer`.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_indices` - indices within the CorrelatorContext timestep array of the timesteps to average.
     ///
     /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
     ///
-    /// * `buffer` - Float buffer as a slice which will be filled with data from the HDU read in [baseline][frequency][pol][r][i] order.
+    /// * `time_factor` - number of timesteps averaged into each output timestep.
+    ///
+    /// * `freq_factor` - number of fine channels averaged into each output fine channel.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the averaged visibilities.
+    ///
+    /// * `weights_buffer` - Float buffer as a slice which will be filled with the summed weights.
     ///
     /// # Returns
     ///
     /// * A Result of Ok if success or a GpuboxError on failure.
     ///
-    pub fn read_by_frequency_into_buffer(
+    fn read_timesteps_averaged_into_buffer(
         &self,
-        corr_timestep_index: usize,
+        corr_timestep_indices: &[usize],
         corr_coarse_chan_index: usize,
+        time_factor: usize,
+        freq_factor: usize,
         buffer: &mut [f32],
+        weights_buffer: &mut [f32],
     ) -> Result<(), GpuboxError> {
-        // Validate input timestep_index and coarse_chan_index and return the fits_filename, batch index and hdu of the corresponding data
-        let (fits_filename, _, hdu_index) =
-            self.get_fits_filename_and_batch_and_hdu(corr_timestep_index, corr_coarse_chan_index)?;
+        let (num_averaged_timesteps, num_averaged_fine_chans) = self
+            .get_averaged_dimensions_for_timesteps(
+                corr_timestep_indices.len(),
+                time_factor,
+                freq_factor,
+            )?;
 
-        // Open the fits file
-        let mut fptr = fits_open!(&fits_filename)?;
-        let hdu = fits_open_hdu!(&mut fptr, hdu_index)?;
+        let averaged_timestep_weights = self.metafits_context.num_baselines
+            * num_averaged_fine_chans
+            * self.metafits_context.num_visibility_pols;
+        let averaged_timestep_floats = averaged_timestep_weights * 2;
 
-        // Prepare temporary buffer
-        let mut temp_buffer = vec![
-            0.;
-            self.metafits_context.num_corr_fine_chans_per_coarse
-                * self.metafits_context.num_visibility_pols
-                * self.metafits_context.num_baselines
-                * 2
-        ];
+        if buffer.len() != num_averaged_timesteps * averaged_timestep_floats {
+            return Err(GpuboxError::InvalidBufferSize(
+                buffer.len(),
+                num_averaged_timesteps * averaged_timestep_floats,
+            ));
+        }
+        if weights_buffer.len() != num_averaged_timesteps * averaged_timestep_weights {
+            return Err(GpuboxError::InvalidBufferSize(
+                weights_buffer.len(),
+                num_averaged_timesteps * averaged_timestep_weights,
+            ));
+        }
 
-        // Read the hdu into our temp buffer
-        get_fits_float_image_into_buffer!(&mut fptr, &hdu, &mut temp_buffer)?;
+        if num_averaged_timesteps == 0 {
+            return Ok(());
+        }
 
-        // If legacy correlator, then convert the HDU into the correct output format
-        if self.mwa_version == MWAVersion::CorrOldLegacy
-            || self.mwa_version == MWAVersion::CorrLegacy
+        // Only one full resolution HDU (and its weights) is held at a time
+        let mut hdu_buffer = self
+            .scratch_buffers
+            .take(self.num_timestep_coarse_chan_floats);
+        let mut hdu_weights_buffer = self
+            .scratch_buffers
+            .take(self.num_timestep_coarse_chan_weight_floats);
+        let use_weights = self.mwa_version == MWAVersion::CorrMWAXv2;
+
+        buffer.iter_mut().for_each(|v| *v = 0.0);
+        weights_buffer.iter_mut().for_each(|w| *w = 0.0);
+
+        for ((timestep_indices, vis_sums), weight_sums) in corr_timestep_indices
+            .chunks(time_factor)
+            .zip(buffer.chunks_exact_mut(averaged_timestep_floats))
+            .zip(weights_buffer.chunks_exact_mut(averaged_timestep_weights))
         {
-            convert::convert_legacy_hdu_to_mwax_frequency_order(
-                &self.legacy_conversion_table,
-                &temp_buffer,
-                buffer,
-                self.metafits_context.num_corr_fine_chans_per_coarse,
-            );
+            for &corr_timestep_index in timestep_indices {
+                if use_weights {
+                    self.read_by_baseline_with_weights_into_buffer(
+                        corr_timestep_index,
+                        corr_coarse_chan_index,
+                        &mut hdu_buffer,
+                        &mut hdu_weights_buffer,
+                    )?;
+                } else {
+                    self.read_by_baseline_into_buffer(
+                        corr_timestep_index,
+                        corr_coarse_chan_index,
+                        &mut hdu_buffer,
+                    )?;
+                }
 
-            Ok(())
-        } else {
-            // Do conversion for mwax (it is in baseline order, we want it in freq order)
-            convert::convert_mwax_hdu_to_frequency_order(
-                &temp_buffer,
-                buffer,
-                self.metafits_context.num_baselines,
-                self.metafits_context.num_corr_fine_chans_per_coarse,
-                self.metafits_context.num_visibility_pols,
-            );
+                self.install(|| {
+                    averaging::accumulate_hdu(
+                        &hdu_buffer,
+                        if use_weights {
+                            Some(&hdu_weights_buffer[..])
+                        } else {
+                            None
+                        },
+                        vis_sums,
+                        weight_sums,
+                        self.metafits_context.num_corr_fine_chans_per_coarse,
+                        self.metafits_context.num_visibility_pols,
+                        freq_factor,
+                    )
+                });
+            }
 
-            Ok(())
+            self.install(|| averaging::normalise_averages(vis_sums, weight_sums));
+        }
+
+        Ok(())
+    }
+
+    /// Iterate over the common good timesteps (see `common_good_timestep_indices`), reading the
+    /// requested coarse channels of upcoming timesteps on a background thread while the caller
+    /// processes the current one.
+    ///
+    /// Each item is a `PrefetchedTimestep`, which dereferences to the visibilities in
+    /// [coarse_chan][HDU] order, where coarse_chan is in the order supplied and each HDU is in
+    /// the requested order. Buffers are recycled once each `PrefetchedTimestep` is dropped, and the
+    /// background thread never reads more than `prefetch_depth` timesteps ahead.
+    ///
+    /// The background thread keeps its own handles to the gpubox files it reads, so the gpubox
+    /// file handle cache is not used.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_coarse_chan_indices` - indices within the CorrelatorContext coarse_chan array for the desired coarse channels.
+    ///
+    /// * `order` - order of the visibilities within each HDU.
+    ///
+    /// * `prefetch_depth` - number of timesteps to read ahead. A value of 0 is treated as 1.
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the iterator, or a GpuboxError if any of the timestep/coarse channel combinations have no data.
+    ///
+    pub fn iter_common_good_timesteps(
+        &self,
+        corr_coarse_chan_indices: &[usize],
+        order: ReadOrder,
+        prefetch_depth: usize,
+    ) -> Result<TimestepPrefetchIterator, GpuboxError> {
+        // Work out every HDU we need up front, so any missing data is reported now
+        let mut plans: Vec<TimestepReadPlan> =
+            Vec::with_capacity(self.common_good_timestep_indices.len());
+
+        for &corr_timestep_index in &self.common_good_timestep_indices {
+            let mut hdus: Vec<(String, usize)> = Vec::with_capacity(corr_coarse_chan_indices.len());
+
+            for &corr_coarse_chan_index in corr_coarse_chan_indices {
+                let (fits_filename, _, hdu_index, _) = self.get_fits_filename_and_batch_and_hdu(
+                    corr_timestep_index,
+                    corr_coarse_chan_index,
+                )?;
+                hdus.push((fits_filename.to_string(), hdu_index));
+            }
+
+            plans.push(TimestepReadPlan {
+                corr_timestep_index,
+                hdus,
+            });
         }
+
+        // The background thread opens the files itself, so with lazy validation make sure now
+        // that every file it will read is valid
+        if let Some(deferred_validation) = &self.deferred_gpubox_validation {
+            for plan in &plans {
+                for (fits_filename, _) in &plan.hdus {
+                    deferred_validation.validate(fits_filename)?;
+                }
+            }
+        }
+
+        let reader = HduReader {
+            mwa_version: self.mwa_version,
+            order,
+            legacy_conversion_table: self.legacy_conversion_table.clone(),
+            num_baselines: self.metafits_context.num_baselines,
+            num_fine_chans: self.metafits_context.num_corr_fine_chans_per_coarse,
+            num_visibility_pols: self.metafits_context.num_visibility_pols,
+            hdu_floats: self.num_timestep_coarse_chan_floats,
+            read_counters: Arc::clone(&self.read_counters),
+            thread_pool: self.thread_pool.clone(),
+            data_sources: self.data_sources.clone(),
+        };
+
+        Ok(TimestepPrefetchIterator::new(reader, plans, prefetch_depth))
+    }
+
+    /// Read many timesteps and coarse channels at once, in parallel, into one supplied buffer.
+    /// Each HDU is read with `read_by_baseline_into_buffer`, with the reads spread over the
+    /// rayon thread pool. As each coarse channel lives in a different gpubox file, the reads
+    /// can proceed concurrently (consider also enabling `enable_fits_handle_cache`).
+    ///
+    /// The output visibilities are in order:
+    /// [timestep][coarse_chan][baseline][frequency][pol][r][i]
+    /// where timestep and coarse_chan are in the order supplied to this method.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_indices` - indices within the CorrelatorContext timestep array for the desired timesteps.
+    ///
+    /// * `corr_coarse_chan_indices` - indices within the CorrelatorContext coarse_chan array for the desired coarse channels.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the data. It must be exactly
+    ///              `corr_timestep_indices.len() * corr_coarse_chan_indices.len() * num_timestep_coarse_chan_floats` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure. If any timestep/coarse channel
+    ///   combination cannot be read (e.g. there is no data for it) an error is returned and the
+    ///   contents of the buffer are unspecified.
+    ///
+    pub fn read_by_baseline_batch(
+        &self,
+        corr_timestep_indices: &[usize],
+        corr_coarse_chan_indices: &[usize],
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        self.read_batch(
+            corr_timestep_indices,
+            corr_coarse_chan_indices,
+            buffer,
+            |timestep_index, coarse_chan_index, hdu_buffer| {
+                self.read_by_baseline_into_buffer(timestep_index, coarse_chan_index, hdu_buffer)
+            },
+        )
+    }
+
+    /// Read many timesteps and coarse channels at once, in parallel, into one supplied buffer.
+    /// Each HDU is read with `read_by_frequency_into_buffer`, with the reads spread over the
+    /// rayon thread pool.
+    ///
+    /// The output visibilities are in order:
+    /// [timestep][coarse_chan][frequency][baseline][pol][r][i]
+    /// where timestep and coarse_chan are in the order supplied to this method.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_indices` - indices within the CorrelatorContext timestep array for the desired timesteps.
+    ///
+    /// * `corr_coarse_chan_indices` - indices within the CorrelatorContext coarse_chan array for the desired coarse channels.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with the data. It must be exactly
+    ///              `corr_timestep_indices.len() * corr_coarse_chan_indices.len() * num_timestep_coarse_chan_floats` long.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure. If any timestep/coarse channel
+    ///   combination cannot be read (e.g. there is no data for it) an error is returned and the
+    ///   contents of the buffer are unspecified.
+    ///
+    pub fn read_by_frequency_batch(
+        &self,
+        corr_timestep_indices: &[usize],
+        corr_coarse_chan_indices: &[usize],
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        self.read_batch(
+            corr_timestep_indices,
+            corr_coarse_chan_indices,
+            buffer,
+            |timestep_index, coarse_chan_index, hdu_buffer| {
+                self.read_by_frequency_into_buffer(timestep_index, coarse_chan_index, hdu_buffer)
+            },
+        )
+    }
+
+    /// Split a caller's buffer into one chunk per timestep/coarse channel combination and fill
+    /// each chunk in parallel with the supplied read function.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_indices` - indices within the CorrelatorContext timestep array for the desired timesteps.
+    ///
+    /// * `corr_coarse_chan_indices` - indices within the CorrelatorContext coarse_chan array for the desired coarse channels.
+    ///
+    /// * `buffer` - Float buffer as a slice to be filled, in [timestep][coarse_chan][HDU] order.
+    ///
+    /// * `read_fn` - function which reads one timestep and coarse channel into a HDU sized buffer.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    fn read_batch<F>(
+        &self,
+        corr_timestep_indices: &[usize],
+        corr_coarse_chan_indices: &[usize],
+        buffer: &mut [f32],
+        read_fn: F,
+    ) -> Result<(), GpuboxError>
+    where
+        F: Fn(usize, usize, &mut [f32]) -> Result<(), GpuboxError> + Sync + Send,
+    {
+        let hdu_floats = self.num_timestep_coarse_chan_floats;
+        let expected_buffer_len =
+            corr_timestep_indices.len() * corr_coarse_chan_indices.len() * hdu_floats;
+
+        if buffer.len() != expected_buffer_len {
+            return Err(GpuboxError::InvalidBufferSize(
+                buffer.len(),
+                expected_buffer_len,
+            ));
+        }
+
+        if expected_buffer_len == 0 {
+            return Ok(());
+        }
+
+        let num_coarse_chans = corr_coarse_chan_indices.len();
+
+        self.install(|| {
+            buffer.par_chunks_mut(hdu_floats).enumerate().try_for_each(
+                |(hdu_number, hdu_buffer)| {
+                    read_fn(
+                        corr_timestep_indices[hdu_number / num_coarse_chans],
+                        corr_coarse_chan_indices[hdu_number % num_coarse_chans],
+                        hdu_buffer,
+                    )
+                },
+            )
+        })
     }
 
     /// Validates the first HDU of a gpubox file against metafits metadata
@@ -208,6 +208,161 @@ fn test_context_mwax() {
     assert_eq!(context.metafits_context.metafits_timesteps.len(), 120);
 }
 
+#[test]
+fn test_context_new_with_gpubox_index_cache() {
+    let metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let filename = "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![filename];
+
+    let temp_dir = tempdir::TempDir::new("gpubox_index_test").unwrap();
+    let index_filename = temp_dir.path().join("1244973688.index");
+
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // First open scans the gpubox files and writes the index
+    let indexed_context = CorrelatorContext::new_with_gpubox_index_cache(
+        &metafits_filename,
+        &gpuboxfiles,
+        &index_filename,
+    )
+    .expect("Failed to create CorrelatorContext with index");
+    assert!(index_filename.exists());
+    assert_eq!(indexed_context.gpubox_time_map, context.gpubox_time_map);
+    assert_eq!(
+        indexed_context.gpubox_hdu_locations,
+        context.gpubox_hdu_locations
+    );
+
+    // Second open uses the index
+    let reopened_context = CorrelatorContext::new_with_gpubox_index_cache(
+        &metafits_filename,
+        &gpuboxfiles,
+        &index_filename,
+    )
+    .expect("Failed to reopen CorrelatorContext with index");
+    assert_eq!(reopened_context.gpubox_time_map, context.gpubox_time_map);
+    assert_eq!(
+        reopened_context.num_timestep_coarse_chan_floats,
+        context.num_timestep_coarse_chan_floats
+    );
+    assert_eq!(
+        reopened_context.common_timestep_indices,
+        context.common_timestep_indices
+    );
+}
+
+#[test]
+fn test_context_builder_lazy_validation() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+
+    // Make a batch of two (identical) gpubox files of different coarse channels
+    let temp_dir = tempdir::TempDir::new("gpubox_lazy_test").unwrap();
+    let gpuboxfiles: Vec<String> = ["gpubox01", "gpubox02"]
+        .iter()
+        .map(|gpubox| {
+            let filename = temp_dir
+                .path()
+                .join(format!("1101503312_20141201210818_{}_00.fits", gpubox));
+            std::fs::copy(
+                "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits",
+                &filename,
+            )
+            .unwrap();
+            filename.to_str().unwrap().to_string()
+        })
+        .collect();
+
+    let context = CorrelatorContext::new(&metafits_filename.to_string(), &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+    assert!(context.deferred_gpubox_validation.is_none());
+
+    let lazy_context = CorrelatorContextBuilder::new()
+        .with_lazy_validation(true)
+        .build(&metafits_filename.to_string(), &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext with lazy validation");
+    assert_eq!(lazy_context.gpubox_time_map, context.gpubox_time_map);
+    assert_eq!(
+        lazy_context.common_timestep_indices,
+        context.common_timestep_indices
+    );
+    let deferred_validation = lazy_context.deferred_gpubox_validation.as_ref().unwrap();
+    assert_eq!(deferred_validation.pending_filenames().len(), 1);
+
+    // Reading the deferred file validates it first
+    let timestep_index = context.provided_timestep_indices[0];
+    let coarse_chan_index = context.provided_coarse_chan_indices[1];
+    let data = context
+        .read_by_baseline(timestep_index, coarse_chan_index)
+        .unwrap();
+    let lazy_data = lazy_context
+        .read_by_baseline(timestep_index, coarse_chan_index)
+        .unwrap();
+    assert_eq!(lazy_data, data);
+    assert!(deferred_validation.pending_filenames().is_empty());
+
+    assert!(lazy_context.validate_gpubox_files().is_ok());
+}
+
+#[test]
+fn test_context_new_from_metafits_context() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let filename = "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![filename];
+
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // Populated for the right MWAVersion, so the metafits context is shared as is
+    let metafits_context =
+        MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrLegacy).unwrap();
+    let shared_context =
+        CorrelatorContext::new_from_metafits_context(Arc::clone(&metafits_context), &gpuboxfiles)
+            .expect("Failed to create CorrelatorContext from MetafitsContext");
+    assert!(Arc::ptr_eq(
+        &shared_context.metafits_context,
+        &metafits_context
+    ));
+    assert_eq!(shared_context.gpubox_time_map, context.gpubox_time_map);
+    assert_eq!(shared_context.num_coarse_chans, context.num_coarse_chans);
+    assert_eq!(
+        shared_context.coarse_chans[0].gpubox_number,
+        context.coarse_chans[0].gpubox_number
+    );
+
+    // Contexts of the same observation share the legacy conversion table
+    assert!(Arc::ptr_eq(
+        &shared_context.legacy_conversion_table,
+        &context.legacy_conversion_table
+    ));
+    assert_eq!(
+        shared_context.read_by_baseline(0, 0).unwrap(),
+        context.read_by_baseline(0, 0).unwrap()
+    );
+
+    // Populated for a different MWAVersion, so a correctly populated copy is used
+    let vcs_metafits_context =
+        MetafitsContext::new_shared(&metafits_filename, MWAVersion::VCSLegacyRecombined).unwrap();
+    let copied_context = CorrelatorContext::new_from_metafits_context(
+        Arc::clone(&vcs_metafits_context),
+        &gpuboxfiles,
+    )
+    .expect("Failed to create CorrelatorContext from MetafitsContext");
+    assert!(!Arc::ptr_eq(
+        &copied_context.metafits_context,
+        &vcs_metafits_context
+    ));
+    assert_eq!(
+        copied_context.metafits_context.mwa_version,
+        Some(MWAVersion::CorrLegacy)
+    );
+    assert_eq!(
+        copied_context.metafits_context.num_metafits_timesteps,
+        context.metafits_context.num_metafits_timesteps
+    );
+    assert_eq!(copied_context.num_timesteps, context.num_timesteps);
+}
+
 #[test]
 fn test_read_by_frequency_invalid_inputs() {
     let mwax_metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
@@ -1055,3 +1210,821 @@ fn test_get_fits_filename_and_batch_and_hdu() {
         error
     );
 }
+
+#[test]
+fn test_read_with_fits_handle_cache() {
+    // Reads with the gpubox file handle cache enabled should return exactly the same data as
+    // reads without it, for both legacy and mwax files.
+    let test_cases = [
+        (
+            "test_files/1101503312_1_timestep/1101503312.metafits",
+            "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits",
+            0,
+        ),
+        (
+            "test_files/1244973688_1_timestep/1244973688.metafits",
+            "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits",
+            10,
+        ),
+    ];
+
+    for (metafits_filename, gpubox_filename, coarse_chan_index) in test_cases.iter() {
+        let gpuboxfiles = vec![*gpubox_filename];
+        let mut context = CorrelatorContext::new(metafits_filename, &gpuboxfiles)
+            .expect("Failed to create CorrelatorContext");
+
+        let uncached_by_bl = context.read_by_baseline(0, *coarse_chan_index).unwrap();
+        let uncached_by_freq = context.read_by_frequency(0, *coarse_chan_index).unwrap();
+
+        context.enable_fits_handle_cache(DEFAULT_MAX_OPEN_FITS_FILES);
+
+        // Read twice so the second read is served from an already open handle
+        for _ in 0..2 {
+            let cached_by_bl = context.read_by_baseline(0, *coarse_chan_index).unwrap();
+            let cached_by_freq = context.read_by_frequency(0, *coarse_chan_index).unwrap();
+
+            assert_eq!(uncached_by_bl, cached_by_bl);
+            assert_eq!(uncached_by_freq, cached_by_freq);
+        }
+
+        // Errors are still reported as normal
+        assert!(matches!(
+            context.read_by_baseline(999, *coarse_chan_index),
+            Err(GpuboxError::InvalidTimeStepIndex(_))
+        ));
+
+        context.disable_fits_handle_cache();
+        assert!(context.gpubox_fits_handle_cache.is_none());
+    }
+}
+
+#[test]
+fn test_read_with_visibility_cache() {
+    // Reads served from a visibility cache should return exactly the same data as reads of the
+    // gpubox files, for both legacy and mwax files and both cache orders.
+    let test_cases = [
+        (
+            "test_files/1101503312_1_timestep/1101503312.metafits",
+            "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits",
+            0,
+        ),
+        (
+            "test_files/1244973688_1_timestep/1244973688.metafits",
+            "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits",
+            10,
+        ),
+    ];
+    let temp_dir = tempdir::TempDir::new("visibility_cache_test").unwrap();
+
+    for (metafits_filename, gpubox_filename, coarse_chan_index) in test_cases.iter() {
+        let gpuboxfiles = vec![*gpubox_filename];
+        let mut context = CorrelatorContext::new(metafits_filename, &gpuboxfiles)
+            .expect("Failed to create CorrelatorContext");
+
+        let uncached_by_bl = context.read_by_baseline(0, *coarse_chan_index).unwrap();
+        let uncached_by_freq = context.read_by_frequency(0, *coarse_chan_index).unwrap();
+
+        for order in [ReadOrder::ByBaseline, ReadOrder::ByFrequency].iter() {
+            let cache_filename = temp_dir.path().join(format!(
+                "{}_{:?}.cache",
+                context.metafits_context.obs_id, order
+            ));
+            context
+                .write_visibility_cache(&cache_filename, *order)
+                .unwrap();
+            context.enable_visibility_cache(&cache_filename).unwrap();
+
+            let cache = context.visibility_cache().unwrap();
+            assert_eq!(cache.order(), *order);
+            let expected = match order {
+                ReadOrder::ByBaseline => &uncached_by_bl,
+                ReadOrder::ByFrequency => &uncached_by_freq,
+            };
+            assert_eq!(
+                cache.visibilities(0, *coarse_chan_index).unwrap(),
+                expected.as_slice()
+            );
+            // Coarse channels without data are not in the cache
+            assert!(cache.visibilities(0, *coarse_chan_index + 1).is_none());
+
+            // No gpubox files are opened for reads served from the cache. Only reads by
+            // baseline of a frequency ordered cache go to the gpubox file.
+            context.set_stats_enabled(true);
+            context.reset_stats();
+            assert_eq!(
+                context.read_by_frequency(0, *coarse_chan_index).unwrap(),
+                uncached_by_freq
+            );
+            assert_eq!(context.get_stats().file_opens, 0);
+            assert_eq!(
+                context.read_by_baseline(0, *coarse_chan_index).unwrap(),
+                uncached_by_bl
+            );
+            let expected_file_opens = match order {
+                ReadOrder::ByBaseline => 0,
+                ReadOrder::ByFrequency => 1,
+            };
+            assert_eq!(context.get_stats().file_opens, expected_file_opens);
+            context.set_stats_enabled(false);
+
+            // Errors are still reported as normal
+            assert!(matches!(
+                context.read_by_baseline(999, *coarse_chan_index),
+                Err(GpuboxError::InvalidTimeStepIndex(_))
+            ));
+            let mut buffer = vec![0.; 10];
+            assert!(matches!(
+                context.read_by_frequency_into_buffer(0, *coarse_chan_index, &mut buffer),
+                Err(GpuboxError::InvalidBufferSize(10, _))
+            ));
+
+            context.disable_visibility_cache();
+            assert!(context.visibility_cache().is_none());
+        }
+    }
+
+    // A cache cannot be used with a different observation
+    let legacy_context = CorrelatorContext::new(&test_cases[0].0, &[test_cases[0].1])
+        .expect("Failed to create CorrelatorContext");
+    let mut mwax_context = CorrelatorContext::new(&test_cases[1].0, &[test_cases[1].1])
+        .expect("Failed to create CorrelatorContext");
+    let cache_filename = temp_dir.path().join("legacy.cache");
+    legacy_context
+        .write_visibility_cache(&cache_filename, ReadOrder::ByBaseline)
+        .unwrap();
+    assert!(matches!(
+        mwax_context.enable_visibility_cache(&cache_filename),
+        Err(VisibilityCacheError::Mismatch(_, _))
+    ));
+    assert!(mwax_context.visibility_cache().is_none());
+}
+
+#[test]
+fn test_context_is_send_and_sync() {
+    // The read methods take &self, so one context can be shared by many threads (this is also
+    // what makes the FFI read functions safe to call concurrently)
+    fn assert_send_sync<T: Send + Sync>() {}
+    assert_send_sync::<CorrelatorContext>();
+}
+
+#[test]
+fn test_concurrent_reads_match_single_reads() {
+    let metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let gpubox_filename =
+        "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+
+    // Both without and with the (shared) gpubox file handle cache
+    for use_handle_cache in [false, true].iter() {
+        let mut context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+            .expect("Failed to create CorrelatorContext");
+
+        let expected_by_bl = context.read_by_baseline(0, 10).unwrap();
+        let expected_by_freq = context.read_by_frequency(0, 10).unwrap();
+
+        if *use_handle_cache {
+            context.enable_fits_handle_cache(DEFAULT_MAX_OPEN_FITS_FILES);
+        }
+
+        let context = std::sync::Arc::new(context);
+        let threads: Vec<_> = (0..8)
+            .map(|_| {
+                let context = context.clone();
+                std::thread::spawn(move || {
+                    let mut by_bl = vec![0.; context.num_timestep_coarse_chan_floats];
+                    let mut by_freq = vec![0.; context.num_timestep_coarse_chan_floats];
+                    for _ in 0..4 {
+                        context
+                            .read_by_baseline_into_buffer(0, 10, &mut by_bl)
+                            .unwrap();
+                        context
+                            .read_by_frequency_into_buffer(0, 10, &mut by_freq)
+                            .unwrap();
+                    }
+                    (by_bl, by_freq)
+                })
+            })
+            .collect();
+
+        for thread in threads {
+            let (by_bl, by_freq) = thread.join().unwrap();
+            assert_eq!(by_bl, expected_by_bl);
+            assert_eq!(by_freq, expected_by_freq);
+        }
+    }
+}
+
+#[test]
+fn test_read_batch_matches_single_reads() {
+    let metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let gpubox_filename =
+        "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    let hdu_floats = context.num_timestep_coarse_chan_floats;
+    // Read the same HDU twice, to check each output chunk is filled in order
+    let timestep_indices = [0, 0];
+    let coarse_chan_indices = [10];
+
+    let mut batch_by_bl = vec![0.; 2 * hdu_floats];
+    context
+        .read_by_baseline_batch(&timestep_indices, &coarse_chan_indices, &mut batch_by_bl)
+        .expect("Batch read by baseline failed");
+
+    let mut batch_by_freq = vec![0.; 2 * hdu_floats];
+    context
+        .read_by_frequency_batch(&timestep_indices, &coarse_chan_indices, &mut batch_by_freq)
+        .expect("Batch read by frequency failed");
+
+    let single_by_bl = context.read_by_baseline(0, 10).unwrap();
+    let single_by_freq = context.read_by_frequency(0, 10).unwrap();
+
+    assert_eq!(&batch_by_bl[..hdu_floats], &single_by_bl[..]);
+    assert_eq!(&batch_by_bl[hdu_floats..], &single_by_bl[..]);
+    assert_eq!(&batch_by_freq[..hdu_floats], &single_by_freq[..]);
+    assert_eq!(&batch_by_freq[hdu_floats..], &single_by_freq[..]);
+}
+
+#[test]
+fn test_read_batch_errors() {
+    let metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let gpubox_filename =
+        "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    let hdu_floats = context.num_timestep_coarse_chan_floats;
+
+    // Buffer is the wrong size
+    let mut buffer = vec![0.; hdu_floats + 1];
+    let result = context.read_by_baseline_batch(&[0], &[10], &mut buffer);
+    assert!(
+        matches!(result, Err(GpuboxError::InvalidBufferSize(l, e)) if l == hdu_floats + 1 && e == hdu_floats)
+    );
+
+    // One of the requested HDUs has no data
+    let mut buffer = vec![0.; 2 * hdu_floats];
+    let result = context.read_by_baseline_batch(&[0], &[0, 10], &mut buffer);
+    assert!(matches!(
+        result,
+        Err(GpuboxError::NoDataForTimeStepCoarseChannel { .. })
+    ));
+
+    // Nothing requested is not an error
+    let mut buffer: Vec<f32> = vec![];
+    assert!(context
+        .read_by_frequency_batch(&[], &[10], &mut buffer)
+        .is_ok());
+}
+
+#[test]
+fn test_read_reuses_scratch_buffers() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    let mut buffer: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_floats];
+
+    // The first read allocates a scratch buffer...
+    context
+        .read_by_baseline_into_buffer(0, 0, &mut buffer)
+        .unwrap();
+    let first_read = buffer.clone();
+    assert_eq!(context.scratch_buffers.len(), 1);
+
+    // ...and subsequent reads (of either kind) reuse it
+    context
+        .read_by_frequency_into_buffer(0, 0, &mut buffer)
+        .unwrap();
+    context
+        .read_by_baseline_into_buffer(0, 0, &mut buffer)
+        .unwrap();
+    assert_eq!(context.scratch_buffers.len(), 1);
+
+    // Reusing the scratch buffer must not change the result
+    assert_eq!(first_read, buffer);
+}
+
+#[test]
+fn test_read_with_weights_mwax() {
+    let mwax_metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let mwax_filename = "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+
+    //
+    // Read the visibility and weights HDUs directly using FITS
+    //
+    let mut fptr = fits_open!(&mwax_filename).unwrap();
+    let fits_hdu = fits_open_hdu!(&mut fptr, 1).unwrap();
+    let fits_hdu_data: Vec<f32> = get_fits_image!(&mut fptr, &fits_hdu).unwrap();
+    let fits_weights_hdu = fits_open_hdu!(&mut fptr, 2).unwrap();
+    let fits_weights_data: Vec<f32> = get_fits_image!(&mut fptr, &fits_weights_hdu).unwrap();
+
+    let gpuboxfiles = vec![mwax_filename];
+    let context = CorrelatorContext::new(&mwax_metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // The weights HDU follows the visibility HDU
+    let unix_time_ms = context.timesteps[0].unix_time_ms;
+    let gpubox_number = context.coarse_chans[10].gpubox_number;
+    let (_, hdu_index) = context.gpubox_time_map[&unix_time_ms][&gpubox_number];
+    assert_eq!(hdu_index, 1);
+    assert_eq!(
+        context.gpubox_hdu_locations[10].unwrap().weights_hdu_index,
+        Some(2)
+    );
+    assert_eq!(
+        context.num_timestep_coarse_chan_weight_floats,
+        fits_weights_data.len()
+    );
+
+    let mut buffer: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_floats];
+    let mut weights_buffer: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_weight_floats];
+
+    // By baseline, the data should match the fits file exactly
+    context
+        .read_by_baseline_with_weights_into_buffer(0, 10, &mut buffer, &mut weights_buffer)
+        .expect("Error!");
+    assert_eq!(buffer, fits_hdu_data);
+    assert_eq!(weights_buffer, fits_weights_data);
+
+    // By frequency, the data should match a plain read by frequency
+    let mut weights_buffer: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_weight_floats];
+    context
+        .read_by_frequency_with_weights_into_buffer(0, 10, &mut buffer, &mut weights_buffer)
+        .expect("Error!");
+    assert_eq!(buffer, context.read_by_frequency(0, 10).unwrap());
+    assert_eq!(weights_buffer, fits_weights_data);
+
+    // Incorrectly sized weights buffer
+    let mut small_weights_buffer: Vec<f32> = vec![0.; 1];
+    let result = context.read_by_baseline_with_weights_into_buffer(
+        0,
+        10,
+        &mut buffer,
+        &mut small_weights_buffer,
+    );
+    assert!(matches!(result, Err(GpuboxError::InvalidBufferSize(1, _))));
+}
+
+#[test]
+fn test_read_with_weights_legacy() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // Legacy correlator observations have no weights
+    assert_eq!(context.num_timestep_coarse_chan_weight_floats, 0);
+
+    let mut buffer: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_floats];
+    let mut weights_buffer: Vec<f32> = vec![];
+    let result =
+        context.read_by_frequency_with_weights_into_buffer(0, 0, &mut buffer, &mut weights_buffer);
+    assert!(matches!(
+        result,
+        Err(GpuboxError::NoWeightsForMwaVersion {
+            mwa_version: MWAVersion::CorrLegacy
+        })
+    ));
+}
+
+#[test]
+fn test_read_raw_into_buffer_invalid_inputs() {
+    let mwax_metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let mwax_filename = "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![mwax_filename];
+    let context = CorrelatorContext::new(&mwax_metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    let mut buffer: Vec<i32> = vec![0; context.num_timestep_coarse_chan_floats];
+
+    // Invalid indices
+    assert!(matches!(
+        context.read_raw_into_buffer(99, 10, &mut buffer),
+        Err(GpuboxError::InvalidTimeStepIndex(_))
+    ));
+    assert!(matches!(
+        context.read_raw_into_buffer(0, 99, &mut buffer),
+        Err(GpuboxError::InvalidCoarseChanIndex(_))
+    ));
+
+    // Incorrectly sized buffer
+    let mut small_buffer: Vec<i32> = vec![0; 1];
+    assert!(matches!(
+        context.read_raw_into_buffer(0, 10, &mut small_buffer),
+        Err(GpuboxError::InvalidBufferSize(1, _))
+    ));
+
+    // This test file was written with float compression, so has no raw integers to read
+    assert!(matches!(
+        context.read_raw_into_buffer(0, 10, &mut buffer),
+        Err(GpuboxError::Fits(FitsError::NotIntegerImage { .. }))
+    ));
+}
+
+#[test]
+fn test_read_raw_into_buffer_legacy() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // Legacy correlator files store floats
+    let mut buffer: Vec<i32> = vec![0; context.num_timestep_coarse_chan_floats];
+    assert!(matches!(
+        context.read_raw_into_buffer(0, 0, &mut buffer),
+        Err(GpuboxError::Fits(FitsError::NotIntegerImage {
+            bitpix: -32,
+            ..
+        }))
+    ));
+}
+
+#[test]
+fn test_read_autos_matches_full_read() {
+    let mwax_metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let mwax_filename = "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let legacy_metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let legacy_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+
+    for &(metafits_filename, gpubox_filename, coarse_chan_index) in &[
+        (mwax_metafits_filename, mwax_filename, 10),
+        (legacy_metafits_filename, legacy_filename, 0),
+    ] {
+        let gpuboxfiles = vec![gpubox_filename];
+        let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+            .expect("Failed to create CorrelatorContext");
+
+        let num_ants = context.metafits_context.num_ants;
+        assert_eq!(context.auto_baseline_indices.len(), num_ants);
+
+        let floats_per_baseline =
+            context.num_timestep_coarse_chan_floats / context.metafits_context.num_baselines;
+        let mut autos: Vec<f32> = vec![0.; num_ants * floats_per_baseline];
+        context
+            .read_autos_into_buffer(0, coarse_chan_index, &mut autos)
+            .expect("Error!");
+
+        let full = context.read_by_baseline(0, coarse_chan_index).unwrap();
+        for (ant, auto) in autos.chunks(floats_per_baseline).enumerate() {
+            let baseline_index = context.auto_baseline_indices[ant];
+            let baseline = &context.metafits_context.baselines[baseline_index];
+            assert_eq!(baseline.ant1_index, ant);
+            assert_eq!(baseline.ant2_index, ant);
+            assert_eq!(
+                auto,
+                &full[baseline_index * floats_per_baseline
+                    ..(baseline_index + 1) * floats_per_baseline]
+            );
+        }
+
+        // Incorrectly sized buffer
+        let mut small_buffer: Vec<f32> = vec![0.; 1];
+        assert!(matches!(
+            context.read_autos_into_buffer(0, coarse_chan_index, &mut small_buffer),
+            Err(GpuboxError::InvalidBufferSize(1, _))
+        ));
+    }
+}
+
+#[cfg(test)]
+/// Helper to average a HDU in [baseline][frequency][pol][r][i] order over groups of fine channels, the slow way.
+fn average_hdu_over_fine_chans(
+    hdu: &[f32],
+    num_fine_chans: usize,
+    num_visibility_pols: usize,
+    freq_factor: usize,
+) -> Vec<f32> {
+    let chan_floats = num_visibility_pols * 2;
+    let mut averaged = vec![0.0; hdu.len() / freq_factor];
+
+    for (i, chunk) in hdu.chunks(chan_floats * freq_factor).enumerate() {
+        for v in 0..chan_floats {
+            let sum: f32 = (0..freq_factor).map(|c| chunk[c * chan_floats + v]).sum();
+            averaged[i * chan_floats + v] = sum / freq_factor as f32;
+        }
+    }
+    assert_eq!(
+        averaged.len(),
+        hdu.len() / num_fine_chans * (num_fine_chans / freq_factor)
+    );
+
+    averaged
+}
+
+#[test]
+fn test_read_averaged_mwax() {
+    let mwax_metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let mwax_filename = "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![mwax_filename];
+    let context = CorrelatorContext::new(&mwax_metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    let num_fine_chans = context.metafits_context.num_corr_fine_chans_per_coarse;
+    let num_pols = context.metafits_context.num_visibility_pols;
+    let freq_factor = 4;
+
+    let (num_averaged_timesteps, num_averaged_fine_chans) = context
+        .get_averaged_dimensions_for_timesteps(context.num_common_timesteps, 1, freq_factor)
+        .unwrap();
+    assert_eq!(num_averaged_timesteps, 1);
+    assert_eq!(num_averaged_fine_chans, num_fine_chans / freq_factor);
+
+    let mut buffer: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_floats / freq_factor];
+    let mut weights_buffer: Vec<f32> = vec![0.; buffer.len() / 2];
+    context
+        .read_timesteps_averaged_into_buffer(
+            &context.common_timestep_indices,
+            10,
+            1,
+            freq_factor,
+            &mut buffer,
+            &mut weights_buffer,
+        )
+        .expect("Error!");
+
+    // One timestep weighted by a constant (per baseline and pol) is just the mean over fine chans
+    let mut full_buffer: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_floats];
+    let mut full_weights: Vec<f32> = vec![0.; context.num_timestep_coarse_chan_weight_floats];
+    context
+        .read_by_baseline_with_weights_into_buffer(0, 10, &mut full_buffer, &mut full_weights)
+        .unwrap();
+    let expected = average_hdu_over_fine_chans(&full_buffer, num_fine_chans, num_pols, freq_factor);
+
+    for (averaged, expected) in buffer.iter().zip(expected.iter()) {
+        assert!((averaged - expected).abs() <= 1e-5 * expected.abs().max(1.0));
+    }
+
+    // The weights are summed over the fine chans of each average
+    for (i, weight) in weights_buffer.iter().enumerate() {
+        let baseline = i / (num_averaged_fine_chans * num_pols);
+        let pol = i % num_pols;
+        assert!(approx_eq!(
+            f32,
+            *weight,
+            full_weights[baseline * num_pols + pol] * freq_factor as f32,
+            F32Margin::default()
+        ));
+    }
+}
+
+#[test]
+fn test_read_averaged_legacy() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    let num_fine_chans = context.metafits_context.num_corr_fine_chans_per_coarse;
+    let num_pols = context.metafits_context.num_visibility_pols;
+    let freq_factor = 2;
+
+    // Average the one timestep with itself, plus a final partial group of one
+    let timesteps = vec![0, 0, 0];
+    let (num_averaged_timesteps, _) = context
+        .get_averaged_dimensions_for_timesteps(timesteps.len(), 2, freq_factor)
+        .unwrap();
+    assert_eq!(num_averaged_timesteps, 2);
+
+    let averaged_floats = context.num_timestep_coarse_chan_floats / freq_factor;
+    let mut buffer: Vec<f32> = vec![0.; num_averaged_timesteps * averaged_floats];
+    let mut weights_buffer: Vec<f32> = vec![0.; buffer.len() / 2];
+    context
+        .read_timesteps_averaged_into_buffer(
+            &timesteps,
+            0,
+            2,
+            freq_factor,
+            &mut buffer,
+            &mut weights_buffer,
+        )
+        .expect("Error!");
+
+    let expected = average_hdu_over_fine_chans(
+        &context.read_by_baseline(0, 0).unwrap(),
+        num_fine_chans,
+        num_pols,
+        freq_factor,
+    );
+
+    for averaged_timestep in buffer.chunks(averaged_floats) {
+        for (averaged, expected) in averaged_timestep.iter().zip(expected.iter()) {
+            assert!((averaged - expected).abs() <= 1e-5 * expected.abs().max(1.0));
+        }
+    }
+
+    // Legacy data has no weights, so the weights count the visibilities in each average
+    let (first, last) = weights_buffer.split_at(averaged_floats / 2);
+    assert!(first.iter().all(|&w| w == (2 * freq_factor) as f32));
+    assert!(last.iter().all(|&w| w == freq_factor as f32));
+}
+
+#[test]
+fn test_read_averaged_invalid_inputs() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // Bad averaging factors
+    for &(time_factor, freq_factor) in &[(0, 1), (1, 0), (1, 3)] {
+        assert!(matches!(
+            context.get_averaged_dimensions(time_factor, freq_factor),
+            Err(GpuboxError::InvalidAveragingFactor {
+                num_fine_chans: 128,
+                ..
+            })
+        ));
+    }
+
+    // Incorrectly sized buffers
+    let averaged_floats = context.num_timestep_coarse_chan_floats / 2;
+    let mut buffer: Vec<f32> = vec![0.; averaged_floats];
+    let mut weights_buffer: Vec<f32> = vec![0.; averaged_floats / 2];
+    let mut small_buffer: Vec<f32> = vec![0.; 1];
+    assert!(matches!(
+        context.read_timesteps_averaged_into_buffer(
+            &[0],
+            0,
+            1,
+            2,
+            &mut small_buffer,
+            &mut weights_buffer
+        ),
+        Err(GpuboxError::InvalidBufferSize(1, _))
+    ));
+    assert!(matches!(
+        context.read_timesteps_averaged_into_buffer(&[0], 0, 1, 2, &mut buffer, &mut small_buffer),
+        Err(GpuboxError::InvalidBufferSize(1, _))
+    ));
+
+    // This observation has no common good timesteps, so there is nothing to average
+    assert_eq!(context.get_averaged_dimensions(2, 2).unwrap(), (0, 64));
+    assert!(context
+        .read_by_baseline_averaged_into_buffer(0, 2, 2, &mut [], &mut [])
+        .is_ok());
+}
+
+#[test]
+fn test_read_subset_matches_full_read() {
+    let legacy_metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let legacy_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let mwax_metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let mwax_filename = "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+
+    for (metafits_filename, gpubox_filename, coarse_chan_index) in &[
+        (legacy_metafits_filename, legacy_filename, 0),
+        (mwax_metafits_filename, mwax_filename, 10),
+    ] {
+        let gpuboxfiles = vec![*gpubox_filename];
+        let context = CorrelatorContext::new(metafits_filename, &gpuboxfiles)
+            .expect("Failed to create CorrelatorContext");
+
+        let num_baselines = context.metafits_context.num_baselines;
+        let num_fine_chans = context.metafits_context.num_corr_fine_chans_per_coarse;
+        let floats_per_baseline_fine_chan = context.metafits_context.num_visibility_pols * 2;
+
+        // A mixture of runs of consecutive baselines and out of order baselines
+        let baseline_indices = vec![0, 1, 2, 500, 7, num_baselines - 1];
+        let fine_chan_range = 3..num_fine_chans - 1;
+
+        let full_by_bl = context.read_by_baseline(0, *coarse_chan_index).unwrap();
+        let full_by_freq = context.read_by_frequency(0, *coarse_chan_index).unwrap();
+
+        let subset_len =
+            baseline_indices.len() * fine_chan_range.len() * floats_per_baseline_fine_chan;
+        let mut subset_by_bl = vec![0.; subset_len];
+        let mut subset_by_freq = vec![0.; subset_len];
+        context
+            .read_by_baseline_subset_into_buffer(
+                0,
+                *coarse_chan_index,
+                &baseline_indices,
+                fine_chan_range.clone(),
+                &mut subset_by_bl,
+            )
+            .unwrap();
+        context
+            .read_by_frequency_subset_into_buffer(
+                0,
+                *coarse_chan_index,
+                &baseline_indices,
+                fine_chan_range.clone(),
+                &mut subset_by_freq,
+            )
+            .unwrap();
+
+        for (subset_bl, &b) in baseline_indices.iter().enumerate() {
+            for (subset_fc, f) in fine_chan_range.clone().enumerate() {
+                let full_bl_index = (b * num_fine_chans + f) * floats_per_baseline_fine_chan;
+                let full_freq_index = (f * num_baselines + b) * floats_per_baseline_fine_chan;
+                let subset_bl_index =
+                    (subset_bl * fine_chan_range.len() + subset_fc) * floats_per_baseline_fine_chan;
+                let subset_freq_index = (subset_fc * baseline_indices.len() + subset_bl)
+                    * floats_per_baseline_fine_chan;
+
+                assert_eq!(
+                    full_by_bl[full_bl_index..full_bl_index + floats_per_baseline_fine_chan],
+                    subset_by_bl[subset_bl_index..subset_bl_index + floats_per_baseline_fine_chan]
+                );
+                assert_eq!(
+                    full_by_freq[full_freq_index..full_freq_index + floats_per_baseline_fine_chan],
+                    subset_by_freq
+                        [subset_freq_index..subset_freq_index + floats_per_baseline_fine_chan]
+                );
+            }
+        }
+    }
+}
+
+#[test]
+fn test_read_subset_invalid_inputs() {
+    let metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let gpubox_filename =
+        "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    let num_baselines = context.metafits_context.num_baselines;
+    let num_fine_chans = context.metafits_context.num_corr_fine_chans_per_coarse;
+    let mut buffer: Vec<f32> = vec![0.; 8];
+
+    // Baseline out of range
+    let result =
+        context.read_by_baseline_subset_into_buffer(0, 10, &[num_baselines], 0..1, &mut buffer);
+    assert!(matches!(result, Err(GpuboxError::InvalidBaselineIndex(_))));
+
+    // Fine channels out of range
+    let result = context.read_by_frequency_subset_into_buffer(
+        0,
+        10,
+        &[0],
+        num_fine_chans..num_fine_chans + 1,
+        &mut buffer,
+    );
+    assert!(matches!(
+        result,
+        Err(GpuboxError::InvalidFineChanRange { .. })
+    ));
+
+    // Wrong sized buffer
+    let result = context.read_by_baseline_subset_into_buffer(0, 10, &[0, 1], 0..1, &mut buffer);
+    assert!(matches!(result, Err(GpuboxError::InvalidBufferSize(8, 16))));
+
+    // An empty subset reads nothing
+    let mut buffer: Vec<f32> = vec![];
+    assert!(context
+        .read_by_frequency_subset_into_buffer(0, 10, &[], 0..num_fine_chans, &mut buffer)
+        .is_ok());
+}
+
+#[test]
+fn test_read_stats() {
+    let metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let gpubox_filename =
+        "test_files/1244973688_1_timestep/1244973688_20190619100110_ch114_000.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // Reads are not counted until collection is enabled, but the time map time always is
+    context.read_by_baseline(0, 10).unwrap();
+    let stats = context.get_stats();
+    assert_eq!(stats.bytes_read, 0);
+    assert_eq!(stats.hdu_seeks, 0);
+    assert!(stats.time_map_time_ns > 0);
+
+    context.set_stats_enabled(true);
+    context.read_by_baseline(0, 10).unwrap();
+    context.read_by_frequency(0, 10).unwrap();
+    let stats = context.get_stats();
+    assert_eq!(
+        stats.bytes_read,
+        2 * context.num_timestep_coarse_chan_bytes as u64
+    );
+    assert_eq!(stats.file_opens, 2);
+    assert_eq!(stats.hdu_seeks, 2);
+
+    context.reset_stats();
+    let reset_stats = context.get_stats();
+    assert_eq!(reset_stats.bytes_read, 0);
+    assert_eq!(reset_stats.convert_time_ns, 0);
+    assert_eq!(reset_stats.time_map_time_ns, stats.time_map_time_ns);
+}
@@ -0,0 +1,28 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Errors associated with data sources.
+*/
+use thiserror::Error;
+
+#[derive(Error, Debug)]
+pub enum DataSourceError {
+    #[error("Error reading {0}: {1}")]
+    Io(String, String),
+
+    #[error("The range of {size} bytes at offset {offset} is beyond the end of {filename} ({file_size} bytes)")]
+    OutOfRange {
+        filename: String,
+        offset: u64,
+        size: u64,
+        file_size: u64,
+    },
+
+    #[error("{0} is not a valid tar archive: {1}")]
+    InvalidTar(String, String),
+
+    #[error("{1} was not found in tar archive {0}")]
+    TarMemberNotFound(String, String),
+}
@@ -0,0 +1,724 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Sources of gpubox and voltage file data other than files on the local filesystem.
+
+Normally a context opens each gpubox or voltage file by its filename. A `DataSource` instead
+supplies the bytes of a file by offset, so that files held in memory, members of a tar archive or
+objects in a remote store (e.g. via HTTP range requests, by implementing `DataSource`) can be read
+without first being copied to disk. Sources are registered by filename in a `DataSources`, which
+is given to `CorrelatorContextBuilder::with_data_sources` or
+`VoltageContextBuilder::with_data_sources`. The gpubox or voltage filenames given to the builder
+(which must still follow the usual naming conventions) are looked up there before the filesystem.
+
+Voltage files are always read by byte range. cfitsio can only read gpubox files from disk or
+memory, so gpubox files are read in place from sources which hold their bytes in memory or memory
+map them (see `DataSource::as_bytes`), such as `MemorySource` and `FileRangeSource`, and are
+otherwise read into memory in full once, the first time they are opened. The metafits file is
+always read from disk.
+ */
+pub mod error;
+pub use error::DataSourceError;
+
+use std::cell::UnsafeCell;
+use std::collections::HashMap;
+use std::ffi::CString;
+use std::fmt;
+use std::fs::File;
+use std::io;
+use std::path::Path;
+use std::ptr;
+use std::sync::{Arc, Mutex, MutexGuard};
+
+use fitsio::{FileOpenMode, FitsFile};
+
+use crate::file_io::{self, FileMap};
+use crate::*;
+
+#[cfg(test)]
+mod test;
+
+/// Size of tar headers and of the blocks tar member data is padded to.
+const TAR_BLOCK_SIZE: u64 = 512;
+
+/// The bytes of one gpubox or voltage file, read by offset. Implementations must be safe to read
+/// from many threads at once.
+pub trait DataSource: fmt::Debug + Send + Sync {
+    /// Returns the size of the file in bytes.
+    fn size(&self) -> io::Result<u64>;
+
+    /// Read exactly `buffer.len()` bytes of the file, starting at `offset`.
+    ///
+    /// # Arguments
+    ///
+    /// * `buffer` - the buffer to fill.
+    ///
+    /// * `offset` - the offset in the file to read from.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An io::Result of Ok if the buffer was filled
+    ///
+    fn read_exact_at(&self, buffer: &mut [u8], offset: u64) -> io::Result<()>;
+
+    /// Returns the whole file, if the source holds it in memory (or memory maps it), so it can
+    /// be read without a copy. The default is None.
+    fn as_bytes(&self) -> Option<&[u8]> {
+        None
+    }
+}
+
+/// Read exactly `buffer.len()` bytes of `bytes` from `offset`, failing if that is past the end.
+fn read_exact_from_slice(bytes: &[u8], buffer: &mut [u8], offset: u64) -> io::Result<()> {
+    let end = offset
+        .checked_add(buffer.len() as u64)
+        .filter(|end| *end <= bytes.len() as u64)
+        .ok_or_else(|| io::Error::from(io::ErrorKind::UnexpectedEof))?;
+    buffer.copy_from_slice(&bytes[offset as usize..end as usize]);
+    Ok(())
+}
+
+/// A file held in memory.
+#[derive(Clone)]
+pub struct MemorySource {
+    data: Arc<[u8]>,
+}
+
+impl MemorySource {
+    /// Create a source from the bytes of a file.
+    ///
+    /// # Arguments
+    ///
+    /// * `data` - the whole file, e.g. a `Vec<u8>`.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A MemorySource
+    ///
+    pub fn new<D: Into<Arc<[u8]>>>(data: D) -> Self {
+        Self { data: data.into() }
+    }
+}
+
+impl DataSource for MemorySource {
+    fn size(&self) -> io::Result<u64> {
+        Ok(self.data.len() as u64)
+    }
+
+    fn read_exact_at(&self, buffer: &mut [u8], offset: u64) -> io::Result<()> {
+        read_exact_from_slice(&self.data, buffer, offset)
+    }
+
+    fn as_bytes(&self) -> Option<&[u8]> {
+        Some(&self.data)
+    }
+}
+
+/// Implements fmt::Debug for MemorySource struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for MemorySource {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(f, "MemorySource {{ size: {} }}", self.data.len())
+    }
+}
+
+/// A range of bytes within a local file (e.g. a member of a tar archive), mapped read-only into
+/// memory. Only the parts which are read are ever read from disk (on platforms without `mmap`,
+/// the range is read into memory when the source is created instead).
+pub struct FileRangeSource {
+    /// Filename of the file containing the range.
+    filename: String,
+    /// The mapping of the range.
+    map: FileMap,
+}
+
+impl FileRangeSource {
+    /// Map a range of a local file into memory.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the file containing the range.
+    ///
+    /// * `offset` - the offset of the start of the range in the file.
+    ///
+    /// * `size` - the length of the range in bytes.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the mapped range, or a DataSourceError if the file cannot be mapped or is too small.
+    ///
+    pub fn new<P: AsRef<Path>>(
+        filename: &P,
+        offset: u64,
+        size: u64,
+    ) -> Result<Self, DataSourceError> {
+        let filename = filename.as_ref().display().to_string();
+        let to_error = |e: io::Error| DataSourceError::Io(filename.clone(), e.to_string());
+
+        let file = File::open(&filename).map_err(to_error)?;
+        let file_size = file.metadata().map_err(to_error)?.len();
+        if offset.checked_add(size).map_or(true, |end| end > file_size) {
+            return Err(DataSourceError::OutOfRange {
+                filename,
+                offset,
+                size,
+                file_size,
+            });
+        }
+
+        let map = FileMap::new(&file, offset, size as usize, false).map_err(to_error)?;
+
+        // The file can be closed now; the mapping keeps its own reference to it.
+        Ok(Self { filename, map })
+    }
+
+    /// Returns the filename of the file containing the range.
+    pub fn filename(&self) -> &str {
+        &self.filename
+    }
+
+    /// Returns the bytes of the range.
+    fn bytes(&self) -> &[u8] {
+        self.map.as_bytes()
+    }
+}
+
+impl DataSource for FileRangeSource {
+    fn size(&self) -> io::Result<u64> {
+        Ok(self.bytes().len() as u64)
+    }
+
+    fn read_exact_at(&self, buffer: &mut [u8], offset: u64) -> io::Result<()> {
+        read_exact_from_slice(self.bytes(), buffer, offset)
+    }
+
+    fn as_bytes(&self) -> Option<&[u8]> {
+        Some(self.bytes())
+    }
+}
+
+/// Implements fmt::Debug for FileRangeSource struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for FileRangeSource {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "FileRangeSource {{ filename: {}, size: {} }}",
+            self.filename,
+            self.bytes().len()
+        )
+    }
+}
+
+/// A regular file within a tar archive.
+#[derive(Clone, Debug, PartialEq)]
+pub struct TarMember {
+    /// Name (path) of the member within the archive.
+    pub name: String,
+    /// Offset of the member's data within the archive.
+    pub offset: u64,
+    /// Size of the member in bytes.
+    pub size: u64,
+}
+
+/// The index of a (ustar, GNU or pax) tar archive on a local filesystem, so that its members can
+/// be read in place rather than extracted. Only the headers are read when it is opened.
+#[derive(Clone, Debug)]
+pub struct TarArchive {
+    /// Filename of the archive.
+    filename: String,
+    /// The regular files in the archive, in archive order.
+    members: Vec<TarMember>,
+}
+
+/// Returns the bytes of a NUL terminated (or NUL padded) tar header field.
+fn tar_field(field: &[u8]) -> &[u8] {
+    match field.iter().position(|b| *b == 0) {
+        Some(len) => &field[..len],
+        None => field,
+    }
+}
+
+/// Parse a numeric tar header field, which is octal, or big-endian base-256 if the high bit of
+/// its first byte is set (used by GNU tar for sizes over 8 GiB).
+fn parse_tar_number(field: &[u8]) -> Option<u64> {
+    if field[0] & 0x80 != 0 {
+        return field[1..]
+            .iter()
+            .try_fold(u64::from(field[0] & 0x7f), |value, b| {
+                value.checked_mul(256).map(|v| v + u64::from(*b))
+            });
+    }
+
+    let digits = std::str::from_utf8(tar_field(field)).ok()?;
+    let digits = digits.trim_matches(|c| c == ' ' || c == '\0');
+    if digits.is_empty() {
+        return Some(0);
+    }
+    u64::from_str_radix(digits, 8).ok()
+}
+
+/// The "path" and "size" records of a pax extended header, which override the fields of the
+/// header which follows it.
+fn parse_pax_records(data: &[u8]) -> (Option<String>, Option<u64>) {
+    let mut path = None;
+    let mut size = None;
+    let mut rest = data;
+
+    // Each record is "<length> <key>=<value>\n", where the length includes the whole record
+    while let Some(space) = rest.iter().position(|b| *b == b' ') {
+        let len: usize = match std::str::from_utf8(&rest[..space])
+            .ok()
+            .and_then(|l| l.parse().ok())
+        {
+            Some(len) if len > space && len <= rest.len() => len,
+            _ => break,
+        };
+        let record = &rest[space + 1..len];
+        let record = record.strip_suffix(b"\n").unwrap_or(record);
+        if let Some(equals) = record.iter().position(|b| *b == b'=') {
+            let value = String::from_utf8_lossy(&record[equals + 1..]).to_string();
+            match &record[..equals] {
+                b"path" => path = Some(value),
+                b"size" => size = value.parse().ok(),
+                _ => {}
+            }
+        }
+        rest = &rest[len..];
+    }
+
+    (path, size)
+}
+
+impl TarArchive {
+    /// Read the index of a tar archive.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the tar archive.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the index of the archive, or a DataSourceError if it cannot be read or is not a tar archive.
+    ///
+    pub fn open<P: AsRef<Path>>(filename: &P) -> Result<Self, DataSourceError> {
+        let filename = filename.as_ref().display().to_string();
+        let to_error = |e: io::Error| DataSourceError::Io(filename.clone(), e.to_string());
+        let invalid = |message: &str| DataSourceError::InvalidTar(filename.clone(), message.into());
+
+        let file = File::open(&filename).map_err(to_error)?;
+        let archive_size = file.metadata().map_err(to_error)?.len();
+
+        let mut members = Vec::new();
+        let mut header = [0u8; TAR_BLOCK_SIZE as usize];
+        let mut header_offset = 0;
+        // Set by a GNU long name or pax header, for the next member
+        let mut next_name: Option<String> = None;
+        let mut next_size: Option<u64> = None;
+
+        // A block of zeros (or the end of the file) marks the end of the archive
+        while header_offset + TAR_BLOCK_SIZE <= archive_size {
+            file_io::read_exact_at(&file, &mut header, header_offset).map_err(to_error)?;
+            if header.iter().all(|b| *b == 0) {
+                break;
+            }
+
+            // The checksum is the sum of the header bytes, with the checksum field as spaces
+            let checksum: u64 = header
+                .iter()
+                .enumerate()
+                .map(|(i, b)| {
+                    if (148..156).contains(&i) {
+                        32
+                    } else {
+                        u64::from(*b)
+                    }
+                })
+                .sum();
+            if parse_tar_number(&header[148..156]) != Some(checksum) {
+                return Err(invalid(&format!(
+                    "bad header checksum at offset {}",
+                    header_offset
+                )));
+            }
+
+            let header_size = parse_tar_number(&header[124..136])
+                .ok_or_else(|| invalid(&format!("bad size at offset {}", header_offset)))?;
+            let size = next_size.take().unwrap_or(header_size);
+            let data_offset = header_offset + TAR_BLOCK_SIZE;
+            // The size is untrusted, so the end of the member (padded to a whole block) is
+            // checked for overflow as well as against the size of the archive
+            let next_header_offset = data_offset
+                .checked_add(size)
+                .filter(|data_end| *data_end <= archive_size)
+                .and_then(|_| size.checked_add(TAR_BLOCK_SIZE - 1))
+                .and_then(|padded| {
+                    data_offset.checked_add(padded / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE)
+                })
+                .ok_or_else(|| {
+                    invalid(&format!("member at offset {} is truncated", header_offset))
+                })?;
+
+            let read_data = || -> Result<Vec<u8>, DataSourceError> {
+                let mut data = vec![0u8; size as usize];
+                file_io::read_exact_at(&file, &mut data, data_offset).map_err(to_error)?;
+                Ok(data)
+            };
+
+            match header[156] {
+                // Regular files
+                b'0' | b'\0' | b'7' => {
+                    let name = match next_name.take() {
+                        Some(name) => name,
+                        None => {
+                            let name = String::from_utf8_lossy(tar_field(&header[0..100]));
+                            let prefix = tar_field(&header[345..500]);
+                            if &header[257..262] == b"ustar" && !prefix.is_empty() {
+                                format!("{}/{}", String::from_utf8_lossy(prefix), name)
+                            } else {
+                                name.to_string()
+                            }
+                        }
+                    };
+                    members.push(TarMember {
+                        name,
+                        offset: data_offset,
+                        size,
+                    });
+                }
+                // GNU long name of the next member
+                b'L' => {
+                    next_name = Some(String::from_utf8_lossy(tar_field(&read_data()?)).to_string())
+                }
+                // pax extended header of the next member
+                b'x' => {
+                    let (path, size) = parse_pax_records(&read_data()?);
+                    next_name = path.or(next_name);
+                    next_size = size;
+                }
+                // Directories, links, pax global headers etc. have no data to read
+                _ => {
+                    next_name = None;
+                }
+            }
+
+            header_offset = next_header_offset;
+        }
+
+        Ok(Self { filename, members })
+    }
+
+    /// Returns the filename of the archive.
+    pub fn filename(&self) -> &str {
+        &self.filename
+    }
+
+    /// Returns the regular files in the archive, in archive order.
+    pub fn members(&self) -> &[TarMember] {
+        &self.members
+    }
+
+    /// Returns a source for a member of the archive.
+    ///
+    /// # Arguments
+    ///
+    /// * `name` - the name (path) of the member within the archive.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the member, mapped into memory, or a DataSourceError if there is no such member.
+    ///
+    pub fn member(&self, name: &str) -> Result<FileRangeSource, DataSourceError> {
+        match self.members.iter().find(|m| m.name == name) {
+            Some(member) => FileRangeSource::new(&self.filename, member.offset, member.size),
+            None => Err(DataSourceError::TarMemberNotFound(
+                self.filename.clone(),
+                name.to_string(),
+            )),
+        }
+    }
+
+    /// Returns a `DataSources` with every member of the archive registered under its name, so
+    /// that the names of the gpubox or voltage files in the archive can be given to a context
+    /// builder.
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the DataSources, or a DataSourceError if a member cannot be mapped.
+    ///
+    pub fn data_sources(&self) -> Result<DataSources, DataSourceError> {
+        let mut data_sources = DataSources::new();
+        for member in &self.members {
+            data_sources.insert(
+                member.name.clone(),
+                Arc::new(FileRangeSource::new(
+                    &self.filename,
+                    member.offset,
+                    member.size,
+                )?),
+            );
+        }
+
+        Ok(data_sources)
+    }
+}
+
+/// The address and size of a gpubox file in memory, as given to cfitsio when opening it. cfitsio
+/// keeps pointers to these cells (rather than their values) for as long as the file is open, and
+/// writes the address and size back through them when the file is closed.
+struct FitsMemoryCells {
+    ptr: UnsafeCell<*mut libc::c_void>,
+    size: UnsafeCell<usize>,
+}
+
+/// A gpubox file in memory for cfitsio to read. This is kept until the `DataSources` is dropped.
+struct FitsMemoryBuffer {
+    ptr: *const u8,
+    size: usize,
+    /// The cells given to cfitsio, one pair for each time the file has been opened, so that files
+    /// closed at the same time never write to the same cells. cfitsio gives no way to tell when a
+    /// file has been closed, so they are kept (boxed, so they never move) with the buffer.
+    cells: Mutex<Vec<Box<FitsMemoryCells>>>,
+    /// The source `ptr` points into, or the copy of it which `ptr` points to.
+    _source: Arc<dyn DataSource>,
+    _data: Option<Vec<u8>>,
+}
+
+// The memory `ptr` points to is only ever read, by cfitsio opening it read-only. Each pair of
+// cells is only written by cfitsio, when closing the one file it was given to, and is never read
+// here after it has been handed over.
+unsafe impl Send for FitsMemoryBuffer {}
+unsafe impl Sync for FitsMemoryBuffer {}
+
+impl FitsMemoryBuffer {
+    /// Returns a new pair of cells holding the address and size of the buffer, for opening it
+    /// once. They are valid for as long as the buffer is.
+    fn new_cells(&self) -> *const FitsMemoryCells {
+        let cells = Box::new(FitsMemoryCells {
+            ptr: UnsafeCell::new(self.ptr as *mut libc::c_void),
+            size: UnsafeCell::new(self.size),
+        });
+        let cells_ptr: *const FitsMemoryCells = &*cells;
+
+        // Nothing is left half-updated by a panic, so a poisoned lock is simply recovered.
+        match self.cells.lock() {
+            Ok(mut guard) => guard.push(cells),
+            Err(poisoned) => poisoned.into_inner().push(cells),
+        }
+
+        cells_ptr
+    }
+}
+
+/// Data sources of the gpubox or voltage files of a context, by filename. Files without a
+/// source are read from the filesystem as normal. Clones share the same sources.
+#[derive(Clone, Default)]
+pub struct DataSources {
+    sources: HashMap<String, Arc<dyn DataSource>>,
+    /// The memory gpubox files have been opened from, by filename.
+    fits_buffers: Arc<Mutex<HashMap<String, Arc<FitsMemoryBuffer>>>>,
+}
+
+impl DataSources {
+    /// Creates an empty set of data sources, so every file is read from the filesystem.
+    ///
+    /// # Arguments
+    ///
+    /// None
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An empty DataSources
+    ///
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Register the source of a gpubox or voltage file, replacing any existing source of it.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the gpubox or voltage filename, exactly as it will be given to the context builder.
+    ///
+    /// * `source` - where to read the file from.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn insert<S: Into<String>>(&mut self, filename: S, source: Arc<dyn DataSource>) {
+        self.sources.insert(filename.into(), source);
+    }
+
+    /// Returns the source of a file, or None if it is read from the filesystem.
+    pub fn get(&self, filename: &str) -> Option<&Arc<dyn DataSource>> {
+        self.sources.get(filename)
+    }
+
+    /// Returns the number of files with a source.
+    pub fn len(&self) -> usize {
+        self.sources.len()
+    }
+
+    /// Returns true if no file has a source.
+    pub fn is_empty(&self) -> bool {
+        self.sources.is_empty()
+    }
+
+    /// Returns the size of a file, from its source or the filesystem.
+    pub(crate) fn file_size(&self, filename: &str) -> io::Result<u64> {
+        match self.get(filename) {
+            Some(source) => source.size(),
+            None => std::fs::metadata(filename).map(|m| m.len()),
+        }
+    }
+
+    /// Lock the gpubox file buffers. Nothing is left half-updated by a panic, so a poisoned
+    /// lock is simply recovered.
+    fn lock_fits_buffers(&self) -> MutexGuard<'_, HashMap<String, Arc<FitsMemoryBuffer>>> {
+        match self.fits_buffers.lock() {
+            Ok(guard) => guard,
+            Err(poisoned) => poisoned.into_inner(),
+        }
+    }
+
+    /// Returns the memory to open a gpubox file from, reading the file into memory if its
+    /// source does not already hold it there.
+    fn get_fits_buffer(
+        &self,
+        filename: &str,
+        source: &Arc<dyn DataSource>,
+    ) -> io::Result<Arc<FitsMemoryBuffer>> {
+        if let Some(buffer) = self.lock_fits_buffers().get(filename) {
+            return Ok(Arc::clone(buffer));
+        }
+
+        let mut data = None;
+        let (ptr, size) = match source.as_bytes() {
+            Some(bytes) => (bytes.as_ptr(), bytes.len()),
+            None => {
+                let mut bytes = vec![0u8; source.size()? as usize];
+                source.read_exact_at(&mut bytes, 0)?;
+                let ptr_and_size = (bytes.as_ptr(), bytes.len());
+                data = Some(bytes);
+                ptr_and_size
+            }
+        };
+        let buffer = Arc::new(FitsMemoryBuffer {
+            ptr,
+            size,
+            cells: Mutex::new(Vec::new()),
+            _source: Arc::clone(source),
+            _data: data,
+        });
+
+        // If another reader got here first, use theirs so there is only one buffer per file
+        Ok(Arc::clone(
+            self.lock_fits_buffers()
+                .entry(filename.to_string())
+                .or_insert(buffer),
+        ))
+    }
+
+    /// Open a gpubox file, from its source if it has one or otherwise from the filesystem.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the gpubox file to open.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the open file, or a FitsError if it could not be opened.
+    ///
+    pub(crate) fn open_fits(&self, filename: &str) -> Result<FitsFile, FitsError> {
+        let source = match self.get(filename) {
+            Some(source) => source,
+            None => return fits_open!(&filename),
+        };
+
+        let to_error = |fits_error: fitsio::errors::Error| FitsError::Open {
+            fits_error,
+            fits_filename: filename.to_string(),
+            source_file: file!(),
+            source_line: line!(),
+        };
+
+        let buffer = self
+            .get_fits_buffer(filename, source)
+            .map_err(|e| to_error(fitsio::errors::Error::Message(e.to_string())))?;
+        let c_filename = CString::new(filename)
+            .map_err(|e| to_error(fitsio::errors::Error::Message(e.to_string())))?;
+
+        let cells = buffer.new_cells();
+        let mut fptr = ptr::null_mut();
+        let mut status = 0;
+        // Safety: the buffer (and the memory and cells it points to) is kept until this
+        // DataSources and all of its clones are dropped, the file is only ever read, and these
+        // cells are given to no other file.
+        unsafe {
+            fitsio_sys::ffomem(
+                &mut fptr,
+                c_filename.as_ptr(),
+                fitsio_sys::READONLY as _,
+                (*cells).ptr.get(),
+                (*cells).size.get().cast(),
+                0,
+                None,
+                &mut status,
+            );
+        }
+        fitsio::errors::check_status(status).map_err(to_error)?;
+
+        unsafe { FitsFile::from_raw(fptr, FileOpenMode::READONLY) }.map_err(to_error)
+    }
+}
+
+/// Implements fmt::Debug for DataSources struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for DataSources {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        let mut filenames: Vec<&String> = self.sources.keys().collect();
+        filenames.sort();
+        write!(f, "DataSources {{ filenames: {:?} }}", filenames)
+    }
+}
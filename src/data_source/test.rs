@@ -0,0 +1,257 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for data sources
+*/
+#[cfg(test)]
+use super::*;
+use std::io::Write;
+
+/// Helper to build a tar header for a member.
+fn tar_header(name: &str, size: usize, typeflag: u8) -> Vec<u8> {
+    let mut header = vec![0u8; TAR_BLOCK_SIZE as usize];
+    header[..name.len()].copy_from_slice(name.as_bytes());
+    header[100..107].copy_from_slice(b"0000644");
+    header[124..135].copy_from_slice(format!("{:011o}", size).as_bytes());
+    header[156] = typeflag;
+    header[257..263].copy_from_slice(b"ustar\0");
+    header[263..265].copy_from_slice(b"00");
+
+    header[148..156].copy_from_slice(b"        ");
+    let checksum: u32 = header.iter().map(|b| u32::from(*b)).sum();
+    header[148..155].copy_from_slice(format!("{:06o}\0", checksum).as_bytes());
+
+    header
+}
+
+/// Helper to append a member (header and padded data) to a tar archive.
+fn append_tar_member(tar: &mut Vec<u8>, name: &str, data: &[u8], typeflag: u8) {
+    tar.extend(tar_header(name, data.len(), typeflag));
+    tar.extend(data);
+    let padding =
+        (TAR_BLOCK_SIZE as usize - data.len() % TAR_BLOCK_SIZE as usize) % TAR_BLOCK_SIZE as usize;
+    tar.extend(vec![0u8; padding]);
+}
+
+/// Helper to write a file into a temp dir and return its path.
+fn write_temp_file(temp_dir: &tempdir::TempDir, name: &str, data: &[u8]) -> std::path::PathBuf {
+    let filename = temp_dir.path().join(name);
+    let mut file = File::create(&filename).unwrap();
+    file.write_all(data).unwrap();
+    filename
+}
+
+#[test]
+fn test_memory_source() {
+    let source = MemorySource::new((0..100u8).collect::<Vec<u8>>());
+    assert_eq!(source.size().unwrap(), 100);
+    assert_eq!(source.as_bytes().unwrap().len(), 100);
+
+    let mut buffer = [0u8; 10];
+    source.read_exact_at(&mut buffer, 90).unwrap();
+    assert_eq!(buffer, [90, 91, 92, 93, 94, 95, 96, 97, 98, 99]);
+
+    // Reads past the end fail
+    assert_eq!(
+        source.read_exact_at(&mut buffer, 91).unwrap_err().kind(),
+        io::ErrorKind::UnexpectedEof
+    );
+}
+
+#[test]
+fn test_file_range_source() {
+    let temp_dir = tempdir::TempDir::new("data_source_test").unwrap();
+    let data: Vec<u8> = (0..10_000).map(|i| (i % 251) as u8).collect();
+    let filename = write_temp_file(&temp_dir, "data.bin", &data);
+
+    // An offset which is not page aligned
+    let source = FileRangeSource::new(&filename, 5_000, 3_000).unwrap();
+    assert_eq!(source.size().unwrap(), 3_000);
+    assert_eq!(source.as_bytes().unwrap(), &data[5_000..8_000]);
+
+    let mut buffer = vec![0u8; 100];
+    source.read_exact_at(&mut buffer, 2_900).unwrap();
+    assert_eq!(buffer, &data[7_900..8_000]);
+    assert!(source.read_exact_at(&mut buffer, 2_901).is_err());
+
+    let empty_source = FileRangeSource::new(&filename, 10_000, 0).unwrap();
+    assert_eq!(empty_source.as_bytes().unwrap(), &[] as &[u8]);
+
+    assert!(matches!(
+        FileRangeSource::new(&filename, 9_000, 1_001).unwrap_err(),
+        DataSourceError::OutOfRange {
+            offset: 9_000,
+            size: 1_001,
+            file_size: 10_000,
+            ..
+        }
+    ));
+}
+
+#[test]
+fn test_parse_tar_number() {
+    assert_eq!(parse_tar_number(b"00000001750\0"), Some(1000));
+    assert_eq!(parse_tar_number(b"     1750 \0\0"), Some(1000));
+    assert_eq!(parse_tar_number(b"\0\0\0\0\0\0\0\0\0\0\0\0"), Some(0));
+    assert_eq!(parse_tar_number(b"0000000175x\0"), None);
+
+    // GNU base-256, for sizes which do not fit in 11 octal digits
+    let mut base_256 = [0u8; 12];
+    base_256[0] = 0x80;
+    base_256[7] = 0x02;
+    assert_eq!(parse_tar_number(&base_256), Some(0x02_0000_0000));
+}
+
+#[test]
+fn test_tar_archive() {
+    let temp_dir = tempdir::TempDir::new("data_source_test").unwrap();
+
+    let long_name = format!("{}/1101503312_1101503312_ch123.dat", "a".repeat(100));
+    let mut tar = Vec::new();
+    append_tar_member(&mut tar, "obs/", &[], b'5');
+    append_tar_member(&mut tar, "obs/first.txt", b"first member", b'0');
+    append_tar_member(
+        &mut tar,
+        "././@LongLink",
+        format!("{}\0", long_name).as_bytes(),
+        b'L',
+    );
+    append_tar_member(&mut tar, "truncated_name", &[7u8; 600], b'0');
+    append_tar_member(&mut tar, "pax", b"20 path=obs/pax.txt\n", b'x');
+    append_tar_member(&mut tar, "ignored_name", b"pax member", b'0');
+    tar.extend(vec![0u8; 2 * TAR_BLOCK_SIZE as usize]);
+    let filename = write_temp_file(&temp_dir, "obs.tar", &tar);
+
+    let archive = TarArchive::open(&filename).unwrap();
+    let names: Vec<&str> = archive.members().iter().map(|m| m.name.as_str()).collect();
+    assert_eq!(
+        names,
+        vec!["obs/first.txt", long_name.as_str(), "obs/pax.txt"]
+    );
+    assert_eq!(archive.members()[0].offset, 2 * TAR_BLOCK_SIZE);
+    assert_eq!(archive.members()[1].size, 600);
+
+    let first = archive.member("obs/first.txt").unwrap();
+    assert_eq!(first.as_bytes().unwrap(), b"first member");
+    let long = archive.member(&long_name).unwrap();
+    assert_eq!(long.as_bytes().unwrap(), &[7u8; 600][..]);
+    assert!(matches!(
+        archive.member("obs/missing.txt").unwrap_err(),
+        DataSourceError::TarMemberNotFound(_, _)
+    ));
+
+    let data_sources = archive.data_sources().unwrap();
+    assert_eq!(data_sources.len(), 3);
+    assert_eq!(data_sources.file_size("obs/pax.txt").unwrap(), 10);
+    let mut buffer = [0u8; 3];
+    data_sources
+        .get("obs/pax.txt")
+        .unwrap()
+        .read_exact_at(&mut buffer, 4)
+        .unwrap();
+    assert_eq!(&buffer, b"mem");
+}
+
+#[test]
+fn test_tar_archive_invalid() {
+    let temp_dir = tempdir::TempDir::new("data_source_test").unwrap();
+
+    let mut tar = Vec::new();
+    append_tar_member(&mut tar, "first.txt", b"first member", b'0');
+    // Corrupt the header
+    tar[0] = b'F';
+    let filename = write_temp_file(&temp_dir, "bad.tar", &tar);
+    assert!(matches!(
+        TarArchive::open(&filename).unwrap_err(),
+        DataSourceError::InvalidTar(_, _)
+    ));
+
+    // A member which runs past the end of the archive
+    let mut tar = Vec::new();
+    append_tar_member(&mut tar, "first.txt", &[1u8; 1000], b'0');
+    tar.truncate(TAR_BLOCK_SIZE as usize + 100);
+    let filename = write_temp_file(&temp_dir, "truncated.tar", &tar);
+    assert!(matches!(
+        TarArchive::open(&filename).unwrap_err(),
+        DataSourceError::InvalidTar(_, _)
+    ));
+
+    // A member whose size would overflow the end offset, in base-256 and in a pax header
+    let mut tar = tar_header("huge.dat", 0, b'0');
+    tar[124] = 0x80;
+    tar[125..128].copy_from_slice(&[0u8; 3]);
+    tar[128..136].copy_from_slice(&u64::MAX.to_be_bytes());
+    tar[148..156].copy_from_slice(b"        ");
+    let checksum: u32 = tar.iter().map(|b| u32::from(*b)).sum();
+    tar[148..155].copy_from_slice(format!("{:06o}\0", checksum).as_bytes());
+    tar.extend(vec![0u8; 4 * TAR_BLOCK_SIZE as usize]);
+    let filename = write_temp_file(&temp_dir, "huge.tar", &tar);
+    assert!(matches!(
+        TarArchive::open(&filename).unwrap_err(),
+        DataSourceError::InvalidTar(_, _)
+    ));
+
+    let mut tar = Vec::new();
+    append_tar_member(&mut tar, "pax", b"29 size=18446744073709551615\n", b'x');
+    append_tar_member(&mut tar, "huge.dat", &[], b'0');
+    tar.extend(vec![0u8; 4 * TAR_BLOCK_SIZE as usize]);
+    let filename = write_temp_file(&temp_dir, "huge_pax.tar", &tar);
+    assert!(matches!(
+        TarArchive::open(&filename).unwrap_err(),
+        DataSourceError::InvalidTar(_, _)
+    ));
+}
+
+#[test]
+fn test_data_sources() {
+    let temp_dir = tempdir::TempDir::new("data_source_test").unwrap();
+    let filename = write_temp_file(&temp_dir, "on_disk.bin", &[0u8; 42]);
+    let filename = filename.to_str().unwrap();
+
+    let mut data_sources = DataSources::new();
+    assert!(data_sources.is_empty());
+    data_sources.insert("in_memory.bin", Arc::new(MemorySource::new(vec![1u8; 10])));
+    assert_eq!(data_sources.len(), 1);
+    assert!(data_sources.get(filename).is_none());
+
+    // Files without a source are read from the filesystem
+    assert_eq!(data_sources.file_size("in_memory.bin").unwrap(), 10);
+    assert_eq!(data_sources.file_size(filename).unwrap(), 42);
+    assert!(data_sources.file_size("missing.bin").is_err());
+
+    // Clones share the sources
+    let clone = data_sources.clone();
+    assert_eq!(clone.file_size("in_memory.bin").unwrap(), 10);
+}
+
+#[test]
+fn test_fits_buffer_cells_per_open() {
+    let source: Arc<dyn DataSource> = Arc::new(MemorySource::new(vec![1u8; 10]));
+    let mut data_sources = DataSources::new();
+    data_sources.insert("in_memory.fits", Arc::clone(&source));
+
+    // Every open of a file shares one buffer...
+    let buffer = data_sources
+        .get_fits_buffer("in_memory.fits", &source)
+        .unwrap();
+    let same_buffer = data_sources
+        .get_fits_buffer("in_memory.fits", &source)
+        .unwrap();
+    assert!(Arc::ptr_eq(&buffer, &same_buffer));
+
+    // ...but gets its own cells for cfitsio to write to when the file is closed
+    let cells1 = buffer.new_cells();
+    let cells2 = buffer.new_cells();
+    assert_ne!(cells1, cells2);
+    unsafe {
+        for cells in &[cells1, cells2] {
+            assert_eq!(
+                *(**cells).ptr.get() as *const u8,
+                source.as_bytes().unwrap().as_ptr()
+            );
+            assert_eq!(*(**cells).size.get(), 10);
+        }
+    }
+}
@@ -0,0 +1,264 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Reading files without filling the page cache, for data which is only ever read once.
+
+Where possible (Linux, a filesystem which supports it, and an aligned buffer and offset) files
+are opened with O_DIRECT so reads bypass the page cache entirely. Otherwise files are read
+normally, but with `posix_fadvise` hints so that the kernel reads ahead and then drops the
+pages as soon as they have been read.
+ */
+use std::alloc::{self, Layout};
+use std::fmt;
+use std::fs::File;
+use std::io;
+use std::ops::{Deref, DerefMut};
+use std::path::Path;
+use std::ptr::NonNull;
+use std::slice;
+
+use crate::file_io;
+
+#[cfg(test)]
+mod test;
+
+/// Alignment (in bytes) of the buffer address, file offset and read length required for reads
+/// to bypass the page cache. 4096 satisfies the logical block size of all common filesystems.
+pub const DIRECT_IO_ALIGNMENT: usize = 4096;
+
+/// A zero-initialised byte buffer whose start is aligned to `DIRECT_IO_ALIGNMENT`, suitable for
+/// passing to `VoltageContext::read_file` and friends when direct I/O is enabled.
+pub struct AlignedBuffer {
+    ptr: NonNull<u8>,
+    len: usize,
+    layout: Layout,
+}
+
+// AlignedBuffer owns its allocation, just like a Vec<u8>.
+unsafe impl Send for AlignedBuffer {}
+unsafe impl Sync for AlignedBuffer {}
+
+impl AlignedBuffer {
+    /// Allocate a new zero-initialised, aligned buffer.
+    ///
+    /// # Arguments
+    ///
+    /// * `len` - length of the buffer in bytes.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An AlignedBuffer of `len` bytes
+    ///
+    pub fn new(len: usize) -> Self {
+        // Round the allocation up to a whole number of aligned blocks (and at least one, as zero
+        // sized allocations are not allowed).
+        let alloc_len =
+            ((len + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT).max(1) * DIRECT_IO_ALIGNMENT;
+        let layout = Layout::from_size_align(alloc_len, DIRECT_IO_ALIGNMENT)
+            .expect("AlignedBuffer length overflowed");
+
+        let ptr = match NonNull::new(unsafe { alloc::alloc_zeroed(layout) }) {
+            Some(p) => p,
+            None => alloc::handle_alloc_error(layout),
+        };
+
+        Self { ptr, len, layout }
+    }
+}
+
+impl Deref for AlignedBuffer {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        unsafe { slice::from_raw_parts(self.ptr.as_ptr(), self.len) }
+    }
+}
+
+impl DerefMut for AlignedBuffer {
+    fn deref_mut(&mut self) -> &mut [u8] {
+        unsafe { slice::from_raw_parts_mut(self.ptr.as_ptr(), self.len) }
+    }
+}
+
+impl Drop for AlignedBuffer {
+    fn drop(&mut self) {
+        unsafe { alloc::dealloc(self.ptr.as_ptr(), self.layout) }
+    }
+}
+
+/// Implements fmt::Debug for AlignedBuffer struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for AlignedBuffer {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(f, "AlignedBuffer {{ len: {} }}", self.len)
+    }
+}
+
+/// Returns true if a read of `buffer` from `offset` meets the alignment requirements of O_DIRECT.
+///
+/// # Arguments
+///
+/// * `buffer` - the buffer to be read into.
+///
+/// * `offset` - the offset in the file to read from.
+///
+///
+/// # Returns
+///
+/// * true if the buffer address, its length and the offset are all aligned
+///
+pub(crate) fn is_direct_io_aligned(buffer: &[u8], offset: u64) -> bool {
+    buffer.as_ptr() as usize % DIRECT_IO_ALIGNMENT == 0
+        && buffer.len() % DIRECT_IO_ALIGNMENT == 0
+        && offset % DIRECT_IO_ALIGNMENT as u64 == 0
+}
+
+/// A file opened for reading without filling the page cache. See the module documentation.
+pub(crate) struct UncachedFile {
+    /// The open file.
+    pub file: File,
+    /// true if the file was opened with O_DIRECT.
+    direct: bool,
+}
+
+impl UncachedFile {
+    /// Open a file for uncached reading.
+    ///
+    /// # Arguments
+    ///
+    /// * `path` - the file to open.
+    ///
+    /// * `try_direct` - try to open the file with O_DIRECT. Only pass true if every read will be
+    ///                  aligned (see `is_direct_io_aligned`). If O_DIRECT is not available the file
+    ///                  is opened normally.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the open file, or an io::Error.
+    ///
+    pub(crate) fn open<P: AsRef<Path>>(path: P, try_direct: bool) -> io::Result<Self> {
+        #[cfg(target_os = "linux")]
+        {
+            if try_direct {
+                use std::os::unix::fs::OpenOptionsExt;
+
+                // Not every filesystem supports O_DIRECT (e.g. tmpfs), in which case open fails
+                // and we fall back to a normal open below.
+                if let Ok(file) = std::fs::OpenOptions::new()
+                    .read(true)
+                    .custom_flags(libc::O_DIRECT)
+                    .open(&path)
+                {
+                    return Ok(Self { file, direct: true });
+                }
+            }
+        }
+        #[cfg(not(target_os = "linux"))]
+        let _ = try_direct;
+
+        Ok(Self {
+            file: File::open(path)?,
+            direct: false,
+        })
+    }
+
+    /// Read exactly `buffer.len()` bytes from `offset`. If the file was not opened with O_DIRECT
+    /// the kernel is told the range will be read sequentially, and then that it is not needed again.
+    ///
+    /// # Arguments
+    ///
+    /// * `buffer` - the buffer to read into.
+    ///
+    /// * `offset` - the offset in the file to read from.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if the buffer was filled, or an io::Error.
+    ///
+    pub(crate) fn read_exact_at(&self, buffer: &mut [u8], offset: u64) -> io::Result<()> {
+        if self.direct {
+            return file_io::read_exact_at(&self.file, buffer, offset);
+        }
+
+        advise(&self.file, offset, buffer.len(), Advice::Sequential);
+        let result = file_io::read_exact_at(&self.file, buffer, offset);
+        advise(&self.file, offset, buffer.len(), Advice::DontNeed);
+
+        result
+    }
+
+    /// Returns true if the file was opened with O_DIRECT, so reads of it bypass the page cache.
+    pub(crate) fn is_direct(&self) -> bool {
+        self.direct
+    }
+}
+
+/// Hints which can be given to the kernel about how part of a file will be used.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) enum Advice {
+    /// The range will be read sequentially, so read ahead aggressively.
+    Sequential,
+    /// The file will be read in small, scattered pieces, so do not read ahead.
+    Random,
+    /// The range will be read soon, so start reading it into the page cache now.
+    WillNeed,
+    /// The range will not be read again, so its pages can be dropped from the page cache.
+    DontNeed,
+}
+
+/// Give the kernel a hint about how a range of a file will be used. Hints are only hints, so
+/// any failure is ignored, and on platforms without `posix_fadvise` this does nothing.
+///
+/// # Arguments
+///
+/// * `file` - the open file.
+///
+/// * `offset` - start of the range.
+///
+/// * `len` - length of the range.
+///
+/// * `advice` - the hint to give.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+#[cfg(target_os = "linux")]
+pub(crate) fn advise(file: &File, offset: u64, len: usize, advice: Advice) {
+    use std::os::unix::io::AsRawFd;
+
+    let advice = match advice {
+        Advice::Sequential => libc::POSIX_FADV_SEQUENTIAL,
+        Advice::Random => libc::POSIX_FADV_RANDOM,
+        Advice::WillNeed => libc::POSIX_FADV_WILLNEED,
+        Advice::DontNeed => libc::POSIX_FADV_DONTNEED,
+    };
+
+    unsafe {
+        libc::posix_fadvise(
+            file.as_raw_fd(),
+            offset as libc::off_t,
+            len as libc::off_t,
+            advice,
+        );
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+pub(crate) fn advise(_file: &File, _offset: u64, _len: usize, _advice: Advice) {}
@@ -0,0 +1,89 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for uncached (direct I/O) reads
+*/
+#[cfg(test)]
+use super::*;
+#[cfg(test)]
+use std::io::Write;
+
+#[cfg(test)]
+/// Helper to write a test file of `len` bytes, where each byte is its offset modulo 251.
+fn generate_test_file(temp_dir: &tempdir::TempDir, len: usize) -> std::path::PathBuf {
+    let filename = temp_dir.path().join("direct_io_test.dat");
+    let data: Vec<u8> = (0..len).map(|i| (i % 251) as u8).collect();
+    File::create(&filename).unwrap().write_all(&data).unwrap();
+
+    filename
+}
+
+#[test]
+fn test_aligned_buffer() {
+    let mut buffer = AlignedBuffer::new(10_000);
+
+    assert_eq!(buffer.len(), 10_000);
+    assert_eq!(buffer.as_ptr() as usize % DIRECT_IO_ALIGNMENT, 0);
+    assert!(buffer.iter().all(|&b| b == 0));
+
+    buffer[9_999] = 1;
+    assert_eq!(buffer[9_999], 1);
+
+    let empty = AlignedBuffer::new(0);
+    assert_eq!(empty.len(), 0);
+}
+
+#[test]
+fn test_is_direct_io_aligned() {
+    let buffer = AlignedBuffer::new(2 * DIRECT_IO_ALIGNMENT);
+
+    assert!(is_direct_io_aligned(&buffer, 0));
+    assert!(is_direct_io_aligned(&buffer, DIRECT_IO_ALIGNMENT as u64));
+    // Unaligned offset
+    assert!(!is_direct_io_aligned(&buffer, 512));
+    // Unaligned length
+    assert!(!is_direct_io_aligned(&buffer[..100], 0));
+    // Unaligned start
+    assert!(!is_direct_io_aligned(
+        &buffer[1..DIRECT_IO_ALIGNMENT + 1],
+        0
+    ));
+}
+
+#[test]
+fn test_uncached_file_read_exact_at() {
+    let temp_dir = tempdir::TempDir::new("direct_io_test").unwrap();
+    let filename = generate_test_file(&temp_dir, 4 * DIRECT_IO_ALIGNMENT);
+
+    // Aligned read, which uses O_DIRECT if the filesystem supports it
+    let mut aligned = AlignedBuffer::new(2 * DIRECT_IO_ALIGNMENT);
+    let file = UncachedFile::open(&filename, true).unwrap();
+    file.read_exact_at(&mut aligned, DIRECT_IO_ALIGNMENT as u64)
+        .unwrap();
+    assert_eq!(aligned[0], (DIRECT_IO_ALIGNMENT % 251) as u8);
+    assert_eq!(
+        aligned[2 * DIRECT_IO_ALIGNMENT - 1],
+        ((3 * DIRECT_IO_ALIGNMENT - 1) % 251) as u8
+    );
+
+    // Unaligned read, which uses cache hints instead
+    let mut unaligned = vec![0u8; 100];
+    let file = UncachedFile::open(&filename, false).unwrap();
+    file.read_exact_at(&mut unaligned, 7).unwrap();
+    assert_eq!(unaligned[0], 7);
+    assert_eq!(unaligned[99], 106);
+
+    // Reading past the end of the file is an error
+    let mut too_long = vec![0u8; 100];
+    assert!(file
+        .read_exact_at(&mut too_long, (4 * DIRECT_IO_ALIGNMENT - 50) as u64)
+        .is_err());
+}
+
+#[test]
+fn test_uncached_file_missing_file() {
+    assert!(UncachedFile::open("test_files/does_not_exist.dat", true).is_err());
+    assert!(UncachedFile::open("test_files/does_not_exist.dat", false).is_err());
+}
@@ -29,6 +29,18 @@ pub enum MwalibError {
     #[error("{0}")]
     Voltage(#[from] crate::voltage_files::error::VoltageFileError),
 
+    /// An error derived from `DataSourceError`.
+    #[error("{0}")]
+    DataSource(#[from] crate::data_source::error::DataSourceError),
+
+    /// An error derived from `VisibilityCacheError`.
+    #[error("{0}")]
+    VisibilityCache(#[from] crate::visibility_cache::error::VisibilityCacheError),
+
+    /// An error derived from `ThreadPoolError`.
+    #[error("{0}")]
+    ThreadPool(#[from] crate::thread_pool::error::ThreadPoolError),
+
     // An error associated with parsing a string into another type.
     #[error("{source_file}:{source_line}\nCouldn't parse {key} in {fits_filename} HDU {hdu_num}")]
     Parse {
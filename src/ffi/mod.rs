@@ -4,14 +4,26 @@
 
 /*!
 This module exists purely for other languages to interface with mwalib.
+
+# Thread safety
+
+Once created, contexts are only read from, so the read functions (e.g.
+`mwalib_correlator_context_read_by_baseline` and `mwalib_voltage_context_read_second`), the
+display and metadata functions and the borrowed accessors take a const pointer and can be called
+concurrently from any number of threads on the same context, without the caller taking a lock.
+The caches used while reading (scratch buffers, and gpubox file handles when the handle cache is
+enabled) are internally synchronised. Each thread must read into its own buffer, and a context
+must not be freed while any other thread is still using it.
  */
 
 use crate::*;
 use gpubox_files::GpuboxError;
 use libc::{c_char, c_float, c_uchar, c_uint, c_ulong, size_t};
 use std::ffi::*;
+use std::fmt;
 use std::mem;
 use std::slice;
+use std::sync::{Arc, Mutex};
 use voltage_files::VoltageFileError;
 
 #[cfg(test)]
@@ -127,6 +139,60 @@ pub extern "C" fn mwalib_get_version_patch() -> c_uint {
     built_info::PKG_VERSION_PATCH.parse::<c_uint>().unwrap()
 }
 
+/// Give mwalib a dedicated thread pool, which all contexts will spread their parallel work
+/// (scanning gpubox files, reordering visibilities and multi-file reads) over, instead of
+/// sharing a pool with one thread per core.
+///
+/// # Arguments
+///
+/// * `num_threads` - number of threads mwalib may use, or 0 to go back to the default of one thread per core.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_set_num_threads(
+    num_threads: size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    match thread_pool::set_num_threads(num_threads) {
+        Ok(()) => MWALIB_SUCCESS,
+        Err(e) => {
+            set_error_message(
+                &format!("{}", e),
+                error_message as *mut u8,
+                error_message_length,
+            );
+            MWALIB_FAILURE
+        }
+    }
+}
+
+/// Get the number of threads mwalib spreads its parallel work over (see `mwalib_set_num_threads`).
+///
+/// # Arguments
+///
+/// * None
+///
+/// # Returns
+///
+/// * Number of threads in mwalib's thread pool
+///
+#[no_mangle]
+pub extern "C" fn mwalib_get_num_threads() -> size_t {
+    thread_pool::get_num_threads()
+}
+
 /// Free a rust-allocated CString.
 ///
 /// mwalib uses error strings to detail the caller with anything that went
@@ -374,6 +440,81 @@ pub unsafe extern "C" fn mwalib_correlator_context_new(
     MWALIB_SUCCESS
 }
 
+/// Create and return a pointer to an `CorrelatorContext` struct based on an existing `MetafitsContext` and gpubox FITS files.
+/// The metafits file is not parsed again, so this is much cheaper than `mwalib_correlator_context_new` when opening many
+/// correlator contexts for the same observation.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext`, either from `mwalib_metafits_context_new`
+///                            or borrowed from another context (e.g. via `mwalib_correlator_context_get_metafits_context`).
+///
+/// * `gpubox_filenames` - pointer to array of char* buffers containing the full path and filename of the gpubox FITS files.
+///
+/// * `gpubox_count` - length of the gpubox FITS char* array.
+///
+/// * `out_correlator_context_ptr` - A Rust-owned populated `CorrelatorContext` pointer. Free with `mwalib_correlator_context_free`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated `char*` buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext`. The new context takes its own copy, so it may be freed afterwards.
+/// * Caller *must* call function `mwalib_correlator_context_free` to release the rust memory.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_context_new_from_metafits_context(
+    metafits_context_ptr: *const MetafitsContext,
+    gpubox_filenames: *mut *const c_char,
+    gpubox_count: size_t,
+    out_correlator_context_ptr: &mut *mut CorrelatorContext,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_context_new_from_metafits_context() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    // The pointer may be borrowed from another context, so we can't take shared ownership of it.
+    // Copying it is still far cheaper than parsing the metafits file again.
+    let metafits_context = Arc::new((*metafits_context_ptr).clone());
+
+    let correlator_slice = slice::from_raw_parts(gpubox_filenames, gpubox_count);
+    let mut correlator_files = Vec::with_capacity(gpubox_count);
+    for g in correlator_slice {
+        let s = CStr::from_ptr(*g).to_str().unwrap();
+        correlator_files.push(s.to_string())
+    }
+    let context =
+        match CorrelatorContext::new_from_metafits_context(metafits_context, &correlator_files) {
+            Ok(c) => c,
+            Err(e) => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                // Return failure
+                return MWALIB_FAILURE;
+            }
+        };
+    *out_correlator_context_ptr = Box::into_raw(Box::new(context));
+    // Return success
+    MWALIB_SUCCESS
+}
+
 /// Display an `CorrelatorContext` struct.
 ///
 ///
@@ -448,9 +589,10 @@ pub unsafe extern "C" fn mwalib_correlator_context_display(
 /// * `error_message` *must* point to an already allocated char* buffer for any error messages.
 /// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
 /// * Caller *must* call `mwalib_correlator_context_free_read_buffer` function to release the rust memory.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
 #[no_mangle]
 pub unsafe extern "C" fn mwalib_correlator_context_read_by_baseline(
-    correlator_context_ptr: *mut CorrelatorContext,
+    correlator_context_ptr: *const CorrelatorContext,
     corr_timestep_index: size_t,
     corr_coarse_chan_index: size_t,
     buffer_ptr: *mut c_float,
@@ -468,7 +610,7 @@ pub unsafe extern "C" fn mwalib_correlator_context_read_by_baseline(
         );
         return MWALIB_FAILURE;
     } else {
-        &mut *correlator_context_ptr
+        &*correlator_context_ptr
     };
 
     // Don't do anything if the buffer pointer is null.
@@ -542,9 +684,10 @@ pub unsafe extern "C" fn mwalib_correlator_context_read_by_baseline(
 /// * `error_message` *must* point to an already allocated char* buffer for any error messages.
 /// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
 /// * Caller *must* call `mwalib_correlator_context_free_read_buffer` function to release the rust memory.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
 #[no_mangle]
 pub unsafe extern "C" fn mwalib_correlator_context_read_by_frequency(
-    correlator_context_ptr: *mut CorrelatorContext,
+    correlator_context_ptr: *const CorrelatorContext,
     corr_timestep_index: size_t,
     corr_coarse_chan_index: size_t,
     buffer_ptr: *mut c_float,
@@ -562,7 +705,7 @@ pub unsafe extern "C" fn mwalib_correlator_context_read_by_frequency(
         );
         return MWALIB_FAILURE;
     } else {
-        &mut *correlator_context_ptr
+        &*correlator_context_ptr
     };
     // Don't do anything if the buffer pointer is null.
     if buffer_ptr.is_null() {
@@ -602,47 +745,31 @@ pub unsafe extern "C" fn mwalib_correlator_context_read_by_frequency(
     }
 }
 
-/// Free a previously-allocated `CorrelatorContext` struct (and it's members).
-///
-/// # Arguments
+/// Read a subset of the baselines and fine channels of a single timestep / coarse channel of MWA data.
 ///
-/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object
+/// This method takes as input a timestep_index, a coarse_chan_index, a list of baseline indices and a
+/// range of fine channels to return that part of one HDU of data in baseline,freq,pol,r,i format. Only the
+/// requested part of the HDU is read from disk where the file layout allows it.
 ///
+/// # Arguments
 ///
-/// # Returns
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
 ///
-/// * MWALIB_SUCCESS on success, non-zero on failure
+/// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
 ///
+/// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
 ///
-/// # Safety
-/// * This must be called once caller is finished with the `CorrelatorContext` object
-/// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
-/// * `correlator_context_ptr` must not have already been freed.
-#[no_mangle]
-pub unsafe extern "C" fn mwalib_correlator_context_free(
-    correlator_context_ptr: *mut CorrelatorContext,
-) -> i32 {
-    if correlator_context_ptr.is_null() {
-        return MWALIB_SUCCESS;
-    }
-    // Release correlator context if applicable
-    Box::from_raw(correlator_context_ptr);
-
-    // Return success
-    MWALIB_SUCCESS
-}
-
-/// Create and return a pointer to an `VoltageContext` struct based on metafits and voltage files
+/// * `baseline_indices_ptr` - pointer to caller-owned array of baseline indices to read (output is in this order).
 ///
-/// # Arguments
+/// * `baseline_indices_len` - length of `baseline_indices_ptr`.
 ///
-/// * `metafits_filename` - pointer to char* buffer containing the full path and filename of a metafits file.
+/// * `fine_chan_start_index` - index of the first fine channel (within the coarse channel) to read.
 ///
-/// * `voltage_filenames` - pointer to array of char* buffers containing the full path and filename of the voltage files.
+/// * `num_fine_chans` - number of fine channels to read.
 ///
-/// * `voltage_file_count` - length of the voltage char* array.
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer to write data into.
 ///
-/// * `out_voltage_context_ptr` - A Rust-owned populated `VoltageContext` pointer. Free with `mwalib_voltage_context_free`.
+/// * `buffer_len` - length of `buffer_ptr`. This must be `baseline_indices_len * num_fine_chans * num_visibility_pols * 2`.
 ///
 /// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
 ///
@@ -651,54 +778,124 @@ pub unsafe extern "C" fn mwalib_correlator_context_free(
 ///
 /// # Returns
 ///
-/// * MWALIB_SUCCESS on success, non-zero on failure
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
 ///
 ///
 /// # Safety
-/// * `error_message` *must* point to an already allocated `char*` buffer for any error messages.
-/// * Caller *must* call function `mwalib_voltage_context_free` to release the rust memory.
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
+/// * `baseline_indices_ptr` must point to an array of at least `baseline_indices_len` elements.
+/// * `buffer_ptr` must point to a buffer of at least `buffer_len` floats.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_voltage_context_new(
-    metafits_filename: *const c_char,
-    voltage_filenames: *mut *const c_char,
-    voltage_file_count: size_t,
-    out_voltage_context_ptr: &mut *mut VoltageContext,
+pub unsafe extern "C" fn mwalib_correlator_context_read_by_baseline_subset(
+    correlator_context_ptr: *const CorrelatorContext,
+    corr_timestep_index: size_t,
+    corr_coarse_chan_index: size_t,
+    baseline_indices_ptr: *const size_t,
+    baseline_indices_len: size_t,
+    fine_chan_start_index: size_t,
+    num_fine_chans: size_t,
+    buffer_ptr: *mut c_float,
+    buffer_len: size_t,
     error_message: *const c_char,
     error_message_length: size_t,
 ) -> i32 {
-    let m = CStr::from_ptr(metafits_filename)
-        .to_str()
-        .unwrap()
-        .to_string();
-    let voltage_slice = slice::from_raw_parts(voltage_filenames, voltage_file_count);
-    let mut voltage_files = Vec::with_capacity(voltage_file_count);
-    for v in voltage_slice {
-        let s = CStr::from_ptr(*v).to_str().unwrap();
-        voltage_files.push(s.to_string())
+    // Load the previously-initialised context and buffer structs. Exit if
+    // either of these are null.
+    let corr_context = if correlator_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_context_read_by_baseline_subset() ERROR: null pointer for correlator_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    } else {
+        &*correlator_context_ptr
+    };
+
+    // Don't do anything if the buffer or baseline pointers are null.
+    if buffer_ptr.is_null() || baseline_indices_ptr.is_null() {
+        return MWALIB_FAILURE;
     }
-    let context = match VoltageContext::new(&m, &voltage_files) {
-        Ok(c) => c,
-        Err(e) => {
+
+    let baseline_indices = slice::from_raw_parts(baseline_indices_ptr, baseline_indices_len);
+    let output_slice = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
+
+    // The end of the fine channel range must not overflow
+    let fine_chan_end_index = match fine_chan_start_index.checked_add(num_fine_chans) {
+        Some(end) => end,
+        None => {
             set_error_message(
-                &format!("{}", e),
+                &format!(
+                    "mwalib_correlator_context_read_by_baseline_subset() ERROR: fine_chan_start_index ({}) + num_fine_chans ({}) overflows",
+                    fine_chan_start_index, num_fine_chans
+                ),
                 error_message as *mut u8,
                 error_message_length,
             );
-            // Return failure
             return MWALIB_FAILURE;
         }
     };
-    *out_voltage_context_ptr = Box::into_raw(Box::new(context));
-    // Return success
-    MWALIB_SUCCESS
+
+    // Read data into provided buffer
+    match corr_context.read_by_baseline_subset_into_buffer(
+        corr_timestep_index,
+        corr_coarse_chan_index,
+        baseline_indices,
+        fine_chan_start_index..fine_chan_end_index,
+        output_slice,
+    ) {
+        Ok(_) => MWALIB_SUCCESS,
+        Err(e) => match e {
+            GpuboxError::NoDataForTimeStepCoarseChannel {
+                timestep_index: _,
+                coarse_chan_index: _,
+            } => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN
+            }
+            _ => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_FAILURE
+            }
+        },
+    }
 }
 
-/// Display a `VoltageContext` struct.
+/// Read a subset of the baselines and fine channels of a single timestep / coarse channel of MWA data.
 ///
+/// This method takes as input a timestep_index, a coarse_chan_index, a list of baseline indices and a
+/// range of fine channels to return that part of one HDU of data in freq,baseline,pol,r,i format. Only the
+/// requested part of the HDU is read from disk where the file layout allows it.
 ///
 /// # Arguments
 ///
-/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+///
+/// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+///
+/// * `baseline_indices_ptr` - pointer to caller-owned array of baseline indices to read (output is in this order).
+///
+/// * `baseline_indices_len` - length of `baseline_indices_ptr`.
+///
+/// * `fine_chan_start_index` - index of the first fine channel (within the coarse channel) to read.
+///
+/// * `num_fine_chans` - number of fine channels to read.
+///
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer to write data into.
+///
+/// * `buffer_len` - length of `buffer_ptr`. This must be `baseline_indices_len * num_fine_chans * num_visibility_pols * 2`.
 ///
 /// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
 ///
@@ -707,53 +904,120 @@ pub unsafe extern "C" fn mwalib_voltage_context_new(
 ///
 /// # Returns
 ///
-/// * MWALIB_SUCCESS on success, non-zero on failure
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
 ///
 ///
 /// # Safety
 /// * `error_message` *must* point to an already allocated char* buffer for any error messages.
-/// * `voltage_context_ptr` must contain an `VoltageContext` object already populated via `mwalib_voltage_context_new`
+/// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
+/// * `baseline_indices_ptr` must point to an array of at least `baseline_indices_len` elements.
+/// * `buffer_ptr` must point to a buffer of at least `buffer_len` floats.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_voltage_context_display(
-    voltage_context_ptr: *const VoltageContext,
+pub unsafe extern "C" fn mwalib_correlator_context_read_by_frequency_subset(
+    correlator_context_ptr: *const CorrelatorContext,
+    corr_timestep_index: size_t,
+    corr_coarse_chan_index: size_t,
+    baseline_indices_ptr: *const size_t,
+    baseline_indices_len: size_t,
+    fine_chan_start_index: size_t,
+    num_fine_chans: size_t,
+    buffer_ptr: *mut c_float,
+    buffer_len: size_t,
     error_message: *const c_char,
     error_message_length: size_t,
 ) -> i32 {
-    if voltage_context_ptr.is_null() {
+    // Load the previously-initialised context and buffer structs. Exit if
+    // either of these are null.
+    let corr_context = if correlator_context_ptr.is_null() {
         set_error_message(
-            "mwalib_voltage_context() ERROR: null pointer for voltage_context_ptr passed in",
+            "mwalib_correlator_context_read_by_frequency_subset() ERROR: null pointer for correlator_context_ptr passed in",
             error_message as *mut u8,
             error_message_length,
         );
         return MWALIB_FAILURE;
+    } else {
+        &*correlator_context_ptr
+    };
+
+    // Don't do anything if the buffer or baseline pointers are null.
+    if buffer_ptr.is_null() || baseline_indices_ptr.is_null() {
+        return MWALIB_FAILURE;
     }
 
-    let context = &*voltage_context_ptr;
+    let baseline_indices = slice::from_raw_parts(baseline_indices_ptr, baseline_indices_len);
+    let output_slice = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
 
-    println!("{}", context);
+    // The end of the fine channel range must not overflow
+    let fine_chan_end_index = match fine_chan_start_index.checked_add(num_fine_chans) {
+        Some(end) => end,
+        None => {
+            set_error_message(
+                &format!(
+                    "mwalib_correlator_context_read_by_frequency_subset() ERROR: fine_chan_start_index ({}) + num_fine_chans ({}) overflows",
+                    fine_chan_start_index, num_fine_chans
+                ),
+                error_message as *mut u8,
+                error_message_length,
+            );
+            return MWALIB_FAILURE;
+        }
+    };
 
-    // Return success
-    MWALIB_SUCCESS
+    // Read data into provided buffer
+    match corr_context.read_by_frequency_subset_into_buffer(
+        corr_timestep_index,
+        corr_coarse_chan_index,
+        baseline_indices,
+        fine_chan_start_index..fine_chan_end_index,
+        output_slice,
+    ) {
+        Ok(_) => MWALIB_SUCCESS,
+        Err(e) => match e {
+            GpuboxError::NoDataForTimeStepCoarseChannel {
+                timestep_index: _,
+                coarse_chan_index: _,
+            } => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN
+            }
+            _ => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_FAILURE
+            }
+        },
+    }
 }
 
-/// Read a single timestep / coarse channel of MWA voltage data.
+/// Read many timesteps and coarse channels of MWA data at once, in baseline order, into one caller supplied buffer.
 ///
-/// This method takes as input a timestep_index and a coarse_chan_index to return one
-/// file-worth of voltage data.
+/// The HDUs are read in parallel on the context's thread pool. The output visibilities are in order:
+/// [timestep][coarse_chan][baseline][frequency][pol][r][i]
+/// where timestep and coarse_chan are in the order supplied.
 ///
 /// # Arguments
 ///
-/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
 ///
-/// * `voltage_timestep_index` - index within the voltage timestep array for the desired timestep.
+/// * `corr_timestep_indices_ptr` - pointer to caller-owned array of indices within the CorrelatorContext timestep array.
 ///
-/// * `voltage_coarse_chan_index` - index within the voltage coarse_chan array for the desired coarse channel.
+/// * `corr_timestep_indices_len` - length of `corr_timestep_indices_ptr`.
 ///
-/// * `buffer_ptr` - pointer to caller-owned and allocated buffer of bytes to write data into. Buffer must be large enough
-///                  for all of the data. Calculate the buffer size in bytes using:
-///                  vcontext.voltage_block_size_bytes * vcontext.num_voltage_blocks_per_timestep
+/// * `corr_coarse_chan_indices_ptr` - pointer to caller-owned array of indices within the CorrelatorContext coarse_chan array.
 ///
-/// * `buffer_len` - length of `buffer_ptr`.
+/// * `corr_coarse_chan_indices_len` - length of `corr_coarse_chan_indices_ptr`.
+///
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer to write data into.
+///
+/// * `buffer_len` - length of `buffer_ptr`. This must be `corr_timestep_indices_len * corr_coarse_chan_indices_len * num_timestep_coarse_chan_floats`.
 ///
 /// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
 ///
@@ -762,94 +1026,213 @@ pub unsafe extern "C" fn mwalib_voltage_context_display(
 ///
 /// # Returns
 ///
-/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if any combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
 ///
 ///
 /// # Safety
 /// * `error_message` *must* point to an already allocated char* buffer for any error messages.
-/// * `voltage_context_ptr` must point to a populated object from the `mwalib_voltage_context_new` function.
-/// * Caller *must* call `mwalib_voltage_context_free_read_buffer` function to release the rust memory.
+/// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
+/// * `corr_timestep_indices_ptr` must point to an array of at least `corr_timestep_indices_len` elements.
+/// * `corr_coarse_chan_indices_ptr` must point to an array of at least `corr_coarse_chan_indices_len` elements.
+/// * `buffer_ptr` must point to a buffer of at least `buffer_len` floats.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_voltage_context_read_file(
-    voltage_context_ptr: *mut VoltageContext,
-    voltage_timestep_index: size_t,
-    voltage_coarse_chan_index: size_t,
-    buffer_ptr: *mut c_uchar,
+pub unsafe extern "C" fn mwalib_correlator_context_read_by_baseline_batch(
+    correlator_context_ptr: *const CorrelatorContext,
+    corr_timestep_indices_ptr: *const size_t,
+    corr_timestep_indices_len: size_t,
+    corr_coarse_chan_indices_ptr: *const size_t,
+    corr_coarse_chan_indices_len: size_t,
+    buffer_ptr: *mut c_float,
     buffer_len: size_t,
     error_message: *const c_char,
     error_message_length: size_t,
 ) -> i32 {
-    // Load the previously-initialised context and buffer structs. Exit if
-    // either of these are null.
-    let voltage_context = if voltage_context_ptr.is_null() {
+    ffi_correlator_context_read_batch(
+        "mwalib_correlator_context_read_by_baseline_batch",
+        correlator_context_ptr,
+        corr_timestep_indices_ptr,
+        corr_timestep_indices_len,
+        corr_coarse_chan_indices_ptr,
+        corr_coarse_chan_indices_len,
+        buffer_ptr,
+        buffer_len,
+        error_message,
+        error_message_length,
+        CorrelatorContext::read_by_baseline_batch,
+    )
+}
+
+/// Read many timesteps and coarse channels of MWA data at once, in frequency order, into one caller supplied buffer.
+///
+/// The HDUs are read in parallel on the context's thread pool. The output visibilities are in order:
+/// [timestep][coarse_chan][frequency][baseline][pol][r][i]
+/// where timestep and coarse_chan are in the order supplied.
+///
+/// # Arguments
+///
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `corr_timestep_indices_ptr` - pointer to caller-owned array of indices within the CorrelatorContext timestep array.
+///
+/// * `corr_timestep_indices_len` - length of `corr_timestep_indices_ptr`.
+///
+/// * `corr_coarse_chan_indices_ptr` - pointer to caller-owned array of indices within the CorrelatorContext coarse_chan array.
+///
+/// * `corr_coarse_chan_indices_len` - length of `corr_coarse_chan_indices_ptr`.
+///
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer to write data into.
+///
+/// * `buffer_len` - length of `buffer_ptr`. This must be `corr_timestep_indices_len * corr_coarse_chan_indices_len * num_timestep_coarse_chan_floats`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if any combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
+/// * `corr_timestep_indices_ptr` must point to an array of at least `corr_timestep_indices_len` elements.
+/// * `corr_coarse_chan_indices_ptr` must point to an array of at least `corr_coarse_chan_indices_len` elements.
+/// * `buffer_ptr` must point to a buffer of at least `buffer_len` floats.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_context_read_by_frequency_batch(
+    correlator_context_ptr: *const CorrelatorContext,
+    corr_timestep_indices_ptr: *const size_t,
+    corr_timestep_indices_len: size_t,
+    corr_coarse_chan_indices_ptr: *const size_t,
+    corr_coarse_chan_indices_len: size_t,
+    buffer_ptr: *mut c_float,
+    buffer_len: size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_correlator_context_read_batch(
+        "mwalib_correlator_context_read_by_frequency_batch",
+        correlator_context_ptr,
+        corr_timestep_indices_ptr,
+        corr_timestep_indices_len,
+        corr_coarse_chan_indices_ptr,
+        corr_coarse_chan_indices_len,
+        buffer_ptr,
+        buffer_len,
+        error_message,
+        error_message_length,
+        CorrelatorContext::read_by_frequency_batch,
+    )
+}
+
+/// Shared implementation of the batch read functions: checks the pointers, builds the slices
+/// and maps any error to the FFI return codes.
+///
+/// # Arguments
+///
+/// * `function_name` - name of the calling FFI function, used in error messages.
+///
+/// * `read_fn` - the `CorrelatorContext` batch read method to call.
+///
+/// * (the remaining arguments are as for `mwalib_correlator_context_read_by_baseline_batch`)
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if any combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
+///
+///
+/// # Safety
+/// * As for `mwalib_correlator_context_read_by_baseline_batch`.
+#[allow(clippy::too_many_arguments)]
+unsafe fn ffi_correlator_context_read_batch<F>(
+    function_name: &str,
+    correlator_context_ptr: *const CorrelatorContext,
+    corr_timestep_indices_ptr: *const size_t,
+    corr_timestep_indices_len: size_t,
+    corr_coarse_chan_indices_ptr: *const size_t,
+    corr_coarse_chan_indices_len: size_t,
+    buffer_ptr: *mut c_float,
+    buffer_len: size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+    read_fn: F,
+) -> i32
+where
+    F: Fn(&CorrelatorContext, &[usize], &[usize], &mut [f32]) -> Result<(), GpuboxError>,
+{
+    // Load the previously-initialised context. Exit if it is null.
+    let corr_context = if correlator_context_ptr.is_null() {
         set_error_message(
-            "mwalib_voltage_context_read_by_file() ERROR: null pointer for voltage_context_ptr passed in",
+            &format!(
+                "{}() ERROR: null pointer for correlator_context_ptr passed in",
+                function_name
+            ),
             error_message as *mut u8,
             error_message_length,
         );
         return MWALIB_FAILURE;
     } else {
-        &mut *voltage_context_ptr
+        &*correlator_context_ptr
     };
 
-    // Don't do anything if the buffer pointer is null.
-    if buffer_ptr.is_null() {
+    // Don't do anything if the buffer or index pointers are null.
+    if buffer_ptr.is_null()
+        || corr_timestep_indices_ptr.is_null()
+        || corr_coarse_chan_indices_ptr.is_null()
+    {
         return MWALIB_FAILURE;
     }
 
-    let output_slice: &mut [u8] = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
+    let timestep_indices =
+        slice::from_raw_parts(corr_timestep_indices_ptr, corr_timestep_indices_len);
+    let coarse_chan_indices =
+        slice::from_raw_parts(corr_coarse_chan_indices_ptr, corr_coarse_chan_indices_len);
+    let output_slice = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
 
-    // Read data in.
-    match voltage_context.read_file(
-        voltage_timestep_index,
-        voltage_coarse_chan_index,
+    // Read data into provided buffer
+    match read_fn(
+        corr_context,
+        timestep_indices,
+        coarse_chan_indices,
         output_slice,
     ) {
         Ok(_) => MWALIB_SUCCESS,
-        Err(e) => match e {
-            VoltageFileError::NoDataForTimeStepCoarseChannel {
-                timestep_index: _,
-                coarse_chan_index: _,
-            } => {
-                set_error_message(
-                    &format!("{}", e),
-                    error_message as *mut u8,
-                    error_message_length,
-                );
-                MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN
-            }
-            _ => {
-                set_error_message(
-                    &format!("{}", e),
-                    error_message as *mut u8,
-                    error_message_length,
-                );
-                MWALIB_FAILURE
+        Err(e) => {
+            set_error_message(
+                &format!("{}", e),
+                error_message as *mut u8,
+                error_message_length,
+            );
+
+            match e {
+                GpuboxError::NoDataForTimeStepCoarseChannel {
+                    timestep_index: _,
+                    coarse_chan_index: _,
+                } => MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN,
+                _ => MWALIB_FAILURE,
             }
-        },
+        }
     }
 }
 
-/// Read a single second / coarse channel of MWA voltage data.
-///
-/// This method takes as input a gps_time (in seconds) and a coarse_chan_index to return one
-/// second-worth of voltage data.
+/// Read only the autocorrelations of a single timestep / coarse channel.
 ///
 /// # Arguments
 ///
-/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
-///
-/// * `gps_second_start` - GPS second which to start getting data at.
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
 ///
-/// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+/// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
 ///
-/// * `voltage_coarse_chan_index` - index within the coarse_chan array for the desired coarse channel.
+/// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
 ///
-/// * `buffer_ptr` - pointer to caller-owned and allocated buffer of bytes to write data into. Buffer must be large enough
-///                  for all of the data. Calculate the buffer size in bytes using:
-///                  (vcontext.voltage_block_size_bytes * vcontext.num_voltage_blocks_per_second) * gps_second_count
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer to write data into, in antenna,freq,pol,r,i order.
 ///
-/// * `buffer_len` - length of `buffer_ptr`.
+/// * `buffer_len` - length of `buffer_ptr`. This must be `num_ants * num_corr_fine_chans_per_coarse * num_visibility_pols * 2`.
 ///
 /// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
 ///
@@ -863,30 +1246,30 @@ pub unsafe extern "C" fn mwalib_voltage_context_read_file(
 ///
 /// # Safety
 /// * `error_message` *must* point to an already allocated char* buffer for any error messages.
-/// * `voltage_context_ptr` must point to a populated object from the `mwalib_voltage_context_new` function.
-/// * Caller *must* call `mwalib_voltage_context_free_read_buffer` function to release the rust memory.
+/// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
+/// * `buffer_ptr` must point to a buffer of at least `buffer_len` floats.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_voltage_context_read_second(
-    voltage_context_ptr: *mut VoltageContext,
-    gps_second_start: c_ulong,
-    gps_second_count: size_t,
-    voltage_coarse_chan_index: size_t,
-    buffer_ptr: *mut c_uchar,
+pub unsafe extern "C" fn mwalib_correlator_context_read_autos(
+    correlator_context_ptr: *const CorrelatorContext,
+    corr_timestep_index: size_t,
+    corr_coarse_chan_index: size_t,
+    buffer_ptr: *mut c_float,
     buffer_len: size_t,
     error_message: *const c_char,
     error_message_length: size_t,
 ) -> i32 {
     // Load the previously-initialised context and buffer structs. Exit if
     // either of these are null.
-    let voltage_context = if voltage_context_ptr.is_null() {
+    let corr_context = if correlator_context_ptr.is_null() {
         set_error_message(
-            "mwalib_voltage_context_read_by_file() ERROR: null pointer for voltage_context_ptr passed in",
+            "mwalib_correlator_context_read_autos() ERROR: null pointer for correlator_context_ptr passed in",
             error_message as *mut u8,
             error_message_length,
         );
         return MWALIB_FAILURE;
     } else {
-        &mut *voltage_context_ptr
+        &*correlator_context_ptr
     };
 
     // Don't do anything if the buffer pointer is null.
@@ -894,18 +1277,17 @@ pub unsafe extern "C" fn mwalib_voltage_context_read_second(
         return MWALIB_FAILURE;
     }
 
-    let output_slice: &mut [u8] = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
+    let output_slice = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
 
-    // Read data in.
-    match voltage_context.read_second(
-        gps_second_start,
-        gps_second_count,
-        voltage_coarse_chan_index,
+    // Read data into provided buffer
+    match corr_context.read_autos_into_buffer(
+        corr_timestep_index,
+        corr_coarse_chan_index,
         output_slice,
     ) {
         Ok(_) => MWALIB_SUCCESS,
         Err(e) => match e {
-            VoltageFileError::NoDataForTimeStepCoarseChannel {
+            GpuboxError::NoDataForTimeStepCoarseChannel {
                 timestep_index: _,
                 coarse_chan_index: _,
             } => {
@@ -928,176 +1310,148 @@ pub unsafe extern "C" fn mwalib_voltage_context_read_second(
     }
 }
 
-/// Free a previously-allocated `VoltageContext` struct (and it's members).
+/// Read a single timestep / coarse channel of MWAX data as the raw integers stored in the gpubox file.
+///
+/// Unlike `mwalib_correlator_context_read_by_baseline`, the data are not scaled or converted to floats.
+/// The physical value of each visibility is `out_bzero + out_bscale * raw`. Legacy correlator files store floats, so this fails for them.
 ///
 /// # Arguments
 ///
-/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+///
+/// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+///
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer of int32s to write data into, in baseline,freq,pol,r,i order.
+///
+/// * `buffer_len` - length of `buffer_ptr`. This must be `num_timestep_coarse_chan_floats`.
+///
+/// * `out_bitpix` - the BITPIX of the HDU.
+///
+/// * `out_bscale` - the BSCALE of the HDU (1 if not present).
+///
+/// * `out_bzero` - the BZERO of the HDU (0 if not present).
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
 ///
 ///
 /// # Returns
 ///
-/// * MWALIB_SUCCESS on success, non-zero on failure
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
 ///
 ///
 /// # Safety
-/// * This must be called once caller is finished with the `VoltageContext` object
-/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
-/// * `voltage_context_ptr` must not have already been freed.
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated object from the `mwalib_correlator_context_new` function.
+/// * This may be called concurrently from multiple threads with the same `correlator_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_voltage_context_free(
-    voltage_context_ptr: *mut VoltageContext,
+pub unsafe extern "C" fn mwalib_correlator_context_read_raw(
+    correlator_context_ptr: *const CorrelatorContext,
+    corr_timestep_index: size_t,
+    corr_coarse_chan_index: size_t,
+    buffer_ptr: *mut i32,
+    buffer_len: size_t,
+    out_bitpix: &mut i32,
+    out_bscale: &mut f64,
+    out_bzero: &mut f64,
+    error_message: *const c_char,
+    error_message_length: size_t,
 ) -> i32 {
-    if voltage_context_ptr.is_null() {
-        return MWALIB_SUCCESS;
+    // Load the previously-initialised context and buffer structs. Exit if
+    // either of these are null.
+    let corr_context = if correlator_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_context_read_raw() ERROR: null pointer for correlator_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    } else {
+        &*correlator_context_ptr
+    };
+
+    // Don't do anything if the buffer pointer is null.
+    if buffer_ptr.is_null() {
+        return MWALIB_FAILURE;
     }
-    // Release voltage context if applicable
-    Box::from_raw(voltage_context_ptr);
 
-    // Return success
-    MWALIB_SUCCESS
-}
+    let output_slice = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
 
-///
-/// This a C struct to allow the caller to consume the metafits metadata
-///
-#[repr(C)]
-pub struct MetafitsMetadata {
-    /// Observation id
-    pub obs_id: u32,
-    /// ATTEN_DB  // global analogue attenuation, in dB
-    pub global_analogue_attenuation_db: f64,
-    /// RA tile pointing
-    pub ra_tile_pointing_deg: f64,
-    /// DEC tile pointing
-    pub dec_tile_pointing_deg: f64,
-    /// RA phase centre
-    pub ra_phase_center_deg: f64,
-    /// DEC phase centre
-    pub dec_phase_center_deg: f64,
-    /// AZIMUTH
-    pub az_deg: f64,
-    /// ALTITUDE
-    pub alt_deg: f64,
-    /// Zenith angle of the pointing centre in degrees
-    pub za_deg: f64,
-    /// AZIMUTH of the pointing centre in radians
-    pub az_rad: f64,
-    /// ALTITUDE (a.k.a. elevation) of the pointing centre in radians
-    pub alt_rad: f64,
-    /// Zenith angle of the pointing centre in radians
-    pub za_rad: f64,
-    /// Altitude of Sun
-    pub sun_alt_deg: f64,
-    /// Distance from pointing center to Sun
-    pub sun_distance_deg: f64,
-    /// Distance from pointing center to the Moon
-    pub moon_distance_deg: f64,
-    /// Distance from pointing center to Jupiter
-    pub jupiter_distance_deg: f64,
-    /// Local Sidereal Time
-    pub lst_deg: f64,
-    /// Local Sidereal Time in radians
-    pub lst_rad: f64,
-    /// Hour Angle of pointing center (as a string)
-    pub hour_angle_string: *mut c_char,
-    /// GRIDNAME
-    pub grid_name: *mut c_char,
-    /// GRIDNUM
-    pub grid_number: i32,
-    /// CREATOR
-    pub creator: *mut c_char,
-    /// PROJECT
-    pub project_id: *mut c_char,
-    /// Observation name
-    pub obs_name: *mut c_char,
-    /// MWA observation mode
-    pub mode: MWAMode,
-    /// Which Geometric delays have been applied to the data
-    pub geometric_delays_applied: GeometricDelaysApplied,
-    /// Have cable delays been applied to the data?    
-    pub cable_delays_applied: bool,
-    /// Have calibration delays and gains been applied to the data?
-    pub calibration_delays_and_gains_applied: bool,
-    /// Correlator fine_chan_resolution
-    pub corr_fine_chan_width_hz: u32,
-    /// Correlator mode dump time
-    pub corr_int_time_ms: u64,
-    /// Number of fine channels in each coarse channel for a correlator observation
-    pub num_corr_fine_chans_per_coarse: usize,
-    /// RECVRS    Array of receiver numbers (this tells us how many receivers too)
-    pub receivers: *mut usize,
-    /// DELAYS    Array of delays
-    pub delays: *mut u32,
-    /// Scheduled start (gps time) of observation
-    pub sched_start_utc: i64,
-    /// Scheduled end (gps time) of observation
-    pub sched_end_utc: i64,
-    /// Scheduled start (MJD) of observation
-    pub sched_start_mjd: f64,
-    /// Scheduled end (MJD) of observation
-    pub sched_end_mjd: f64,
-    /// Scheduled start (UNIX time) of observation
-    pub sched_start_unix_time_ms: u64,
-    /// Scheduled end (UNIX time) of observation
-    pub sched_end_unix_time_ms: u64,
-    /// Scheduled start (GPS) of observation
-    pub sched_start_gps_time_ms: u64,
-    /// Scheduled end (GPS) of observation
-    pub sched_end_gps_time_ms: u64,
-    /// Scheduled duration of observation
-    pub sched_duration_ms: u64,
-    /// Seconds of bad data after observation starts
-    pub quack_time_duration_ms: u64,
-    /// OBSID+QUACKTIM as Unix timestamp (first good timestep)
-    pub good_time_unix_ms: u64,
-    /// Good time expressed as GPS seconds
-    pub good_time_gps_ms: u64,
-    /// Total number of antennas (tiles) in the array
-    pub num_ants: usize,
-    /// Array of antennas
-    pub antennas: *mut Antenna,
-    /// The Metafits defines an rf chain for antennas(tiles) * pol(X,Y)
-    pub num_rf_inputs: usize,
-    /// Array of rf inputs
-    pub rf_inputs: *mut Rfinput,
-    /// Number of antenna pols. e.g. X and Y
-    pub num_ant_pols: usize,
-    /// Number of baselines
-    pub num_baselines: usize,
-    /// Baseline array
-    pub baselines: *mut Baseline,
-    /// Number of visibility_pols
-    pub num_visibility_pols: usize,
-    /// Number of coarse channels based on the metafits
-    pub num_metafits_coarse_chans: usize,
-    /// metafits_coarse_chans array
-    pub metafits_coarse_chans: *mut CoarseChannel,
-    /// Number of timesteps based on the metafits
-    pub num_metafits_timesteps: usize,
-    /// metafits_timesteps array
-    pub metafits_timesteps: *mut TimeStep,
-    /// Total bandwidth of observation assuming we have all coarse channels
-    pub obs_bandwidth_hz: u32,
-    /// Bandwidth of each coarse channel
-    pub coarse_chan_width_hz: u32,
-    /// Centre frequency of observation
-    pub centre_freq_hz: u32,
-    /// filename of metafits file used
-    pub metafits_filename: *mut c_char,
+    // Read data into provided buffer
+    match corr_context.read_raw_into_buffer(
+        corr_timestep_index,
+        corr_coarse_chan_index,
+        output_slice,
+    ) {
+        Ok(scaling) => {
+            *out_bitpix = scaling.bitpix;
+            *out_bscale = scaling.bscale;
+            *out_bzero = scaling.bzero;
+
+            MWALIB_SUCCESS
+        }
+        Err(e) => {
+            set_error_message(
+                &format!("{}", e),
+                error_message as *mut u8,
+                error_message_length,
+            );
+
+            match e {
+                GpuboxError::NoDataForTimeStepCoarseChannel {
+                    timestep_index: _,
+                    coarse_chan_index: _,
+                } => MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN,
+                _ => MWALIB_FAILURE,
+            }
+        }
+    }
 }
 
-/// This passed back a struct containing the `MetafitsContext` metadata, given a MetafitsContext, CorrelatorContext or VoltageContext
+/// Free a previously-allocated `CorrelatorContext` struct (and it's members).
 ///
 /// # Arguments
 ///
-/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object. (Exclusive with correlator_context_ptr and voltage_context_ptr)
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object
 ///
-/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object. (Exclusive with metafits_context_ptr and voltage_context_ptr)
 ///
-/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object. (Exclusive with metafits_context_ptr and correlator_context_ptr)
+/// # Returns
 ///
-/// * `out_metafits_metadata_ptr` - pointer to a Rust-owned `mwalibMetafitsMetadata` struct. Free with `mwalib_metafits_metadata_free`
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * This must be called once caller is finished with the `CorrelatorContext` object
+/// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
+/// * `correlator_context_ptr` must not have already been freed.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_context_free(
+    correlator_context_ptr: *mut CorrelatorContext,
+) -> i32 {
+    if correlator_context_ptr.is_null() {
+        return MWALIB_SUCCESS;
+    }
+    // Release correlator context if applicable
+    Box::from_raw(correlator_context_ptr);
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+/// Create and return a pointer to an `VoltageContext` struct based on metafits and voltage files
+///
+/// # Arguments
+///
+/// * `metafits_filename` - pointer to char* buffer containing the full path and filename of a metafits file.
+///
+/// * `voltage_filenames` - pointer to array of char* buffers containing the full path and filename of the voltage files.
+///
+/// * `voltage_file_count` - length of the voltage char* array.
+///
+/// * `out_voltage_context_ptr` - A Rust-owned populated `VoltageContext` pointer. Free with `mwalib_voltage_context_free`.
 ///
 /// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
 ///
@@ -1110,330 +1464,2325 @@ pub struct MetafitsMetadata {
 ///
 ///
 /// # Safety
-/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
-/// * `metafits_context_ptr` must point to a populated MetafitsContext object from the `mwalib_metafits_context_new` function OR
-/// * `correlator_context_ptr` must point to a populated CorrelatorContext object from the 'mwalib_correlator_context_new' function OR
-/// * `voltage_context_ptr` must point to a populated VoltageContext object from the `mwalib_voltage_context_new` function. (Set the unused contexts to NULL).
-/// * Caller must call `mwalib_metafits_metadata_free` once finished, to free the rust memory.
+/// * `error_message` *must* point to an already allocated `char*` buffer for any error messages.
+/// * Caller *must* call function `mwalib_voltage_context_free` to release the rust memory.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_metafits_metadata_get(
-    metafits_context_ptr: *mut MetafitsContext,
-    correlator_context_ptr: *mut CorrelatorContext,
-    voltage_context_ptr: *mut VoltageContext,
-    out_metafits_metadata_ptr: &mut *mut MetafitsMetadata,
+pub unsafe extern "C" fn mwalib_voltage_context_new(
+    metafits_filename: *const c_char,
+    voltage_filenames: *mut *const c_char,
+    voltage_file_count: size_t,
+    out_voltage_context_ptr: &mut *mut VoltageContext,
     error_message: *const c_char,
     error_message_length: size_t,
 ) -> i32 {
-    // Ensure only either metafits XOR correlator XOR voltage context is passed in
-    if !(!metafits_context_ptr.is_null()
-        ^ !correlator_context_ptr.is_null()
-        ^ !voltage_context_ptr.is_null())
-    {
-        set_error_message(
-            "mwalib_metafits_metadata_get() ERROR: pointers for metafits_context_ptr, correlator_context_ptr and/or voltage_context_ptr were passed in. Only one should be provided.",
-            error_message as *mut u8,
-            error_message_length,
-        );
-        return MWALIB_FAILURE;
+    let m = CStr::from_ptr(metafits_filename)
+        .to_str()
+        .unwrap()
+        .to_string();
+    let voltage_slice = slice::from_raw_parts(voltage_filenames, voltage_file_count);
+    let mut voltage_files = Vec::with_capacity(voltage_file_count);
+    for v in voltage_slice {
+        let s = CStr::from_ptr(*v).to_str().unwrap();
+        voltage_files.push(s.to_string())
     }
-
-    // Create our metafits context pointer depending on what was passed in
-    let metafits_context = if !metafits_context_ptr.is_null() {
-        // Caller passed in a metafits context, so use that
-        &*metafits_context_ptr
-    } else if !correlator_context_ptr.is_null() {
-        // Caller passed in a correlator context, so use that
-        &(*correlator_context_ptr).metafits_context
-    } else {
-        // Caller passed in a voltage context, so use that
-        &(*voltage_context_ptr).metafits_context
+    let context = match VoltageContext::new(&m, &voltage_files) {
+        Ok(c) => c,
+        Err(e) => {
+            set_error_message(
+                &format!("{}", e),
+                error_message as *mut u8,
+                error_message_length,
+            );
+            // Return failure
+            return MWALIB_FAILURE;
+        }
     };
+    *out_voltage_context_ptr = Box::into_raw(Box::new(context));
+    // Return success
+    MWALIB_SUCCESS
+}
 
-    // Populate baselines
-    let mut baseline_vec: Vec<Baseline> = Vec::new();
-    for item in metafits_context.baselines.iter() {
-        let out_item = {
-            let baseline::Baseline {
-                ant1_index,
-                ant2_index,
-            } = item;
-            Baseline {
-                ant1_index: *ant1_index,
-                ant2_index: *ant2_index,
-            }
-        };
-
-        baseline_vec.push(out_item);
+/// Create and return a pointer to an `VoltageContext` struct based on an existing `MetafitsContext` and voltage files.
+/// The metafits file is not parsed again, so this is much cheaper than `mwalib_voltage_context_new` when opening many
+/// voltage contexts for the same observation.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext`, either from `mwalib_metafits_context_new`
+///                            or borrowed from another context (e.g. via `mwalib_voltage_context_get_metafits_context`).
+///
+/// * `voltage_filenames` - pointer to array of char* buffers containing the full path and filename of the voltage files.
+///
+/// * `voltage_file_count` - length of the voltage char* array.
+///
+/// * `out_voltage_context_ptr` - A Rust-owned populated `VoltageContext` pointer. Free with `mwalib_voltage_context_free`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated `char*` buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext`. The new context takes its own copy, so it may be freed afterwards.
+/// * Caller *must* call function `mwalib_voltage_context_free` to release the rust memory.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_new_from_metafits_context(
+    metafits_context_ptr: *const MetafitsContext,
+    voltage_filenames: *mut *const c_char,
+    voltage_file_count: size_t,
+    out_voltage_context_ptr: &mut *mut VoltageContext,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_new_from_metafits_context() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // Populate antennas
-    let mut antenna_vec: Vec<Antenna> = Vec::new();
-    for item in metafits_context.antennas.iter() {
-        let out_item = {
-            let antenna::Antenna {
-                ant,
-                tile_id,
-                tile_name,
-                rfinput_x,
-                rfinput_y,
-                electrical_length_m,
-                north_m,
-                east_m,
-                height_m,
-            } = item;
-            Antenna {
-                ant: *ant,
-                tile_id: *tile_id,
-                tile_name: CString::new(tile_name.as_str()).unwrap().into_raw(),
-                rfinput_x: rfinput_x.subfile_order as usize,
-                rfinput_y: rfinput_y.subfile_order as usize,
-                electrical_length_m: *electrical_length_m,
-                north_m: *north_m,
-                east_m: *east_m,
-                height_m: *height_m,
-            }
-        };
+    // The pointer may be borrowed from another context, so we can't take shared ownership of it.
+    // Copying it is still far cheaper than parsing the metafits file again.
+    let metafits_context = Arc::new((*metafits_context_ptr).clone());
 
-        antenna_vec.push(out_item);
+    let voltage_slice = slice::from_raw_parts(voltage_filenames, voltage_file_count);
+    let mut voltage_files = Vec::with_capacity(voltage_file_count);
+    for g in voltage_slice {
+        let s = CStr::from_ptr(*g).to_str().unwrap();
+        voltage_files.push(s.to_string())
     }
+    let context = match VoltageContext::new_from_metafits_context(metafits_context, &voltage_files)
+    {
+        Ok(c) => c,
+        Err(e) => {
+            set_error_message(
+                &format!("{}", e),
+                error_message as *mut u8,
+                error_message_length,
+            );
+            // Return failure
+            return MWALIB_FAILURE;
+        }
+    };
+    *out_voltage_context_ptr = Box::into_raw(Box::new(context));
+    // Return success
+    MWALIB_SUCCESS
+}
 
-    // Populate rf_inputs
-    let mut rfinput_vec: Vec<Rfinput> = Vec::new();
-    for item in metafits_context.rf_inputs.iter() {
-        let out_item = {
-            let rfinput::Rfinput {
-                input,
-                ant,
-                tile_id,
-                tile_name,
-                pol,
-                electrical_length_m,
-                north_m,
-                east_m,
-                height_m,
-                vcs_order,
-                subfile_order,
-                flagged,
-                rec_number,
-                rec_slot_number,
-                digital_gains: _, // not currently supported via FFI interface
-                dipole_gains: _,  // not currently supported via FFI interface
-                dipole_delays: _, // not currently supported via FFI interface
-            } = item;
-            Rfinput {
-                input: *input,
-                ant: *ant,
-                tile_id: *tile_id,
-                tile_name: CString::new(String::from(&*tile_name)).unwrap().into_raw(),
-                pol: CString::new(pol.to_string()).unwrap().into_raw(),
-                electrical_length_m: *electrical_length_m,
-                north_m: *north_m,
-                east_m: *east_m,
-                height_m: *height_m,
-                vcs_order: *vcs_order,
-                subfile_order: *subfile_order,
-                flagged: *flagged,
-                rec_number: *rec_number,
-                rec_slot_number: *rec_slot_number,
-            }
-        };
-        rfinput_vec.push(out_item);
+/// Display a `VoltageContext` struct.
+///
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must contain an `VoltageContext` object already populated via `mwalib_voltage_context_new`
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_display(
+    voltage_context_ptr: *const VoltageContext,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // Populate metafits coarse channels
-    let mut coarse_chan_vec: Vec<CoarseChannel> = Vec::new();
+    let context = &*voltage_context_ptr;
 
-    for item in metafits_context.metafits_coarse_chans.iter() {
-        let out_item = {
-            let coarse_channel::CoarseChannel {
-                corr_chan_number,
-                rec_chan_number,
-                gpubox_number,
-                chan_width_hz,
-                chan_start_hz,
-                chan_centre_hz,
-                chan_end_hz,
-            } = item;
-            CoarseChannel {
-                corr_chan_number: *corr_chan_number,
-                rec_chan_number: *rec_chan_number,
-                gpubox_number: *gpubox_number,
-                chan_width_hz: *chan_width_hz,
-                chan_start_hz: *chan_start_hz,
-                chan_centre_hz: *chan_centre_hz,
-                chan_end_hz: *chan_end_hz,
-            }
-        };
+    println!("{}", context);
 
-        coarse_chan_vec.push(out_item);
+    // Return success
+    MWALIB_SUCCESS
+}
+
+/// Read a single timestep / coarse channel of MWA voltage data.
+///
+/// This method takes as input a timestep_index and a coarse_chan_index to return one
+/// file-worth of voltage data.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `voltage_timestep_index` - index within the voltage timestep array for the desired timestep.
+///
+/// * `voltage_coarse_chan_index` - index within the voltage coarse_chan array for the desired coarse channel.
+///
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer of bytes to write data into. Buffer must be large enough
+///                  for all of the data. Calculate the buffer size in bytes using:
+///                  vcontext.voltage_block_size_bytes * vcontext.num_voltage_blocks_per_timestep
+///
+/// * `buffer_len` - length of `buffer_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated object from the `mwalib_voltage_context_new` function.
+/// * Caller *must* call `mwalib_voltage_context_free_read_buffer` function to release the rust memory.
+/// * This may be called concurrently from multiple threads with the same `voltage_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_read_file(
+    voltage_context_ptr: *const VoltageContext,
+    voltage_timestep_index: size_t,
+    voltage_coarse_chan_index: size_t,
+    buffer_ptr: *mut c_uchar,
+    buffer_len: size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    // Load the previously-initialised context and buffer structs. Exit if
+    // either of these are null.
+    let voltage_context = if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_read_by_file() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    } else {
+        &*voltage_context_ptr
+    };
+
+    // Don't do anything if the buffer pointer is null.
+    if buffer_ptr.is_null() {
+        return MWALIB_FAILURE;
     }
 
-    // Populate metafits timesteps
-    let mut timestep_vec: Vec<TimeStep> = Vec::new();
+    let output_slice: &mut [u8] = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
 
-    for item in metafits_context.metafits_timesteps.iter() {
-        let out_item = {
-            let timestep::TimeStep {
-                unix_time_ms,
-                gps_time_ms,
-            } = item;
-            TimeStep {
-                unix_time_ms: *unix_time_ms,
-                gps_time_ms: *gps_time_ms,
+    // Read data in.
+    match voltage_context.read_file(
+        voltage_timestep_index,
+        voltage_coarse_chan_index,
+        output_slice,
+    ) {
+        Ok(_) => MWALIB_SUCCESS,
+        Err(e) => match e {
+            VoltageFileError::NoDataForTimeStepCoarseChannel {
+                timestep_index: _,
+                coarse_chan_index: _,
+            } => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN
             }
-        };
-        timestep_vec.push(out_item);
+            _ => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_FAILURE
+            }
+        },
     }
+}
 
-    // Populate the outgoing structure with data from the metafits context
-    // We explicitly break out the attributes so at compile time it will let us know
-    // if there have been new fields added to the rust struct, then we can choose to
-    // ignore them (with _) or add that field to the FFI struct.
-    let out_metadata = {
-        let MetafitsContext {
-            obs_id,
-            sched_start_gps_time_ms,
-            sched_end_gps_time_ms,
-            sched_start_unix_time_ms,
-            sched_end_unix_time_ms,
-            sched_start_utc,
-            sched_end_utc,
-            sched_start_mjd,
-            sched_end_mjd,
-            sched_duration_ms,
-            ra_tile_pointing_degrees,
-            dec_tile_pointing_degrees,
-            ra_phase_center_degrees,
-            dec_phase_center_degrees,
-            az_deg,
-            alt_deg,
-            za_deg,
-            az_rad,
-            alt_rad,
-            za_rad,
-            sun_alt_deg,
-            sun_distance_deg,
-            moon_distance_deg,
-            jupiter_distance_deg,
-            lst_deg: lst_degrees,
-            lst_rad: lst_radians,
-            hour_angle_string,
-            grid_name,
-            grid_number,
-            creator,
-            project_id,
-            obs_name,
-            mode,
-            geometric_delays_applied,
-            cable_delays_applied,
-            calibration_delays_and_gains_applied,
-            corr_fine_chan_width_hz,
-            corr_int_time_ms,
-            num_corr_fine_chans_per_coarse,
-            receivers,
-            delays,
-            global_analogue_attenuation_db,
-            quack_time_duration_ms,
-            good_time_unix_ms,
-            good_time_gps_ms,
-            num_ants,
-            antennas: _, // This is populated seperately
-            num_rf_inputs,
-            rf_inputs: _, // This is populated seperately
-            num_ant_pols,
-            num_baselines,
-            baselines: _, // This is populated seperately
-            num_visibility_pols,
-            metafits_timesteps: _, // This is populated seperately
-            num_metafits_timesteps,
-            metafits_coarse_chans: _, // This is populated seperately
-            num_metafits_coarse_chans,
-            obs_bandwidth_hz,
-            coarse_chan_width_hz,
-            centre_freq_hz,
-            metafits_filename,
-        } = metafits_context;
-        MetafitsMetadata {
-            obs_id: *obs_id,
-            global_analogue_attenuation_db: *global_analogue_attenuation_db,
-            ra_tile_pointing_deg: *ra_tile_pointing_degrees,
-            dec_tile_pointing_deg: *dec_tile_pointing_degrees,
-            ra_phase_center_deg: (*ra_phase_center_degrees).unwrap_or(0.),
-            dec_phase_center_deg: (*dec_phase_center_degrees).unwrap_or(0.),
-            az_deg: *az_deg,
-            alt_deg: *alt_deg,
-            za_deg: *za_deg,
-            az_rad: *az_rad,
-            alt_rad: *alt_rad,
-            za_rad: *za_rad,
-            sun_alt_deg: *sun_alt_deg,
-            sun_distance_deg: *sun_distance_deg,
-            moon_distance_deg: *moon_distance_deg,
-            jupiter_distance_deg: *jupiter_distance_deg,
-            lst_deg: *lst_degrees,
-            lst_rad: *lst_radians,
-            hour_angle_string: CString::new(String::from(&*hour_angle_string))
-                .unwrap()
-                .into_raw(),
-            grid_name: CString::new(String::from(&*grid_name)).unwrap().into_raw(),
-            grid_number: *grid_number,
-            creator: CString::new(String::from(&*creator)).unwrap().into_raw(),
-            project_id: CString::new(String::from(&*project_id)).unwrap().into_raw(),
-            obs_name: CString::new(String::from(&*obs_name)).unwrap().into_raw(),
-            mode: *mode,
-            geometric_delays_applied: *geometric_delays_applied,
-            cable_delays_applied: *cable_delays_applied,
-            calibration_delays_and_gains_applied: *calibration_delays_and_gains_applied,
-            corr_fine_chan_width_hz: *corr_fine_chan_width_hz,
-            corr_int_time_ms: *corr_int_time_ms,
-            num_corr_fine_chans_per_coarse: *num_corr_fine_chans_per_coarse,
-            receivers: ffi_array_to_boxed_slice(receivers.clone()),
-            delays: ffi_array_to_boxed_slice(delays.clone()),
-            sched_start_utc: sched_start_utc.timestamp(),
-            sched_end_utc: sched_end_utc.timestamp(),
-            sched_start_mjd: *sched_start_mjd,
-            sched_end_mjd: *sched_end_mjd,
-            sched_start_unix_time_ms: *sched_start_unix_time_ms,
-            sched_end_unix_time_ms: *sched_end_unix_time_ms,
-            sched_start_gps_time_ms: *sched_start_gps_time_ms,
-            sched_end_gps_time_ms: *sched_end_gps_time_ms,
-            sched_duration_ms: *sched_duration_ms,
-            quack_time_duration_ms: *quack_time_duration_ms,
-            good_time_unix_ms: *good_time_unix_ms,
-            good_time_gps_ms: *good_time_gps_ms,
-            num_ants: *num_ants,
-            antennas: ffi_array_to_boxed_slice(antenna_vec),
-            num_rf_inputs: *num_rf_inputs,
-            rf_inputs: ffi_array_to_boxed_slice(rfinput_vec),
-            num_ant_pols: *num_ant_pols,
-            num_baselines: *num_baselines,
-            baselines: ffi_array_to_boxed_slice(baseline_vec),
-            num_visibility_pols: *num_visibility_pols,
-            num_metafits_coarse_chans: *num_metafits_coarse_chans,
-            metafits_coarse_chans: ffi_array_to_boxed_slice(coarse_chan_vec),
-            num_metafits_timesteps: *num_metafits_timesteps,
-            metafits_timesteps: ffi_array_to_boxed_slice(timestep_vec),
-            obs_bandwidth_hz: *obs_bandwidth_hz,
-            coarse_chan_width_hz: *coarse_chan_width_hz,
-            centre_freq_hz: *centre_freq_hz,
-            metafits_filename: CString::new(String::from(&*metafits_filename))
-                .unwrap()
-                .into_raw(),
-        }
+/// Read a single second / coarse channel of MWA voltage data.
+///
+/// This method takes as input a gps_time (in seconds) and a coarse_chan_index to return one
+/// second-worth of voltage data.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `gps_second_start` - GPS second which to start getting data at.
+///
+/// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+///
+/// * `voltage_coarse_chan_index` - index within the coarse_chan array for the desired coarse channel.
+///
+/// * `buffer_ptr` - pointer to caller-owned and allocated buffer of bytes to write data into. Buffer must be large enough
+///                  for all of the data. Calculate the buffer size in bytes using:
+///                  (vcontext.voltage_block_size_bytes * vcontext.num_voltage_blocks_per_second) * gps_second_count
+///
+/// * `buffer_len` - length of `buffer_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated object from the `mwalib_voltage_context_new` function.
+/// * Caller *must* call `mwalib_voltage_context_free_read_buffer` function to release the rust memory.
+/// * This may be called concurrently from multiple threads with the same `voltage_context_ptr`, as long as each thread reads into its own `buffer_ptr`.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_read_second(
+    voltage_context_ptr: *const VoltageContext,
+    gps_second_start: c_ulong,
+    gps_second_count: size_t,
+    voltage_coarse_chan_index: size_t,
+    buffer_ptr: *mut c_uchar,
+    buffer_len: size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    // Load the previously-initialised context and buffer structs. Exit if
+    // either of these are null.
+    let voltage_context = if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_read_by_file() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    } else {
+        &*voltage_context_ptr
+    };
+
+    // Don't do anything if the buffer pointer is null.
+    if buffer_ptr.is_null() {
+        return MWALIB_FAILURE;
+    }
+
+    let output_slice: &mut [u8] = slice::from_raw_parts_mut(buffer_ptr, buffer_len);
+
+    // Read data in.
+    match voltage_context.read_second(
+        gps_second_start,
+        gps_second_count,
+        voltage_coarse_chan_index,
+        output_slice,
+    ) {
+        Ok(_) => MWALIB_SUCCESS,
+        Err(e) => match e {
+            VoltageFileError::NoDataForTimeStepCoarseChannel {
+                timestep_index: _,
+                coarse_chan_index: _,
+            } => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN
+            }
+            _ => {
+                set_error_message(
+                    &format!("{}", e),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                MWALIB_FAILURE
+            }
+        },
+    }
+}
+
+/// Memory map a single timestep / coarse channel of MWA voltage data, so the caller can use the
+/// data in place rather than having it copied into a buffer by `mwalib_voltage_context_read_file`.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `voltage_timestep_index` - index within the voltage timestep array for the desired timestep.
+///
+/// * `voltage_coarse_chan_index` - index within the voltage coarse_chan array for the desired coarse channel.
+///
+/// * `out_voltage_file_mmap_ptr` - A Rust-owned `VoltageFileMmap` pointer. Free with `mwalib_voltage_file_mmap_free`.
+///
+/// * `out_data_ptr` - pointer to the mapped voltage blocks (the same bytes `mwalib_voltage_context_read_file` would have
+///                    written into its buffer). This is only valid until `mwalib_voltage_file_mmap_free` is called.
+///
+/// * `out_data_len` - length in bytes of `out_data_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated object from the `mwalib_voltage_context_new` function.
+/// * `out_data_ptr` must not be written to, or used after the mapping is freed.
+/// * Caller *must* call `mwalib_voltage_file_mmap_free` function to unmap the file.
+/// * This may be called concurrently from multiple threads with the same `voltage_context_ptr`.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_mmap_file(
+    voltage_context_ptr: *const VoltageContext,
+    voltage_timestep_index: size_t,
+    voltage_coarse_chan_index: size_t,
+    out_voltage_file_mmap_ptr: &mut *mut VoltageFileMmap,
+    out_data_ptr: &mut *const c_uchar,
+    out_data_len: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    let voltage_context = if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_mmap_file() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    } else {
+        &*voltage_context_ptr
     };
 
-    // Pass back a pointer to the rust owned struct
-    *out_metafits_metadata_ptr = Box::into_raw(Box::new(out_metadata));
+    match voltage_context.mmap_file(voltage_timestep_index, voltage_coarse_chan_index) {
+        Ok(mmap) => {
+            let data = mmap.data();
+            *out_data_ptr = data.as_ptr();
+            *out_data_len = data.len();
+            *out_voltage_file_mmap_ptr = Box::into_raw(Box::new(mmap));
+
+            MWALIB_SUCCESS
+        }
+        Err(e) => {
+            set_error_message(
+                &format!("{}", e),
+                error_message as *mut u8,
+                error_message_length,
+            );
+
+            match e {
+                VoltageFileError::NoDataForTimeStepCoarseChannel {
+                    timestep_index: _,
+                    coarse_chan_index: _,
+                } => MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN,
+                _ => MWALIB_FAILURE,
+            }
+        }
+    }
+}
+
+/// Memory map the voltage data for a range of GPS seconds for a single coarse channel, so the caller can use
+/// the data in place rather than having it copied into a buffer by `mwalib_voltage_context_read_second`.
+/// The seconds may span more than one data file, so one mapping is returned per data file, in time order.
+/// Concatenating the data of each gives the same bytes as `mwalib_voltage_context_read_second`.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `gps_second_start` - GPS second which to start getting data at.
+///
+/// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+///
+/// * `voltage_coarse_chan_index` - index within the voltage coarse_chan array for the desired coarse channel.
+///
+/// * `out_voltage_file_mmap_ptrs` - pointer to caller-owned array of `max_files` pointers, which are set to Rust-owned
+///                                  `VoltageFileMmap` pointers. Free each with `mwalib_voltage_file_mmap_free`.
+///
+/// * `out_data_ptrs` - pointer to caller-owned array of `max_files` pointers, which are set to the voltage blocks of
+///                     each mapping which are in the requested GPS seconds. Each is only valid until its mapping is freed.
+///
+/// * `out_data_lens` - pointer to caller-owned array of `max_files` lengths in bytes of `out_data_ptrs`.
+///
+/// * `max_files` - length of the `out_voltage_file_mmap_ptrs`, `out_data_ptrs` and `out_data_lens` arrays.
+///
+/// * `out_num_files` - set to the number of data files the GPS seconds span (and so the number of mappings returned).
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, MWALIB_NO_DATA_FOR_TIMESTEP_COARSE_CHAN if the combination of timestep and coarse channel has no associated data file (no data), any other non-zero code on failure.
+///   If the seconds span more than `max_files` data files, nothing is mapped, `out_num_files` is set to the number needed and MWALIB_FAILURE is returned.
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated object from the `mwalib_voltage_context_new` function.
+/// * `out_voltage_file_mmap_ptrs`, `out_data_ptrs` and `out_data_lens` must each point to an array of at least `max_files` elements.
+/// * The data pointed to by `out_data_ptrs` must not be written to, or used after its mapping is freed.
+/// * Caller *must* call `mwalib_voltage_file_mmap_free` for each of the first `out_num_files` mappings to unmap them.
+/// * This may be called concurrently from multiple threads with the same `voltage_context_ptr`.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_mmap_second(
+    voltage_context_ptr: *const VoltageContext,
+    gps_second_start: c_ulong,
+    gps_second_count: size_t,
+    voltage_coarse_chan_index: size_t,
+    out_voltage_file_mmap_ptrs: *mut *mut VoltageFileMmap,
+    out_data_ptrs: *mut *const c_uchar,
+    out_data_lens: *mut size_t,
+    max_files: size_t,
+    out_num_files: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    let voltage_context = if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_mmap_second() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    } else {
+        &*voltage_context_ptr
+    };
+
+    // Don't do anything if any of the output arrays are null.
+    if out_voltage_file_mmap_ptrs.is_null() || out_data_ptrs.is_null() || out_data_lens.is_null() {
+        return MWALIB_FAILURE;
+    }
+
+    match voltage_context.mmap_second(
+        gps_second_start,
+        gps_second_count,
+        voltage_coarse_chan_index,
+    ) {
+        Ok(mmaps) => {
+            *out_num_files = mmaps.len();
+            if mmaps.len() > max_files {
+                set_error_message(
+                    &format!(
+                        "mwalib_voltage_context_mmap_second() ERROR: the GPS seconds span {} data files, but max_files is {}",
+                        mmaps.len(),
+                        max_files
+                    ),
+                    error_message as *mut u8,
+                    error_message_length,
+                );
+                return MWALIB_FAILURE;
+            }
+
+            let mmap_ptrs = slice::from_raw_parts_mut(out_voltage_file_mmap_ptrs, mmaps.len());
+            let data_ptrs = slice::from_raw_parts_mut(out_data_ptrs, mmaps.len());
+            let data_lens = slice::from_raw_parts_mut(out_data_lens, mmaps.len());
+            for (i, seconds_mmap) in mmaps.into_iter().enumerate() {
+                // The data lives in the mapping, not the struct, so it does not move with it
+                let data = seconds_mmap.data();
+                data_ptrs[i] = data.as_ptr();
+                data_lens[i] = data.len();
+                mmap_ptrs[i] = Box::into_raw(Box::new(seconds_mmap.mmap));
+            }
+
+            MWALIB_SUCCESS
+        }
+        Err(e) => {
+            set_error_message(
+                &format!("{}", e),
+                error_message as *mut u8,
+                error_message_length,
+            );
+
+            match e {
+                VoltageFileError::NoDataForTimeStepCoarseChannel {
+                    timestep_index: _,
+                    coarse_chan_index: _,
+                } => MWALIB_NO_DATA_FOR_TIMESTEP_COARSECHAN,
+                _ => MWALIB_FAILURE,
+            }
+        }
+    }
+}
+
+/// Get the header and delay block of a memory mapped voltage file.
+///
+/// # Arguments
+///
+/// * `voltage_file_mmap_ptr` - pointer to a `VoltageFileMmap` from `mwalib_voltage_context_mmap_file` or `mwalib_voltage_context_mmap_second`.
+///
+/// * `out_header_ptr` - pointer to the mapped header (empty for legacy VCS). Only valid until the mapping is freed.
+///
+/// * `out_header_len` - length in bytes of `out_header_ptr`.
+///
+/// * `out_delay_block_ptr` - pointer to the mapped delay block (empty for legacy VCS). Only valid until the mapping is freed.
+///
+/// * `out_delay_block_len` - length in bytes of `out_delay_block_ptr`.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `voltage_file_mmap_ptr` must point to a `VoltageFileMmap` from `mwalib_voltage_context_mmap_file` or `mwalib_voltage_context_mmap_second` which has not been freed.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_file_mmap_get_header(
+    voltage_file_mmap_ptr: *const VoltageFileMmap,
+    out_header_ptr: &mut *const c_uchar,
+    out_header_len: &mut size_t,
+    out_delay_block_ptr: &mut *const c_uchar,
+    out_delay_block_len: &mut size_t,
+) -> i32 {
+    if voltage_file_mmap_ptr.is_null() {
+        return MWALIB_FAILURE;
+    }
+    let mmap = &*voltage_file_mmap_ptr;
+
+    *out_header_ptr = mmap.header().as_ptr();
+    *out_header_len = mmap.header().len();
+    *out_delay_block_ptr = mmap.delay_block().as_ptr();
+    *out_delay_block_len = mmap.delay_block().len();
+
+    MWALIB_SUCCESS
+}
+
+/// Unmap a voltage file previously mapped by `mwalib_voltage_context_mmap_file` or `mwalib_voltage_context_mmap_second`.
+///
+/// # Arguments
+///
+/// * `voltage_file_mmap_ptr` - pointer to a `VoltageFileMmap` from `mwalib_voltage_context_mmap_file` or `mwalib_voltage_context_mmap_second`.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * This must be called once caller is finished with the mapped data.
+/// * `voltage_file_mmap_ptr` must point to a `VoltageFileMmap` from `mwalib_voltage_context_mmap_file` or `mwalib_voltage_context_mmap_second`.
+/// * `voltage_file_mmap_ptr` must not have already been freed, and no pointers obtained from it may be used afterwards.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_file_mmap_free(
+    voltage_file_mmap_ptr: *mut VoltageFileMmap,
+) -> i32 {
+    if voltage_file_mmap_ptr.is_null() {
+        return MWALIB_SUCCESS;
+    }
+    // Unmap the file
+    drop(Box::from_raw(voltage_file_mmap_ptr));
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+/// Free a previously-allocated `VoltageContext` struct (and it's members).
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * This must be called once caller is finished with the `VoltageContext` object
+/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
+/// * `voltage_context_ptr` must not have already been freed.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_free(
+    voltage_context_ptr: *mut VoltageContext,
+) -> i32 {
+    if voltage_context_ptr.is_null() {
+        return MWALIB_SUCCESS;
+    }
+    // Release voltage context if applicable
+    Box::from_raw(voltage_context_ptr);
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+///
+/// This a C struct to allow the caller to consume the metafits metadata
+///
+#[repr(C)]
+pub struct MetafitsMetadata {
+    /// Observation id
+    pub obs_id: u32,
+    /// ATTEN_DB  // global analogue attenuation, in dB
+    pub global_analogue_attenuation_db: f64,
+    /// RA tile pointing
+    pub ra_tile_pointing_deg: f64,
+    /// DEC tile pointing
+    pub dec_tile_pointing_deg: f64,
+    /// RA phase centre
+    pub ra_phase_center_deg: f64,
+    /// DEC phase centre
+    pub dec_phase_center_deg: f64,
+    /// AZIMUTH
+    pub az_deg: f64,
+    /// ALTITUDE
+    pub alt_deg: f64,
+    /// Zenith angle of the pointing centre in degrees
+    pub za_deg: f64,
+    /// AZIMUTH of the pointing centre in radians
+    pub az_rad: f64,
+    /// ALTITUDE (a.k.a. elevation) of the pointing centre in radians
+    pub alt_rad: f64,
+    /// Zenith angle of the pointing centre in radians
+    pub za_rad: f64,
+    /// Altitude of Sun
+    pub sun_alt_deg: f64,
+    /// Distance from pointing center to Sun
+    pub sun_distance_deg: f64,
+    /// Distance from pointing center to the Moon
+    pub moon_distance_deg: f64,
+    /// Distance from pointing center to Jupiter
+    pub jupiter_distance_deg: f64,
+    /// Local Sidereal Time
+    pub lst_deg: f64,
+    /// Local Sidereal Time in radians
+    pub lst_rad: f64,
+    /// Hour Angle of pointing center (as a string)
+    pub hour_angle_string: *mut c_char,
+    /// GRIDNAME
+    pub grid_name: *mut c_char,
+    /// GRIDNUM
+    pub grid_number: i32,
+    /// CREATOR
+    pub creator: *mut c_char,
+    /// PROJECT
+    pub project_id: *mut c_char,
+    /// Observation name
+    pub obs_name: *mut c_char,
+    /// MWA observation mode
+    pub mode: MWAMode,
+    /// Which Geometric delays have been applied to the data
+    pub geometric_delays_applied: GeometricDelaysApplied,
+    /// Have cable delays been applied to the data?    
+    pub cable_delays_applied: bool,
+    /// Have calibration delays and gains been applied to the data?
+    pub calibration_delays_and_gains_applied: bool,
+    /// Correlator fine_chan_resolution
+    pub corr_fine_chan_width_hz: u32,
+    /// Correlator mode dump time
+    pub corr_int_time_ms: u64,
+    /// Number of fine channels in each coarse channel for a correlator observation
+    pub num_corr_fine_chans_per_coarse: usize,
+    /// RECVRS    Array of receiver numbers (this tells us how many receivers too)
+    pub receivers: *mut usize,
+    /// DELAYS    Array of delays
+    pub delays: *mut u32,
+    /// Scheduled start (gps time) of observation
+    pub sched_start_utc: i64,
+    /// Scheduled end (gps time) of observation
+    pub sched_end_utc: i64,
+    /// Scheduled start (MJD) of observation
+    pub sched_start_mjd: f64,
+    /// Scheduled end (MJD) of observation
+    pub sched_end_mjd: f64,
+    /// Scheduled start (UNIX time) of observation
+    pub sched_start_unix_time_ms: u64,
+    /// Scheduled end (UNIX time) of observation
+    pub sched_end_unix_time_ms: u64,
+    /// Scheduled start (GPS) of observation
+    pub sched_start_gps_time_ms: u64,
+    /// Scheduled end (GPS) of observation
+    pub sched_end_gps_time_ms: u64,
+    /// Scheduled duration of observation
+    pub sched_duration_ms: u64,
+    /// Seconds of bad data after observation starts
+    pub quack_time_duration_ms: u64,
+    /// OBSID+QUACKTIM as Unix timestamp (first good timestep)
+    pub good_time_unix_ms: u64,
+    /// Good time expressed as GPS seconds
+    pub good_time_gps_ms: u64,
+    /// Total number of antennas (tiles) in the array
+    pub num_ants: usize,
+    /// Array of antennas
+    pub antennas: *mut Antenna,
+    /// The Metafits defines an rf chain for antennas(tiles) * pol(X,Y)
+    pub num_rf_inputs: usize,
+    /// Array of rf inputs
+    pub rf_inputs: *mut Rfinput,
+    /// Number of antenna pols. e.g. X and Y
+    pub num_ant_pols: usize,
+    /// Number of baselines
+    pub num_baselines: usize,
+    /// Baseline array
+    pub baselines: *mut Baseline,
+    /// Number of visibility_pols
+    pub num_visibility_pols: usize,
+    /// Number of coarse channels based on the metafits
+    pub num_metafits_coarse_chans: usize,
+    /// metafits_coarse_chans array
+    pub metafits_coarse_chans: *mut CoarseChannel,
+    /// Number of timesteps based on the metafits
+    pub num_metafits_timesteps: usize,
+    /// metafits_timesteps array
+    pub metafits_timesteps: *mut TimeStep,
+    /// Total bandwidth of observation assuming we have all coarse channels
+    pub obs_bandwidth_hz: u32,
+    /// Bandwidth of each coarse channel
+    pub coarse_chan_width_hz: u32,
+    /// Centre frequency of observation
+    pub centre_freq_hz: u32,
+    /// filename of metafits file used
+    pub metafits_filename: *mut c_char,
+}
+
+/// This passed back a struct containing the `MetafitsContext` metadata, given a MetafitsContext, CorrelatorContext or VoltageContext
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object. (Exclusive with correlator_context_ptr and voltage_context_ptr)
+///
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object. (Exclusive with metafits_context_ptr and voltage_context_ptr)
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object. (Exclusive with metafits_context_ptr and correlator_context_ptr)
+///
+/// * `out_metafits_metadata_ptr` - pointer to a Rust-owned `mwalibMetafitsMetadata` struct. Free with `mwalib_metafits_metadata_free`
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated MetafitsContext object from the `mwalib_metafits_context_new` function OR
+/// * `correlator_context_ptr` must point to a populated CorrelatorContext object from the 'mwalib_correlator_context_new' function OR
+/// * `voltage_context_ptr` must point to a populated VoltageContext object from the `mwalib_voltage_context_new` function. (Set the unused contexts to NULL).
+/// * Caller must call `mwalib_metafits_metadata_free` once finished, to free the rust memory.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_metadata_get(
+    metafits_context_ptr: *const MetafitsContext,
+    correlator_context_ptr: *const CorrelatorContext,
+    voltage_context_ptr: *const VoltageContext,
+    out_metafits_metadata_ptr: &mut *mut MetafitsMetadata,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    // Ensure only either metafits XOR correlator XOR voltage context is passed in
+    if !(!metafits_context_ptr.is_null()
+        ^ !correlator_context_ptr.is_null()
+        ^ !voltage_context_ptr.is_null())
+    {
+        set_error_message(
+            "mwalib_metafits_metadata_get() ERROR: pointers for metafits_context_ptr, correlator_context_ptr and/or voltage_context_ptr were passed in. Only one should be provided.",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    // Create our metafits context pointer depending on what was passed in
+    let metafits_context = if !metafits_context_ptr.is_null() {
+        // Caller passed in a metafits context, so use that
+        &*metafits_context_ptr
+    } else if !correlator_context_ptr.is_null() {
+        // Caller passed in a correlator context, so use that
+        &(*correlator_context_ptr).metafits_context
+    } else {
+        // Caller passed in a voltage context, so use that
+        &(*voltage_context_ptr).metafits_context
+    };
+
+    // Populate baselines
+    let mut baseline_vec: Vec<Baseline> = Vec::new();
+    for item in metafits_context.baselines.iter() {
+        let out_item = {
+            let baseline::Baseline {
+                ant1_index,
+                ant2_index,
+            } = item;
+            Baseline {
+                ant1_index: *ant1_index,
+                ant2_index: *ant2_index,
+            }
+        };
+
+        baseline_vec.push(out_item);
+    }
+
+    // Populate antennas
+    let mut antenna_vec: Vec<Antenna> = Vec::new();
+    for item in metafits_context.antennas.iter() {
+        antenna_vec.push(ffi_antenna(
+            item,
+            CString::new(item.tile_name.as_str()).unwrap().into_raw(),
+        ));
+    }
+
+    // Populate rf_inputs
+    let mut rfinput_vec: Vec<Rfinput> = Vec::new();
+    for item in metafits_context.rf_inputs.iter() {
+        rfinput_vec.push(ffi_rfinput(
+            item,
+            CString::new(item.tile_name.as_str()).unwrap().into_raw(),
+            CString::new(item.pol.to_string()).unwrap().into_raw(),
+        ));
+    }
+
+    // Populate metafits coarse channels
+    let mut coarse_chan_vec: Vec<CoarseChannel> = Vec::new();
+
+    for item in metafits_context.metafits_coarse_chans.iter() {
+        let out_item = {
+            let coarse_channel::CoarseChannel {
+                corr_chan_number,
+                rec_chan_number,
+                gpubox_number,
+                chan_width_hz,
+                chan_start_hz,
+                chan_centre_hz,
+                chan_end_hz,
+            } = item;
+            CoarseChannel {
+                corr_chan_number: *corr_chan_number,
+                rec_chan_number: *rec_chan_number,
+                gpubox_number: *gpubox_number,
+                chan_width_hz: *chan_width_hz,
+                chan_start_hz: *chan_start_hz,
+                chan_centre_hz: *chan_centre_hz,
+                chan_end_hz: *chan_end_hz,
+            }
+        };
+
+        coarse_chan_vec.push(out_item);
+    }
+
+    // Populate metafits timesteps
+    let mut timestep_vec: Vec<TimeStep> = Vec::new();
+
+    for item in metafits_context.metafits_timesteps.iter() {
+        let out_item = {
+            let timestep::TimeStep {
+                unix_time_ms,
+                gps_time_ms,
+            } = item;
+            TimeStep {
+                unix_time_ms: *unix_time_ms,
+                gps_time_ms: *gps_time_ms,
+            }
+        };
+        timestep_vec.push(out_item);
+    }
+
+    // Populate the outgoing structure with data from the metafits context
+    // We explicitly break out the attributes so at compile time it will let us know
+    // if there have been new fields added to the rust struct, then we can choose to
+    // ignore them (with _) or add that field to the FFI struct.
+    let out_metadata = {
+        let MetafitsContext {
+            obs_id,
+            sched_start_gps_time_ms,
+            sched_end_gps_time_ms,
+            sched_start_unix_time_ms,
+            sched_end_unix_time_ms,
+            sched_start_utc,
+            sched_end_utc,
+            sched_start_mjd,
+            sched_end_mjd,
+            sched_duration_ms,
+            ra_tile_pointing_degrees,
+            dec_tile_pointing_degrees,
+            ra_phase_center_degrees,
+            dec_phase_center_degrees,
+            az_deg,
+            alt_deg,
+            za_deg,
+            az_rad,
+            alt_rad,
+            za_rad,
+            sun_alt_deg,
+            sun_distance_deg,
+            moon_distance_deg,
+            jupiter_distance_deg,
+            lst_deg: lst_degrees,
+            lst_rad: lst_radians,
+            hour_angle_string,
+            grid_name,
+            grid_number,
+            creator,
+            project_id,
+            obs_name,
+            mode,
+            geometric_delays_applied,
+            cable_delays_applied,
+            calibration_delays_and_gains_applied,
+            corr_fine_chan_width_hz,
+            corr_int_time_ms,
+            num_corr_fine_chans_per_coarse,
+            receivers,
+            delays,
+            global_analogue_attenuation_db,
+            quack_time_duration_ms,
+            good_time_unix_ms,
+            good_time_gps_ms,
+            num_ants,
+            antennas: _, // This is populated seperately
+            num_rf_inputs,
+            rf_inputs: _, // This is populated seperately
+            num_ant_pols,
+            num_baselines,
+            baselines: _, // This is populated seperately
+            num_visibility_pols,
+            metafits_timesteps: _, // This is populated seperately
+            num_metafits_timesteps,
+            metafits_coarse_chans: _, // This is populated seperately
+            num_metafits_coarse_chans,
+            obs_bandwidth_hz,
+            coarse_chan_width_hz,
+            centre_freq_hz,
+            metafits_filename,
+            ffi_metadata_cache: _, // This is not provided to FFI via this struct
+            mwa_version: _,        // This is currently not provided to FFI as it is private
+            baseline_lookup: _,    // Provided by mwalib_metafits_context_get_baseline_table
+            metafits_coarse_chan_vec: _, // Provided via metafits_coarse_chans
+        } = metafits_context;
+        MetafitsMetadata {
+            obs_id: *obs_id,
+            global_analogue_attenuation_db: *global_analogue_attenuation_db,
+            ra_tile_pointing_deg: *ra_tile_pointing_degrees,
+            dec_tile_pointing_deg: *dec_tile_pointing_degrees,
+            ra_phase_center_deg: (*ra_phase_center_degrees).unwrap_or(0.),
+            dec_phase_center_deg: (*dec_phase_center_degrees).unwrap_or(0.),
+            az_deg: *az_deg,
+            alt_deg: *alt_deg,
+            za_deg: *za_deg,
+            az_rad: *az_rad,
+            alt_rad: *alt_rad,
+            za_rad: *za_rad,
+            sun_alt_deg: *sun_alt_deg,
+            sun_distance_deg: *sun_distance_deg,
+            moon_distance_deg: *moon_distance_deg,
+            jupiter_distance_deg: *jupiter_distance_deg,
+            lst_deg: *lst_degrees,
+            lst_rad: *lst_radians,
+            hour_angle_string: CString::new(String::from(&*hour_angle_string))
+                .unwrap()
+                .into_raw(),
+            grid_name: CString::new(String::from(&*grid_name)).unwrap().into_raw(),
+            grid_number: *grid_number,
+            creator: CString::new(String::from(&*creator)).unwrap().into_raw(),
+            project_id: CString::new(String::from(&*project_id)).unwrap().into_raw(),
+            obs_name: CString::new(String::from(&*obs_name)).unwrap().into_raw(),
+            mode: *mode,
+            geometric_delays_applied: *geometric_delays_applied,
+            cable_delays_applied: *cable_delays_applied,
+            calibration_delays_and_gains_applied: *calibration_delays_and_gains_applied,
+            corr_fine_chan_width_hz: *corr_fine_chan_width_hz,
+            corr_int_time_ms: *corr_int_time_ms,
+            num_corr_fine_chans_per_coarse: *num_corr_fine_chans_per_coarse,
+            receivers: ffi_array_to_boxed_slice(receivers.clone()),
+            delays: ffi_array_to_boxed_slice(delays.clone()),
+            sched_start_utc: sched_start_utc.timestamp(),
+            sched_end_utc: sched_end_utc.timestamp(),
+            sched_start_mjd: *sched_start_mjd,
+            sched_end_mjd: *sched_end_mjd,
+            sched_start_unix_time_ms: *sched_start_unix_time_ms,
+            sched_end_unix_time_ms: *sched_end_unix_time_ms,
+            sched_start_gps_time_ms: *sched_start_gps_time_ms,
+            sched_end_gps_time_ms: *sched_end_gps_time_ms,
+            sched_duration_ms: *sched_duration_ms,
+            quack_time_duration_ms: *quack_time_duration_ms,
+            good_time_unix_ms: *good_time_unix_ms,
+            good_time_gps_ms: *good_time_gps_ms,
+            num_ants: *num_ants,
+            antennas: ffi_array_to_boxed_slice(antenna_vec),
+            num_rf_inputs: *num_rf_inputs,
+            rf_inputs: ffi_array_to_boxed_slice(rfinput_vec),
+            num_ant_pols: *num_ant_pols,
+            num_baselines: *num_baselines,
+            baselines: ffi_array_to_boxed_slice(baseline_vec),
+            num_visibility_pols: *num_visibility_pols,
+            num_metafits_coarse_chans: *num_metafits_coarse_chans,
+            metafits_coarse_chans: ffi_array_to_boxed_slice(coarse_chan_vec),
+            num_metafits_timesteps: *num_metafits_timesteps,
+            metafits_timesteps: ffi_array_to_boxed_slice(timestep_vec),
+            obs_bandwidth_hz: *obs_bandwidth_hz,
+            coarse_chan_width_hz: *coarse_chan_width_hz,
+            centre_freq_hz: *centre_freq_hz,
+            metafits_filename: CString::new(String::from(&*metafits_filename))
+                .unwrap()
+                .into_raw(),
+        }
+    };
+
+    // Pass back a pointer to the rust owned struct
+    *out_metafits_metadata_ptr = Box::into_raw(Box::new(out_metadata));
+
+    // Return Success
+    MWALIB_SUCCESS
+}
+
+/// Free a previously-allocated `mwalibMetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_metadata_ptr` - pointer to an already populated `mwalibMetafitsMetadata` object
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * This must be called once caller is finished with the `mwalibMetafitsMetadata` object
+/// * `metafits_metadata_ptr` must point to a populated `mwalibMetafitsMetadata` object from the `mwalib_metafits_metadata_get` function.
+/// * `metafits_metadata_ptr` must not have already been freed.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_metadata_free(
+    metafits_metadata_ptr: *mut MetafitsMetadata,
+) -> i32 {
+    // If the pointer is null, just return
+    if metafits_metadata_ptr.is_null() {
+        return MWALIB_SUCCESS;
+    }
+
+    //
+    // Free members first
+    //
+    // baselines
+    if !(*metafits_metadata_ptr).baselines.is_null() {
+        drop(Box::from_raw((*metafits_metadata_ptr).baselines));
+    }
+
+    // antennas
+    if !(*metafits_metadata_ptr).antennas.is_null() {
+        // Extract a slice from the pointer
+        let slice: &mut [Antenna] = slice::from_raw_parts_mut(
+            (*metafits_metadata_ptr).antennas,
+            (*metafits_metadata_ptr).num_ants,
+        );
+        // Now for each item we need to free anything on the heap
+        for i in slice.iter_mut() {
+            drop(Box::from_raw(i.tile_name));
+        }
+
+        // Free the memory for the slice
+        drop(Box::from_raw(slice));
+    }
+
+    // rf inputs
+    if !(*metafits_metadata_ptr).rf_inputs.is_null() {
+        // Extract a slice from the pointer
+        let slice: &mut [Rfinput] = slice::from_raw_parts_mut(
+            (*metafits_metadata_ptr).rf_inputs,
+            (*metafits_metadata_ptr).num_rf_inputs,
+        );
+        // Now for each item we need to free anything on the heap
+        for i in slice.iter_mut() {
+            drop(Box::from_raw(i.tile_name));
+            drop(Box::from_raw(i.pol));
+        }
+
+        // Free the memory for the slice
+        drop(Box::from_raw(slice));
+    }
+
+    // coarse_channels
+    if !(*metafits_metadata_ptr).metafits_coarse_chans.is_null() {
+        drop(Box::from_raw(
+            (*metafits_metadata_ptr).metafits_coarse_chans,
+        ));
+    }
+
+    // timesteps
+    if !(*metafits_metadata_ptr).metafits_timesteps.is_null() {
+        drop(Box::from_raw((*metafits_metadata_ptr).metafits_timesteps));
+    }
+
+    // receivers
+    if !(*metafits_metadata_ptr).receivers.is_null() {
+        drop(Box::from_raw((*metafits_metadata_ptr).receivers));
+    }
+
+    // delays
+    if !(*metafits_metadata_ptr).delays.is_null() {
+        drop(Box::from_raw((*metafits_metadata_ptr).delays));
+    }
+
+    // Free main metadata struct
+    drop(Box::from_raw(metafits_metadata_ptr));
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+///
+/// C Representation of the `CorrelatorContext` metadata
+///
+#[repr(C)]
+pub struct CorrelatorMetadata {
+    /// Version of the correlator format
+    pub mwa_version: MWAVersion,
+    /// This is an array of all known timesteps (union of metafits and provided timesteps from data files)
+    pub timesteps: *mut TimeStep,
+    /// Count all known timesteps (union of metafits and provided timesteps from data files)
+    pub num_timesteps: usize,
+    /// Vector of coarse channels which is the effectively the same as the metafits provided coarse channels
+    pub coarse_chans: *mut CoarseChannel,
+    /// Count of coarse channels (same as metafits coarse channel count)
+    pub num_coarse_chans: usize,
+    /// Count of common timesteps
+    pub num_common_timesteps: usize,
+    /// Vector of (in)common timestep indices
+    pub common_timestep_indices: *mut usize,
+    /// Count of common coarse channels
+    pub num_common_coarse_chans: usize,
+    /// Indices of common coarse channels
+    pub common_coarse_chan_indices: *mut usize,
+    /// The proper start of the observation (the time that is common to all
+    /// provided gpubox files).
+    pub common_start_unix_time_ms: u64,
+    /// `end_time_ms` will is the actual end time of the observation
+    /// i.e. start time of last common timestep plus integration time.
+    pub common_end_unix_time_ms: u64,
+    /// `start_unix_time_ms` but in GPS milliseconds
+    pub common_start_gps_time_ms: u64,
+    /// `end_unix_time_ms` but in GPS milliseconds
+    pub common_end_gps_time_ms: u64,
+    /// Total duration of observation (based on gpubox files)
+    pub common_duration_ms: u64,
+    /// Total bandwidth of the common coarse channels which have been provided (which may be less than or equal to the bandwith in the MetafitsContext)
+    pub common_bandwidth_hz: u32,
+    /// Number of common timesteps only including timesteps after the quack time
+    pub num_common_good_timesteps: usize,
+    /// Vector of (in)common timestep indices only including timesteps after the quack time
+    pub common_good_timestep_indices: *mut usize,
+    /// Number of common coarse channels only including timesteps after the quack time
+    pub num_common_good_coarse_chans: usize,
+    /// Vector of (in)common timestep indices only including timesteps after the quack time
+    pub common_good_coarse_chan_indices: *mut usize,
+    /// The start of the observation (the time that is common to all
+    /// provided gpubox files) only including timesteps after the quack time
+    pub common_good_start_unix_time_ms: u64,
+    /// `end_unix_time_ms` is the common end time of the observation only including timesteps after the quack time
+    /// i.e. start time of last common timestep plus integration time.
+    pub common_good_end_unix_time_ms: u64,
+    /// `common_good_start_unix_time_ms` but in GPS milliseconds
+    pub common_good_start_gps_time_ms: u64,
+    /// `common_good_end_unix_time_ms` but in GPS milliseconds
+    pub common_good_end_gps_time_ms: u64,
+    /// Total duration of common_good timesteps
+    pub common_good_duration_ms: u64,
+    /// Total bandwidth of the common coarse channels only including timesteps after the quack time
+    pub common_good_bandwidth_hz: u32,
+    /// Number of provided timestep indices we have at least *some* data for
+    pub num_provided_timesteps: usize,
+    /// The indices of any timesteps which we have *some* data for
+    pub provided_timestep_indices: *mut usize,
+    /// Number of provided coarse channel indices we have at least *some* data for
+    pub num_provided_coarse_chans: usize,
+    /// The indices of any coarse channels which we have *some* data for
+    pub provided_coarse_chan_indices: *mut usize,
+    /// The number of bytes taken up by a scan/timestep in each gpubox file.
+    pub num_timestep_coarse_chan_bytes: usize,
+    /// The number of floats in each gpubox HDU.
+    pub num_timestep_coarse_chan_floats: usize,
+    /// This is the number of gpubox files *per batch*.
+    pub num_gpubox_files: usize,
+}
+
+/// This returns a struct containing the `CorrelatorContext` metadata
+///
+/// # Arguments
+///
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `out_correaltor_metadata_ptr` - A Rust-owned populated `CorrelatorMetadata` struct. Free with `mwalib_correlator_metadata_free`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
+/// * Caller must call `mwalib_correlator_metadata_free` once finished, to free the rust memory.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_metadata_get(
+    correlator_context_ptr: *const CorrelatorContext,
+    out_correlator_metadata_ptr: &mut *mut CorrelatorMetadata,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if correlator_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_metadata_get() ERROR: Warning: null pointer for correlator_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+    // Get the correlator context object from the raw pointer passed in
+    let context = &*correlator_context_ptr;
+
+    // Populate correlator coarse channels
+    let mut coarse_chan_vec: Vec<CoarseChannel> = Vec::new();
+
+    for item in context.coarse_chans.iter() {
+        let out_item = {
+            let coarse_channel::CoarseChannel {
+                corr_chan_number,
+                rec_chan_number,
+                gpubox_number,
+                chan_width_hz,
+                chan_start_hz,
+                chan_centre_hz,
+                chan_end_hz,
+            } = item;
+            CoarseChannel {
+                corr_chan_number: *corr_chan_number,
+                rec_chan_number: *rec_chan_number,
+                gpubox_number: *gpubox_number,
+                chan_width_hz: *chan_width_hz,
+                chan_start_hz: *chan_start_hz,
+                chan_centre_hz: *chan_centre_hz,
+                chan_end_hz: *chan_end_hz,
+            }
+        };
+
+        coarse_chan_vec.push(out_item);
+    }
+
+    // Populate correlator timesteps
+    let mut timestep_vec: Vec<TimeStep> = Vec::new();
+
+    for item in context.timesteps.iter() {
+        let out_item = {
+            let timestep::TimeStep {
+                unix_time_ms,
+                gps_time_ms,
+            } = item;
+            TimeStep {
+                unix_time_ms: *unix_time_ms,
+                gps_time_ms: *gps_time_ms,
+            }
+        };
+        timestep_vec.push(out_item);
+    }
+
+    // Populate the rust owned data structure with data from the correlator context
+    // We explicitly break out the attributes so at compile time it will let us know
+    // if there have been new fields added to the rust struct, then we can choose to
+    // ignore them (with _) or add that field to the FFI struct.
+    let out_context = {
+        let CorrelatorContext {
+            metafits_context: _, // This is provided by the seperate metafits_metadata struct in FFI
+            mwa_version,
+            num_timesteps,
+            timesteps: _, // This is populated seperately
+            num_coarse_chans,
+            coarse_chans: _, // This is populated seperately
+            common_timestep_indices,
+            num_common_timesteps,
+            common_coarse_chan_indices,
+            num_common_coarse_chans,
+            common_start_unix_time_ms,
+            common_end_unix_time_ms,
+            common_start_gps_time_ms,
+            common_end_gps_time_ms,
+            common_duration_ms,
+            common_bandwidth_hz,
+            common_good_timestep_indices,
+            num_common_good_timesteps,
+            common_good_coarse_chan_indices,
+            num_common_good_coarse_chans,
+            common_good_start_unix_time_ms,
+            common_good_end_unix_time_ms,
+            common_good_start_gps_time_ms,
+            common_good_end_gps_time_ms,
+            common_good_duration_ms,
+            common_good_bandwidth_hz,
+            provided_timestep_indices,
+            num_provided_timesteps: num_provided_timestep_indices,
+            provided_coarse_chan_indices,
+            num_provided_coarse_chans: num_provided_coarse_chan_indices,
+            num_timestep_coarse_chan_bytes,
+            num_timestep_coarse_chan_floats,
+            num_timestep_coarse_chan_weight_floats: _, // This is currently not provided to FFI
+            num_gpubox_files,
+            gpubox_batches: _, // This is currently not provided to FFI as it is private
+            gpubox_time_map: _, // This is currently not provided to FFI
+            gpubox_hdu_locations: _, // This is currently not provided to FFI as it is private
+            legacy_conversion_table: _, // This is currently not provided to FFI as it is private
+            auto_baseline_indices: _, // This is currently not provided to FFI as it is private
+            legacy_auto_conversion_table: _, // This is currently not provided to FFI as it is private
+            gpubox_fits_handle_cache: _, // This is currently not provided to FFI as it is private
+            scratch_buffers: _,          // This is currently not provided to FFI as it is private
+            read_counters: _,            // Provided by mwalib_correlator_context_get_stats
+            thread_pool: _, // This is currently not provided to FFI, see mwalib_set_num_threads
+            deferred_gpubox_validation: _, // This is currently not provided to FFI as it is private
+            data_sources: _, // This is currently not provided to FFI
+            visibility_cache: _, // This is currently not provided to FFI
+        } = context;
+        CorrelatorMetadata {
+            mwa_version: *mwa_version,
+            num_timesteps: *num_timesteps,
+            timesteps: ffi_array_to_boxed_slice(timestep_vec),
+            num_coarse_chans: *num_coarse_chans,
+            coarse_chans: ffi_array_to_boxed_slice(coarse_chan_vec),
+            num_common_timesteps: *num_common_timesteps,
+            common_timestep_indices: ffi_array_to_boxed_slice(common_timestep_indices.clone()),
+            num_common_coarse_chans: *num_common_coarse_chans,
+            common_coarse_chan_indices: ffi_array_to_boxed_slice(
+                common_coarse_chan_indices.clone(),
+            ),
+            common_start_unix_time_ms: *common_start_unix_time_ms,
+            common_end_unix_time_ms: *common_end_unix_time_ms,
+            common_start_gps_time_ms: *common_start_gps_time_ms,
+            common_end_gps_time_ms: *common_end_gps_time_ms,
+            common_duration_ms: *common_duration_ms,
+            common_bandwidth_hz: *common_bandwidth_hz,
+
+            num_common_good_timesteps: *num_common_good_timesteps,
+            common_good_timestep_indices: ffi_array_to_boxed_slice(
+                common_good_timestep_indices.clone(),
+            ),
+            num_common_good_coarse_chans: *num_common_good_coarse_chans,
+            common_good_coarse_chan_indices: ffi_array_to_boxed_slice(
+                common_good_coarse_chan_indices.clone(),
+            ),
+            common_good_start_unix_time_ms: *common_good_start_unix_time_ms,
+            common_good_end_unix_time_ms: *common_good_end_unix_time_ms,
+            common_good_start_gps_time_ms: *common_good_start_gps_time_ms,
+            common_good_end_gps_time_ms: *common_good_end_gps_time_ms,
+            common_good_duration_ms: *common_good_duration_ms,
+            common_good_bandwidth_hz: *common_good_bandwidth_hz,
+
+            num_provided_timesteps: *num_provided_timestep_indices,
+            provided_timestep_indices: ffi_array_to_boxed_slice(provided_timestep_indices.clone()),
+            num_provided_coarse_chans: *num_provided_coarse_chan_indices,
+            provided_coarse_chan_indices: ffi_array_to_boxed_slice(
+                provided_coarse_chan_indices.clone(),
+            ),
+            num_timestep_coarse_chan_bytes: *num_timestep_coarse_chan_bytes,
+            num_timestep_coarse_chan_floats: *num_timestep_coarse_chan_floats,
+            num_gpubox_files: *num_gpubox_files,
+        }
+    };
+
+    // Pass out the pointer to the rust owned data structure
+    *out_correlator_metadata_ptr = Box::into_raw(Box::new(out_context));
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+/// Free a previously-allocated `CorrelatorMetadata` struct.
+///
+/// # Arguments
+///
+/// * `correlator_metadata_ptr` - pointer to an already populated `CorrelatorMetadata` object
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * This must be called once caller is finished with the `CorrelatorMetadata` object
+/// * `correlator_metadata_ptr` must point to a populated `CorrelatorMetadata` object from the `mwalib_correlator_metadata_get` function.
+/// * `correlator_metadata_ptr` must not have already been freed.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_metadata_free(
+    correlator_metadata_ptr: *mut CorrelatorMetadata,
+) -> i32 {
+    if correlator_metadata_ptr.is_null() {
+        return MWALIB_SUCCESS;
+    }
+
+    //
+    // free any other members first
+    //
+
+    // coarse_channels
+    if !(*correlator_metadata_ptr).coarse_chans.is_null() {
+        drop(Box::from_raw((*correlator_metadata_ptr).coarse_chans));
+    }
+
+    // timesteps
+    if !(*correlator_metadata_ptr).timesteps.is_null() {
+        drop(Box::from_raw((*correlator_metadata_ptr).timesteps));
+    }
+
+    // common timestep indices
+    if !(*correlator_metadata_ptr).common_timestep_indices.is_null() {
+        drop(Box::from_raw(
+            (*correlator_metadata_ptr).common_timestep_indices,
+        ));
+    }
+
+    // common coarse chan indices
+    if !(*correlator_metadata_ptr)
+        .common_coarse_chan_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*correlator_metadata_ptr).common_coarse_chan_indices,
+        ));
+    }
+
+    // common good timestep indices
+    if !(*correlator_metadata_ptr)
+        .common_good_timestep_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*correlator_metadata_ptr).common_good_timestep_indices,
+        ));
+    }
+
+    // common good coarse chan indices
+    if !(*correlator_metadata_ptr)
+        .common_good_coarse_chan_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*correlator_metadata_ptr).common_good_coarse_chan_indices,
+        ));
+    }
+
+    // provided timestep indices
+    if !(*correlator_metadata_ptr)
+        .provided_timestep_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*correlator_metadata_ptr).provided_timestep_indices,
+        ));
+    }
+
+    // provided coarse channel indices
+    if !(*correlator_metadata_ptr)
+        .provided_coarse_chan_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*correlator_metadata_ptr).provided_coarse_chan_indices,
+        ));
+    }
+
+    // Free main metadata struct
+    drop(Box::from_raw(correlator_metadata_ptr));
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+///
+/// C Representation of the `VoltageContext` metadata
+///
+#[repr(C)]
+pub struct VoltageMetadata {
+    /// Version of the correlator format
+    pub mwa_version: MWAVersion,
+    /// This is an array of all known timesteps (union of metafits and provided timesteps from data files)
+    pub timesteps: *mut TimeStep,
+    /// Number of timesteps in the observation
+    pub num_timesteps: usize,
+    /// The number of millseconds interval between timestep indices
+    pub timestep_duration_ms: u64,
+    /// Vector of coarse channels which is the effectively the same as the metafits provided coarse channels
+    pub coarse_chans: *mut CoarseChannel,
+    /// Number of coarse channels after we've validated the input voltage files
+    pub num_coarse_chans: usize,
+    /// Number of common timesteps
+    pub num_common_timesteps: usize,
+    /// Vector of (in)common timestep indices
+    pub common_timestep_indices: *mut usize,
+    /// Number of common coarse chans
+    pub num_common_coarse_chans: usize,
+    /// Vector of (in)common coarse channel indices
+    pub common_coarse_chan_indices: *mut usize,
+    /// The start of the observation (the time that is common to all
+    /// provided data files).
+    pub common_start_unix_time_ms: u64,
+    /// `end_unix_time_ms` is the common end time of the observation
+    /// i.e. start time of last common timestep plus integration time.
+    pub common_end_unix_time_ms: u64,
+    /// `start_unix_time_ms` but in GPS milliseconds
+    pub common_start_gps_time_ms: u64,
+    /// `end_unix_time_ms` but in GPS milliseconds
+    pub common_end_gps_time_ms: u64,
+    /// Total duration of common timesteps
+    pub common_duration_ms: u64,
+    /// Total bandwidth of the common coarse channels
+    pub common_bandwidth_hz: u32,
+    /// Number of common timesteps only including timesteps after the quack time
+    pub num_common_good_timesteps: usize,
+    /// Vector of (in)common timestep indices only including timesteps after the quack time
+    pub common_good_timestep_indices: *mut usize,
+    /// Number of common coarse channels only including timesteps after the quack time
+    pub num_common_good_coarse_chans: usize,
+    /// Vector of (in)common coarse channel indices only including timesteps after the quack time
+    pub common_good_coarse_chan_indices: *mut usize,
+    /// The start of the observation (the time that is common to all
+    /// provided data files) only including timesteps after the quack time
+    pub common_good_start_unix_time_ms: u64,
+    /// `end_unix_time_ms` is the common end time of the observation only including timesteps after the quack time
+    /// i.e. start time of last common timestep plus integration time.
+    pub common_good_end_unix_time_ms: u64,
+    /// `common_good_start_unix_time_ms` but in GPS milliseconds
+    pub common_good_start_gps_time_ms: u64,
+    /// `common_good_end_unix_time_ms` but in GPS milliseconds
+    pub common_good_end_gps_time_ms: u64,
+    /// Total duration of common_good timesteps
+    pub common_good_duration_ms: u64,
+    /// Total bandwidth of the common coarse channels only including timesteps after the quack time
+    pub common_good_bandwidth_hz: u32,
+    /// Number of provided timestep indices we have at least *some* data for
+    pub num_provided_timesteps: usize,
+    /// The indices of any timesteps which we have *some* data for
+    pub provided_timestep_indices: *mut usize,
+    /// Number of provided coarse channel indices we have at least *some* data for
+    pub num_provided_coarse_chans: usize,
+    /// The indices of any coarse channels which we have *some* data for
+    pub provided_coarse_chan_indices: *mut usize,
+    /// Bandwidth of each coarse channel
+    pub coarse_chan_width_hz: u32,
+    /// Volatge fine_chan_resolution (if applicable- MWA legacy is 10 kHz, MWAX is unchannelised i.e. the full coarse channel width)
+    pub fine_chan_width_hz: u32,
+    /// Number of fine channels in each coarse channel
+    pub num_fine_chans_per_coarse: usize,
+    /// Number of bytes in each sample (a sample is a complex, thus includes r and i)
+    pub sample_size_bytes: u64,
+    /// Number of voltage blocks per timestep
+    pub num_voltage_blocks_per_timestep: u64,
+    /// Number of voltage blocks of samples in each second of data    
+    pub num_voltage_blocks_per_second: u64,
+    /// Number of samples in each voltage_blocks for each second of data per rf_input * fine_chans * real|imag
+    pub num_samples_per_voltage_block: u64,
+    /// The size of each voltage block    
+    pub voltage_block_size_bytes: u64,
+    /// Number of bytes used to store delays - for MWAX this is the same as a voltage block size, for legacy it is 0
+    pub delay_block_size_bytes: u64,
+    /// The amount of bytes to skip before getting into real data within the voltage files
+    pub data_file_header_size_bytes: u64,
+    /// Expected voltage file size
+    pub expected_voltage_data_file_size_bytes: u64,
+}
+
+/// This returns a struct containing the `VoltageContext` metadata
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `out_voltage_metadata_ptr` - A Rust-owned populated `VoltageMetadata` struct. Free with `mwalib_voltage_metadata_free`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
+/// * Caller must call `mwalib_voltage_metadata_free` once finished, to free the rust memory.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_metadata_get(
+    voltage_context_ptr: *const VoltageContext,
+    out_voltage_metadata_ptr: &mut *mut VoltageMetadata,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_metadata_get() ERROR: Warning: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+    // Get the voltage context object from the raw pointer passed in
+    let context = &*voltage_context_ptr;
+
+    // Populate voltage coarse channels
+    let mut coarse_chan_vec: Vec<CoarseChannel> = Vec::new();
+
+    for item in context.coarse_chans.iter() {
+        let out_item = {
+            let coarse_channel::CoarseChannel {
+                corr_chan_number,
+                rec_chan_number,
+                gpubox_number,
+                chan_width_hz,
+                chan_start_hz,
+                chan_centre_hz,
+                chan_end_hz,
+            } = item;
+            CoarseChannel {
+                corr_chan_number: *corr_chan_number,
+                rec_chan_number: *rec_chan_number,
+                gpubox_number: *gpubox_number,
+                chan_width_hz: *chan_width_hz,
+                chan_start_hz: *chan_start_hz,
+                chan_centre_hz: *chan_centre_hz,
+                chan_end_hz: *chan_end_hz,
+            }
+        };
+
+        coarse_chan_vec.push(out_item);
+    }
+
+    // Populate voltage timesteps
+    let mut timestep_vec: Vec<TimeStep> = Vec::new();
+
+    for item in context.timesteps.iter() {
+        let out_item = {
+            let timestep::TimeStep {
+                unix_time_ms,
+                gps_time_ms,
+            } = item;
+            TimeStep {
+                unix_time_ms: *unix_time_ms,
+                gps_time_ms: *gps_time_ms,
+            }
+        };
+        timestep_vec.push(out_item);
+    }
+
+    // Populate the rust owned data structure with data from the voltage context
+    // We explicitly break out the attributes so at compile time it will let us know
+    // if there have been new fields added to the rust struct, then we can choose to
+    // ignore them (with _) or add that field to the FFI struct.
+    let out_context = {
+        let VoltageContext {
+            metafits_context: _, // This is provided by the seperate metafits_metadata struct in FFI
+            mwa_version,
+            num_timesteps,
+            timesteps: _, // This is populated seperately
+            timestep_duration_ms,
+            num_coarse_chans,
+            coarse_chans: _, // This is populated seperately
+            common_timestep_indices,
+            num_common_timesteps,
+            common_coarse_chan_indices,
+            num_common_coarse_chans,
+            common_start_unix_time_ms,
+            common_end_unix_time_ms,
+            common_start_gps_time_ms,
+            common_end_gps_time_ms,
+            common_duration_ms,
+            common_bandwidth_hz,
+            common_good_timestep_indices,
+            num_common_good_timesteps,
+            common_good_coarse_chan_indices,
+            num_common_good_coarse_chans,
+            common_good_start_unix_time_ms,
+            common_good_end_unix_time_ms,
+            common_good_start_gps_time_ms,
+            common_good_end_gps_time_ms,
+            common_good_duration_ms,
+            common_good_bandwidth_hz,
+            provided_timestep_indices,
+            num_provided_timesteps: num_provided_timestep_indices,
+            provided_coarse_chan_indices,
+            num_provided_coarse_chans: num_provided_coarse_chan_indices,
+            coarse_chan_width_hz,
+            fine_chan_width_hz,
+            num_fine_chans_per_coarse,
+            sample_size_bytes,
+            num_voltage_blocks_per_timestep,
+            num_voltage_blocks_per_second,
+            num_samples_per_voltage_block,
+            voltage_block_size_bytes,
+            delay_block_size_bytes,
+            data_file_header_size_bytes,
+            expected_voltage_data_file_size_bytes,
+            voltage_batches: _, // This is currently not provided to FFI as it is private
+            voltage_file_locations: _, // This is currently not provided to FFI as it is private
+            direct_io: _,       // This is currently not provided to FFI as it is private
+            voltage_time_map: _, // This is currently not provided to FFI as it is private
+            read_counters: _,   // Provided by mwalib_voltage_context_get_stats
+            thread_pool: _,     // This is currently not provided to FFI, see mwalib_set_num_threads
+            data_sources: _,    // This is currently not provided to FFI
+        } = context;
+        VoltageMetadata {
+            mwa_version: *mwa_version,
+            timesteps: ffi_array_to_boxed_slice(timestep_vec),
+            num_timesteps: *num_timesteps,
+            timestep_duration_ms: *timestep_duration_ms,
+            coarse_chans: ffi_array_to_boxed_slice(coarse_chan_vec),
+            num_coarse_chans: *num_coarse_chans,
+            num_common_timesteps: *num_common_timesteps,
+            common_timestep_indices: ffi_array_to_boxed_slice(common_timestep_indices.clone()),
+            num_common_coarse_chans: *num_common_coarse_chans,
+            common_coarse_chan_indices: ffi_array_to_boxed_slice(
+                common_coarse_chan_indices.clone(),
+            ),
+            common_start_unix_time_ms: *common_start_unix_time_ms,
+            common_end_unix_time_ms: *common_end_unix_time_ms,
+            common_start_gps_time_ms: *common_start_gps_time_ms,
+            common_end_gps_time_ms: *common_end_gps_time_ms,
+            common_duration_ms: *common_duration_ms,
+            common_bandwidth_hz: *common_bandwidth_hz,
+            num_common_good_timesteps: *num_common_good_timesteps,
+            common_good_timestep_indices: ffi_array_to_boxed_slice(
+                common_good_timestep_indices.clone(),
+            ),
+            num_common_good_coarse_chans: *num_common_good_coarse_chans,
+            common_good_coarse_chan_indices: ffi_array_to_boxed_slice(
+                common_good_coarse_chan_indices.clone(),
+            ),
+            common_good_start_unix_time_ms: *common_good_start_unix_time_ms,
+            common_good_end_unix_time_ms: *common_good_end_unix_time_ms,
+            common_good_start_gps_time_ms: *common_good_start_gps_time_ms,
+            common_good_end_gps_time_ms: *common_good_end_gps_time_ms,
+            common_good_duration_ms: *common_good_duration_ms,
+            common_good_bandwidth_hz: *common_good_bandwidth_hz,
+            num_provided_timesteps: *num_provided_timestep_indices,
+            provided_timestep_indices: ffi_array_to_boxed_slice(provided_timestep_indices.clone()),
+            num_provided_coarse_chans: *num_provided_coarse_chan_indices,
+            provided_coarse_chan_indices: ffi_array_to_boxed_slice(
+                provided_coarse_chan_indices.clone(),
+            ),
+            coarse_chan_width_hz: *coarse_chan_width_hz,
+            fine_chan_width_hz: *fine_chan_width_hz,
+            num_fine_chans_per_coarse: *num_fine_chans_per_coarse,
+            sample_size_bytes: *sample_size_bytes,
+            num_voltage_blocks_per_timestep: *num_voltage_blocks_per_timestep,
+            num_voltage_blocks_per_second: *num_voltage_blocks_per_second,
+            num_samples_per_voltage_block: *num_samples_per_voltage_block,
+            voltage_block_size_bytes: *voltage_block_size_bytes,
+            delay_block_size_bytes: *delay_block_size_bytes,
+            data_file_header_size_bytes: *data_file_header_size_bytes,
+            expected_voltage_data_file_size_bytes: *expected_voltage_data_file_size_bytes,
+        }
+    };
+
+    // Pass out the pointer to the rust owned data structure
+    *out_voltage_metadata_ptr = Box::into_raw(Box::new(out_context));
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+/// Free a previously-allocated `VoltageMetadata` struct.
+///
+/// # Arguments
+///
+/// * `voltage_metadata_ptr` - pointer to an already populated `VoltageMetadata` object
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * This must be called once caller is finished with the `VoltageMetadata` object
+/// * `voltage_metadata_ptr` must point to a populated `VoltageMetadata` object from the `mwalib_voltage_metadata_get` function.
+/// * `voltage_metadata_ptr` must not have already been freed.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_metadata_free(
+    voltage_metadata_ptr: *mut VoltageMetadata,
+) -> i32 {
+    if voltage_metadata_ptr.is_null() {
+        return MWALIB_SUCCESS;
+    }
+
+    //
+    // free any other members first
+    //
+
+    // coarse_channels
+    if !(*voltage_metadata_ptr).coarse_chans.is_null() {
+        drop(Box::from_raw((*voltage_metadata_ptr).coarse_chans));
+    }
+
+    // timesteps
+    if !(*voltage_metadata_ptr).timesteps.is_null() {
+        drop(Box::from_raw((*voltage_metadata_ptr).timesteps));
+    }
+
+    // common timestep indices
+    if !(*voltage_metadata_ptr).common_timestep_indices.is_null() {
+        drop(Box::from_raw(
+            (*voltage_metadata_ptr).common_timestep_indices,
+        ));
+    }
+
+    // common coarse chan indices
+    if !(*voltage_metadata_ptr).common_coarse_chan_indices.is_null() {
+        drop(Box::from_raw(
+            (*voltage_metadata_ptr).common_coarse_chan_indices,
+        ));
+    }
+
+    // common good timestep indices
+    if !(*voltage_metadata_ptr)
+        .common_good_timestep_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*voltage_metadata_ptr).common_good_timestep_indices,
+        ));
+    }
+
+    // common good coarse chan indices
+    if !(*voltage_metadata_ptr)
+        .common_good_coarse_chan_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*voltage_metadata_ptr).common_good_coarse_chan_indices,
+        ));
+    }
+
+    // provided timestep indices
+    if !(*voltage_metadata_ptr).provided_timestep_indices.is_null() {
+        drop(Box::from_raw(
+            (*voltage_metadata_ptr).provided_timestep_indices,
+        ));
+    }
+
+    // provided coarse channel indices
+    if !(*voltage_metadata_ptr)
+        .provided_coarse_chan_indices
+        .is_null()
+    {
+        drop(Box::from_raw(
+            (*voltage_metadata_ptr).provided_coarse_chan_indices,
+        ));
+    }
+
+    // Free main metadata struct
+    drop(Box::from_raw(voltage_metadata_ptr));
+
+    // Return success
+    MWALIB_SUCCESS
+}
+
+/// Returns a pointer to the start of `items` for passing to C as a borrowed array, or null if
+/// it is empty (matching the arrays returned by the `mwalib_*_metadata_get` functions).
+///
+/// # Arguments
+///
+/// * `items` - the Rust slice to lend to C. `T` must have the same layout as `U`.
+///
+///
+/// # Returns
+///
+/// * a raw pointer to the array of U's, valid for as long as `items` is
+///
+fn ffi_borrowed_array_ptr<T, U>(items: &[T]) -> *const U {
+    debug_assert_eq!(mem::size_of::<T>(), mem::size_of::<U>());
+
+    if items.is_empty() {
+        std::ptr::null()
+    } else {
+        items.as_ptr() as *const U
+    }
+}
+
+/// Generic helper for the FFI per-field getters of `MetafitsContext`.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `function_name` - name of the calling FFI function, for error messages.
+///
+/// * `get_value` - returns the requested value from the `MetafitsContext`.
+///
+/// * `out_value` - the requested value.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object which has not been freed.
+unsafe fn ffi_metafits_context_get_value<T>(
+    metafits_context_ptr: *const MetafitsContext,
+    function_name: &str,
+    get_value: impl Fn(&MetafitsContext) -> T,
+    out_value: &mut T,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            &format!(
+                "{}() ERROR: null pointer for metafits_context_ptr passed in",
+                function_name
+            ),
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    *out_value = get_value(&*metafits_context_ptr);
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed pointer to the `MetafitsContext` owned by a `CorrelatorContext`, so that the
+/// `mwalib_metafits_context_get_*` functions can be used with it.
+///
+/// # Arguments
+///
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `out_metafits_context_ptr` - pointer to the `MetafitsContext` within the `CorrelatorContext`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
+/// * `out_metafits_context_ptr` is only valid until the `CorrelatorContext` is freed, and must *not* be passed to `mwalib_metafits_context_free`.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_context_get_metafits_context(
+    correlator_context_ptr: *const CorrelatorContext,
+    out_metafits_context_ptr: &mut *const MetafitsContext,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if correlator_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_context_get_metafits_context() ERROR: null pointer for correlator_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    *out_metafits_context_ptr = Arc::as_ptr(&(*correlator_context_ptr).metafits_context);
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed pointer to the `MetafitsContext` owned by a `VoltageContext`, so that the
+/// `mwalib_metafits_context_get_*` functions can be used with it.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `out_metafits_context_ptr` - pointer to the `MetafitsContext` within the `VoltageContext`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
+/// * `out_metafits_context_ptr` is only valid until the `VoltageContext` is freed, and must *not* be passed to `mwalib_metafits_context_free`.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_get_metafits_context(
+    voltage_context_ptr: *const VoltageContext,
+    out_metafits_context_ptr: &mut *const MetafitsContext,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_get_metafits_context() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    *out_metafits_context_ptr = Arc::as_ptr(&(*voltage_context_ptr).metafits_context);
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed array of the antennas of a `MetafitsContext`, without copying them into a
+/// new `MetafitsMetadata` struct. The C structs are built from the context the first time this is
+/// called, and then kept (with their strings) until the context is freed.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_antennas_ptr` - pointer to the first `Antenna` (or NULL if there are none).
+///
+/// * `out_num_ants` - number of `Antenna` structs in `out_antennas_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+/// * `out_antennas_ptr` is only valid until the `MetafitsContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_antennas(
+    metafits_context_ptr: *const MetafitsContext,
+    out_antennas_ptr: &mut *const Antenna,
+    out_num_ants: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_metafits_context_get_antennas() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    let metafits_context = &*metafits_context_ptr;
+    let views = metafits_context.ffi_metadata_cache.get(metafits_context);
+
+    *out_antennas_ptr = ffi_borrowed_array_ptr(&views.antennas);
+    *out_num_ants = views.antennas.len();
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed array of the rf_inputs of a `MetafitsContext`, without copying them into a
+/// new `MetafitsMetadata` struct. The C structs are built from the context the first time this is
+/// called, and then kept (with their strings) until the context is freed.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_rf_inputs_ptr` - pointer to the first `Rfinput` (or NULL if there are none).
+///
+/// * `out_num_rf_inputs` - number of `Rfinput` structs in `out_rf_inputs_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+/// * `out_rf_inputs_ptr` is only valid until the `MetafitsContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_rf_inputs(
+    metafits_context_ptr: *const MetafitsContext,
+    out_rf_inputs_ptr: &mut *const Rfinput,
+    out_num_rf_inputs: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_metafits_context_get_rf_inputs() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    let metafits_context = &*metafits_context_ptr;
+    let views = metafits_context.ffi_metadata_cache.get(metafits_context);
+
+    *out_rf_inputs_ptr = ffi_borrowed_array_ptr(&views.rf_inputs);
+    *out_num_rf_inputs = views.rf_inputs.len();
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed array of the baselines of a `MetafitsContext`. This points directly into the
+/// context's own storage, so nothing is copied.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_baselines_ptr` - pointer to the first `Baseline` (or NULL if there are none).
+///
+/// * `out_num_baselines` - number of `Baseline` structs in `out_baselines_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+/// * `out_baselines_ptr` is only valid until the `MetafitsContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_baselines(
+    metafits_context_ptr: *const MetafitsContext,
+    out_baselines_ptr: &mut *const Baseline,
+    out_num_baselines: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_metafits_context_get_baselines() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    let metafits_context = &*metafits_context_ptr;
+
+    *out_baselines_ptr = ffi_borrowed_array_ptr(&metafits_context.baselines);
+    *out_num_baselines = metafits_context.baselines.len();
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed table of the baseline index of every pair of antennas of a `MetafitsContext`,
+/// so that baselines can be looked up by antenna pair without searching. This points directly
+/// into the context's own storage, so nothing is copied.
+///
+/// The table is `num_ants * num_ants` entries: the baseline between antennas ant1_index and
+/// ant2_index is at `[ant1_index * num_ants + ant2_index]`. Only the upper triangle holds
+/// baselines; entries with ant1_index > ant2_index are UINT32_MAX.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_baseline_table_ptr` - pointer to the first entry of the table (or NULL if there are no antennas).
+///
+/// * `out_num_ants` - number of antennas (the table is `out_num_ants * out_num_ants` entries).
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+/// * `out_baseline_table_ptr` is only valid until the `MetafitsContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_baseline_table(
+    metafits_context_ptr: *const MetafitsContext,
+    out_baseline_table_ptr: &mut *const u32,
+    out_num_ants: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_metafits_context_get_baseline_table() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
+
+    let metafits_context = &*metafits_context_ptr;
+
+    *out_baseline_table_ptr = ffi_borrowed_array_ptr(metafits_context.get_baseline_table());
+    *out_num_ants = metafits_context.antennas.len();
 
-    // Return Success
     MWALIB_SUCCESS
 }
 
-/// Free a previously-allocated `mwalibMetafitsMetadata` struct.
+/// Get a borrowed array of the coarse channels listed in the metafits of a `MetafitsContext`. This points directly into the
+/// context's own storage, so nothing is copied.
 ///
 /// # Arguments
 ///
-/// * `metafits_metadata_ptr` - pointer to an already populated `mwalibMetafitsMetadata` object
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_metafits_coarse_chans_ptr` - pointer to the first `CoarseChannel` (or NULL if there are none).
+///
+/// * `out_num_metafits_coarse_chans` - number of `CoarseChannel` structs in `out_metafits_coarse_chans_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
 ///
 ///
 /// # Returns
@@ -1442,170 +3791,293 @@ pub unsafe extern "C" fn mwalib_metafits_metadata_get(
 ///
 ///
 /// # Safety
-/// * This must be called once caller is finished with the `mwalibMetafitsMetadata` object
-/// * `metafits_metadata_ptr` must point to a populated `mwalibMetafitsMetadata` object from the `mwalib_metafits_metadata_get` function.
-/// * `metafits_metadata_ptr` must not have already been freed.
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+/// * `out_metafits_coarse_chans_ptr` is only valid until the `MetafitsContext` is freed. It must not be written to or freed by the caller.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_metafits_metadata_free(
-    metafits_metadata_ptr: *mut MetafitsMetadata,
+pub unsafe extern "C" fn mwalib_metafits_context_get_metafits_coarse_chans(
+    metafits_context_ptr: *const MetafitsContext,
+    out_metafits_coarse_chans_ptr: &mut *const CoarseChannel,
+    out_num_metafits_coarse_chans: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
 ) -> i32 {
-    // If the pointer is null, just return
-    if metafits_metadata_ptr.is_null() {
-        return MWALIB_SUCCESS;
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_metafits_context_get_metafits_coarse_chans() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    //
-    // Free members first
-    //
-    // baselines
-    if !(*metafits_metadata_ptr).baselines.is_null() {
-        drop(Box::from_raw((*metafits_metadata_ptr).baselines));
-    }
+    let metafits_context = &*metafits_context_ptr;
 
-    // antennas
-    if !(*metafits_metadata_ptr).antennas.is_null() {
-        // Extract a slice from the pointer
-        let slice: &mut [Antenna] = slice::from_raw_parts_mut(
-            (*metafits_metadata_ptr).antennas,
-            (*metafits_metadata_ptr).num_ants,
-        );
-        // Now for each item we need to free anything on the heap
-        for i in slice.iter_mut() {
-            drop(Box::from_raw(i.tile_name));
-        }
+    *out_metafits_coarse_chans_ptr =
+        ffi_borrowed_array_ptr(&metafits_context.metafits_coarse_chans);
+    *out_num_metafits_coarse_chans = metafits_context.metafits_coarse_chans.len();
 
-        // Free the memory for the slice
-        drop(Box::from_raw(slice));
-    }
+    MWALIB_SUCCESS
+}
 
-    // rf inputs
-    if !(*metafits_metadata_ptr).rf_inputs.is_null() {
-        // Extract a slice from the pointer
-        let slice: &mut [Rfinput] = slice::from_raw_parts_mut(
-            (*metafits_metadata_ptr).rf_inputs,
-            (*metafits_metadata_ptr).num_rf_inputs,
+/// Get a borrowed array of the timesteps listed in the metafits of a `MetafitsContext`. This points directly into the
+/// context's own storage, so nothing is copied.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_metafits_timesteps_ptr` - pointer to the first `TimeStep` (or NULL if there are none).
+///
+/// * `out_num_metafits_timesteps` - number of `TimeStep` structs in `out_metafits_timesteps_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+/// * `out_metafits_timesteps_ptr` is only valid until the `MetafitsContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_metafits_timesteps(
+    metafits_context_ptr: *const MetafitsContext,
+    out_metafits_timesteps_ptr: &mut *const TimeStep,
+    out_num_metafits_timesteps: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if metafits_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_metafits_context_get_metafits_timesteps() ERROR: null pointer for metafits_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
         );
-        // Now for each item we need to free anything on the heap
-        for i in slice.iter_mut() {
-            drop(Box::from_raw(i.tile_name));
-            drop(Box::from_raw(i.pol));
-        }
+        return MWALIB_FAILURE;
+    }
 
-        // Free the memory for the slice
-        drop(Box::from_raw(slice));
+    let metafits_context = &*metafits_context_ptr;
+
+    *out_metafits_timesteps_ptr = ffi_borrowed_array_ptr(&metafits_context.metafits_timesteps);
+    *out_num_metafits_timesteps = metafits_context.metafits_timesteps.len();
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed array of the coarse channels of a `CorrelatorContext`. This points directly into the
+/// context's own storage, so nothing is copied.
+///
+/// # Arguments
+///
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `out_coarse_chans_ptr` - pointer to the first `CoarseChannel` (or NULL if there are none).
+///
+/// * `out_num_coarse_chans` - number of `CoarseChannel` structs in `out_coarse_chans_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
+/// * `out_coarse_chans_ptr` is only valid until the `CorrelatorContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_context_get_coarse_chans(
+    correlator_context_ptr: *const CorrelatorContext,
+    out_coarse_chans_ptr: &mut *const CoarseChannel,
+    out_num_coarse_chans: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if correlator_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_context_get_coarse_chans() ERROR: null pointer for correlator_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // coarse_channels
-    if !(*metafits_metadata_ptr).metafits_coarse_chans.is_null() {
-        drop(Box::from_raw(
-            (*metafits_metadata_ptr).metafits_coarse_chans,
-        ));
+    let correlator_context = &*correlator_context_ptr;
+
+    *out_coarse_chans_ptr = ffi_borrowed_array_ptr(&correlator_context.coarse_chans);
+    *out_num_coarse_chans = correlator_context.coarse_chans.len();
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed array of the timesteps of a `CorrelatorContext`. This points directly into the
+/// context's own storage, so nothing is copied.
+///
+/// # Arguments
+///
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `out_timesteps_ptr` - pointer to the first `TimeStep` (or NULL if there are none).
+///
+/// * `out_num_timesteps` - number of `TimeStep` structs in `out_timesteps_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
+/// * `out_timesteps_ptr` is only valid until the `CorrelatorContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_context_get_timesteps(
+    correlator_context_ptr: *const CorrelatorContext,
+    out_timesteps_ptr: &mut *const TimeStep,
+    out_num_timesteps: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if correlator_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_context_get_timesteps() ERROR: null pointer for correlator_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // timesteps
-    if !(*metafits_metadata_ptr).metafits_timesteps.is_null() {
-        drop(Box::from_raw((*metafits_metadata_ptr).metafits_timesteps));
+    let correlator_context = &*correlator_context_ptr;
+
+    *out_timesteps_ptr = ffi_borrowed_array_ptr(&correlator_context.timesteps);
+    *out_num_timesteps = correlator_context.timesteps.len();
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed array of the coarse channels of a `VoltageContext`. This points directly into the
+/// context's own storage, so nothing is copied.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `out_coarse_chans_ptr` - pointer to the first `CoarseChannel` (or NULL if there are none).
+///
+/// * `out_num_coarse_chans` - number of `CoarseChannel` structs in `out_coarse_chans_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
+/// * `out_coarse_chans_ptr` is only valid until the `VoltageContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_get_coarse_chans(
+    voltage_context_ptr: *const VoltageContext,
+    out_coarse_chans_ptr: &mut *const CoarseChannel,
+    out_num_coarse_chans: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_get_coarse_chans() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // receivers
-    if !(*metafits_metadata_ptr).receivers.is_null() {
-        drop(Box::from_raw((*metafits_metadata_ptr).receivers));
+    let voltage_context = &*voltage_context_ptr;
+
+    *out_coarse_chans_ptr = ffi_borrowed_array_ptr(&voltage_context.coarse_chans);
+    *out_num_coarse_chans = voltage_context.coarse_chans.len();
+
+    MWALIB_SUCCESS
+}
+
+/// Get a borrowed array of the timesteps of a `VoltageContext`. This points directly into the
+/// context's own storage, so nothing is copied.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `out_timesteps_ptr` - pointer to the first `TimeStep` (or NULL if there are none).
+///
+/// * `out_num_timesteps` - number of `TimeStep` structs in `out_timesteps_ptr`.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
+/// * `out_timesteps_ptr` is only valid until the `VoltageContext` is freed. It must not be written to or freed by the caller.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_get_timesteps(
+    voltage_context_ptr: *const VoltageContext,
+    out_timesteps_ptr: &mut *const TimeStep,
+    out_num_timesteps: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_get_timesteps() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // delays
-    if !(*metafits_metadata_ptr).delays.is_null() {
-        drop(Box::from_raw((*metafits_metadata_ptr).delays));
-    }
+    let voltage_context = &*voltage_context_ptr;
 
-    // Free main metadata struct
-    drop(Box::from_raw(metafits_metadata_ptr));
+    *out_timesteps_ptr = ffi_borrowed_array_ptr(&voltage_context.timesteps);
+    *out_num_timesteps = voltage_context.timesteps.len();
 
-    // Return success
     MWALIB_SUCCESS
 }
 
-///
-/// C Representation of the `CorrelatorContext` metadata
-///
-#[repr(C)]
-pub struct CorrelatorMetadata {
-    /// Version of the correlator format
-    pub mwa_version: MWAVersion,
-    /// This is an array of all known timesteps (union of metafits and provided timesteps from data files)
-    pub timesteps: *mut TimeStep,
-    /// Count all known timesteps (union of metafits and provided timesteps from data files)
-    pub num_timesteps: usize,
-    /// Vector of coarse channels which is the effectively the same as the metafits provided coarse channels
-    pub coarse_chans: *mut CoarseChannel,
-    /// Count of coarse channels (same as metafits coarse channel count)
-    pub num_coarse_chans: usize,
-    /// Count of common timesteps
-    pub num_common_timesteps: usize,
-    /// Vector of (in)common timestep indices
-    pub common_timestep_indices: *mut usize,
-    /// Count of common coarse channels
-    pub num_common_coarse_chans: usize,
-    /// Indices of common coarse channels
-    pub common_coarse_chan_indices: *mut usize,
-    /// The proper start of the observation (the time that is common to all
-    /// provided gpubox files).
-    pub common_start_unix_time_ms: u64,
-    /// `end_time_ms` will is the actual end time of the observation
-    /// i.e. start time of last common timestep plus integration time.
-    pub common_end_unix_time_ms: u64,
-    /// `start_unix_time_ms` but in GPS milliseconds
-    pub common_start_gps_time_ms: u64,
-    /// `end_unix_time_ms` but in GPS milliseconds
-    pub common_end_gps_time_ms: u64,
-    /// Total duration of observation (based on gpubox files)
-    pub common_duration_ms: u64,
-    /// Total bandwidth of the common coarse channels which have been provided (which may be less than or equal to the bandwith in the MetafitsContext)
-    pub common_bandwidth_hz: u32,
-    /// Number of common timesteps only including timesteps after the quack time
-    pub num_common_good_timesteps: usize,
-    /// Vector of (in)common timestep indices only including timesteps after the quack time
-    pub common_good_timestep_indices: *mut usize,
-    /// Number of common coarse channels only including timesteps after the quack time
-    pub num_common_good_coarse_chans: usize,
-    /// Vector of (in)common timestep indices only including timesteps after the quack time
-    pub common_good_coarse_chan_indices: *mut usize,
-    /// The start of the observation (the time that is common to all
-    /// provided gpubox files) only including timesteps after the quack time
-    pub common_good_start_unix_time_ms: u64,
-    /// `end_unix_time_ms` is the common end time of the observation only including timesteps after the quack time
-    /// i.e. start time of last common timestep plus integration time.
-    pub common_good_end_unix_time_ms: u64,
-    /// `common_good_start_unix_time_ms` but in GPS milliseconds
-    pub common_good_start_gps_time_ms: u64,
-    /// `common_good_end_unix_time_ms` but in GPS milliseconds
-    pub common_good_end_gps_time_ms: u64,
-    /// Total duration of common_good timesteps
-    pub common_good_duration_ms: u64,
-    /// Total bandwidth of the common coarse channels only including timesteps after the quack time
-    pub common_good_bandwidth_hz: u32,
-    /// Number of provided timestep indices we have at least *some* data for
-    pub num_provided_timesteps: usize,
-    /// The indices of any timesteps which we have *some* data for
-    pub provided_timestep_indices: *mut usize,
-    /// Number of provided coarse channel indices we have at least *some* data for
-    pub num_provided_coarse_chans: usize,
-    /// The indices of any coarse channels which we have *some* data for
-    pub provided_coarse_chan_indices: *mut usize,
-    /// The number of bytes taken up by a scan/timestep in each gpubox file.
-    pub num_timestep_coarse_chan_bytes: usize,
-    /// The number of floats in each gpubox HDU.
-    pub num_timestep_coarse_chan_floats: usize,
-    /// This is the number of gpubox files *per batch*.
-    pub num_gpubox_files: usize,
-}
-
-/// This returns a struct containing the `CorrelatorContext` metadata
+/// Start or stop collecting read stats of a `CorrelatorContext` (see `mwalib_correlator_context_get_stats`).
+/// Collection is off by default.
 ///
 /// # Arguments
 ///
 /// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
 ///
-/// * `out_correaltor_metadata_ptr` - A Rust-owned populated `CorrelatorMetadata` struct. Free with `mwalib_correlator_metadata_free`.
+/// * `enabled` - true to collect read stats, false to stop. The counters keep their values either way.
 ///
 /// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
 ///
@@ -1620,171 +4092,81 @@ pub struct CorrelatorMetadata {
 /// # Safety
 /// * `error_message` *must* point to an already allocated char* buffer for any error messages.
 /// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
-/// * Caller must call `mwalib_correlator_metadata_free` once finished, to free the rust memory.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_correlator_metadata_get(
-    correlator_context_ptr: *mut CorrelatorContext,
-    out_correlator_metadata_ptr: &mut *mut CorrelatorMetadata,
+pub unsafe extern "C" fn mwalib_correlator_context_set_stats_enabled(
+    correlator_context_ptr: *const CorrelatorContext,
+    enabled: bool,
     error_message: *const c_char,
     error_message_length: size_t,
 ) -> i32 {
     if correlator_context_ptr.is_null() {
         set_error_message(
-            "mwalib_correlator_metadata_get() ERROR: Warning: null pointer for correlator_context_ptr passed in",
+            "mwalib_correlator_context_set_stats_enabled() ERROR: null pointer for correlator_context_ptr passed in",
             error_message as *mut u8,
             error_message_length,
         );
         return MWALIB_FAILURE;
     }
-    // Get the correlator context object from the raw pointer passed in
-    let context = &*correlator_context_ptr;
-
-    // Populate correlator coarse channels
-    let mut coarse_chan_vec: Vec<CoarseChannel> = Vec::new();
-
-    for item in context.coarse_chans.iter() {
-        let out_item = {
-            let coarse_channel::CoarseChannel {
-                corr_chan_number,
-                rec_chan_number,
-                gpubox_number,
-                chan_width_hz,
-                chan_start_hz,
-                chan_centre_hz,
-                chan_end_hz,
-            } = item;
-            CoarseChannel {
-                corr_chan_number: *corr_chan_number,
-                rec_chan_number: *rec_chan_number,
-                gpubox_number: *gpubox_number,
-                chan_width_hz: *chan_width_hz,
-                chan_start_hz: *chan_start_hz,
-                chan_centre_hz: *chan_centre_hz,
-                chan_end_hz: *chan_end_hz,
-            }
-        };
-
-        coarse_chan_vec.push(out_item);
-    }
-
-    // Populate correlator timesteps
-    let mut timestep_vec: Vec<TimeStep> = Vec::new();
-
-    for item in context.timesteps.iter() {
-        let out_item = {
-            let timestep::TimeStep {
-                unix_time_ms,
-                gps_time_ms,
-            } = item;
-            TimeStep {
-                unix_time_ms: *unix_time_ms,
-                gps_time_ms: *gps_time_ms,
-            }
-        };
-        timestep_vec.push(out_item);
-    }
 
-    // Populate the rust owned data structure with data from the correlator context
-    // We explicitly break out the attributes so at compile time it will let us know
-    // if there have been new fields added to the rust struct, then we can choose to
-    // ignore them (with _) or add that field to the FFI struct.
-    let out_context = {
-        let CorrelatorContext {
-            metafits_context: _, // This is provided by the seperate metafits_metadata struct in FFI
-            mwa_version,
-            num_timesteps,
-            timesteps: _, // This is populated seperately
-            num_coarse_chans,
-            coarse_chans: _, // This is populated seperately
-            common_timestep_indices,
-            num_common_timesteps,
-            common_coarse_chan_indices,
-            num_common_coarse_chans,
-            common_start_unix_time_ms,
-            common_end_unix_time_ms,
-            common_start_gps_time_ms,
-            common_end_gps_time_ms,
-            common_duration_ms,
-            common_bandwidth_hz,
-            common_good_timestep_indices,
-            num_common_good_timesteps,
-            common_good_coarse_chan_indices,
-            num_common_good_coarse_chans,
-            common_good_start_unix_time_ms,
-            common_good_end_unix_time_ms,
-            common_good_start_gps_time_ms,
-            common_good_end_gps_time_ms,
-            common_good_duration_ms,
-            common_good_bandwidth_hz,
-            provided_timestep_indices,
-            num_provided_timesteps: num_provided_timestep_indices,
-            provided_coarse_chan_indices,
-            num_provided_coarse_chans: num_provided_coarse_chan_indices,
-            num_timestep_coarse_chan_bytes,
-            num_timestep_coarse_chan_floats,
-            num_gpubox_files,
-            gpubox_batches: _, // This is currently not provided to FFI as it is private
-            gpubox_time_map: _, // This is currently not provided to FFI
-            legacy_conversion_table: _, // This is currently not provided to FFI as it is private
-        } = context;
-        CorrelatorMetadata {
-            mwa_version: *mwa_version,
-            num_timesteps: *num_timesteps,
-            timesteps: ffi_array_to_boxed_slice(timestep_vec),
-            num_coarse_chans: *num_coarse_chans,
-            coarse_chans: ffi_array_to_boxed_slice(coarse_chan_vec),
-            num_common_timesteps: *num_common_timesteps,
-            common_timestep_indices: ffi_array_to_boxed_slice(common_timestep_indices.clone()),
-            num_common_coarse_chans: *num_common_coarse_chans,
-            common_coarse_chan_indices: ffi_array_to_boxed_slice(
-                common_coarse_chan_indices.clone(),
-            ),
-            common_start_unix_time_ms: *common_start_unix_time_ms,
-            common_end_unix_time_ms: *common_end_unix_time_ms,
-            common_start_gps_time_ms: *common_start_gps_time_ms,
-            common_end_gps_time_ms: *common_end_gps_time_ms,
-            common_duration_ms: *common_duration_ms,
-            common_bandwidth_hz: *common_bandwidth_hz,
+    (&*correlator_context_ptr).set_stats_enabled(enabled);
 
-            num_common_good_timesteps: *num_common_good_timesteps,
-            common_good_timestep_indices: ffi_array_to_boxed_slice(
-                common_good_timestep_indices.clone(),
-            ),
-            num_common_good_coarse_chans: *num_common_good_coarse_chans,
-            common_good_coarse_chan_indices: ffi_array_to_boxed_slice(
-                common_good_coarse_chan_indices.clone(),
-            ),
-            common_good_start_unix_time_ms: *common_good_start_unix_time_ms,
-            common_good_end_unix_time_ms: *common_good_end_unix_time_ms,
-            common_good_start_gps_time_ms: *common_good_start_gps_time_ms,
-            common_good_end_gps_time_ms: *common_good_end_gps_time_ms,
-            common_good_duration_ms: *common_good_duration_ms,
-            common_good_bandwidth_hz: *common_good_bandwidth_hz,
+    MWALIB_SUCCESS
+}
 
-            num_provided_timesteps: *num_provided_timestep_indices,
-            provided_timestep_indices: ffi_array_to_boxed_slice(provided_timestep_indices.clone()),
-            num_provided_coarse_chans: *num_provided_coarse_chan_indices,
-            provided_coarse_chan_indices: ffi_array_to_boxed_slice(
-                provided_coarse_chan_indices.clone(),
-            ),
-            num_timestep_coarse_chan_bytes: *num_timestep_coarse_chan_bytes,
-            num_timestep_coarse_chan_floats: *num_timestep_coarse_chan_floats,
-            num_gpubox_files: *num_gpubox_files,
-        }
-    };
+/// Get the read stats collected so far by a `CorrelatorContext`.
+///
+/// # Arguments
+///
+/// * `correlator_context_ptr` - pointer to an already populated `CorrelatorContext` object.
+///
+/// * `out_stats` - pointer to a caller-owned `ReadStats` struct, which is overwritten with a snapshot of the counters.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `correlator_context_ptr` must point to a populated `CorrelatorContext` object from the `mwalib_correlator_context_new` function.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_correlator_context_get_stats(
+    correlator_context_ptr: *const CorrelatorContext,
+    out_stats: &mut ReadStats,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if correlator_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_correlator_context_get_stats() ERROR: null pointer for correlator_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
+    }
 
-    // Pass out the pointer to the rust owned data structure
-    *out_correlator_metadata_ptr = Box::into_raw(Box::new(out_context));
+    *out_stats = (&*correlator_context_ptr).get_stats();
 
-    // Return success
     MWALIB_SUCCESS
 }
 
-/// Free a previously-allocated `CorrelatorMetadata` struct.
+/// Start or stop collecting read stats of a `VoltageContext` (see `mwalib_voltage_context_get_stats`).
+/// Collection is off by default.
 ///
 /// # Arguments
 ///
-/// * `correlator_metadata_ptr` - pointer to an already populated `CorrelatorMetadata` object
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `enabled` - true to collect read stats, false to stop. The counters keep their values either way.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
 ///
 ///
 /// # Returns
@@ -1793,195 +4175,154 @@ pub unsafe extern "C" fn mwalib_correlator_metadata_get(
 ///
 ///
 /// # Safety
-/// * This must be called once caller is finished with the `CorrelatorMetadata` object
-/// * `correlator_metadata_ptr` must point to a populated `CorrelatorMetadata` object from the `mwalib_correlator_metadata_get` function.
-/// * `correlator_metadata_ptr` must not have already been freed.
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_correlator_metadata_free(
-    correlator_metadata_ptr: *mut CorrelatorMetadata,
+pub unsafe extern "C" fn mwalib_voltage_context_set_stats_enabled(
+    voltage_context_ptr: *const VoltageContext,
+    enabled: bool,
+    error_message: *const c_char,
+    error_message_length: size_t,
 ) -> i32 {
-    if correlator_metadata_ptr.is_null() {
-        return MWALIB_SUCCESS;
-    }
-
-    //
-    // free any other members first
-    //
-
-    // coarse_channels
-    if !(*correlator_metadata_ptr).coarse_chans.is_null() {
-        drop(Box::from_raw((*correlator_metadata_ptr).coarse_chans));
-    }
-
-    // timesteps
-    if !(*correlator_metadata_ptr).timesteps.is_null() {
-        drop(Box::from_raw((*correlator_metadata_ptr).timesteps));
-    }
-
-    // common timestep indices
-    if !(*correlator_metadata_ptr).common_timestep_indices.is_null() {
-        drop(Box::from_raw(
-            (*correlator_metadata_ptr).common_timestep_indices,
-        ));
-    }
-
-    // common coarse chan indices
-    if !(*correlator_metadata_ptr)
-        .common_coarse_chan_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*correlator_metadata_ptr).common_coarse_chan_indices,
-        ));
-    }
-
-    // common good timestep indices
-    if !(*correlator_metadata_ptr)
-        .common_good_timestep_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*correlator_metadata_ptr).common_good_timestep_indices,
-        ));
+    if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_set_stats_enabled() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // common good coarse chan indices
-    if !(*correlator_metadata_ptr)
-        .common_good_coarse_chan_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*correlator_metadata_ptr).common_good_coarse_chan_indices,
-        ));
-    }
+    (&*voltage_context_ptr).set_stats_enabled(enabled);
 
-    // provided timestep indices
-    if !(*correlator_metadata_ptr)
-        .provided_timestep_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*correlator_metadata_ptr).provided_timestep_indices,
-        ));
-    }
+    MWALIB_SUCCESS
+}
 
-    // provided coarse channel indices
-    if !(*correlator_metadata_ptr)
-        .provided_coarse_chan_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*correlator_metadata_ptr).provided_coarse_chan_indices,
-        ));
+/// Get the read stats collected so far by a `VoltageContext`.
+///
+/// # Arguments
+///
+/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+///
+/// * `out_stats` - pointer to a caller-owned `ReadStats` struct, which is overwritten with a snapshot of the counters.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_voltage_context_get_stats(
+    voltage_context_ptr: *const VoltageContext,
+    out_stats: &mut ReadStats,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    if voltage_context_ptr.is_null() {
+        set_error_message(
+            "mwalib_voltage_context_get_stats() ERROR: null pointer for voltage_context_ptr passed in",
+            error_message as *mut u8,
+            error_message_length,
+        );
+        return MWALIB_FAILURE;
     }
 
-    // Free main metadata struct
-    drop(Box::from_raw(correlator_metadata_ptr));
+    *out_stats = (&*voltage_context_ptr).get_stats();
 
-    // Return success
     MWALIB_SUCCESS
 }
 
+/// Get the observation id from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
 ///
-/// C Representation of the `VoltageContext` metadata
+/// # Arguments
 ///
-#[repr(C)]
-pub struct VoltageMetadata {
-    /// Version of the correlator format
-    pub mwa_version: MWAVersion,
-    /// This is an array of all known timesteps (union of metafits and provided timesteps from data files)
-    pub timesteps: *mut TimeStep,
-    /// Number of timesteps in the observation
-    pub num_timesteps: usize,
-    /// The number of millseconds interval between timestep indices
-    pub timestep_duration_ms: u64,
-    /// Vector of coarse channels which is the effectively the same as the metafits provided coarse channels
-    pub coarse_chans: *mut CoarseChannel,
-    /// Number of coarse channels after we've validated the input voltage files
-    pub num_coarse_chans: usize,
-    /// Number of common timesteps
-    pub num_common_timesteps: usize,
-    /// Vector of (in)common timestep indices
-    pub common_timestep_indices: *mut usize,
-    /// Number of common coarse chans
-    pub num_common_coarse_chans: usize,
-    /// Vector of (in)common coarse channel indices
-    pub common_coarse_chan_indices: *mut usize,
-    /// The start of the observation (the time that is common to all
-    /// provided data files).
-    pub common_start_unix_time_ms: u64,
-    /// `end_unix_time_ms` is the common end time of the observation
-    /// i.e. start time of last common timestep plus integration time.
-    pub common_end_unix_time_ms: u64,
-    /// `start_unix_time_ms` but in GPS milliseconds
-    pub common_start_gps_time_ms: u64,
-    /// `end_unix_time_ms` but in GPS milliseconds
-    pub common_end_gps_time_ms: u64,
-    /// Total duration of common timesteps
-    pub common_duration_ms: u64,
-    /// Total bandwidth of the common coarse channels
-    pub common_bandwidth_hz: u32,
-    /// Number of common timesteps only including timesteps after the quack time
-    pub num_common_good_timesteps: usize,
-    /// Vector of (in)common timestep indices only including timesteps after the quack time
-    pub common_good_timestep_indices: *mut usize,
-    /// Number of common coarse channels only including timesteps after the quack time
-    pub num_common_good_coarse_chans: usize,
-    /// Vector of (in)common coarse channel indices only including timesteps after the quack time
-    pub common_good_coarse_chan_indices: *mut usize,
-    /// The start of the observation (the time that is common to all
-    /// provided data files) only including timesteps after the quack time
-    pub common_good_start_unix_time_ms: u64,
-    /// `end_unix_time_ms` is the common end time of the observation only including timesteps after the quack time
-    /// i.e. start time of last common timestep plus integration time.
-    pub common_good_end_unix_time_ms: u64,
-    /// `common_good_start_unix_time_ms` but in GPS milliseconds
-    pub common_good_start_gps_time_ms: u64,
-    /// `common_good_end_unix_time_ms` but in GPS milliseconds
-    pub common_good_end_gps_time_ms: u64,
-    /// Total duration of common_good timesteps
-    pub common_good_duration_ms: u64,
-    /// Total bandwidth of the common coarse channels only including timesteps after the quack time
-    pub common_good_bandwidth_hz: u32,
-    /// Number of provided timestep indices we have at least *some* data for
-    pub num_provided_timesteps: usize,
-    /// The indices of any timesteps which we have *some* data for
-    pub provided_timestep_indices: *mut usize,
-    /// Number of provided coarse channel indices we have at least *some* data for
-    pub num_provided_coarse_chans: usize,
-    /// The indices of any coarse channels which we have *some* data for
-    pub provided_coarse_chan_indices: *mut usize,
-    /// Bandwidth of each coarse channel
-    pub coarse_chan_width_hz: u32,
-    /// Volatge fine_chan_resolution (if applicable- MWA legacy is 10 kHz, MWAX is unchannelised i.e. the full coarse channel width)
-    pub fine_chan_width_hz: u32,
-    /// Number of fine channels in each coarse channel
-    pub num_fine_chans_per_coarse: usize,
-    /// Number of bytes in each sample (a sample is a complex, thus includes r and i)
-    pub sample_size_bytes: u64,
-    /// Number of voltage blocks per timestep
-    pub num_voltage_blocks_per_timestep: u64,
-    /// Number of voltage blocks of samples in each second of data    
-    pub num_voltage_blocks_per_second: u64,
-    /// Number of samples in each voltage_blocks for each second of data per rf_input * fine_chans * real|imag
-    pub num_samples_per_voltage_block: u64,
-    /// The size of each voltage block    
-    pub voltage_block_size_bytes: u64,
-    /// Number of bytes used to store delays - for MWAX this is the same as a voltage block size, for legacy it is 0
-    pub delay_block_size_bytes: u64,
-    /// The amount of bytes to skip before getting into real data within the voltage files
-    pub data_file_header_size_bytes: u64,
-    /// Expected voltage file size
-    pub expected_voltage_data_file_size_bytes: u64,
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_obs_id` - the observation id.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_obs_id(
+    metafits_context_ptr: *const MetafitsContext,
+    out_obs_id: &mut u32,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_obs_id",
+        |m| m.obs_id,
+        out_obs_id,
+        error_message,
+        error_message_length,
+    )
+}
+
+/// Get the observation mode from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_mode` - the observation mode.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_mode(
+    metafits_context_ptr: *const MetafitsContext,
+    out_mode: &mut MWAMode,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_mode",
+        |m| m.mode,
+        out_mode,
+        error_message,
+        error_message_length,
+    )
 }
 
-/// This returns a struct containing the `VoltageContext` metadata
+/// Get the scheduled start (gps time) of the observation, in milliseconds from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
 ///
 /// # Arguments
 ///
-/// * `voltage_context_ptr` - pointer to an already populated `VoltageContext` object.
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
 ///
-/// * `out_voltage_metadata_ptr` - A Rust-owned populated `VoltageMetadata` struct. Free with `mwalib_voltage_metadata_free`.
+/// * `out_sched_start_gps_time_ms` - the scheduled start (gps time) of the observation, in milliseconds.
 ///
 /// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
 ///
@@ -1995,187 +4336,149 @@ pub struct VoltageMetadata {
 ///
 /// # Safety
 /// * `error_message` *must* point to an already allocated char* buffer for any error messages.
-/// * `voltage_context_ptr` must point to a populated `VoltageContext` object from the `mwalib_voltage_context_new` function.
-/// * Caller must call `mwalib_voltage_metadata_free` once finished, to free the rust memory.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_voltage_metadata_get(
-    voltage_context_ptr: *mut VoltageContext,
-    out_voltage_metadata_ptr: &mut *mut VoltageMetadata,
+pub unsafe extern "C" fn mwalib_metafits_context_get_sched_start_gps_time_ms(
+    metafits_context_ptr: *const MetafitsContext,
+    out_sched_start_gps_time_ms: &mut u64,
     error_message: *const c_char,
     error_message_length: size_t,
 ) -> i32 {
-    if voltage_context_ptr.is_null() {
-        set_error_message(
-            "mwalib_voltage_metadata_get() ERROR: Warning: null pointer for voltage_context_ptr passed in",
-            error_message as *mut u8,
-            error_message_length,
-        );
-        return MWALIB_FAILURE;
-    }
-    // Get the voltage context object from the raw pointer passed in
-    let context = &*voltage_context_ptr;
-
-    // Populate voltage coarse channels
-    let mut coarse_chan_vec: Vec<CoarseChannel> = Vec::new();
-
-    for item in context.coarse_chans.iter() {
-        let out_item = {
-            let coarse_channel::CoarseChannel {
-                corr_chan_number,
-                rec_chan_number,
-                gpubox_number,
-                chan_width_hz,
-                chan_start_hz,
-                chan_centre_hz,
-                chan_end_hz,
-            } = item;
-            CoarseChannel {
-                corr_chan_number: *corr_chan_number,
-                rec_chan_number: *rec_chan_number,
-                gpubox_number: *gpubox_number,
-                chan_width_hz: *chan_width_hz,
-                chan_start_hz: *chan_start_hz,
-                chan_centre_hz: *chan_centre_hz,
-                chan_end_hz: *chan_end_hz,
-            }
-        };
-
-        coarse_chan_vec.push(out_item);
-    }
-
-    // Populate voltage timesteps
-    let mut timestep_vec: Vec<TimeStep> = Vec::new();
-
-    for item in context.timesteps.iter() {
-        let out_item = {
-            let timestep::TimeStep {
-                unix_time_ms,
-                gps_time_ms,
-            } = item;
-            TimeStep {
-                unix_time_ms: *unix_time_ms,
-                gps_time_ms: *gps_time_ms,
-            }
-        };
-        timestep_vec.push(out_item);
-    }
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_sched_start_gps_time_ms",
+        |m| m.sched_start_gps_time_ms,
+        out_sched_start_gps_time_ms,
+        error_message,
+        error_message_length,
+    )
+}
 
-    // Populate the rust owned data structure with data from the voltage context
-    // We explicitly break out the attributes so at compile time it will let us know
-    // if there have been new fields added to the rust struct, then we can choose to
-    // ignore them (with _) or add that field to the FFI struct.
-    let out_context = {
-        let VoltageContext {
-            metafits_context: _, // This is provided by the seperate metafits_metadata struct in FFI
-            mwa_version,
-            num_timesteps,
-            timesteps: _, // This is populated seperately
-            timestep_duration_ms,
-            num_coarse_chans,
-            coarse_chans: _, // This is populated seperately
-            common_timestep_indices,
-            num_common_timesteps,
-            common_coarse_chan_indices,
-            num_common_coarse_chans,
-            common_start_unix_time_ms,
-            common_end_unix_time_ms,
-            common_start_gps_time_ms,
-            common_end_gps_time_ms,
-            common_duration_ms,
-            common_bandwidth_hz,
-            common_good_timestep_indices,
-            num_common_good_timesteps,
-            common_good_coarse_chan_indices,
-            num_common_good_coarse_chans,
-            common_good_start_unix_time_ms,
-            common_good_end_unix_time_ms,
-            common_good_start_gps_time_ms,
-            common_good_end_gps_time_ms,
-            common_good_duration_ms,
-            common_good_bandwidth_hz,
-            provided_timestep_indices,
-            num_provided_timesteps: num_provided_timestep_indices,
-            provided_coarse_chan_indices,
-            num_provided_coarse_chans: num_provided_coarse_chan_indices,
-            coarse_chan_width_hz,
-            fine_chan_width_hz,
-            num_fine_chans_per_coarse,
-            sample_size_bytes,
-            num_voltage_blocks_per_timestep,
-            num_voltage_blocks_per_second,
-            num_samples_per_voltage_block,
-            voltage_block_size_bytes,
-            delay_block_size_bytes,
-            data_file_header_size_bytes,
-            expected_voltage_data_file_size_bytes,
-            voltage_batches: _, // This is currently not provided to FFI as it is private
-            voltage_time_map: _, // This is currently not provided to FFI as it is private
-        } = context;
-        VoltageMetadata {
-            mwa_version: *mwa_version,
-            timesteps: ffi_array_to_boxed_slice(timestep_vec),
-            num_timesteps: *num_timesteps,
-            timestep_duration_ms: *timestep_duration_ms,
-            coarse_chans: ffi_array_to_boxed_slice(coarse_chan_vec),
-            num_coarse_chans: *num_coarse_chans,
-            num_common_timesteps: *num_common_timesteps,
-            common_timestep_indices: ffi_array_to_boxed_slice(common_timestep_indices.clone()),
-            num_common_coarse_chans: *num_common_coarse_chans,
-            common_coarse_chan_indices: ffi_array_to_boxed_slice(
-                common_coarse_chan_indices.clone(),
-            ),
-            common_start_unix_time_ms: *common_start_unix_time_ms,
-            common_end_unix_time_ms: *common_end_unix_time_ms,
-            common_start_gps_time_ms: *common_start_gps_time_ms,
-            common_end_gps_time_ms: *common_end_gps_time_ms,
-            common_duration_ms: *common_duration_ms,
-            common_bandwidth_hz: *common_bandwidth_hz,
-            num_common_good_timesteps: *num_common_good_timesteps,
-            common_good_timestep_indices: ffi_array_to_boxed_slice(
-                common_good_timestep_indices.clone(),
-            ),
-            num_common_good_coarse_chans: *num_common_good_coarse_chans,
-            common_good_coarse_chan_indices: ffi_array_to_boxed_slice(
-                common_good_coarse_chan_indices.clone(),
-            ),
-            common_good_start_unix_time_ms: *common_good_start_unix_time_ms,
-            common_good_end_unix_time_ms: *common_good_end_unix_time_ms,
-            common_good_start_gps_time_ms: *common_good_start_gps_time_ms,
-            common_good_end_gps_time_ms: *common_good_end_gps_time_ms,
-            common_good_duration_ms: *common_good_duration_ms,
-            common_good_bandwidth_hz: *common_good_bandwidth_hz,
-            num_provided_timesteps: *num_provided_timestep_indices,
-            provided_timestep_indices: ffi_array_to_boxed_slice(provided_timestep_indices.clone()),
-            num_provided_coarse_chans: *num_provided_coarse_chan_indices,
-            provided_coarse_chan_indices: ffi_array_to_boxed_slice(
-                provided_coarse_chan_indices.clone(),
-            ),
-            coarse_chan_width_hz: *coarse_chan_width_hz,
-            fine_chan_width_hz: *fine_chan_width_hz,
-            num_fine_chans_per_coarse: *num_fine_chans_per_coarse,
-            sample_size_bytes: *sample_size_bytes,
-            num_voltage_blocks_per_timestep: *num_voltage_blocks_per_timestep,
-            num_voltage_blocks_per_second: *num_voltage_blocks_per_second,
-            num_samples_per_voltage_block: *num_samples_per_voltage_block,
-            voltage_block_size_bytes: *voltage_block_size_bytes,
-            delay_block_size_bytes: *delay_block_size_bytes,
-            data_file_header_size_bytes: *data_file_header_size_bytes,
-            expected_voltage_data_file_size_bytes: *expected_voltage_data_file_size_bytes,
-        }
-    };
+/// Get the scheduled duration of the observation, in milliseconds from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_sched_duration_ms` - the scheduled duration of the observation, in milliseconds.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_sched_duration_ms(
+    metafits_context_ptr: *const MetafitsContext,
+    out_sched_duration_ms: &mut u64,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_sched_duration_ms",
+        |m| m.sched_duration_ms,
+        out_sched_duration_ms,
+        error_message,
+        error_message_length,
+    )
+}
 
-    // Pass out the pointer to the rust owned data structure
-    *out_voltage_metadata_ptr = Box::into_raw(Box::new(out_context));
+/// Get the number of antennas from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_num_ants` - the number of antennas.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_num_ants(
+    metafits_context_ptr: *const MetafitsContext,
+    out_num_ants: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_num_ants",
+        |m| m.num_ants,
+        out_num_ants,
+        error_message,
+        error_message_length,
+    )
+}
 
-    // Return success
-    MWALIB_SUCCESS
+/// Get the number of rf_inputs from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_num_rf_inputs` - the number of rf_inputs.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_num_rf_inputs(
+    metafits_context_ptr: *const MetafitsContext,
+    out_num_rf_inputs: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_num_rf_inputs",
+        |m| m.num_rf_inputs,
+        out_num_rf_inputs,
+        error_message,
+        error_message_length,
+    )
 }
 
-/// Free a previously-allocated `VoltageMetadata` struct.
+/// Get the number of baselines from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
 ///
 /// # Arguments
 ///
-/// * `voltage_metadata_ptr` - pointer to an already populated `VoltageMetadata` object
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_num_baselines` - the number of baselines.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
 ///
 ///
 /// # Returns
@@ -2184,87 +4487,175 @@ pub unsafe extern "C" fn mwalib_voltage_metadata_get(
 ///
 ///
 /// # Safety
-/// * This must be called once caller is finished with the `VoltageMetadata` object
-/// * `voltage_metadata_ptr` must point to a populated `VoltageMetadata` object from the `mwalib_voltage_metadata_get` function.
-/// * `voltage_metadata_ptr` must not have already been freed.
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
 #[no_mangle]
-pub unsafe extern "C" fn mwalib_voltage_metadata_free(
-    voltage_metadata_ptr: *mut VoltageMetadata,
+pub unsafe extern "C" fn mwalib_metafits_context_get_num_baselines(
+    metafits_context_ptr: *const MetafitsContext,
+    out_num_baselines: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
 ) -> i32 {
-    if voltage_metadata_ptr.is_null() {
-        return MWALIB_SUCCESS;
-    }
-
-    //
-    // free any other members first
-    //
-
-    // coarse_channels
-    if !(*voltage_metadata_ptr).coarse_chans.is_null() {
-        drop(Box::from_raw((*voltage_metadata_ptr).coarse_chans));
-    }
-
-    // timesteps
-    if !(*voltage_metadata_ptr).timesteps.is_null() {
-        drop(Box::from_raw((*voltage_metadata_ptr).timesteps));
-    }
-
-    // common timestep indices
-    if !(*voltage_metadata_ptr).common_timestep_indices.is_null() {
-        drop(Box::from_raw(
-            (*voltage_metadata_ptr).common_timestep_indices,
-        ));
-    }
-
-    // common coarse chan indices
-    if !(*voltage_metadata_ptr).common_coarse_chan_indices.is_null() {
-        drop(Box::from_raw(
-            (*voltage_metadata_ptr).common_coarse_chan_indices,
-        ));
-    }
-
-    // common good timestep indices
-    if !(*voltage_metadata_ptr)
-        .common_good_timestep_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*voltage_metadata_ptr).common_good_timestep_indices,
-        ));
-    }
-
-    // common good coarse chan indices
-    if !(*voltage_metadata_ptr)
-        .common_good_coarse_chan_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*voltage_metadata_ptr).common_good_coarse_chan_indices,
-        ));
-    }
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_num_baselines",
+        |m| m.num_baselines,
+        out_num_baselines,
+        error_message,
+        error_message_length,
+    )
+}
 
-    // provided timestep indices
-    if !(*voltage_metadata_ptr).provided_timestep_indices.is_null() {
-        drop(Box::from_raw(
-            (*voltage_metadata_ptr).provided_timestep_indices,
-        ));
-    }
+/// Get the centre frequency of the observation, in Hz from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_centre_freq_hz` - the centre frequency of the observation, in Hz.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_centre_freq_hz(
+    metafits_context_ptr: *const MetafitsContext,
+    out_centre_freq_hz: &mut u32,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_centre_freq_hz",
+        |m| m.centre_freq_hz,
+        out_centre_freq_hz,
+        error_message,
+        error_message_length,
+    )
+}
 
-    // provided coarse channel indices
-    if !(*voltage_metadata_ptr)
-        .provided_coarse_chan_indices
-        .is_null()
-    {
-        drop(Box::from_raw(
-            (*voltage_metadata_ptr).provided_coarse_chan_indices,
-        ));
-    }
+/// Get the total bandwidth of the observation, in Hz from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_obs_bandwidth_hz` - the total bandwidth of the observation, in Hz.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_obs_bandwidth_hz(
+    metafits_context_ptr: *const MetafitsContext,
+    out_obs_bandwidth_hz: &mut u32,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_obs_bandwidth_hz",
+        |m| m.obs_bandwidth_hz,
+        out_obs_bandwidth_hz,
+        error_message,
+        error_message_length,
+    )
+}
 
-    // Free main metadata struct
-    drop(Box::from_raw(voltage_metadata_ptr));
+/// Get the correlator integration time, in milliseconds from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_corr_int_time_ms` - the correlator integration time, in milliseconds.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_corr_int_time_ms(
+    metafits_context_ptr: *const MetafitsContext,
+    out_corr_int_time_ms: &mut u64,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_corr_int_time_ms",
+        |m| m.corr_int_time_ms,
+        out_corr_int_time_ms,
+        error_message,
+        error_message_length,
+    )
+}
 
-    // Return success
-    MWALIB_SUCCESS
+/// Get the number of correlator fine channels per coarse channel from a `MetafitsContext`, without populating a whole `MetafitsMetadata` struct.
+///
+/// # Arguments
+///
+/// * `metafits_context_ptr` - pointer to an already populated `MetafitsContext` object.
+///
+/// * `out_num_corr_fine_chans_per_coarse` - the number of correlator fine channels per coarse channel.
+///
+/// * `error_message` - pointer to already allocated buffer for any error messages to be returned to the caller.
+///
+/// * `error_message_length` - length of error_message char* buffer.
+///
+///
+/// # Returns
+///
+/// * MWALIB_SUCCESS on success, non-zero on failure
+///
+///
+/// # Safety
+/// * `error_message` *must* point to an already allocated char* buffer for any error messages.
+/// * `metafits_context_ptr` must point to a populated `MetafitsContext` object from the `mwalib_metafits_context_new`, `mwalib_correlator_context_get_metafits_context` or `mwalib_voltage_context_get_metafits_context` functions.
+#[no_mangle]
+pub unsafe extern "C" fn mwalib_metafits_context_get_num_corr_fine_chans_per_coarse(
+    metafits_context_ptr: *const MetafitsContext,
+    out_num_corr_fine_chans_per_coarse: &mut size_t,
+    error_message: *const c_char,
+    error_message_length: size_t,
+) -> i32 {
+    ffi_metafits_context_get_value(
+        metafits_context_ptr,
+        "mwalib_metafits_context_get_num_corr_fine_chans_per_coarse",
+        |m| m.num_corr_fine_chans_per_coarse,
+        out_num_corr_fine_chans_per_coarse,
+        error_message,
+        error_message_length,
+    )
 }
 
 /// Representation in C of an `Antenna` struct
@@ -2378,3 +4769,227 @@ pub struct TimeStep {
     pub unix_time_ms: u64,
     pub gps_time_ms: u64,
 }
+
+/// Convert an `Antenna` into its C representation.
+///
+/// # Arguments
+///
+/// * `item` - the antenna to convert.
+///
+/// * `tile_name` - C string holding the antenna's tile name, which the returned struct will point to.
+///
+///
+/// # Returns
+///
+/// * The C representation of `item`
+///
+fn ffi_antenna(item: &antenna::Antenna, tile_name: *mut c_char) -> Antenna {
+    // We explicitly break out the attributes so at compile time it will let us know
+    // if there have been new fields added to the rust struct.
+    let antenna::Antenna {
+        ant,
+        tile_id,
+        tile_name: _, // Passed in as a C string
+        rfinput_x,
+        rfinput_y,
+        electrical_length_m,
+        north_m,
+        east_m,
+        height_m,
+    } = item;
+    Antenna {
+        ant: *ant,
+        tile_id: *tile_id,
+        tile_name,
+        rfinput_x: rfinput_x.subfile_order as usize,
+        rfinput_y: rfinput_y.subfile_order as usize,
+        electrical_length_m: *electrical_length_m,
+        north_m: *north_m,
+        east_m: *east_m,
+        height_m: *height_m,
+    }
+}
+
+/// Convert an `Rfinput` into its C representation.
+///
+/// # Arguments
+///
+/// * `item` - the rf_input to convert.
+///
+/// * `tile_name` - C string holding the rf_input's tile name, which the returned struct will point to.
+///
+/// * `pol` - C string holding the rf_input's polarisation, which the returned struct will point to.
+///
+///
+/// # Returns
+///
+/// * The C representation of `item`
+///
+fn ffi_rfinput(item: &rfinput::Rfinput, tile_name: *mut c_char, pol: *mut c_char) -> Rfinput {
+    // We explicitly break out the attributes so at compile time it will let us know
+    // if there have been new fields added to the rust struct.
+    let rfinput::Rfinput {
+        input,
+        ant,
+        tile_id,
+        tile_name: _, // Passed in as a C string
+        pol: _,       // Passed in as a C string
+        electrical_length_m,
+        north_m,
+        east_m,
+        height_m,
+        vcs_order,
+        subfile_order,
+        flagged,
+        rec_number,
+        rec_slot_number,
+        digital_gains: _, // not currently supported via FFI interface
+        dipole_gains: _,  // not currently supported via FFI interface
+        dipole_delays: _, // not currently supported via FFI interface
+    } = item;
+    Rfinput {
+        input: *input,
+        ant: *ant,
+        tile_id: *tile_id,
+        tile_name,
+        pol,
+        electrical_length_m: *electrical_length_m,
+        north_m: *north_m,
+        east_m: *east_m,
+        height_m: *height_m,
+        vcs_order: *vcs_order,
+        subfile_order: *subfile_order,
+        flagged: *flagged,
+        rec_number: *rec_number,
+        rec_slot_number: *rec_slot_number,
+    }
+}
+
+/// C representations of the antennas and rf_inputs of a `MetafitsContext`, which (unlike the
+/// other metadata structs) cannot simply be borrowed from the context as they contain strings.
+struct FfiMetadataViews {
+    /// C representation of `MetafitsContext.antennas`
+    antennas: Vec<Antenna>,
+    /// C representation of `MetafitsContext.rf_inputs`
+    rf_inputs: Vec<Rfinput>,
+    /// Owns the C strings which `antennas` and `rf_inputs` point to
+    _strings: Vec<CString>,
+}
+
+// The only raw pointers in FfiMetadataViews are to the strings it owns, so it can be sent between threads.
+unsafe impl Send for FfiMetadataViews {}
+
+impl FfiMetadataViews {
+    /// Build the C representations of the antennas and rf_inputs of a `MetafitsContext`.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the metafits context.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A populated FfiMetadataViews struct
+    ///
+    fn new(metafits_context: &MetafitsContext) -> Self {
+        let mut strings: Vec<CString> = Vec::with_capacity(
+            metafits_context.antennas.len() + 2 * metafits_context.rf_inputs.len(),
+        );
+
+        // Moving a CString does not move its heap allocation, so the pointers taken here remain
+        // valid once the strings are stored.
+        let mut c_string = |s: &str| -> *mut c_char {
+            let c_string = CString::new(s).unwrap();
+            let ptr = c_string.as_ptr() as *mut c_char;
+            strings.push(c_string);
+            ptr
+        };
+
+        let antennas: Vec<Antenna> = metafits_context
+            .antennas
+            .iter()
+            .map(|item| ffi_antenna(item, c_string(&item.tile_name)))
+            .collect();
+
+        let rf_inputs: Vec<Rfinput> = metafits_context
+            .rf_inputs
+            .iter()
+            .map(|item| {
+                ffi_rfinput(
+                    item,
+                    c_string(&item.tile_name),
+                    c_string(&item.pol.to_string()),
+                )
+            })
+            .collect();
+
+        Self {
+            antennas,
+            rf_inputs,
+            _strings: strings,
+        }
+    }
+}
+
+/// Holds the C representations of the antennas and rf_inputs of a `MetafitsContext`, which are
+/// built the first time they are requested by `mwalib_metafits_context_get_antennas` or
+/// `mwalib_metafits_context_get_rf_inputs`, and then live as long as the context.
+#[derive(Default)]
+pub(crate) struct FfiMetadataCache {
+    views: Mutex<Option<Box<FfiMetadataViews>>>,
+}
+
+impl FfiMetadataCache {
+    /// Returns the C representations of the antennas and rf_inputs of `metafits_context`,
+    /// building them if this is the first request.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the metafits context which owns this cache.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The cached FfiMetadataViews, valid for as long as the cache is
+    ///
+    fn get(&self, metafits_context: &MetafitsContext) -> &FfiMetadataViews {
+        // A panic while building the views leaves the cache empty, so a poisoned lock is simply recovered.
+        let mut views = match self.views.lock() {
+            Ok(guard) => guard,
+            Err(poisoned) => poisoned.into_inner(),
+        };
+
+        let views_ptr: *const FfiMetadataViews =
+            &**views.get_or_insert_with(|| Box::new(FfiMetadataViews::new(metafits_context)));
+
+        // Once built, the boxed views are never replaced or dropped until the cache is, so they
+        // outlive the lock guard.
+        unsafe { &*views_ptr }
+    }
+}
+
+impl Clone for FfiMetadataCache {
+    /// A clone of a `MetafitsContext` gets its own, empty cache, as the cached C structs belong
+    /// to the context they were built for.
+    fn clone(&self) -> Self {
+        Self::default()
+    }
+}
+
+/// Implements fmt::Debug for FfiMetadataCache struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for FfiMetadataCache {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(f, "FfiMetadataCache")
+    }
+}
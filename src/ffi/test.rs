@@ -436,6 +436,81 @@ fn test_mwalib_correlator_context_new_valid_free() {
     }
 }
 
+#[test]
+fn test_mwalib_correlator_context_new_from_metafits_context_valid() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let metafits_context_ptr = get_test_ffi_metafits_context(MWAVersion::CorrLegacy);
+
+    let gpubox_file =
+        CString::new("test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits")
+            .unwrap();
+    let gpubox_files: Vec<*const c_char> = vec![gpubox_file.as_ptr()];
+
+    let gpubox_files_ptr = gpubox_files.as_ptr() as *mut *const c_char;
+
+    unsafe {
+        // Create a CorrelatorContext
+        let mut correlator_context_ptr: *mut CorrelatorContext = std::ptr::null_mut();
+        let retval = mwalib_correlator_context_new_from_metafits_context(
+            metafits_context_ptr,
+            gpubox_files_ptr,
+            1,
+            &mut correlator_context_ptr,
+            error_message_ptr,
+            error_len,
+        );
+
+        // Check return value of mwalib_correlator_context_new_from_metafits_context
+        assert_eq!(
+            retval, 0,
+            "mwalib_correlator_context_new_from_metafits_context failure"
+        );
+
+        // The new context has its own copy, so the metafits context can be freed first
+        assert_eq!(mwalib_metafits_context_free(metafits_context_ptr), 0);
+
+        let context = correlator_context_ptr.as_ref().unwrap();
+        assert_eq!(context.metafits_context.obs_id, 1_101_503_312);
+        assert_eq!(context.mwa_version, MWAVersion::CorrLegacy);
+        assert_eq!(context.num_timesteps, 1);
+
+        assert_eq!(mwalib_correlator_context_free(correlator_context_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_correlator_context_new_from_metafits_context_null_context() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let gpubox_file =
+        CString::new("test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits")
+            .unwrap();
+    let gpubox_files: Vec<*const c_char> = vec![gpubox_file.as_ptr()];
+
+    let gpubox_files_ptr = gpubox_files.as_ptr() as *mut *const c_char;
+
+    unsafe {
+        let mut correlator_context_ptr: *mut CorrelatorContext = std::ptr::null_mut();
+        let retval = mwalib_correlator_context_new_from_metafits_context(
+            std::ptr::null(),
+            gpubox_files_ptr,
+            1,
+            &mut correlator_context_ptr,
+            error_message_ptr,
+            error_len,
+        );
+
+        // Should get a non-zero return code, and no context
+        assert_ne!(retval, 0);
+        assert!(correlator_context_ptr.is_null());
+    }
+}
+
 #[test]
 fn test_mwalib_correlator_context_new_invalid() {
     // This tests for a invalid correlator context (missing file)
@@ -572,6 +647,163 @@ fn test_mwalib_correlator_context_legacy_read_by_baseline_valid() {
     }
 }
 
+#[test]
+fn test_mwalib_correlator_context_legacy_read_by_baseline_subset_valid() {
+    let correlator_context_ptr: *mut CorrelatorContext = get_test_ffi_correlator_context();
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let timestep_index = 0;
+    let coarse_chan_index = 0;
+    let baseline_indices: Vec<size_t> = vec![0, 8255];
+    let num_fine_chans = 2;
+
+    let buffer_len = baseline_indices.len() * num_fine_chans * 8;
+    unsafe {
+        let buffer: Vec<f32> = vec![0.0; buffer_len];
+        let buffer_ptr: *mut f32 = ffi_array_to_boxed_slice(buffer);
+
+        let retval = mwalib_correlator_context_read_by_baseline_subset(
+            correlator_context_ptr,
+            timestep_index,
+            coarse_chan_index,
+            baseline_indices.as_ptr(),
+            baseline_indices.len(),
+            0,
+            num_fine_chans,
+            buffer_ptr,
+            buffer_len,
+            error_message_ptr,
+            error_message_length,
+        );
+
+        assert_eq!(retval, 0);
+
+        // Reconstitute the buffer and compare to a full read
+        let ret_buffer: Vec<f32> = ffi_boxed_slice_to_array(buffer_ptr, buffer_len);
+        let full_buffer: Vec<f32> = (*correlator_context_ptr)
+            .read_by_baseline(timestep_index, coarse_chan_index)
+            .unwrap();
+        assert_eq!(ret_buffer[0..16], full_buffer[0..16]);
+        assert_eq!(
+            ret_buffer[16..32],
+            full_buffer[8255 * 128 * 8..8255 * 128 * 8 + 16]
+        );
+    }
+}
+
+#[test]
+fn test_mwalib_correlator_context_read_subset_fine_chan_range_overflow() {
+    let correlator_context_ptr: *mut CorrelatorContext = get_test_ffi_correlator_context();
+
+    let error_message_length: size_t = 256;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let baseline_indices: Vec<size_t> = vec![0];
+    let num_fine_chans = 2;
+
+    let buffer_len = baseline_indices.len() * num_fine_chans * 8;
+    unsafe {
+        let buffer: Vec<f32> = vec![0.0; buffer_len];
+        let buffer_ptr: *mut f32 = ffi_array_to_boxed_slice(buffer);
+
+        // start + num_fine_chans does not fit in a size_t
+        for read_subset in &[
+            mwalib_correlator_context_read_by_baseline_subset,
+            mwalib_correlator_context_read_by_frequency_subset,
+        ] {
+            let retval = read_subset(
+                correlator_context_ptr,
+                0,
+                0,
+                baseline_indices.as_ptr(),
+                baseline_indices.len(),
+                size_t::MAX,
+                num_fine_chans,
+                buffer_ptr,
+                buffer_len,
+                error_message_ptr,
+                error_message_length,
+            );
+
+            assert_eq!(retval, MWALIB_FAILURE);
+            let c_str: &CStr = CStr::from_ptr(error_message_ptr);
+            assert!(c_str.to_str().unwrap().contains("overflows"));
+        }
+
+        ffi_boxed_slice_to_array(buffer_ptr, buffer_len);
+    }
+}
+
+#[test]
+fn test_mwalib_correlator_context_legacy_read_autos_valid() {
+    let correlator_context_ptr: *mut CorrelatorContext = get_test_ffi_correlator_context();
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let timestep_index = 0;
+    let coarse_chan_index = 0;
+
+    let buffer_len = 128 * 128 * 8;
+    unsafe {
+        let buffer: Vec<f32> = vec![0.0; buffer_len];
+        let buffer_ptr: *mut f32 = ffi_array_to_boxed_slice(buffer);
+
+        let retval = mwalib_correlator_context_read_autos(
+            correlator_context_ptr,
+            timestep_index,
+            coarse_chan_index,
+            buffer_ptr,
+            buffer_len,
+            error_message_ptr,
+            error_message_length,
+        );
+
+        assert_eq!(retval, 0);
+
+        // Reconstitute the buffer and compare to a full read. 0 and 8255 are the first and last autos.
+        let ret_buffer: Vec<f32> = ffi_boxed_slice_to_array(buffer_ptr, buffer_len);
+        let full_buffer: Vec<f32> = (*correlator_context_ptr)
+            .read_by_baseline(timestep_index, coarse_chan_index)
+            .unwrap();
+        assert_eq!(ret_buffer[0..1024], full_buffer[0..1024]);
+        assert_eq!(ret_buffer[127 * 1024..], full_buffer[8255 * 1024..]);
+    }
+}
+
+#[test]
+fn test_mwalib_correlator_context_read_autos_null_context() {
+    let correlator_context_ptr: *const CorrelatorContext = std::ptr::null();
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let buffer_len = 128 * 128 * 8;
+    unsafe {
+        let buffer: Vec<f32> = vec![0.0; buffer_len];
+        let buffer_ptr: *mut f32 = ffi_array_to_boxed_slice(buffer);
+
+        let retval = mwalib_correlator_context_read_autos(
+            correlator_context_ptr,
+            0,
+            0,
+            buffer_ptr,
+            buffer_len,
+            error_message_ptr,
+            error_message_length,
+        );
+
+        // Should get a non-zero return code
+        assert_ne!(retval, 0);
+    }
+}
+
 #[test]
 fn test_mwalib_correlator_context_legacy_read_by_baseline_null_context() {
     let correlator_context_ptr: *mut CorrelatorContext = std::ptr::null_mut();
@@ -751,6 +983,159 @@ fn test_mwalib_correlator_context_legacy_read_by_frequency_null_buffer() {
     }
 }
 
+#[test]
+fn test_mwalib_correlator_context_legacy_read_batch_valid() {
+    let correlator_context_ptr: *mut CorrelatorContext = get_test_ffi_correlator_context();
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let timestep_indices: Vec<size_t> = vec![0];
+    let coarse_chan_indices: Vec<size_t> = vec![0];
+
+    let hdu_len = 8256 * 128 * 8;
+    unsafe {
+        // A batch of one HDU matches the single HDU reads, in both orders
+        let mut single_buffer: Vec<f32> = vec![0.0; hdu_len];
+        let mut batch_buffer: Vec<f32> = vec![0.0; hdu_len];
+
+        let retval = mwalib_correlator_context_read_by_baseline(
+            correlator_context_ptr,
+            0,
+            0,
+            single_buffer.as_mut_ptr(),
+            hdu_len,
+            error_message_ptr,
+            error_message_length,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+
+        let retval = mwalib_correlator_context_read_by_baseline_batch(
+            correlator_context_ptr,
+            timestep_indices.as_ptr(),
+            timestep_indices.len(),
+            coarse_chan_indices.as_ptr(),
+            coarse_chan_indices.len(),
+            batch_buffer.as_mut_ptr(),
+            hdu_len,
+            error_message_ptr,
+            error_message_length,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(batch_buffer, single_buffer);
+
+        let retval = mwalib_correlator_context_read_by_frequency(
+            correlator_context_ptr,
+            0,
+            0,
+            single_buffer.as_mut_ptr(),
+            hdu_len,
+            error_message_ptr,
+            error_message_length,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+
+        let retval = mwalib_correlator_context_read_by_frequency_batch(
+            correlator_context_ptr,
+            timestep_indices.as_ptr(),
+            timestep_indices.len(),
+            coarse_chan_indices.as_ptr(),
+            coarse_chan_indices.len(),
+            batch_buffer.as_mut_ptr(),
+            hdu_len,
+            error_message_ptr,
+            error_message_length,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(batch_buffer, single_buffer);
+
+        // A buffer of the wrong size is rejected
+        let retval = mwalib_correlator_context_read_by_baseline_batch(
+            correlator_context_ptr,
+            timestep_indices.as_ptr(),
+            timestep_indices.len(),
+            coarse_chan_indices.as_ptr(),
+            coarse_chan_indices.len(),
+            batch_buffer.as_mut_ptr(),
+            hdu_len - 1,
+            error_message_ptr,
+            error_message_length,
+        );
+        assert_eq!(retval, MWALIB_FAILURE);
+    }
+}
+
+#[test]
+fn test_mwalib_correlator_context_read_batch_null_context() {
+    let correlator_context_ptr: *mut CorrelatorContext = std::ptr::null_mut();
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let timestep_indices: Vec<size_t> = vec![0];
+    let coarse_chan_indices: Vec<size_t> = vec![0];
+
+    let buffer_len = 8256 * 128 * 8;
+    unsafe {
+        let mut buffer: Vec<f32> = vec![0.0; buffer_len];
+
+        let retval = mwalib_correlator_context_read_by_frequency_batch(
+            correlator_context_ptr,
+            timestep_indices.as_ptr(),
+            timestep_indices.len(),
+            coarse_chan_indices.as_ptr(),
+            coarse_chan_indices.len(),
+            buffer.as_mut_ptr(),
+            buffer_len,
+            error_message_ptr,
+            error_message_length,
+        );
+
+        // Should get a non-zero return code
+        assert_ne!(retval, 0);
+    }
+}
+
+#[test]
+fn test_mwalib_correlator_context_read_raw_null_context() {
+    let correlator_context_ptr: *const CorrelatorContext = std::ptr::null();
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let mut bitpix: i32 = 0;
+    let mut bscale: f64 = 0.;
+    let mut bzero: f64 = 0.;
+
+    let buffer_len = 8256 * 128 * 8;
+    unsafe {
+        let buffer: Vec<i32> = vec![0; buffer_len];
+        let buffer_ptr: *mut i32 = ffi_array_to_boxed_slice(buffer);
+
+        let retval = mwalib_correlator_context_read_raw(
+            correlator_context_ptr,
+            0,
+            0,
+            buffer_ptr,
+            buffer_len,
+            &mut bitpix,
+            &mut bscale,
+            &mut bzero,
+            error_message_ptr,
+            error_message_length,
+        );
+
+        // Should get a non-zero return code
+        assert_ne!(retval, 0);
+
+        // The outputs are untouched
+        assert_eq!(bitpix, 0);
+    }
+}
+
 //
 // VoltageContext Tests
 //
@@ -812,6 +1197,88 @@ fn test_mwalib_voltage_context_new_valid_mwaxv2() {
     }
 }
 
+#[test]
+fn test_mwalib_voltage_context_new_from_metafits_context_valid() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    // Borrow the metafits context of another context of the same observation
+    let other_context_ptr = get_test_ffi_voltage_context(MWAVersion::VCSMWAXv2);
+    let mut metafits_context_ptr: *const MetafitsContext = std::ptr::null();
+
+    // Setup files
+    let created_voltage_files =
+        voltage_context::test::get_test_voltage_files(MWAVersion::VCSMWAXv2);
+    let voltage_file = CString::new(created_voltage_files[0].clone()).unwrap();
+
+    let voltage_files: Vec<*const c_char> = vec![voltage_file.as_ptr()];
+
+    let voltage_files_ptr = voltage_files.as_ptr() as *mut *const c_char;
+
+    unsafe {
+        assert_eq!(
+            mwalib_voltage_context_get_metafits_context(
+                other_context_ptr,
+                &mut metafits_context_ptr,
+                error_message_ptr,
+                error_len,
+            ),
+            MWALIB_SUCCESS
+        );
+
+        // Create a VoltageContext
+        let mut voltage_context_ptr: *mut VoltageContext = std::ptr::null_mut();
+        let retval = mwalib_voltage_context_new_from_metafits_context(
+            metafits_context_ptr,
+            voltage_files_ptr,
+            1,
+            &mut voltage_context_ptr,
+            error_message_ptr,
+            error_len,
+        );
+
+        // Check return value of mwalib_voltage_context_new_from_metafits_context
+        assert_eq!(
+            retval, 0,
+            "mwalib_voltage_context_new_from_metafits_context failure"
+        );
+
+        let context = voltage_context_ptr.as_ref().unwrap();
+        assert_eq!(context.mwa_version, MWAVersion::VCSMWAXv2);
+        assert_eq!(
+            context.metafits_context.rf_inputs,
+            (&(*other_context_ptr).metafits_context).rf_inputs
+        );
+
+        assert_eq!(mwalib_voltage_context_free(voltage_context_ptr), 0);
+        assert_eq!(mwalib_voltage_context_free(other_context_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_voltage_context_new_from_metafits_context_null_context() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    unsafe {
+        let mut voltage_context_ptr: *mut VoltageContext = std::ptr::null_mut();
+        let retval = mwalib_voltage_context_new_from_metafits_context(
+            std::ptr::null(),
+            std::ptr::null_mut(),
+            0,
+            &mut voltage_context_ptr,
+            error_message_ptr,
+            error_len,
+        );
+
+        // Should get a non-zero return code, and no context
+        assert_ne!(retval, 0);
+        assert!(voltage_context_ptr.is_null());
+    }
+}
+
 #[test]
 fn test_mwalib_voltage_context_new_invalid() {
     // This tests for a invalid voltage context (missing file)
@@ -1063,13 +1530,203 @@ fn test_mwalib_voltage_context_mwaxv2_read_file_valid() {
             226
         );
 
-        // block: 120, rfinput: 0, sample: 0, value: 0
-        assert_eq!(
-            buffer[voltage_context::test::get_index_for_location_in_test_voltage_file_mwaxv2(
-                120, 0, 0, 0
-            )],
-            88
+        // block: 120, rfinput: 0, sample: 0, value: 0
+        assert_eq!(
+            buffer[voltage_context::test::get_index_for_location_in_test_voltage_file_mwaxv2(
+                120, 0, 0, 0
+            )],
+            88
+        );
+    }
+}
+
+#[test]
+fn test_mwalib_voltage_context_mwaxv2_mmap_file_valid() {
+    let voltage_context_ptr: *mut VoltageContext =
+        get_test_ffi_voltage_context(MWAVersion::VCSMWAXv2);
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let timestep_index = 0;
+    let coarse_chan_index = 14;
+
+    unsafe {
+        let mut mmap_ptr: *mut VoltageFileMmap = std::ptr::null_mut();
+        let mut data_ptr: *const u8 = std::ptr::null();
+        let mut data_len: size_t = 0;
+
+        let retval = mwalib_voltage_context_mmap_file(
+            voltage_context_ptr,
+            timestep_index,
+            coarse_chan_index,
+            &mut mmap_ptr,
+            &mut data_ptr,
+            &mut data_len,
+            error_message_ptr,
+            error_message_length,
+        );
+
+        assert_eq!(retval, 0);
+        assert!(!mmap_ptr.is_null());
+
+        // 2 pols x 1 fine chans x 1 tile * 64000 samples * 160 blocks * 2 bytes per sample
+        assert_eq!(data_len, 2 * 64000 * 160 * 2);
+
+        let data = slice::from_raw_parts(data_ptr, data_len);
+
+        // block: 0, rfinput: 0, sample: 1, value: 1
+        assert_eq!(
+            data[voltage_context::test::get_index_for_location_in_test_voltage_file_mwaxv2(
+                0, 0, 1, 1
+            )],
+            253
+        );
+
+        // block: 120, rfinput: 0, sample: 0, value: 0
+        assert_eq!(
+            data[voltage_context::test::get_index_for_location_in_test_voltage_file_mwaxv2(
+                120, 0, 0, 0
+            )],
+            88
+        );
+
+        let mut header_ptr: *const u8 = std::ptr::null();
+        let mut header_len: size_t = 0;
+        let mut delay_block_ptr: *const u8 = std::ptr::null();
+        let mut delay_block_len: size_t = 0;
+
+        assert_eq!(
+            mwalib_voltage_file_mmap_get_header(
+                mmap_ptr,
+                &mut header_ptr,
+                &mut header_len,
+                &mut delay_block_ptr,
+                &mut delay_block_len,
+            ),
+            0
+        );
+        assert_eq!(
+            header_len,
+            (*voltage_context_ptr).data_file_header_size_bytes as usize
+        );
+        assert_eq!(
+            delay_block_len,
+            (*voltage_context_ptr).delay_block_size_bytes as usize
+        );
+
+        assert_eq!(mwalib_voltage_file_mmap_free(mmap_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_voltage_context_mwaxv2_mmap_second_valid() {
+    let voltage_context_ptr: *mut VoltageContext =
+        get_test_ffi_voltage_context(MWAVersion::VCSMWAXv2);
+
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    // Span the last 2 seconds of file 0 and the first 2 seconds of file 1
+    let gps_second_start = 1_101_503_318;
+    let gps_second_count: usize = 4;
+    let coarse_chan_index = 14;
+
+    unsafe {
+        let buffer_len = ((*voltage_context_ptr).voltage_block_size_bytes
+            * (*voltage_context_ptr).num_voltage_blocks_per_second
+            * gps_second_count as u64) as usize;
+        let mut buffer: Vec<u8> = vec![0; buffer_len];
+        (*voltage_context_ptr)
+            .read_second(
+                gps_second_start,
+                gps_second_count,
+                coarse_chan_index,
+                &mut buffer,
+            )
+            .unwrap();
+
+        let mut mmap_ptrs: Vec<*mut VoltageFileMmap> = vec![std::ptr::null_mut(); 2];
+        let mut data_ptrs: Vec<*const u8> = vec![std::ptr::null(); 2];
+        let mut data_lens: Vec<size_t> = vec![0; 2];
+        let mut num_files: size_t = 0;
+
+        // Too few output slots, so nothing is mapped, but we are told how many are needed
+        let retval = mwalib_voltage_context_mmap_second(
+            voltage_context_ptr,
+            gps_second_start,
+            gps_second_count,
+            coarse_chan_index,
+            mmap_ptrs.as_mut_ptr(),
+            data_ptrs.as_mut_ptr(),
+            data_lens.as_mut_ptr(),
+            1,
+            &mut num_files,
+            error_message_ptr,
+            error_message_length,
+        );
+        assert_ne!(retval, 0);
+        assert_eq!(num_files, 2);
+        assert!(mmap_ptrs[0].is_null());
+
+        let retval = mwalib_voltage_context_mmap_second(
+            voltage_context_ptr,
+            gps_second_start,
+            gps_second_count,
+            coarse_chan_index,
+            mmap_ptrs.as_mut_ptr(),
+            data_ptrs.as_mut_ptr(),
+            data_lens.as_mut_ptr(),
+            mmap_ptrs.len(),
+            &mut num_files,
+            error_message_ptr,
+            error_message_length,
+        );
+        assert_eq!(retval, 0);
+        assert_eq!(num_files, 2);
+
+        // The mapped data of both files together is what read_second reads
+        let mut mapped: Vec<u8> = Vec::new();
+        for i in 0..num_files {
+            mapped.extend_from_slice(slice::from_raw_parts(data_ptrs[i], data_lens[i]));
+        }
+        assert_eq!(mapped, buffer);
+
+        for mmap_ptr in mmap_ptrs {
+            assert_eq!(mwalib_voltage_file_mmap_free(mmap_ptr), 0);
+        }
+    }
+}
+
+#[test]
+fn test_mwalib_voltage_context_mmap_file_null_context() {
+    let error_message_length: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_message_length)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    unsafe {
+        let mut mmap_ptr: *mut VoltageFileMmap = std::ptr::null_mut();
+        let mut data_ptr: *const u8 = std::ptr::null();
+        let mut data_len: size_t = 0;
+
+        let retval = mwalib_voltage_context_mmap_file(
+            std::ptr::null_mut(),
+            0,
+            0,
+            &mut mmap_ptr,
+            &mut data_ptr,
+            &mut data_len,
+            error_message_ptr,
+            error_message_length,
         );
+
+        assert_ne!(retval, 0);
+        assert!(mmap_ptr.is_null());
+
+        // Freeing a null mapping is a no-op
+        assert_eq!(mwalib_voltage_file_mmap_free(mmap_ptr), 0);
     }
 }
 
@@ -1528,3 +2185,612 @@ fn test_mwalib_voltage_metadata_get_null_context() {
         assert_ne!(ret_val, 0);
     }
 }
+
+#[test]
+fn test_ffi_struct_layouts_match_rust_structs() {
+    // The borrowed array accessors hand out pointers to the Rust structs as their C
+    // representations, so the layouts must be identical.
+    macro_rules! offset_of {
+        ($value:expr, $field:ident) => {
+            &$value.$field as *const _ as usize - &$value as *const _ as usize
+        };
+    }
+
+    let timestep = timestep::TimeStep::new(1, 2);
+    let c_timestep = TimeStep {
+        unix_time_ms: 1,
+        gps_time_ms: 2,
+    };
+    assert_eq!(
+        mem::size_of::<timestep::TimeStep>(),
+        mem::size_of::<TimeStep>()
+    );
+    assert_eq!(
+        offset_of!(timestep, unix_time_ms),
+        offset_of!(c_timestep, unix_time_ms)
+    );
+    assert_eq!(
+        offset_of!(timestep, gps_time_ms),
+        offset_of!(c_timestep, gps_time_ms)
+    );
+
+    let baseline = baseline::Baseline {
+        ant1_index: 1,
+        ant2_index: 2,
+    };
+    let c_baseline = Baseline {
+        ant1_index: 1,
+        ant2_index: 2,
+    };
+    assert_eq!(
+        mem::size_of::<baseline::Baseline>(),
+        mem::size_of::<Baseline>()
+    );
+    assert_eq!(
+        offset_of!(baseline, ant1_index),
+        offset_of!(c_baseline, ant1_index)
+    );
+    assert_eq!(
+        offset_of!(baseline, ant2_index),
+        offset_of!(c_baseline, ant2_index)
+    );
+
+    let coarse_chan = coarse_channel::CoarseChannel {
+        corr_chan_number: 1,
+        rec_chan_number: 2,
+        gpubox_number: 3,
+        chan_width_hz: 4,
+        chan_start_hz: 5,
+        chan_centre_hz: 6,
+        chan_end_hz: 7,
+    };
+    let c_coarse_chan = CoarseChannel {
+        corr_chan_number: 1,
+        rec_chan_number: 2,
+        gpubox_number: 3,
+        chan_width_hz: 4,
+        chan_start_hz: 5,
+        chan_centre_hz: 6,
+        chan_end_hz: 7,
+    };
+    assert_eq!(
+        mem::size_of::<coarse_channel::CoarseChannel>(),
+        mem::size_of::<CoarseChannel>()
+    );
+    assert_eq!(
+        offset_of!(coarse_chan, corr_chan_number),
+        offset_of!(c_coarse_chan, corr_chan_number)
+    );
+    assert_eq!(
+        offset_of!(coarse_chan, rec_chan_number),
+        offset_of!(c_coarse_chan, rec_chan_number)
+    );
+    assert_eq!(
+        offset_of!(coarse_chan, gpubox_number),
+        offset_of!(c_coarse_chan, gpubox_number)
+    );
+    assert_eq!(
+        offset_of!(coarse_chan, chan_width_hz),
+        offset_of!(c_coarse_chan, chan_width_hz)
+    );
+    assert_eq!(
+        offset_of!(coarse_chan, chan_start_hz),
+        offset_of!(c_coarse_chan, chan_start_hz)
+    );
+    assert_eq!(
+        offset_of!(coarse_chan, chan_centre_hz),
+        offset_of!(c_coarse_chan, chan_centre_hz)
+    );
+    assert_eq!(
+        offset_of!(coarse_chan, chan_end_hz),
+        offset_of!(c_coarse_chan, chan_end_hz)
+    );
+}
+
+#[test]
+fn test_mwalib_metafits_context_get_borrowed_arrays_valid() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let metafits_context_ptr: *mut MetafitsContext =
+        get_test_ffi_metafits_context(MWAVersion::CorrLegacy);
+
+    unsafe {
+        //
+        // Test baselines
+        //
+        let mut baselines_ptr: *const Baseline = std::ptr::null();
+        let mut num_baselines: size_t = 0;
+        let retval = mwalib_metafits_context_get_baselines(
+            metafits_context_ptr,
+            &mut baselines_ptr,
+            &mut num_baselines,
+            error_message_ptr,
+            error_len,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(num_baselines, 8256);
+        // This must point straight at the context's own baselines
+        assert_eq!(
+            baselines_ptr as usize,
+            (*metafits_context_ptr).baselines.as_ptr() as usize
+        );
+        let baselines = slice::from_raw_parts(baselines_ptr, num_baselines);
+        assert_eq!(baselines[2].ant1_index, 0);
+        assert_eq!(baselines[2].ant2_index, 2);
+
+        //
+        // Test baseline table
+        //
+        let mut baseline_table_ptr: *const u32 = std::ptr::null();
+        let mut num_table_ants: size_t = 0;
+        let retval = mwalib_metafits_context_get_baseline_table(
+            metafits_context_ptr,
+            &mut baseline_table_ptr,
+            &mut num_table_ants,
+            error_message_ptr,
+            error_len,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(num_table_ants, 128);
+        let baseline_table = slice::from_raw_parts(baseline_table_ptr, 128 * 128);
+        assert_eq!(baseline_table[2], 2);
+        assert_eq!(baseline_table[128 + 1], 128);
+        assert_eq!(baseline_table[128], u32::MAX);
+
+        //
+        // Test antennas
+        //
+        let mut antennas_ptr: *const Antenna = std::ptr::null();
+        let mut num_ants: size_t = 0;
+        let retval = mwalib_metafits_context_get_antennas(
+            metafits_context_ptr,
+            &mut antennas_ptr,
+            &mut num_ants,
+            error_message_ptr,
+            error_len,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(num_ants, 128);
+        let antennas = slice::from_raw_parts(antennas_ptr, num_ants);
+        assert_eq!(
+            CStr::from_ptr(antennas[127].tile_name).to_str().unwrap(),
+            "Tile168"
+        );
+        assert_eq!(antennas[2].tile_id, 13);
+
+        // A second call returns the same, already built, array
+        let mut antennas_ptr2: *const Antenna = std::ptr::null();
+        let retval = mwalib_metafits_context_get_antennas(
+            metafits_context_ptr,
+            &mut antennas_ptr2,
+            &mut num_ants,
+            error_message_ptr,
+            error_len,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(antennas_ptr, antennas_ptr2);
+
+        //
+        // Test rf inputs
+        //
+        let mut rf_inputs_ptr: *const Rfinput = std::ptr::null();
+        let mut num_rf_inputs: size_t = 0;
+        let retval = mwalib_metafits_context_get_rf_inputs(
+            metafits_context_ptr,
+            &mut rf_inputs_ptr,
+            &mut num_rf_inputs,
+            error_message_ptr,
+            error_len,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(num_rf_inputs, 256);
+        let rf_inputs = slice::from_raw_parts(rf_inputs_ptr, num_rf_inputs);
+        assert_eq!(rf_inputs[2].ant, 1);
+        assert_eq!(
+            CStr::from_ptr(rf_inputs[2].tile_name).to_str().unwrap(),
+            "Tile012"
+        );
+        assert_eq!(CStr::from_ptr(rf_inputs[2].pol).to_str().unwrap(), "X");
+
+        //
+        // Test metafits coarse channels
+        //
+        let mut coarse_chans_ptr: *const CoarseChannel = std::ptr::null();
+        let mut num_coarse_chans: size_t = 0;
+        let retval = mwalib_metafits_context_get_metafits_coarse_chans(
+            metafits_context_ptr,
+            &mut coarse_chans_ptr,
+            &mut num_coarse_chans,
+            error_message_ptr,
+            error_len,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(num_coarse_chans, 24);
+        let coarse_chans = slice::from_raw_parts(coarse_chans_ptr, num_coarse_chans);
+        assert_eq!(coarse_chans[0].rec_chan_number, 109);
+
+        //
+        // Test metafits timesteps
+        //
+        let mut timesteps_ptr: *const TimeStep = std::ptr::null();
+        let mut num_timesteps: size_t = 0;
+        let retval = mwalib_metafits_context_get_metafits_timesteps(
+            metafits_context_ptr,
+            &mut timesteps_ptr,
+            &mut num_timesteps,
+            error_message_ptr,
+            error_len,
+        );
+        assert_eq!(retval, MWALIB_SUCCESS);
+        assert_eq!(num_timesteps, 56);
+        let timesteps = slice::from_raw_parts(timesteps_ptr, num_timesteps);
+        assert_eq!(timesteps[0].unix_time_ms, 1_417_468_096_000);
+        assert_eq!(timesteps[55].unix_time_ms, 1_417_468_206_000);
+
+        assert_eq!(mwalib_metafits_context_free(metafits_context_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_metafits_context_get_borrowed_arrays_null_context() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    unsafe {
+        let mut rf_inputs_ptr: *const Rfinput = std::ptr::null();
+        let mut num_rf_inputs: size_t = 0;
+        let retval = mwalib_metafits_context_get_rf_inputs(
+            std::ptr::null(),
+            &mut rf_inputs_ptr,
+            &mut num_rf_inputs,
+            error_message_ptr,
+            error_len,
+        );
+
+        // We should get a non-zero return code
+        assert_ne!(retval, 0);
+        assert!(rf_inputs_ptr.is_null());
+    }
+}
+
+#[test]
+fn test_mwalib_metafits_context_get_values_valid() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let metafits_context_ptr: *mut MetafitsContext =
+        get_test_ffi_metafits_context(MWAVersion::CorrLegacy);
+
+    unsafe {
+        let mut obs_id: u32 = 0;
+        assert_eq!(
+            mwalib_metafits_context_get_obs_id(
+                metafits_context_ptr,
+                &mut obs_id,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(obs_id, 1_101_503_312);
+
+        let mut num_ants: size_t = 0;
+        assert_eq!(
+            mwalib_metafits_context_get_num_ants(
+                metafits_context_ptr,
+                &mut num_ants,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(num_ants, 128);
+
+        let mut num_baselines: size_t = 0;
+        assert_eq!(
+            mwalib_metafits_context_get_num_baselines(
+                metafits_context_ptr,
+                &mut num_baselines,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(num_baselines, 8256);
+
+        let mut centre_freq_hz: u32 = 0;
+        assert_eq!(
+            mwalib_metafits_context_get_centre_freq_hz(
+                metafits_context_ptr,
+                &mut centre_freq_hz,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(centre_freq_hz, (*metafits_context_ptr).centre_freq_hz);
+
+        assert_eq!(mwalib_metafits_context_free(metafits_context_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_metafits_context_get_values_null_context() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    unsafe {
+        let mut obs_id: u32 = 0;
+        let retval = mwalib_metafits_context_get_obs_id(
+            std::ptr::null(),
+            &mut obs_id,
+            error_message_ptr,
+            error_len,
+        );
+
+        // We should get a non-zero return code and an error message
+        assert_ne!(retval, 0);
+        let expected_error: &str =
+            "mwalib_metafits_context_get_obs_id() ERROR: null pointer for metafits_context_ptr passed in";
+        assert!(CStr::from_ptr(error_message_ptr)
+            .to_str()
+            .unwrap()
+            .starts_with(expected_error));
+    }
+}
+
+#[test]
+fn test_mwalib_correlator_context_get_borrowed_arrays_valid() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let correlator_context_ptr: *mut CorrelatorContext = get_test_ffi_correlator_context();
+
+    unsafe {
+        // The metafits context within the correlator context can be used with the metafits accessors
+        let mut metafits_context_ptr: *const MetafitsContext = std::ptr::null();
+        assert_eq!(
+            mwalib_correlator_context_get_metafits_context(
+                correlator_context_ptr,
+                &mut metafits_context_ptr,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        let mut obs_id: u32 = 0;
+        assert_eq!(
+            mwalib_metafits_context_get_obs_id(
+                metafits_context_ptr,
+                &mut obs_id,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(obs_id, 1_101_503_312);
+
+        let mut coarse_chans_ptr: *const CoarseChannel = std::ptr::null();
+        let mut num_coarse_chans: size_t = 0;
+        assert_eq!(
+            mwalib_correlator_context_get_coarse_chans(
+                correlator_context_ptr,
+                &mut coarse_chans_ptr,
+                &mut num_coarse_chans,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(num_coarse_chans, 24);
+        let coarse_chans = slice::from_raw_parts(coarse_chans_ptr, num_coarse_chans);
+        assert_eq!(coarse_chans[0].rec_chan_number, 109);
+        assert_eq!(coarse_chans[23].rec_chan_number, 132);
+
+        let mut timesteps_ptr: *const TimeStep = std::ptr::null();
+        let mut num_timesteps: size_t = 0;
+        assert_eq!(
+            mwalib_correlator_context_get_timesteps(
+                correlator_context_ptr,
+                &mut timesteps_ptr,
+                &mut num_timesteps,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(num_timesteps, (*correlator_context_ptr).num_timesteps);
+        let timesteps = slice::from_raw_parts(timesteps_ptr, num_timesteps);
+        assert_eq!(
+            timesteps[0].unix_time_ms,
+            (&(*correlator_context_ptr).timesteps)[0].unix_time_ms
+        );
+
+        assert_eq!(mwalib_correlator_context_free(correlator_context_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_voltage_context_get_borrowed_arrays_valid() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let voltage_context_ptr: *mut VoltageContext =
+        get_test_ffi_voltage_context(MWAVersion::VCSLegacyRecombined);
+
+    unsafe {
+        let mut metafits_context_ptr: *const MetafitsContext = std::ptr::null();
+        assert_eq!(
+            mwalib_voltage_context_get_metafits_context(
+                voltage_context_ptr,
+                &mut metafits_context_ptr,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(
+            metafits_context_ptr as usize,
+            std::sync::Arc::as_ptr(&(*voltage_context_ptr).metafits_context) as usize
+        );
+
+        let mut coarse_chans_ptr: *const CoarseChannel = std::ptr::null();
+        let mut num_coarse_chans: size_t = 0;
+        assert_eq!(
+            mwalib_voltage_context_get_coarse_chans(
+                voltage_context_ptr,
+                &mut coarse_chans_ptr,
+                &mut num_coarse_chans,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(num_coarse_chans, 24);
+        let coarse_chans = slice::from_raw_parts(coarse_chans_ptr, num_coarse_chans);
+        assert_eq!(coarse_chans[0].rec_chan_number, 109);
+        assert_eq!(coarse_chans[23].rec_chan_number, 132);
+
+        let mut timesteps_ptr: *const TimeStep = std::ptr::null();
+        let mut num_timesteps: size_t = 0;
+        assert_eq!(
+            mwalib_voltage_context_get_timesteps(
+                voltage_context_ptr,
+                &mut timesteps_ptr,
+                &mut num_timesteps,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(num_timesteps, (*voltage_context_ptr).num_timesteps);
+        let timesteps = slice::from_raw_parts(timesteps_ptr, num_timesteps);
+        assert_eq!(
+            timesteps[0].gps_time_ms,
+            (&(*voltage_context_ptr).timesteps)[0].gps_time_ms
+        );
+
+        assert_eq!(mwalib_voltage_context_free(voltage_context_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_context_get_stats_null_context() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+    let mut stats = ReadStats::default();
+
+    unsafe {
+        assert_eq!(
+            mwalib_correlator_context_get_stats(
+                std::ptr::null(),
+                &mut stats,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_FAILURE
+        );
+        assert_eq!(
+            mwalib_correlator_context_set_stats_enabled(
+                std::ptr::null(),
+                true,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_FAILURE
+        );
+        assert_eq!(
+            mwalib_voltage_context_get_stats(
+                std::ptr::null(),
+                &mut stats,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_FAILURE
+        );
+        assert_eq!(
+            mwalib_voltage_context_set_stats_enabled(
+                std::ptr::null(),
+                true,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_FAILURE
+        );
+    }
+}
+
+#[test]
+fn test_mwalib_voltage_context_get_stats_valid() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let voltage_context_ptr: *mut VoltageContext =
+        get_test_ffi_voltage_context(MWAVersion::VCSLegacyRecombined);
+
+    unsafe {
+        let voltage_context = &*voltage_context_ptr;
+        let buffer_len = (voltage_context.voltage_block_size_bytes
+            * voltage_context.num_voltage_blocks_per_timestep) as usize;
+        let mut buffer: Vec<u8> = vec![0; buffer_len];
+
+        assert_eq!(
+            mwalib_voltage_context_set_stats_enabled(
+                voltage_context_ptr,
+                true,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        voltage_context.read_file(0, 14, &mut buffer).unwrap();
+
+        let mut stats = ReadStats::default();
+        assert_eq!(
+            mwalib_voltage_context_get_stats(
+                voltage_context_ptr,
+                &mut stats,
+                error_message_ptr,
+                error_len
+            ),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(stats.bytes_read, buffer_len as u64);
+        assert_eq!(stats.file_opens, 1);
+        assert_eq!(stats.hdu_seeks, 0);
+
+        assert_eq!(mwalib_voltage_context_free(voltage_context_ptr), 0);
+    }
+}
+
+#[test]
+fn test_mwalib_set_num_threads() {
+    let error_len: size_t = 128;
+    let error_message = CString::new(" ".repeat(error_len)).unwrap();
+    let error_message_ptr = error_message.as_ptr() as *const c_char;
+
+    let _lock = thread_pool::LIBRARY_THREAD_POOL_TEST_LOCK.lock();
+
+    unsafe {
+        assert_eq!(
+            mwalib_set_num_threads(2, error_message_ptr, error_len),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(mwalib_get_num_threads(), 2);
+
+        assert_eq!(
+            mwalib_set_num_threads(0, error_message_ptr, error_len),
+            MWALIB_SUCCESS
+        );
+        assert_eq!(mwalib_get_num_threads(), rayon::current_num_threads());
+    }
+}
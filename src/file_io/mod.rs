@@ -0,0 +1,201 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Platform specific file access: positional reads and read-only memory maps of a range of a file.
+
+On unix these use `pread` and `mmap`. Elsewhere positional reads use the platform's equivalent
+(or, failing that, a seek and a read), and "mapping" a range reads it into memory instead, so
+callers get the same bytes either way.
+ */
+use std::fs::File;
+use std::io;
+
+#[cfg(test)]
+mod test;
+
+/// Read exactly `buffer.len()` bytes of `file`, starting at `offset`. On unix and Windows this
+/// does not use or move the file's cursor, so many threads may read the same `File` at once.
+/// On other platforms it seeks and then reads, so concurrent reads of one `File` must not overlap.
+///
+/// # Arguments
+///
+/// * `file` - the open file.
+///
+/// * `buffer` - the buffer to fill.
+///
+/// * `offset` - the offset in the file to read from.
+///
+///
+/// # Returns
+///
+/// * A Result of Ok if the buffer was filled, or an io::Error.
+///
+#[cfg(unix)]
+pub(crate) fn read_exact_at(file: &File, buffer: &mut [u8], offset: u64) -> io::Result<()> {
+    use std::os::unix::fs::FileExt;
+
+    file.read_exact_at(buffer, offset)
+}
+
+#[cfg(windows)]
+pub(crate) fn read_exact_at(file: &File, mut buffer: &mut [u8], mut offset: u64) -> io::Result<()> {
+    use std::os::windows::fs::FileExt;
+
+    while !buffer.is_empty() {
+        match file.seek_read(buffer, offset) {
+            Ok(0) => {
+                return Err(io::Error::new(
+                    io::ErrorKind::UnexpectedEof,
+                    "failed to fill whole buffer",
+                ))
+            }
+            Ok(n) => {
+                buffer = &mut buffer[n..];
+                offset += n as u64;
+            }
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+            Err(e) => return Err(e),
+        }
+    }
+
+    Ok(())
+}
+
+#[cfg(not(any(unix, windows)))]
+pub(crate) fn read_exact_at(file: &File, buffer: &mut [u8], offset: u64) -> io::Result<()> {
+    use std::io::{Read, Seek, SeekFrom};
+
+    let mut file = file;
+    file.seek(SeekFrom::Start(offset))?;
+    file.read_exact(buffer)
+}
+
+/// A range of a file held read-only in memory: memory mapped on unix, so only the pages which
+/// are used are ever read from disk, and read into memory up front elsewhere.
+pub(crate) struct FileMap {
+    /// Start of the mapping, which begins at the page containing the range (null if the range is empty).
+    #[cfg(unix)]
+    ptr: *mut libc::c_void,
+    /// Length of the mapping in bytes.
+    #[cfg(unix)]
+    map_len: usize,
+    /// Offset of the range from the start of the mapping.
+    #[cfg(unix)]
+    range_offset: usize,
+    /// Length of the range in bytes.
+    len: usize,
+    /// The bytes of the range, held as u64s so that the start of the range is aligned like a
+    /// mapping would be (callers may view a range starting at a page aligned offset as floats).
+    #[cfg(not(unix))]
+    words: Vec<u64>,
+}
+
+// The mapping is read-only and owned by this struct, so it can be shared between threads.
+#[cfg(unix)]
+unsafe impl Send for FileMap {}
+#[cfg(unix)]
+unsafe impl Sync for FileMap {}
+
+impl FileMap {
+    /// Map a range of an open file into memory. The file can be closed afterwards.
+    ///
+    /// # Arguments
+    ///
+    /// * `file` - the open file.
+    ///
+    /// * `offset` - the offset of the start of the range in the file. This need not be page aligned.
+    ///
+    /// * `len` - the length of the range in bytes. The range must lie within the file.
+    ///
+    /// * `sequential` - hint that the range will be read front to back, so the kernel should read ahead.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the mapped range, or an io::Error if it could not be mapped.
+    ///
+    #[cfg(unix)]
+    pub(crate) fn new(file: &File, offset: u64, len: usize, sequential: bool) -> io::Result<Self> {
+        use std::os::unix::io::AsRawFd;
+
+        // mmap does not accept a length of 0, and the mapping must start on a page boundary
+        let page_size = unsafe { libc::sysconf(libc::_SC_PAGESIZE) } as u64;
+        let map_offset = offset - offset % page_size;
+        let range_offset = (offset - map_offset) as usize;
+        let map_len = range_offset + len;
+        let ptr = if len == 0 {
+            std::ptr::null_mut()
+        } else {
+            let ptr = unsafe {
+                libc::mmap(
+                    std::ptr::null_mut(),
+                    map_len,
+                    libc::PROT_READ,
+                    libc::MAP_SHARED,
+                    file.as_raw_fd(),
+                    map_offset as libc::off_t,
+                )
+            };
+
+            if ptr == libc::MAP_FAILED {
+                return Err(io::Error::last_os_error());
+            }
+
+            // This is only a hint, so failure does not matter.
+            if sequential {
+                unsafe {
+                    libc::madvise(ptr, map_len, libc::MADV_SEQUENTIAL);
+                }
+            }
+
+            ptr
+        };
+
+        // The mapping keeps its own reference to the file.
+        Ok(Self {
+            ptr,
+            map_len,
+            range_offset,
+            len,
+        })
+    }
+
+    #[cfg(not(unix))]
+    pub(crate) fn new(file: &File, offset: u64, len: usize, _sequential: bool) -> io::Result<Self> {
+        let mut words = vec![0u64; (len + 7) / 8];
+        let bytes = unsafe { std::slice::from_raw_parts_mut(words.as_mut_ptr() as *mut u8, len) };
+        read_exact_at(file, bytes, offset)?;
+
+        Ok(Self { len, words })
+    }
+
+    /// Returns the bytes of the range.
+    pub(crate) fn as_bytes(&self) -> &[u8] {
+        #[cfg(unix)]
+        {
+            if self.ptr.is_null() {
+                return &[];
+            }
+            unsafe {
+                std::slice::from_raw_parts((self.ptr as *const u8).add(self.range_offset), self.len)
+            }
+        }
+        #[cfg(not(unix))]
+        unsafe {
+            std::slice::from_raw_parts(self.words.as_ptr() as *const u8, self.len)
+        }
+    }
+}
+
+#[cfg(unix)]
+impl Drop for FileMap {
+    fn drop(&mut self) {
+        if !self.ptr.is_null() {
+            unsafe {
+                libc::munmap(self.ptr, self.map_len);
+            }
+        }
+    }
+}
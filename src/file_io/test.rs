@@ -0,0 +1,61 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for positional reads and file maps
+*/
+#[cfg(test)]
+use super::*;
+#[cfg(test)]
+use std::io::Write;
+
+#[cfg(test)]
+/// Helper to write a test file of `len` bytes, where each byte is its offset modulo 251.
+fn generate_test_file(temp_dir: &tempdir::TempDir, len: usize) -> File {
+    let filename = temp_dir.path().join("file_io_test.dat");
+    let data: Vec<u8> = (0..len).map(|i| (i % 251) as u8).collect();
+    File::create(&filename).unwrap().write_all(&data).unwrap();
+
+    File::open(&filename).unwrap()
+}
+
+#[test]
+fn test_read_exact_at() {
+    let temp_dir = tempdir::TempDir::new("file_io_test").unwrap();
+    let file = generate_test_file(&temp_dir, 10_000);
+
+    let mut buffer = vec![0u8; 1000];
+    read_exact_at(&file, &mut buffer, 5000).unwrap();
+    assert!(buffer
+        .iter()
+        .enumerate()
+        .all(|(i, &b)| b == ((5000 + i) % 251) as u8));
+
+    // Reading past the end of the file is an error
+    let result = read_exact_at(&file, &mut buffer, 9500);
+    assert_eq!(result.unwrap_err().kind(), io::ErrorKind::UnexpectedEof);
+}
+
+#[test]
+fn test_file_map() {
+    let temp_dir = tempdir::TempDir::new("file_io_test").unwrap();
+    let file = generate_test_file(&temp_dir, 10_000);
+
+    // The start of the range does not need to be page aligned
+    for &(offset, len) in &[(0, 10_000), (4097, 1000), (1, 0), (9999, 1)] {
+        let map = FileMap::new(&file, offset, len, offset == 0).unwrap();
+        let expected: Vec<u8> = (offset as usize..offset as usize + len)
+            .map(|i| (i % 251) as u8)
+            .collect();
+        assert_eq!(map.as_bytes(), expected.as_slice());
+
+        // A range starting at a page boundary can be viewed as floats
+        if offset == 0 {
+            assert_eq!(
+                map.as_bytes().as_ptr() as usize % std::mem::align_of::<f64>(),
+                0
+            );
+        }
+    }
+}
@@ -0,0 +1,204 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+A bounded, thread-safe cache of open FITS file handles.
+
+Opening a FITS file (and having cfitsio parse its headers) can cost more than reading a
+HDU from it, particularly on network/parallel filesystems. This cache keeps up to a fixed
+number of files open, evicting the least recently used handle when it is full.
+ */
+use std::fmt;
+use std::sync::{Arc, Mutex, MutexGuard};
+
+use fitsio::threadsafe_fitsfile::ThreadsafeFitsFile;
+
+use crate::read_stats::ReadCounters;
+use crate::*;
+
+#[cfg(test)]
+mod test;
+
+/// The default maximum number of FITS files to keep open at any one time.
+pub const DEFAULT_MAX_OPEN_FITS_FILES: usize = 32;
+
+/// A bounded least-recently-used cache of open FITS files, keyed by filename.
+///
+/// Each cached handle is wrapped in its own mutex, so concurrent readers of *different*
+/// files do not contend with each other, while concurrent readers of the *same* file are
+/// serialised (cfitsio keeps a "current HDU" per file handle, so this is required).
+pub(crate) struct FitsHandleCache {
+    /// Maximum number of handles kept open.
+    max_open_files: usize,
+    /// Open handles, ordered from least recently used (front) to most recently used (back).
+    /// The number of files is small (typically one per coarse channel per batch) so a
+    /// linear scan is cheaper than maintaining a separate index.
+    handles: Mutex<Vec<(String, ThreadsafeFitsFile)>>,
+    /// Read stats of the owning context, which are told about every file opened.
+    read_counters: Option<Arc<ReadCounters>>,
+    /// Where to open the FITS files from, if not the filesystem.
+    data_sources: DataSources,
+}
+
+impl FitsHandleCache {
+    /// Creates a new, empty cache.
+    ///
+    /// # Arguments
+    ///
+    /// * `max_open_files` - maximum number of FITS files to keep open. A value of 0 is treated as 1.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An empty FitsHandleCache
+    ///
+    pub(crate) fn new(max_open_files: usize) -> Self {
+        let max_open_files = max_open_files.max(1);
+
+        Self {
+            max_open_files,
+            handles: Mutex::new(Vec::with_capacity(max_open_files)),
+            read_counters: None,
+            data_sources: DataSources::new(),
+        }
+    }
+
+    /// Count every file this cache opens in the given read stats.
+    ///
+    /// # Arguments
+    ///
+    /// * `read_counters` - the read stats of the context which owns this cache.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * This FitsHandleCache
+    ///
+    pub(crate) fn with_read_counters(mut self, read_counters: Arc<ReadCounters>) -> Self {
+        self.read_counters = Some(read_counters);
+        self
+    }
+
+    /// Open FITS files from the given data sources where they have one.
+    ///
+    /// # Arguments
+    ///
+    /// * `data_sources` - the data sources of the context which owns this cache.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * This FitsHandleCache
+    ///
+    pub(crate) fn with_data_sources(mut self, data_sources: DataSources) -> Self {
+        self.data_sources = data_sources;
+        self
+    }
+
+    /// Lock the list of handles. A panic in another reader cannot leave the list itself in an
+    /// inconsistent state, so a poisoned lock is simply recovered.
+    fn lock_handles(&self) -> MutexGuard<'_, Vec<(String, ThreadsafeFitsFile)>> {
+        match self.handles.lock() {
+            Ok(guard) => guard,
+            Err(poisoned) => poisoned.into_inner(),
+        }
+    }
+
+    /// Returns a handle to the requested FITS file, opening it (and evicting the least
+    /// recently used handle if the cache is full) if it is not already open.
+    ///
+    /// The returned handle remains valid even if it is subsequently evicted; the file is
+    /// closed once the last user drops it.
+    ///
+    /// # Arguments
+    ///
+    /// * `fits_filename` - filename of the FITS file to open.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing a thread-safe handle to the open FITS file, or a FitsError if it could not be opened.
+    ///
+    pub(crate) fn get_or_open(&self, fits_filename: &str) -> Result<ThreadsafeFitsFile, FitsError> {
+        if let Some(handle) = self.get(fits_filename) {
+            return Ok(handle);
+        }
+
+        // Open the file without holding the list lock, so that other readers can continue
+        // to use already-open files in the meantime.
+        let handle = self.data_sources.open_fits(fits_filename)?.threadsafe();
+        if let Some(read_counters) = &self.read_counters {
+            read_counters.add_file_open();
+        }
+
+        let mut handles = self.lock_handles();
+
+        // Another reader may have opened this file while we were doing so; prefer theirs so
+        // that only one handle per file is cached.
+        if let Some(index) = handles.iter().position(|(f, _)| f == fits_filename) {
+            let entry = handles.remove(index);
+            let existing = entry.1.clone();
+            handles.push(entry);
+            return Ok(existing);
+        }
+
+        if handles.len() >= self.max_open_files {
+            handles.remove(0);
+        }
+        handles.push((fits_filename.to_string(), handle.clone()));
+
+        Ok(handle)
+    }
+
+    /// Returns a handle to the requested FITS file if it is currently cached, marking it as
+    /// the most recently used.
+    ///
+    /// # Arguments
+    ///
+    /// * `fits_filename` - filename of the FITS file.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing a thread-safe handle to the open FITS file, or None if it is not cached.
+    ///
+    fn get(&self, fits_filename: &str) -> Option<ThreadsafeFitsFile> {
+        let mut handles = self.lock_handles();
+
+        let index = handles.iter().position(|(f, _)| f == fits_filename)?;
+        let entry = handles.remove(index);
+        let handle = entry.1.clone();
+        handles.push(entry);
+
+        Some(handle)
+    }
+}
+
+/// Implements fmt::Debug for FitsHandleCache struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for FitsHandleCache {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        let handles = self.lock_handles();
+        let open_files: Vec<&str> = handles
+            .iter()
+            .map(|(filename, _)| filename.as_str())
+            .collect();
+
+        write!(
+            f,
+            "FitsHandleCache {{ max_open_files: {}, open_files: {:?} }}",
+            self.max_open_files, open_files
+        )
+    }
+}
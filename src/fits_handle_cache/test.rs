@@ -0,0 +1,65 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for the FITS handle cache
+*/
+#[cfg(test)]
+use super::*;
+
+#[test]
+fn test_fits_handle_cache_reuses_handles() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let cache = FitsHandleCache::new(2);
+
+    assert_eq!(cache.lock_handles().len(), 0);
+    assert_eq!(cache.max_open_files, 2);
+
+    cache.get_or_open(metafits_filename).unwrap();
+    assert_eq!(cache.lock_handles().len(), 1);
+
+    // Opening the same file again should not add a new handle
+    let handle = cache.get_or_open(metafits_filename).unwrap();
+    assert_eq!(cache.lock_handles().len(), 1);
+
+    // And the handle should be usable
+    let mut fptr = handle.lock().unwrap();
+    let hdu = fits_open_hdu!(&mut fptr, 0).unwrap();
+    let obs_id: i32 = get_required_fits_key!(&mut fptr, &hdu, "GPSTIME").unwrap();
+    assert_eq!(obs_id, 1_101_503_312);
+}
+
+#[test]
+fn test_fits_handle_cache_evicts_least_recently_used() {
+    let file1 = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let file2 = "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let file3 = "test_files/1244973688_1_timestep/1244973688.metafits";
+    let cache = FitsHandleCache::new(2);
+
+    cache.get_or_open(file1).unwrap();
+    cache.get_or_open(file2).unwrap();
+    // Touch file1 so that file2 is now the least recently used
+    cache.get_or_open(file1).unwrap();
+    cache.get_or_open(file3).unwrap();
+
+    assert_eq!(cache.lock_handles().len(), 2);
+    assert!(cache.get(file1).is_some());
+    assert!(cache.get(file2).is_none());
+    assert!(cache.get(file3).is_some());
+}
+
+#[test]
+fn test_fits_handle_cache_zero_capacity() {
+    let cache = FitsHandleCache::new(0);
+    assert_eq!(cache.max_open_files, 1);
+}
+
+#[test]
+fn test_fits_handle_cache_missing_file() {
+    let cache = FitsHandleCache::new(2);
+    let result = cache.get_or_open("test_files/does_not_exist.fits");
+
+    assert!(matches!(result.err(), Some(FitsError::Open { .. })));
+    assert_eq!(cache.lock_handles().len(), 0);
+}
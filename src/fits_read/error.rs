@@ -58,6 +58,27 @@ pub enum FitsError {
         source_line: u32,
     },
 
+    /// Error when the section of an image requested does not match the buffer supplied.
+    #[error("{source_file}:{source_line}\n{fits_filename} HDU {hdu_num}: Image section of {section_len} pixels cannot be read into a buffer of {buffer_len} floats")]
+    InvalidSection {
+        fits_filename: String,
+        hdu_num: usize,
+        section_len: usize,
+        buffer_len: usize,
+        source_file: &'static str,
+        source_line: u32,
+    },
+
+    /// Error when a HDU which must contain integers contains floats.
+    #[error("{source_file}:{source_line}\n{fits_filename} HDU {hdu_num}: Image has BITPIX = {bitpix}, but an integer image was expected")]
+    NotIntegerImage {
+        fits_filename: String,
+        hdu_num: usize,
+        bitpix: i32,
+        source_file: &'static str,
+        source_line: u32,
+    },
+
     /// An error associated with parsing a string into another type.
     #[error("{source_file}:{source_line}\nCouldn't parse {key} in {fits_filename} HDU {hdu_num}")]
     Parse {
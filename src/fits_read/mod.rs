@@ -271,6 +271,91 @@ macro_rules! get_fits_float_image_into_buffer {
     };
 }
 
+/// Given a FITS file pointer and a HDU, read a rectangular section of the associated float
+/// image. Only the pixels in the section are read (and, for tile compressed images, only the
+/// tiles which overlap it are decompressed).
+///
+/// # Arguments
+///
+/// * `fits_fptr` - A reference to the `FITSFile` object.
+///
+/// * `hdu` - A reference to the HDU you want to read the section from.
+///
+/// * `ranges` - Zero-based, half-open pixel range for each image axis, in FITS axis order
+/// (i.e. NAXIS1 first).
+///
+/// * `buffer` - Buffer of floats (as a slice) to fill with data from the section. It must be
+/// exactly the size of the section.
+///
+///
+/// # Returns
+///
+/// * A Result of Ok on success, Err on error.
+///
+#[macro_export]
+macro_rules! get_fits_float_image_section_into_buffer {
+    ($fptr:expr, $hdu:expr, $ranges:expr, $buffer:expr) => {
+        _get_fits_float_img_section_into_buf($fptr, $hdu, $ranges, $buffer, file!(), line!())
+    };
+}
+
+/// Given a FITS file pointer and a HDU of integers, read the associated image as it is stored
+/// in the file, without cfitsio applying BSCALE/BZERO or converting it to floats.
+///
+/// # Arguments
+///
+/// * `fits_fptr` - A reference to the `FITSFile` object.
+///
+/// * `hdu` - A reference to the HDU you want to read. Its BITPIX must be 8, 16 or 32.
+///
+/// * `buffer` - Buffer of i32s (as a slice) to fill with data from the HDU.
+///
+///
+/// # Returns
+///
+/// * A Result containing the `FitsImageScaling` of the image on success, Err on error.
+///
+#[macro_export]
+macro_rules! get_fits_raw_i32_image_into_buffer {
+    ($fptr:expr, $hdu:expr, $buffer:expr) => {
+        _get_fits_raw_i32_img_into_buf($fptr, $hdu, $buffer, file!(), line!())
+    };
+}
+
+/// How to convert the raw values of an integer image HDU into physical values, as read from its
+/// header. The physical value of each pixel is `bzero + bscale * raw`.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct FitsImageScaling {
+    /// BITPIX of the HDU (8, 16 or 32)
+    pub bitpix: i32,
+    /// BSCALE of the HDU (1 if not present)
+    pub bscale: f64,
+    /// BZERO of the HDU (0 if not present)
+    pub bzero: f64,
+}
+
+impl FitsImageScaling {
+    /// Returns true if BSCALE is 1 and BZERO is 0, i.e. raw values are already physical values.
+    pub fn is_identity(&self) -> bool {
+        self.bscale == 1.0 && self.bzero == 0.0
+    }
+
+    /// Convert a raw value into a physical value.
+    ///
+    /// # Arguments
+    ///
+    /// * `raw` - a raw value as read from the HDU.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The physical value (`bzero + bscale * raw`)
+    ///
+    pub fn physical_value(&self, raw: i32) -> f64 {
+        self.bzero + self.bscale * raw as f64
+    }
+}
+
 /// Open a fits file.
 ///
 /// To only be used internally; use the `fits_open!` macro instead.
@@ -575,6 +660,157 @@ pub fn _get_fits_float_img_into_buf(
     Ok(())
 }
 
+/// Direct read of the raw integers of a FITS HDU
+#[doc(hidden)]
+pub fn _get_fits_raw_i32_img_into_buf(
+    fits_fptr: &mut FitsFile,
+    hdu: &FitsHdu,
+    buffer: &mut [i32],
+    source_file: &'static str,
+    source_line: u32,
+) -> Result<FitsImageScaling, FitsError> {
+    let to_error = |fits_fptr: &FitsFile, status: i32| -> Result<(), FitsError> {
+        fitsio::errors::check_status(status).map_err(|e| FitsError::Fitsio {
+            fits_error: e,
+            fits_filename: fits_fptr.filename.clone(),
+            hdu_num: hdu.number + 1,
+            source_file,
+            source_line,
+        })
+    };
+
+    // Only integer images can be read without conversion
+    let mut bitpix = 0;
+    let mut status = 0;
+    unsafe {
+        fitsio_sys::ffgidt(fits_fptr.as_raw(), &mut bitpix, &mut status);
+    }
+    to_error(fits_fptr, status)?;
+
+    if bitpix < 0 || bitpix > 32 {
+        return Err(FitsError::NotIntegerImage {
+            fits_filename: fits_fptr.filename.clone(),
+            hdu_num: hdu.number + 1,
+            bitpix,
+            source_file,
+            source_line,
+        });
+    }
+
+    let scaling = FitsImageScaling {
+        bitpix,
+        bscale: _get_optional_fits_key(fits_fptr, hdu, "BSCALE", source_file, source_line)?
+            .unwrap_or(1.0),
+        bzero: _get_optional_fits_key(fits_fptr, hdu, "BZERO", source_file, source_line)?
+            .unwrap_or(0.0),
+    };
+
+    unsafe {
+        // Turn off scaling so cfitsio returns the values as stored. Reading BITPIX = 32 into
+        // TINT is then just a copy (and byte swap), with no per-element conversion.
+        let mut status = 0;
+        fitsio_sys::ffpscl(fits_fptr.as_raw(), 1.0, 0.0, &mut status);
+        to_error(fits_fptr, status)?;
+
+        // Call the underlying cfitsio read function for ints
+        let mut status = 0;
+        fitsio_sys::ffgpv(
+            fits_fptr.as_raw(),
+            fitsio_sys::TINT as _,
+            1,
+            buffer.len() as i64,
+            ptr::null_mut(),
+            buffer.as_mut_ptr() as *mut _,
+            ptr::null_mut(),
+            &mut status,
+        );
+
+        // Restore the scaling from the header (even if the read failed), as the file handle may
+        // be reused for other reads of this HDU
+        let mut restore_status = 0;
+        fitsio_sys::ffpscl(
+            fits_fptr.as_raw(),
+            scaling.bscale,
+            scaling.bzero,
+            &mut restore_status,
+        );
+
+        // Check fits call status
+        to_error(fits_fptr, status)?;
+        to_error(fits_fptr, restore_status)?;
+    }
+
+    Ok(scaling)
+}
+
+/// Direct read of a section of a FITS HDU
+#[doc(hidden)]
+pub fn _get_fits_float_img_section_into_buf(
+    fits_fptr: &mut FitsFile,
+    hdu: &FitsHdu,
+    ranges: &[std::ops::Range<usize>],
+    buffer: &mut [f32],
+    source_file: &'static str,
+    source_line: u32,
+) -> Result<(), FitsError> {
+    // The section must be non-empty and exactly fill the buffer, as cfitsio writes
+    // the whole section with no bounds checking of its own
+    let section_len: usize = ranges
+        .iter()
+        .map(|r| r.end.saturating_sub(r.start))
+        .product();
+    if ranges.is_empty() || section_len == 0 || section_len != buffer.len() {
+        return Err(FitsError::InvalidSection {
+            fits_filename: fits_fptr.filename.clone(),
+            hdu_num: hdu.number + 1,
+            section_len,
+            buffer_len: buffer.len(),
+            source_file,
+            source_line,
+        });
+    }
+
+    // cfitsio wants one-based, inclusive corners
+    let mut first_pixel: Vec<libc::c_long> = ranges
+        .iter()
+        .map(|r| (r.start + 1) as libc::c_long)
+        .collect();
+    let mut last_pixel: Vec<libc::c_long> = ranges.iter().map(|r| r.end as libc::c_long).collect();
+    let mut increment: Vec<libc::c_long> = vec![1; ranges.len()];
+
+    unsafe {
+        // Call the underlying cfitsio section read function for floats
+        let mut status = 0;
+        fitsio_sys::ffgsv(
+            fits_fptr.as_raw(),
+            fitsio_sys::TFLOAT as _,
+            first_pixel.as_mut_ptr(),
+            last_pixel.as_mut_ptr(),
+            increment.as_mut_ptr(),
+            ptr::null_mut(),
+            buffer.as_mut_ptr() as *mut _,
+            ptr::null_mut(),
+            &mut status,
+        );
+
+        // Check fits call status
+        match fitsio::errors::check_status(status) {
+            Ok(_) => {}
+            Err(e) => {
+                return Err(FitsError::Fitsio {
+                    fits_error: e,
+                    fits_filename: fits_fptr.filename.clone(),
+                    hdu_num: hdu.number + 1,
+                    source_file,
+                    source_line,
+                });
+            }
+        }
+    }
+
+    Ok(())
+}
+
 /// Get a long string from a FITS file. The supplied FITS file pointer *must* be
 /// using the appropriate HDU already, or this function will fail.
 ///
@@ -100,6 +100,43 @@ fn test_get_fits_image_valid_f32() {
     });
 }
 
+#[test]
+fn test_get_fits_float_image_section_into_buffer() {
+    // with_temp_file creates a temp dir and temp file, then removes them once out of scope
+    with_new_temp_fits_file("test_get_fits_image_section.fits", |mut fptr| {
+        // 3 rows (NAXIS2) of 4 pixels (NAXIS1)
+        let image_description = ImageDescription {
+            data_type: ImageType::Float,
+            dimensions: &[3, 4],
+        };
+        fptr.create_image("EXTNAME".to_string(), &image_description)
+            .unwrap();
+        let hdu = fits_open_hdu!(fptr, 1).expect("Couldn't open HDU 1");
+        let data: Vec<f32> = (0..12).map(|i| i as f32).collect();
+        assert!(hdu.write_image(&mut fptr, &data).is_ok());
+
+        // Pixels 1 and 2 of the first 2 rows
+        let mut buffer = vec![0.0; 4];
+        let result =
+            get_fits_float_image_section_into_buffer!(fptr, &hdu, &[1..3, 0..2], &mut buffer);
+        assert!(result.is_ok());
+        assert_eq!(buffer, vec![1.0, 2.0, 5.0, 6.0]);
+
+        // The buffer must match the size of the section
+        let mut buffer = vec![0.0; 3];
+        let result =
+            get_fits_float_image_section_into_buffer!(fptr, &hdu, &[1..3, 0..2], &mut buffer);
+        assert!(matches!(
+            result,
+            Err(FitsError::InvalidSection {
+                section_len: 4,
+                buffer_len: 3,
+                ..
+            })
+        ));
+    });
+}
+
 #[test]
 fn test_get_fits_image_valid_i32() {
     // with_temp_file creates a temp dir and temp file, then removes them once out of scope
@@ -134,6 +171,71 @@ fn test_get_fits_image_valid_i32() {
     });
 }
 
+#[test]
+fn test_get_fits_raw_i32_image_into_buffer() {
+    // with_temp_file creates a temp dir and temp file, then removes them once out of scope
+    with_new_temp_fits_file("test_get_fits_raw_image.fits", |mut fptr| {
+        let image_description = ImageDescription {
+            data_type: ImageType::Long,
+            dimensions: &[1, 3],
+        };
+        fptr.create_image("EXTNAME".to_string(), &image_description)
+            .unwrap();
+        let hdu = fits_open_hdu!(fptr, 1).expect("Couldn't open HDU 1");
+        assert!(hdu.write_image(&mut fptr, &[-1, 0, 1]).is_ok());
+
+        // No BSCALE or BZERO, so raw values are physical values
+        let mut buffer = vec![0; 3];
+        let scaling = get_fits_raw_i32_image_into_buffer!(fptr, &hdu, &mut buffer).unwrap();
+        assert_eq!(buffer, vec![-1, 0, 1]);
+        assert_eq!(scaling.bitpix, 32);
+        assert!(scaling.is_identity());
+
+        // With scaling keys, the raw values are still returned as stored
+        hdu.write_key(&mut fptr, "BSCALE", 2.0).unwrap();
+        hdu.write_key(&mut fptr, "BZERO", 10.0).unwrap();
+        let mut buffer = vec![0; 3];
+        let scaling = get_fits_raw_i32_image_into_buffer!(fptr, &hdu, &mut buffer).unwrap();
+        assert_eq!(buffer, vec![-1, 0, 1]);
+        assert_eq!(
+            scaling,
+            FitsImageScaling {
+                bitpix: 32,
+                bscale: 2.0,
+                bzero: 10.0
+            }
+        );
+        assert!(!scaling.is_identity());
+        assert_eq!(scaling.physical_value(buffer[0]), 8.0);
+
+        // Scaled reads of the same HDU still apply the scaling afterwards
+        let scaled: Vec<f32> = get_fits_image!(fptr, &hdu).unwrap();
+        assert_eq!(scaled, vec![8.0, 10.0, 12.0]);
+    });
+}
+
+#[test]
+fn test_get_fits_raw_i32_image_into_buffer_not_integer() {
+    // with_temp_file creates a temp dir and temp file, then removes them once out of scope
+    with_new_temp_fits_file("test_get_fits_raw_image.fits", |mut fptr| {
+        let image_description = ImageDescription {
+            data_type: ImageType::Float,
+            dimensions: &[1, 3],
+        };
+        fptr.create_image("EXTNAME".to_string(), &image_description)
+            .unwrap();
+        let hdu = fits_open_hdu!(fptr, 1).expect("Couldn't open HDU 1");
+        assert!(hdu.write_image(&mut fptr, &[1.0, 2.0, 3.0]).is_ok());
+
+        let mut buffer = vec![0; 3];
+        let result = get_fits_raw_i32_image_into_buffer!(fptr, &hdu, &mut buffer);
+        assert!(matches!(
+            result,
+            Err(FitsError::NotIntegerImage { bitpix: -32, .. })
+        ));
+    });
+}
+
 #[test]
 fn test_get_fits_image_invalid() {
     // with_temp_file creates a temp dir and temp file, then removes them once out of scope
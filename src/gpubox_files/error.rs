@@ -18,6 +18,16 @@ pub enum GpuboxError {
     #[error("Invalid coarse chan index provided. The coarse chan index must be between 0 and {0}")]
     InvalidCoarseChanIndex(usize),
 
+    #[error("Invalid baseline index provided. The baseline index must be between 0 and {0}")]
+    InvalidBaselineIndex(usize),
+
+    #[error("Invalid fine chan range {start}..{end} provided. The fine chan range must be within 0..{num_fine_chans}")]
+    InvalidFineChanRange {
+        start: usize,
+        end: usize,
+        num_fine_chans: usize,
+    },
+
     #[error("No gpubox / mwax fits files were supplied")]
     NoGpuboxes,
 
@@ -106,6 +116,28 @@ maybe you have a mix of different files?"#)]
         coarse_chan_index: usize,
     },
 
+    #[error("Provided buffer of {0} floats is not the correct size (should be {1} floats)")]
+    InvalidBufferSize(usize, usize),
+
+    #[error("HDU {hdu_index} of MWAX gpubox file {gpubox_filename} should be the weights HDU of the preceding visibility HDU, but its dimensions or TIME do not match")]
+    InvalidWeightsHdu {
+        gpubox_filename: String,
+        hdu_index: usize,
+    },
+
+    #[error("Weights HDUs are only present in MWAX v2 gpubox files, not {mwa_version} files")]
+    NoWeightsForMwaVersion { mwa_version: MWAVersion },
+
+    #[error("Invalid averaging factors (time {time_factor}, frequency {freq_factor}). Both must be at least 1, and the frequency factor must divide the {num_fine_chans} fine chans per coarse chan")]
+    InvalidAveragingFactor {
+        time_factor: usize,
+        freq_factor: usize,
+        num_fine_chans: usize,
+    },
+
+    #[error("The gpubox file {0} does not have the same HDU times and HDU size as the first gpubox file of its batch, which was assumed as the context was created with lazy validation. Create the context without lazy validation to read this observation")]
+    LazyValidationMismatch(String),
+
     /// An error derived from `FitsError`.
     #[error("{0}")]
     Fits(#[from] crate::fits_read::error::FitsError),
@@ -8,14 +8,17 @@ Functions for organising and checking the consistency of gpubox files.
 pub mod error;
 
 use std::collections::BTreeMap;
+use std::collections::HashMap;
 use std::collections::HashSet;
 use std::fmt;
 use std::path::Path;
+use std::sync::Mutex;
 
 use fitsio::{hdu::FitsHdu, FitsFile};
 use rayon::prelude::*;
 use regex::Regex;
 
+use crate::gpubox_index_cache::*;
 use crate::*;
 pub use error::GpuboxError;
 
@@ -133,13 +136,108 @@ lazy_static::lazy_static! {
 ///                                      Unix          Chan    Batch  Hdu
 pub(crate) type GpuboxTimeMap = BTreeMap<u64, BTreeMap<usize, (usize, usize)>>;
 
+/// The weights HDUs of MWAX v2 gpubox files, keyed by UNIX time and gpubox
+/// coarse-channel number like `GpuboxTimeMap`. Each is the index of the
+/// weights HDU which follows the visibility HDU in the `GpuboxTimeMap`. There
+/// is no entry for legacy files, or for a visibility HDU without a weights HDU.
+///                                            Unix          Chan    Weights Hdu
+pub(crate) type GpuboxWeightsHduMap = BTreeMap<u64, BTreeMap<usize, usize>>;
+
+/// Where the data for one (timestep, coarse channel) is stored, fully resolved so that no
+/// searching is needed when reading.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) struct GpuboxHduLocation {
+    /// Index into `gpubox_batches`.
+    pub batch_index: usize,
+    /// Index into `gpubox_batches[batch_index].gpubox_files`.
+    pub file_index: usize,
+    /// Index of the visibility HDU within the gpubox file.
+    pub hdu_index: usize,
+    /// Index of the weights HDU within the gpubox file (MWAX v2 only).
+    pub weights_hdu_index: Option<usize>,
+}
+
 /// A little struct to help us not get confused when dealing with the returned
 /// values from complex functions.
 pub(crate) struct GpuboxInfo {
     pub batches: Vec<GpuBoxBatch>,
     pub mwa_version: MWAVersion,
     pub time_map: GpuboxTimeMap,
+    pub weights_hdu_map: GpuboxWeightsHduMap,
     pub hdu_size: usize,
+    /// With lazy validation, the gpubox files which were not scanned (see `DeferredGpuboxValidation`).
+    pub deferred_validation: Option<DeferredGpuboxValidation>,
+}
+
+/// The gpubox files of a context created with lazy validation which have not been opened yet.
+/// Each is assumed to have the same HDU times and HDU size as the first gpubox file of its
+/// batch (which was scanned), and is scanned and checked against that the first time it is read.
+#[derive(Debug)]
+pub(crate) struct DeferredGpuboxValidation {
+    /// Correlator version of the gpubox files.
+    mwa_version: MWAVersion,
+    /// The obs_id reported from the metafits file primary HDU.
+    metafits_obs_id: u32,
+    /// Where to read the gpubox files from.
+    data_sources: DataSources,
+    /// The assumed scan of each gpubox file which has not been validated yet. Files are removed
+    /// once they have been validated, so each is only scanned once.
+    pending: Mutex<HashMap<String, GpuboxFileScan>>,
+}
+
+impl DeferredGpuboxValidation {
+    /// Lock the pending files. Nothing is left half-updated by a panic, so a poisoned lock is
+    /// simply recovered.
+    fn lock_pending(&self) -> std::sync::MutexGuard<'_, HashMap<String, GpuboxFileScan>> {
+        match self.pending.lock() {
+            Ok(guard) => guard,
+            Err(poisoned) => poisoned.into_inner(),
+        }
+    }
+
+    /// Validate a gpubox file (as per `scan_gpubox_file`) and check it matches the scan assumed
+    /// for it, if that has not already been done.
+    ///
+    /// # Arguments
+    ///
+    /// * `gpubox_filename` - The filename of the gpubox file about to be read.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if the file is valid (now or previously), or a GpuboxError if not.
+    ///
+    pub fn validate(&self, gpubox_filename: &str) -> Result<(), GpuboxError> {
+        let expected_scan = match self.lock_pending().get(gpubox_filename) {
+            Some(scan) => scan.clone(),
+            None => return Ok(()),
+        };
+
+        // The file is scanned without holding the lock, so other files can be validated at the
+        // same time. If two readers validate the same file at once, it is just scanned twice.
+        let scan = scan_gpubox_file(
+            gpubox_filename,
+            self.mwa_version,
+            self.metafits_obs_id,
+            &self.data_sources,
+        )?;
+        if scan != expected_scan {
+            return Err(GpuboxError::LazyValidationMismatch(
+                gpubox_filename.to_string(),
+            ));
+        }
+
+        self.lock_pending().remove(gpubox_filename);
+
+        Ok(())
+    }
+
+    /// Returns the filenames of the gpubox files which have not been validated yet.
+    pub fn pending_filenames(&self) -> Vec<String> {
+        let mut filenames: Vec<String> = self.lock_pending().keys().cloned().collect();
+        filenames.sort();
+        filenames
+    }
 }
 
 /// Convert `Vec<TempGPUBoxFile>` to `Vec<GPUBoxBatch>`. This requires the fits
@@ -220,6 +318,10 @@ fn convert_temp_gpuboxes(temp_gpuboxes: Vec<TempGpuBoxFile>) -> Vec<GpuBoxBatch>
 ///
 /// * `metafits_obs_id` - The obs_id reported from the metafits file primary HDU
 ///
+/// * `lazy_validation` - true to scan only one gpubox file per batch (see `examine_gpubox_files_with_index_cache`).
+///
+/// * `data_sources` - Where to read gpubox files from, if not the filesystem.
+///
 /// # Returns
 ///
 /// * A Result containing a vector of GPUBoxBatch structs, the MWA Correlator
@@ -230,65 +332,262 @@ fn convert_temp_gpuboxes(temp_gpuboxes: Vec<TempGpuBoxFile>) -> Vec<GpuBoxBatch>
 pub(crate) fn examine_gpubox_files<T: AsRef<Path>>(
     gpubox_filenames: &[T],
     metafits_obs_id: u32,
+    lazy_validation: bool,
+    data_sources: &DataSources,
+) -> Result<GpuboxInfo, GpuboxError> {
+    examine_gpubox_files_with_index_cache(
+        gpubox_filenames,
+        metafits_obs_id,
+        None,
+        lazy_validation,
+        data_sources,
+    )
+}
+
+/// As per `examine_gpubox_files`, but gpubox files which have an up to date entry in the
+/// supplied index cache are not opened at all. Any gpubox files which are scanned are added to
+/// the index cache.
+///
+/// With `lazy_validation`, only one gpubox file of each batch is scanned (one in the index
+/// cache, if there is one). The others are assumed to have the same HDU times and HDU size, and
+/// are returned in `GpuboxInfo::deferred_validation` to be checked when they are first read.
+///
+///
+/// # Arguments
+///
+/// * `gpubox_filenames` - A vector or slice of strings or references to strings
+///                        containing all of the gpubox filenames provided by the client.
+///
+/// * `metafits_obs_id` - The obs_id reported from the metafits file primary HDU
+///
+/// * `index_cache` - An optional index of previously scanned gpubox files.
+///
+/// * `lazy_validation` - true to scan only one gpubox file per batch.
+///
+/// * `data_sources` - Where to read gpubox files from, if not the filesystem.
+///
+/// # Returns
+///
+/// * A Result containing a vector of GPUBoxBatch structs, the MWA Correlator
+///   version, the UNIX times paired with gpubox HDU numbers, and the amount of
+///   data in each HDU.
+///
+///
+pub(crate) fn examine_gpubox_files_with_index_cache<T: AsRef<Path>>(
+    gpubox_filenames: &[T],
+    metafits_obs_id: u32,
+    mut index_cache: Option<&mut GpuboxIndexCache>,
+    lazy_validation: bool,
+    data_sources: &DataSources,
 ) -> Result<GpuboxInfo, GpuboxError> {
     let (temp_gpuboxes, corr_format) = determine_gpubox_batches(gpubox_filenames)?;
 
-    let time_map: GpuboxTimeMap = create_time_map(&temp_gpuboxes, corr_format)?;
+    // Use the index for any gpubox files which have not changed since they were indexed. Files
+    // from a data source are not on disk, so are never indexed.
+    let cached_scans: Vec<Option<GpuboxFileScan>> = temp_gpuboxes
+        .iter()
+        .map(|g| match &index_cache {
+            Some(index) if data_sources.get(g.filename).is_none() => {
+                index.get(g.filename, corr_format, metafits_obs_id).cloned()
+            }
+            _ => None,
+        })
+        .collect();
+
+    // With lazy validation, pick the one gpubox file of each batch to scan, preferring one
+    // which is indexed (so that nothing needs to be opened at all)
+    let mut batch_scanned_file: HashMap<usize, usize> = HashMap::new();
+    if lazy_validation {
+        for (index, g) in temp_gpuboxes.iter().enumerate() {
+            let scanned_index = batch_scanned_file.entry(g.batch_number).or_insert(index);
+            if cached_scans[*scanned_index].is_none() && cached_scans[index].is_some() {
+                *scanned_index = index;
+            }
+        }
+    }
+    let is_deferred = |index: usize, g: &TempGpuBoxFile| -> bool {
+        lazy_validation && batch_scanned_file[&g.batch_number] != index
+    };
 
-    let mut batches = convert_temp_gpuboxes(temp_gpuboxes);
+    // Ugly hack to open up all the HDUs of the gpubox files in parallel. We
+    // can't do this over the `GPUBoxBatch` or `GPUBoxFile` structs because they
+    // contain the `FitsFile` struct, which does not implement the `Send`
+    // trait. `ThreadsafeFitsFile` does contain this, but does not allow
+    // iteration. It seems like the smaller evil is to just iterate over the
+    // filenames here and get the relevant info out of the HDUs before things
+    // get too complicated elsewhere.
 
-    // Determine the size of each gpubox's image on HDU 1. mwalib will throw an
-    // error if this size is not consistent for all gpubox files.
+    // In parallel, open up all the fits files which are not indexed (or deferred), validate
+    // them and get their HDU times. rayon preserves the order of the input
+    // arguments, so there is no need to keep the temporary gpubox files along
+    // with their scans.
+    // This happens while a context is being created, so the library-wide thread pool is used.
+    let scans = thread_pool::install(None, || {
+        temp_gpuboxes
+            .par_iter()
+            .enumerate()
+            .zip(cached_scans.into_par_iter())
+            .map(|((index, g), cached_scan)| match cached_scan {
+                Some(scan) => Ok(Some((scan, true))),
+                None if is_deferred(index, g) => Ok(None),
+                None => scan_gpubox_file(g.filename, corr_format, metafits_obs_id, data_sources)
+                    .map(|s| Some((s, false))),
+            })
+            .collect::<Vec<Result<Option<(GpuboxFileScan, bool)>, GpuboxError>>>()
+    });
+    let scans = scans
+        .into_iter()
+        .collect::<Result<Vec<Option<(GpuboxFileScan, bool)>>, GpuboxError>>()?;
+
+    // Deferred gpubox files are assumed to have the same scan as the scanned file of their batch
+    let mut deferred_scans: HashMap<String, GpuboxFileScan> = HashMap::new();
+    let scans: Vec<(GpuboxFileScan, bool)> = scans
+        .iter()
+        .zip(temp_gpuboxes.iter())
+        .map(|(scan, g)| match scan {
+            Some(scan) => scan.clone(),
+            None => {
+                let (assumed_scan, _) = scans[batch_scanned_file[&g.batch_number]].clone().unwrap();
+                deferred_scans.insert(g.filename.to_string(), assumed_scan.clone());
+                // Treat it as cached, so it is not added to the index cache until validated
+                (assumed_scan, true)
+            }
+        })
+        .collect();
+
+    // Collapse all of the gpubox scans into a single time map. mwalib will
+    // throw an error if the HDU size is not consistent for all gpubox files.
+    let mut time_map: GpuboxTimeMap = BTreeMap::new();
+    let mut weights_hdu_map: GpuboxWeightsHduMap = BTreeMap::new();
     let mut hdu_size: Option<usize> = None;
-    for b in &mut batches {
-        for g in &mut b.gpubox_files {
-            let mut fptr = fits_open!(&g.filename)?;
-
-            // Check that there are some HDUs (apart from just the primary)
-            // Assuming it does have some, open the first one
-            let hdu = match fptr.iter().count() {
-                1 => {
-                    return Err(GpuboxError::NoDataHDUsInGpuboxFile {
-                        gpubox_filename: g.filename.clone(),
-                    })
-                }
-                _ => fits_open_hdu!(&mut fptr, 1)?,
-            };
-
-            let this_size = get_hdu_image_size!(&mut fptr, &hdu)?.iter().product();
-            match hdu_size {
-                None => hdu_size = Some(this_size),
-                Some(s) => {
-                    if s != this_size {
-                        return Err(GpuboxError::UnequalHduSizes);
-                    }
+    for ((scan, was_cached), gpubox) in scans.into_iter().zip(temp_gpuboxes.iter()) {
+        match hdu_size {
+            None => hdu_size = Some(scan.hdu_size),
+            Some(s) => {
+                if s != scan.hdu_size {
+                    return Err(GpuboxError::UnequalHduSizes);
                 }
             }
+        }
+
+        for (time, (hdu_index, weights_hdu_index)) in &scan.hdus {
+            let chans = time_map.entry(*time).or_insert_with(BTreeMap::new);
+            if chans.contains_key(&gpubox.channel_identifier) {
+                continue;
+            }
+            chans.insert(gpubox.channel_identifier, (gpubox.batch_number, *hdu_index));
 
-            // Do another check by looking in the header of each fits file and checking the mwa_version is correct
-            let primary_hdu = fits_open_hdu!(&mut fptr, 0)?;
-            validate_gpubox_metadata_mwa_version(
-                &mut fptr,
-                &primary_hdu,
-                &g.filename,
-                corr_format,
-            )?;
-
-            // Do another check to ensure the obsid in the metafits matches that in the gpubox files
-            validate_gpubox_metadata_obs_id(&mut fptr, &primary_hdu, &g.filename, metafits_obs_id)?;
+            if let Some(weights_hdu_index) = weights_hdu_index {
+                weights_hdu_map
+                    .entry(*time)
+                    .or_insert_with(BTreeMap::new)
+                    .insert(gpubox.channel_identifier, *weights_hdu_index);
+            }
+        }
+
+        if !was_cached && data_sources.get(gpubox.filename).is_none() {
+            if let Some(index) = index_cache.as_mut() {
+                index.insert(gpubox.filename, corr_format, metafits_obs_id, scan);
+            }
         }
     }
 
+    let batches = convert_temp_gpuboxes(temp_gpuboxes);
+
     // `determine_gpubox_batches` fails if no gpubox files are supplied, so it
     // is safe to unwrap hdu_size.
     Ok(GpuboxInfo {
         batches,
         mwa_version: corr_format,
         time_map,
+        weights_hdu_map,
         hdu_size: hdu_size.unwrap(),
+        deferred_validation: if lazy_validation {
+            Some(DeferredGpuboxValidation {
+                mwa_version: corr_format,
+                metafits_obs_id,
+                data_sources: data_sources.clone(),
+                pending: Mutex::new(deferred_scans),
+            })
+        } else {
+            None
+        },
     })
 }
 
+/// Open a gpubox file, check it is consistent with the other gpubox files and
+/// the metafits, and work out which UNIX times are associated with which HDUs
+/// and how much data is in each HDU.
+///
+/// Fail if
+///
+/// * MWAX gpubox files don't have a CORR_VER key in HDU 0, or it is not equal
+///   to 2;
+/// * the file has no data HDUs;
+/// * the correlator version or obsid in the file do not match what is expected.
+///
+///
+/// # Arguments
+///
+/// * `gpubox_filename` - The filename of the gpubox file.
+///
+/// * `mwa_version` - enum telling us which correlator version the observation was created by.
+///
+/// * `metafits_obs_id` - The obs_id reported from the metafits file primary HDU
+///
+/// * `data_sources` - Where to read gpubox files from, if not the filesystem.
+///
+///
+/// # Returns
+///
+/// * A Result containing the scan of the gpubox file.
+///
+///
+fn scan_gpubox_file(
+    gpubox_filename: &str,
+    mwa_version: MWAVersion,
+    metafits_obs_id: u32,
+    data_sources: &DataSources,
+) -> Result<GpuboxFileScan, GpuboxError> {
+    let mut fptr = data_sources.open_fits(gpubox_filename)?;
+    let primary_hdu = fits_open_hdu!(&mut fptr, 0)?;
+
+    // New correlator files include a version - check that it is present.
+    if mwa_version == MWAVersion::CorrMWAXv2 {
+        let v: u8 = get_required_fits_key!(&mut fptr, &primary_hdu, "CORR_VER")?;
+        if v != 2 {
+            return Err(GpuboxError::MwaxCorrVerMismatch(
+                gpubox_filename.to_string(),
+            ));
+        }
+    }
+
+    // Get the UNIX times from each of the HDUs of this `FitsFile`.
+    let hdus = map_unix_times_to_hdus(&mut fptr, gpubox_filename, mwa_version)?;
+
+    // Determine the size of the image on HDU 1.
+    // Check that there are some HDUs (apart from just the primary)
+    // Assuming it does have some, open the first one
+    let hdu = match fptr.iter().count() {
+        1 => {
+            return Err(GpuboxError::NoDataHDUsInGpuboxFile {
+                gpubox_filename: gpubox_filename.to_string(),
+            })
+        }
+        _ => fits_open_hdu!(&mut fptr, 1)?,
+    };
+    let hdu_size = get_hdu_image_size!(&mut fptr, &hdu)?.iter().product();
+
+    // Do another check by looking in the header of each fits file and checking the mwa_version is correct
+    let primary_hdu = fits_open_hdu!(&mut fptr, 0)?;
+    validate_gpubox_metadata_mwa_version(&mut fptr, &primary_hdu, gpubox_filename, mwa_version)?;
+
+    // Do another check to ensure the obsid in the metafits matches that in the gpubox files
+    validate_gpubox_metadata_obs_id(&mut fptr, &primary_hdu, gpubox_filename, metafits_obs_id)?;
+
+    Ok(GpuboxFileScan { hdus, hdu_size })
+}
+
 /// Group input gpubox files into batches. A "gpubox batch" refers to the number
 /// XX in a gpubox filename
 /// (e.g. `1065880128_20131015134930_gpubox01_XX.fits`). Some older files might
@@ -427,45 +726,113 @@ fn determine_hdu_time(
 }
 
 /// Iterate over each HDU of the given gpubox file, tracking which UNIX times
-/// are associated with which HDU numbers.
+/// are associated with which HDU numbers. For MWAX v2 files, each visibility HDU
+/// is followed by a weights HDU for the same time, which is recorded alongside
+/// it once `validate_weights_hdu` has checked it really is one.
 ///
 ///
 /// # Arguments
 ///
 /// * `gpubox_fptr` - A FitsFile reference to this gpubox file.
 ///
+/// * `gpubox_filename` - The filename of the gpubox file, for error messages.
+///
 /// * `mwa_version` - enum telling us which correlator version the observation was created by.
 ///
 ///
 /// # Returns
 ///
-/// * A BTree representing time and hdu index this gpubox file.
+/// * A BTree representing time and the (visibility hdu index, weights hdu index) of this gpubox file.
 ///
 ///
 fn map_unix_times_to_hdus(
     gpubox_fptr: &mut FitsFile,
+    gpubox_filename: &str,
     mwa_version: MWAVersion,
-) -> Result<BTreeMap<u64, usize>, FitsError> {
+) -> Result<BTreeMap<u64, (usize, Option<usize>)>, GpuboxError> {
     let mut map = BTreeMap::new();
     let last_hdu_index = gpubox_fptr.iter().count();
-    // The new correlator has a "weights" HDU in each alternating HDU. Skip
-    // those.
-    let step_size = if mwa_version == MWAVersion::CorrMWAXv2 {
-        2
-    } else {
-        1
-    };
+    // The new correlator has a "weights" HDU in each alternating HDU. Step
+    // over those, but keep track of them.
+    let has_weights = mwa_version == MWAVersion::CorrMWAXv2;
+    let step_size = if has_weights { 2 } else { 1 };
     // Ignore the first HDU in all gpubox files; it contains only a little
     // metadata.
     for hdu_index in (1..last_hdu_index).step_by(step_size) {
         let hdu = fits_open_hdu!(gpubox_fptr, hdu_index)?;
         let time = determine_hdu_time(gpubox_fptr, &hdu)?;
-        map.insert(time, hdu_index);
+        // A truncated file may be missing the final weights HDU
+        let weights_hdu_index = if has_weights && hdu_index + 1 < last_hdu_index {
+            validate_weights_hdu(gpubox_fptr, &hdu, hdu_index, time, gpubox_filename)?;
+            Some(hdu_index + 1)
+        } else {
+            None
+        };
+        map.insert(time, (hdu_index, weights_hdu_index));
     }
 
     Ok(map)
 }
 
+/// Validate that the HDU after an MWAX v2 visibility HDU is its weights HDU,
+/// rather than assuming so. A weights HDU has one row per baseline like the
+/// visibility HDU, but only one float per pol rather than one complex value per
+/// fine channel and pol, and has the same TIME / MILLITIM as the visibility HDU.
+///
+///
+/// # Arguments
+///
+/// * `gpubox_fptr` - A FitsFile reference to this gpubox file.
+///
+/// * `visibility_hdu` - The visibility HDU which the weights HDU should follow.
+///
+/// * `visibility_hdu_index` - The index of `visibility_hdu`.
+///
+/// * `visibility_hdu_time` - The UNIX time in milliseconds of `visibility_hdu`.
+///
+/// * `gpubox_filename` - The filename of the gpubox file being validated.
+///
+///
+/// # Returns
+///
+/// * A Result containing `Ok` or a `GpuboxError` if the next HDU is not a weights HDU.
+///
+///
+fn validate_weights_hdu(
+    gpubox_fptr: &mut FitsFile,
+    visibility_hdu: &FitsHdu,
+    visibility_hdu_index: usize,
+    visibility_hdu_time: u64,
+    gpubox_filename: &str,
+) -> Result<(), GpuboxError> {
+    let weights_hdu_index = visibility_hdu_index + 1;
+    let invalid = || GpuboxError::InvalidWeightsHdu {
+        gpubox_filename: gpubox_filename.to_string(),
+        hdu_index: weights_hdu_index,
+    };
+
+    // Dimensions are [NAXIS2, NAXIS1], i.e. [baselines, floats per baseline]
+    let visibility_dims = get_hdu_image_size!(gpubox_fptr, visibility_hdu)?;
+    let weights_hdu = fits_open_hdu!(gpubox_fptr, weights_hdu_index)?;
+    let weights_dims = match get_hdu_image_size!(gpubox_fptr, &weights_hdu) {
+        Ok(dims) => dims,
+        Err(_) => return Err(invalid()),
+    };
+    match (visibility_dims.as_slice(), weights_dims.as_slice()) {
+        (&[vis_rows, vis_floats], &[weights_rows, weights_floats])
+            if vis_rows == weights_rows
+                && weights_floats > 0
+                && weights_floats < vis_floats
+                && vis_floats % (weights_floats * 2) == 0 => {}
+        _ => return Err(invalid()),
+    }
+
+    match determine_hdu_time(gpubox_fptr, &weights_hdu) {
+        Ok(time) if time == visibility_hdu_time => Ok(()),
+        _ => Err(invalid()),
+    }
+}
+
 /// Validate that the correlator version we worked out from the filename does not contradict
 /// the CORR_VER key from MWAX files or absence of that key for legacy correlator.
 ///
@@ -562,71 +929,66 @@ fn validate_gpubox_metadata_obs_id(
     }
 }
 
-/// Returns a BTree structure consisting of:
-/// BTree of timesteps. Each timestep is a BTree for a course channel.
-/// Each coarse channel then contains the batch number and hdu index.
+/// Build a dense table of where the data for every (timestep, coarse channel) is stored, so
+/// that reads need only index into it rather than search the time map and batches. The table
+/// is indexed by `corr_timestep_index * corr_coarse_chans.len() + corr_coarse_chan_index`, and
+/// contains None for each timestep/coarse channel we have no data for.
 ///
 /// # Arguments
 ///
-/// * `gpubox_batches` - vector of structs describing each gpubox "batch"
+/// * `gpubox_time_map` - BTree structure containing the map of what gpubox files and timesteps we were supplied by the client.
 ///
-/// * `mwa_version` - enum telling us which correlator version the observation was created by.
+/// * `gpubox_batches` - the gpubox batches referred to by `gpubox_time_map`.
+///
+/// * `corr_timesteps` - Vector of Correlator Context TimeStep structs.
 ///
+/// * `corr_coarse_chans` - Vector of Correlator Context CoarseChannel structs.
 ///
 /// # Returns
 ///
-/// * A Result containing the GPUBox Time Map or an error.
+/// * A vector of num_timesteps * num_coarse_chans optional HDU locations
 ///
 ///
-fn create_time_map(
-    gpuboxes: &[TempGpuBoxFile],
-    mwa_version: MWAVersion,
-) -> Result<GpuboxTimeMap, GpuboxError> {
-    // Ugly hack to open up all the HDUs of the gpubox files in parallel. We
-    // can't do this over the `GPUBoxBatch` or `GPUBoxFile` structs because they
-    // contain the `FitsFile` struct, which does not implement the `Send`
-    // trait. `ThreadsafeFitsFile` does contain this, but does not allow
-    // iteration. It seems like the smaller evil is to just iterate over the
-    // filenames here and get the relevant info out of the HDUs before things
-    // get too complicated elsewhere.
-
-    // In parallel, open up all the fits files and get their HDU times. rayon
-    // preserves the order of the input arguments, so there is no need to keep
-    // the temporary gpubox files along with their times. In any case, handling
-    // that would be difficult!
-    let maps = gpuboxes
-        .into_par_iter()
-        .map(|g| {
-            let mut fptr = fits_open!(&g.filename)?;
-            let hdu = fits_open_hdu!(&mut fptr, 0)?;
-
-            // New correlator files include a version - check that it is present.
-            if mwa_version == MWAVersion::CorrMWAXv2 {
-                let v: u8 = get_required_fits_key!(&mut fptr, &hdu, "CORR_VER")?;
-                if v != 2 {
-                    return Err(GpuboxError::MwaxCorrVerMismatch(g.filename.to_string()));
-                }
-            }
+pub(crate) fn build_gpubox_hdu_location_table(
+    gpubox_time_map: &GpuboxTimeMap,
+    gpubox_weights_hdu_map: &GpuboxWeightsHduMap,
+    gpubox_batches: &[GpuBoxBatch],
+    corr_timesteps: &[TimeStep],
+    corr_coarse_chans: &[CoarseChannel],
+) -> Vec<Option<GpuboxHduLocation>> {
+    let mut table = Vec::with_capacity(corr_timesteps.len() * corr_coarse_chans.len());
+
+    for timestep in corr_timesteps {
+        let chans = gpubox_time_map.get(&timestep.unix_time_ms);
+        let weights_chans = gpubox_weights_hdu_map.get(&timestep.unix_time_ms);
+
+        for coarse_chan in corr_coarse_chans {
+            let channel_identifier = coarse_chan.gpubox_number;
+            let weights_hdu_index = weights_chans
+                .and_then(|c| c.get(&channel_identifier))
+                .copied();
+
+            let location = chans.and_then(|c| c.get(&channel_identifier)).and_then(
+                |&(batch_index, hdu_index)| {
+                    gpubox_batches
+                        .get(batch_index)?
+                        .gpubox_files
+                        .iter()
+                        .position(|gf| gf.channel_identifier == channel_identifier)
+                        .map(|file_index| GpuboxHduLocation {
+                            batch_index,
+                            file_index,
+                            hdu_index,
+                            weights_hdu_index,
+                        })
+                },
+            );
 
-            // Get the UNIX times from each of the HDUs of this `FitsFile`.
-            map_unix_times_to_hdus(&mut fptr, mwa_version).map_err(GpuboxError::from)
-        })
-        .collect::<Vec<Result<BTreeMap<u64, usize>, GpuboxError>>>();
-
-    // Collapse all of the gpubox time maps into a single map.
-    let mut gpubox_time_map = BTreeMap::new();
-    for (map_maybe_error, gpubox) in maps.into_iter().zip(gpuboxes.iter()) {
-        let map = map_maybe_error?;
-        for (time, hdu_index) in map {
-            gpubox_time_map
-                .entry(time)
-                .or_insert_with(BTreeMap::new)
-                .entry(gpubox.channel_identifier)
-                .or_insert((gpubox.batch_number, hdu_index));
+            table.push(location);
         }
     }
 
-    Ok(gpubox_time_map)
+    table
 }
 
 /// Returns a vector of timestep indicies which exist in the GpuBoxTimeMap (i.e. the user has provided at least some data files for these timesteps)
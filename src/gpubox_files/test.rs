@@ -447,15 +447,114 @@ fn test_map_unix_times_to_hdus_test() {
             hdu.write_key(fptr, "MILLITIM", *millitime)
                 .expect("Couldn't write key 'MILLITIM'");
 
-            expected.insert(time * 1000 + millitime, i + 1);
+            expected.insert(time * 1000 + millitime, (i + 1, None));
         }
 
-        let result = map_unix_times_to_hdus(fptr, MWAVersion::CorrLegacy);
+        let result = map_unix_times_to_hdus(fptr, "test.fits", MWAVersion::CorrLegacy);
         assert!(result.is_ok());
         assert_eq!(result.unwrap(), expected);
     });
 }
 
+#[test]
+fn test_map_unix_times_to_hdus_mwaxv2_test() {
+    // with_temp_file creates a temp dir and temp file, then removes them once out of scope
+    with_new_temp_fits_file("map_unix_times_to_hdus_mwaxv2_test.fits", |fptr| {
+        // MWAX v2 files alternate visibility and weights HDUs. The last weights HDU is
+        // missing here, as if the file was truncated.
+        let times: Vec<(u64, u64)> =
+            vec![(1_381_844_923, 500), (1_381_844_924, 0), (1_381_844_950, 0)];
+        let mut expected = BTreeMap::new();
+        // 100 baselines of 8 fine chans * 4 pols * 2 [r,i], and their weights of 4 pols
+        let visibility_description = ImageDescription {
+            data_type: ImageType::Float,
+            dimensions: &[100, 64],
+        };
+        let weights_description = ImageDescription {
+            data_type: ImageType::Float,
+            dimensions: &[100, 4],
+        };
+        for (i, (time, millitime)) in times.iter().enumerate() {
+            let mut descriptions = vec![&visibility_description];
+            if i != times.len() - 1 {
+                descriptions.push(&weights_description);
+            }
+            for description in &descriptions {
+                let hdu = fptr
+                    .create_image("EXTNAME".to_string(), description)
+                    .expect("Couldn't create image");
+                hdu.write_key(fptr, "TIME", *time)
+                    .expect("Couldn't write key 'TIME'");
+                hdu.write_key(fptr, "MILLITIM", *millitime)
+                    .expect("Couldn't write key 'MILLITIM'");
+            }
+
+            let weights_hdu_index = if descriptions.len() == 2 {
+                Some(i * 2 + 2)
+            } else {
+                None
+            };
+            expected.insert(time * 1000 + millitime, (i * 2 + 1, weights_hdu_index));
+        }
+
+        let result = map_unix_times_to_hdus(fptr, "test.fits", MWAVersion::CorrMWAXv2);
+        assert!(result.is_ok());
+        assert_eq!(result.unwrap(), expected);
+    });
+}
+
+#[test]
+fn test_map_unix_times_to_hdus_mwaxv2_invalid_weights_hdu() {
+    // Each case is the (dimensions, time) of the HDU following a visibility HDU of
+    // [100, 64] at time 1_381_844_923
+    let cases: Vec<(&[usize], u64)> = vec![
+        // Another visibility HDU, e.g. a weights HDU is missing from the middle of the file
+        (&[100, 64], 1_381_844_924),
+        (&[100, 64], 1_381_844_923),
+        // Wrong number of baselines
+        (&[99, 4], 1_381_844_923),
+        // Floats per baseline not a divisor of the visibility HDU's
+        (&[100, 3], 1_381_844_923),
+        // Right shape, wrong time
+        (&[100, 4], 1_381_844_924),
+    ];
+
+    for (case_index, (dimensions, next_time)) in cases.iter().enumerate() {
+        // with_temp_file creates a temp dir and temp file, then removes them once out of scope
+        with_new_temp_fits_file(
+            &format!("map_unix_times_to_hdus_invalid_weights_{}.fits", case_index),
+            |fptr| {
+                let hdus: [(&[usize], u64); 2] =
+                    [(&[100, 64], 1_381_844_923), (dimensions, *next_time)];
+                for (hdu_dimensions, time) in hdus.iter() {
+                    let image_description = ImageDescription {
+                        data_type: ImageType::Float,
+                        dimensions: hdu_dimensions,
+                    };
+                    let hdu = fptr
+                        .create_image("EXTNAME".to_string(), &image_description)
+                        .expect("Couldn't create image");
+                    hdu.write_key(fptr, "TIME", *time)
+                        .expect("Couldn't write key 'TIME'");
+                    hdu.write_key(fptr, "MILLITIM", 0_u64)
+                        .expect("Couldn't write key 'MILLITIM'");
+                }
+
+                let result = map_unix_times_to_hdus(fptr, "test.fits", MWAVersion::CorrMWAXv2);
+                assert!(
+                    matches!(
+                        result,
+                        Err(GpuboxError::InvalidWeightsHdu { hdu_index: 2, .. })
+                    ),
+                    "case {}: {:?}",
+                    case_index,
+                    result
+                );
+            },
+        );
+    }
+}
+
 #[test]
 fn test_determine_common_times_test_many_timesteps() {
     // Create two files, with mostly overlapping times, but also a little
@@ -880,6 +979,83 @@ fn test_populate_provided_coarse_channels_some() {
     assert_eq!(provided_coarse_chans[2], 3);
 }
 
+#[test]
+fn test_build_gpubox_hdu_location_table() {
+    // Coarse chan 101 has 2 timesteps, 102 only the second and 103 and 104 none
+    let gpubox_time_map = create_determine_common_obs_times_and_chans_test_data(
+        vec![1000, 2000],
+        vec![2000],
+        vec![],
+        vec![],
+    );
+
+    // The files within a batch are not necessarily in coarse channel order
+    let mut batch = GpuBoxBatch::new(0);
+    batch.gpubox_files.push(GpuBoxFile {
+        filename: String::from("gpubox102_00.fits"),
+        channel_identifier: 102,
+    });
+    batch.gpubox_files.push(GpuBoxFile {
+        filename: String::from("gpubox101_00.fits"),
+        channel_identifier: 101,
+    });
+    let gpubox_batches = vec![batch];
+
+    let correlator_timesteps = vec![
+        TimeStep::new(1000, 1000),
+        TimeStep::new(2000, 2000),
+        TimeStep::new(3000, 3000),
+    ];
+
+    let correlator_coarse_chans = vec![
+        CoarseChannel::new(1, 101, 101, 1_280_000),
+        CoarseChannel::new(2, 102, 102, 1_280_000),
+        CoarseChannel::new(3, 103, 103, 1_280_000),
+    ];
+
+    // Only the second timestep of coarse chan 101 has a weights HDU
+    let mut gpubox_weights_hdu_map: GpuboxWeightsHduMap = BTreeMap::new();
+    gpubox_weights_hdu_map
+        .entry(2000)
+        .or_insert_with(BTreeMap::new)
+        .insert(101, 7);
+
+    let table = build_gpubox_hdu_location_table(
+        &gpubox_time_map,
+        &gpubox_weights_hdu_map,
+        &gpubox_batches,
+        &correlator_timesteps,
+        &correlator_coarse_chans,
+    );
+
+    let location = |file_index, hdu_index, weights_hdu_index| {
+        Some(GpuboxHduLocation {
+            batch_index: 0,
+            file_index,
+            hdu_index,
+            weights_hdu_index,
+        })
+    };
+
+    assert_eq!(
+        table,
+        vec![
+            // timestep 1000
+            location(1, 1, None),
+            None,
+            None,
+            // timestep 2000
+            location(1, 2, Some(7)),
+            location(0, 1, None),
+            None,
+            // timestep 3000
+            None,
+            None,
+            None,
+        ]
+    );
+}
+
 #[test]
 fn test_determine_common_obs_times_and_chans_all_common() {
     // Scenario- all 4 coarse chans have a common timestep
@@ -1253,3 +1429,44 @@ fn test_determine_common_obs_times_and_chans_non_contiguous() {
     assert_eq!(o_good.duration_ms, 1000);
     assert_eq!(o_good.coarse_chan_identifiers, vec![101, 102, 103, 104]);
 }
+
+#[test]
+fn test_examine_gpubox_files_lazy_validation() {
+    // Make a batch of two (identical) gpubox files of different coarse channels
+    let temp_dir = tempdir::TempDir::new("gpubox_lazy_test").unwrap();
+    let gpubox_filenames: Vec<String> = ["gpubox01", "gpubox02"]
+        .iter()
+        .map(|gpubox| {
+            let filename = temp_dir
+                .path()
+                .join(format!("1101503312_20141201210818_{}_00.fits", gpubox));
+            std::fs::copy(
+                "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits",
+                &filename,
+            )
+            .unwrap();
+            filename.to_str().unwrap().to_string()
+        })
+        .collect();
+
+    let gpubox_info =
+        examine_gpubox_files(&gpubox_filenames, 1101503312, false, &DataSources::new()).unwrap();
+    assert!(gpubox_info.deferred_validation.is_none());
+
+    // Lazily, only the first file is scanned, but the result is the same
+    let lazy_gpubox_info =
+        examine_gpubox_files(&gpubox_filenames, 1101503312, true, &DataSources::new()).unwrap();
+    assert_eq!(lazy_gpubox_info.time_map, gpubox_info.time_map);
+    assert_eq!(lazy_gpubox_info.hdu_size, gpubox_info.hdu_size);
+
+    let deferred_validation = lazy_gpubox_info.deferred_validation.unwrap();
+    assert_eq!(
+        deferred_validation.pending_filenames(),
+        vec![gpubox_filenames[1].clone()]
+    );
+
+    // Validating the deferred file removes it from the pending files
+    assert!(deferred_validation.validate(&gpubox_filenames[1]).is_ok());
+    assert!(deferred_validation.pending_filenames().is_empty());
+    assert!(deferred_validation.validate(&gpubox_filenames[0]).is_ok());
+}
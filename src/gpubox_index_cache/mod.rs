@@ -0,0 +1,362 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+An optional on-disk index of what is in each gpubox file, so that reopening an observation does
+not need to open and scan every HDU of every gpubox file again.
+
+The index is a small text file, with one entry per gpubox file. Each entry is keyed by the gpubox
+filename, its size and its modification time, so an entry is only used if the file is unchanged
+since it was indexed. The index is only ever an optimisation: if it is missing, unreadable or
+corrupt it is ignored, and the gpubox files are scanned as normal.
+ */
+use std::collections::{BTreeMap, HashMap};
+use std::fmt;
+use std::fs;
+use std::io::{self, BufRead, BufReader, BufWriter, Write};
+use std::path::Path;
+use std::time::UNIX_EPOCH;
+
+use crate::*;
+
+#[cfg(test)]
+mod test;
+
+/// First line of every index file. Bump the version whenever the format changes so that old
+/// indices are ignored (and then rewritten) rather than misread.
+const INDEX_HEADER: &str = "mwalib-gpubox-index 1";
+
+/// Everything learned about one gpubox file by scanning (and validating) it.
+#[derive(Debug, Clone, PartialEq)]
+pub(crate) struct GpuboxFileScan {
+    /// UNIX time (ms) of each visibility HDU, and the visibility and weights HDU indices.
+    pub hdus: BTreeMap<u64, (usize, Option<usize>)>,
+    /// Number of floats in each visibility HDU.
+    pub hdu_size: usize,
+}
+
+/// An index entry for one gpubox file.
+#[derive(Debug, Clone, PartialEq)]
+struct GpuboxIndexEntry {
+    /// Size of the file in bytes when it was indexed.
+    file_size: u64,
+    /// Modification time of the file (ns since the UNIX epoch) when it was indexed.
+    modified_ns: u128,
+    /// Correlator version the file was validated against.
+    mwa_version: MWAVersion,
+    /// Obsid the file was validated against.
+    obs_id: u32,
+    /// The result of scanning the file.
+    scan: GpuboxFileScan,
+}
+
+/// An index of gpubox files, keyed by filename.
+#[derive(Default)]
+pub(crate) struct GpuboxIndexCache {
+    entries: HashMap<String, GpuboxIndexEntry>,
+    /// true if entries have been added since the index was loaded.
+    modified: bool,
+}
+
+impl GpuboxIndexCache {
+    /// Load an index from disk. A missing, unreadable or corrupt index results in an empty
+    /// index, as the index is only an optimisation.
+    ///
+    /// # Arguments
+    ///
+    /// * `index_filename` - path of the index file.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A GpuboxIndexCache
+    ///
+    pub(crate) fn load<P: AsRef<Path>>(index_filename: P) -> Self {
+        match fs::File::open(index_filename) {
+            Ok(f) => Self::parse(BufReader::new(f)).unwrap_or_default(),
+            Err(_) => Self::default(),
+        }
+    }
+
+    /// Write this index to disk, replacing any existing index file. The index is written to a
+    /// temporary file first and then renamed, so concurrent readers never see a partial index.
+    ///
+    /// # Arguments
+    ///
+    /// * `index_filename` - path of the index file.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if the index was written, or an io::Error.
+    ///
+    pub(crate) fn save<P: AsRef<Path>>(&self, index_filename: P) -> io::Result<()> {
+        let index_filename = index_filename.as_ref();
+        let mut temp_filename = index_filename.as_os_str().to_owned();
+        temp_filename.push(format!(".{}.tmp", std::process::id()));
+
+        let result = fs::File::create(&temp_filename)
+            .and_then(|f| {
+                let mut writer = BufWriter::new(f);
+                self.write(&mut writer)?;
+                writer.flush()
+            })
+            .and_then(|_| fs::rename(&temp_filename, index_filename));
+
+        if result.is_err() {
+            let _ = fs::remove_file(&temp_filename);
+        }
+
+        result
+    }
+
+    /// Returns the scan of a gpubox file, if it is in the index and the file has not changed
+    /// since it was indexed.
+    ///
+    /// # Arguments
+    ///
+    /// * `gpubox_filename` - filename of the gpubox file.
+    ///
+    /// * `mwa_version` - correlator version the file must have been validated against.
+    ///
+    /// * `obs_id` - obsid the file must have been validated against.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the scan of the gpubox file, or None if there is no valid entry.
+    ///
+    pub(crate) fn get(
+        &self,
+        gpubox_filename: &str,
+        mwa_version: MWAVersion,
+        obs_id: u32,
+    ) -> Option<&GpuboxFileScan> {
+        let entry = self.entries.get(gpubox_filename)?;
+        let (file_size, modified_ns) = get_file_size_and_modified_ns(gpubox_filename)?;
+
+        if entry.file_size == file_size
+            && entry.modified_ns == modified_ns
+            && entry.mwa_version == mwa_version
+            && entry.obs_id == obs_id
+        {
+            Some(&entry.scan)
+        } else {
+            None
+        }
+    }
+
+    /// Add (or replace) the entry for a gpubox file. Files which cannot be stat'ed, or whose
+    /// names cannot be stored in the index, are not added.
+    ///
+    /// # Arguments
+    ///
+    /// * `gpubox_filename` - filename of the gpubox file.
+    ///
+    /// * `mwa_version` - correlator version the file was validated against.
+    ///
+    /// * `obs_id` - obsid the file was validated against.
+    ///
+    /// * `scan` - the result of scanning the file.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub(crate) fn insert(
+        &mut self,
+        gpubox_filename: &str,
+        mwa_version: MWAVersion,
+        obs_id: u32,
+        scan: GpuboxFileScan,
+    ) {
+        if gpubox_filename.contains(|c| c == '\t' || c == '\n' || c == '\r') {
+            return;
+        }
+
+        if let Some((file_size, modified_ns)) = get_file_size_and_modified_ns(gpubox_filename) {
+            self.entries.insert(
+                gpubox_filename.to_string(),
+                GpuboxIndexEntry {
+                    file_size,
+                    modified_ns,
+                    mwa_version,
+                    obs_id,
+                    scan,
+                },
+            );
+            self.modified = true;
+        }
+    }
+
+    /// Returns true if entries have been added since the index was loaded (i.e. it needs saving).
+    pub(crate) fn is_modified(&self) -> bool {
+        self.modified
+    }
+
+    /// Write the index in its text format:
+    ///
+    /// ```text
+    /// mwalib-gpubox-index 1
+    /// file<TAB>filename<TAB>size<TAB>mtime_ns<TAB>mwa_version<TAB>obs_id<TAB>hdu_size
+    /// hdu<TAB>unix_time_ms<TAB>hdu_index<TAB>weights_hdu_index or -
+    /// ...
+    /// ```
+    ///
+    /// # Arguments
+    ///
+    /// * `writer` - where to write the index to.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if the index was written, or an io::Error.
+    ///
+    fn write<W: Write>(&self, writer: &mut W) -> io::Result<()> {
+        writeln!(writer, "{}", INDEX_HEADER)?;
+
+        // Write in filename order so the file is deterministic
+        let mut filenames: Vec<&String> = self.entries.keys().collect();
+        filenames.sort();
+
+        for filename in filenames {
+            let entry = &self.entries[filename];
+            writeln!(
+                writer,
+                "file\t{}\t{}\t{}\t{}\t{}\t{}",
+                filename,
+                entry.file_size,
+                entry.modified_ns,
+                entry.mwa_version as u8,
+                entry.obs_id,
+                entry.scan.hdu_size
+            )?;
+
+            for (unix_time_ms, (hdu_index, weights_hdu_index)) in &entry.scan.hdus {
+                match weights_hdu_index {
+                    Some(w) => writeln!(writer, "hdu\t{}\t{}\t{}", unix_time_ms, hdu_index, w)?,
+                    None => writeln!(writer, "hdu\t{}\t{}\t-", unix_time_ms, hdu_index)?,
+                }
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Parse an index written by `write`.
+    ///
+    /// # Arguments
+    ///
+    /// * `reader` - where to read the index from.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the index, or None if it could not be read or is not a valid index.
+    ///
+    fn parse<R: BufRead>(reader: R) -> Option<Self> {
+        let mut lines = reader.lines();
+        if lines.next()?.ok()? != INDEX_HEADER {
+            return None;
+        }
+
+        let mut index = Self::default();
+        let mut current: Option<(String, GpuboxIndexEntry)> = None;
+
+        for line in lines {
+            let line = line.ok()?;
+            let fields: Vec<&str> = line.split('\t').collect();
+
+            match fields.as_slice() {
+                ["file", filename, file_size, modified_ns, mwa_version, obs_id, hdu_size] => {
+                    if let Some((f, e)) = current.take() {
+                        index.entries.insert(f, e);
+                    }
+
+                    let mwa_version = match mwa_version.parse::<u8>().ok()? {
+                        1 => MWAVersion::CorrOldLegacy,
+                        2 => MWAVersion::CorrLegacy,
+                        3 => MWAVersion::CorrMWAXv2,
+                        _ => return None,
+                    };
+
+                    current = Some((
+                        filename.to_string(),
+                        GpuboxIndexEntry {
+                            file_size: file_size.parse().ok()?,
+                            modified_ns: modified_ns.parse().ok()?,
+                            mwa_version,
+                            obs_id: obs_id.parse().ok()?,
+                            scan: GpuboxFileScan {
+                                hdus: BTreeMap::new(),
+                                hdu_size: hdu_size.parse().ok()?,
+                            },
+                        },
+                    ));
+                }
+                ["hdu", unix_time_ms, hdu_index, weights_hdu_index] => {
+                    let weights_hdu_index = match *weights_hdu_index {
+                        "-" => None,
+                        w => Some(w.parse().ok()?),
+                    };
+
+                    // An hdu line must follow a file line
+                    current.as_mut()?.1.scan.hdus.insert(
+                        unix_time_ms.parse().ok()?,
+                        (hdu_index.parse().ok()?, weights_hdu_index),
+                    );
+                }
+                _ => return None,
+            }
+        }
+
+        if let Some((f, e)) = current.take() {
+            index.entries.insert(f, e);
+        }
+
+        Some(index)
+    }
+}
+
+/// Implements fmt::Debug for GpuboxIndexCache struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for GpuboxIndexCache {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(f, "GpuboxIndexCache {{ files: {} }}", self.entries.len())
+    }
+}
+
+/// Get the size and modification time of a file.
+///
+/// # Arguments
+///
+/// * `filename` - the file to stat.
+///
+///
+/// # Returns
+///
+/// * An Option containing the size in bytes and modification time in ns since the UNIX epoch, or None if the file cannot be stat'ed.
+///
+fn get_file_size_and_modified_ns(filename: &str) -> Option<(u64, u128)> {
+    let metadata = fs::metadata(filename).ok()?;
+    let modified_ns = metadata
+        .modified()
+        .ok()?
+        .duration_since(UNIX_EPOCH)
+        .ok()?
+        .as_nanos();
+
+    Some((metadata.len(), modified_ns))
+}
@@ -0,0 +1,162 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for the gpubox index cache
+*/
+#[cfg(test)]
+use super::*;
+#[cfg(test)]
+use std::io::Cursor;
+
+#[cfg(test)]
+fn make_scan() -> GpuboxFileScan {
+    let mut hdus = BTreeMap::new();
+    hdus.insert(1_417_468_096_000, (1, None));
+    hdus.insert(1_417_468_096_500, (3, Some(4)));
+
+    GpuboxFileScan {
+        hdus,
+        hdu_size: 128,
+    }
+}
+
+#[test]
+fn test_gpubox_index_cache_write_parse_round_trip() {
+    let mut index = GpuboxIndexCache::default();
+    index.entries.insert(
+        String::from("a_gpubox01_00.fits"),
+        GpuboxIndexEntry {
+            file_size: 12345,
+            modified_ns: 1_600_000_000_123_456_789,
+            mwa_version: MWAVersion::CorrMWAXv2,
+            obs_id: 1_244_973_688,
+            scan: make_scan(),
+        },
+    );
+    index.entries.insert(
+        String::from("b_gpubox02_00.fits"),
+        GpuboxIndexEntry {
+            file_size: 1,
+            modified_ns: 2,
+            mwa_version: MWAVersion::CorrLegacy,
+            obs_id: 1_101_503_312,
+            scan: GpuboxFileScan {
+                hdus: BTreeMap::new(),
+                hdu_size: 0,
+            },
+        },
+    );
+
+    let mut written: Vec<u8> = Vec::new();
+    index.write(&mut written).unwrap();
+
+    let parsed = GpuboxIndexCache::parse(Cursor::new(written)).unwrap();
+    assert_eq!(parsed.entries, index.entries);
+    assert!(!parsed.is_modified());
+}
+
+#[test]
+fn test_gpubox_index_cache_parse_invalid() {
+    // Wrong header (e.g. a future version of the format)
+    assert!(GpuboxIndexCache::parse(Cursor::new("mwalib-gpubox-index 999\n")).is_none());
+
+    // Empty file
+    assert!(GpuboxIndexCache::parse(Cursor::new("")).is_none());
+
+    // hdu line without a preceding file line
+    let text = format!("{}\nhdu\t1\t1\t-\n", INDEX_HEADER);
+    assert!(GpuboxIndexCache::parse(Cursor::new(text)).is_none());
+
+    // Truncated file line
+    let text = format!("{}\nfile\ta.fits\t1\t2\n", INDEX_HEADER);
+    assert!(GpuboxIndexCache::parse(Cursor::new(text)).is_none());
+
+    // Unknown mwa_version
+    let text = format!("{}\nfile\ta.fits\t1\t2\t9\t3\t4\n", INDEX_HEADER);
+    assert!(GpuboxIndexCache::parse(Cursor::new(text)).is_none());
+}
+
+#[test]
+fn test_gpubox_index_cache_load_missing_or_corrupt() {
+    let index = GpuboxIndexCache::load("test_files/does_not_exist.index");
+    assert_eq!(index.entries.len(), 0);
+
+    let temp_dir = tempdir::TempDir::new("gpubox_index_test").unwrap();
+    let index_filename = temp_dir.path().join("corrupt.index");
+    fs::write(&index_filename, "not an index\n").unwrap();
+
+    let index = GpuboxIndexCache::load(&index_filename);
+    assert_eq!(index.entries.len(), 0);
+}
+
+#[test]
+fn test_gpubox_index_cache_get_insert_save_load() {
+    let temp_dir = tempdir::TempDir::new("gpubox_index_test").unwrap();
+    let gpubox_path = temp_dir
+        .path()
+        .join("1244973688_20190619000000_ch001_000.fits");
+    fs::write(&gpubox_path, vec![0u8; 2880]).unwrap();
+    let gpubox_filename = gpubox_path.to_str().unwrap();
+    let index_filename = temp_dir.path().join("gpubox.index");
+
+    let mut index = GpuboxIndexCache::default();
+    assert!(index
+        .get(gpubox_filename, MWAVersion::CorrMWAXv2, 1_244_973_688)
+        .is_none());
+
+    index.insert(
+        gpubox_filename,
+        MWAVersion::CorrMWAXv2,
+        1_244_973_688,
+        make_scan(),
+    );
+    assert!(index.is_modified());
+    assert_eq!(
+        index.get(gpubox_filename, MWAVersion::CorrMWAXv2, 1_244_973_688),
+        Some(&make_scan())
+    );
+
+    // Entries are only valid for the same correlator version and obsid
+    assert!(index
+        .get(gpubox_filename, MWAVersion::CorrLegacy, 1_244_973_688)
+        .is_none());
+    assert!(index
+        .get(gpubox_filename, MWAVersion::CorrMWAXv2, 1_101_503_312)
+        .is_none());
+
+    index.save(&index_filename).unwrap();
+    let loaded = GpuboxIndexCache::load(&index_filename);
+    assert_eq!(
+        loaded.get(gpubox_filename, MWAVersion::CorrMWAXv2, 1_244_973_688),
+        Some(&make_scan())
+    );
+
+    // Changing the file invalidates its entry
+    fs::write(&gpubox_path, vec![0u8; 5760]).unwrap();
+    assert!(loaded
+        .get(gpubox_filename, MWAVersion::CorrMWAXv2, 1_244_973_688)
+        .is_none());
+}
+
+#[test]
+fn test_gpubox_index_cache_insert_unstorable_or_missing() {
+    let mut index = GpuboxIndexCache::default();
+
+    index.insert(
+        "test_files/does_not_exist.fits",
+        MWAVersion::CorrMWAXv2,
+        1_244_973_688,
+        make_scan(),
+    );
+    index.insert(
+        "test_files/bad\tname.fits",
+        MWAVersion::CorrMWAXv2,
+        1_244_973_688,
+        make_scan(),
+    );
+
+    assert_eq!(index.entries.len(), 0);
+    assert!(!index.is_modified());
+}
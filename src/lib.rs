@@ -7,20 +7,36 @@ Definitions for what we expose to the library
 Public items will be exposed as mwalib::module.
 */
 mod antenna;
+mod averaging;
 mod baseline;
+#[cfg(feature = "benchmarks")]
+#[doc(hidden)]
+pub mod bench_support;
 mod coarse_channel;
 mod convert;
 mod correlator_context;
+mod data_source;
+mod direct_io;
 mod error;
 mod ffi;
+mod file_io;
+mod fits_handle_cache;
 mod fits_read;
 mod gpubox_files;
+mod gpubox_index_cache;
 mod metafits_context;
 mod misc;
+mod prefetch;
+mod read_stats;
 mod rfinput;
+pub mod thread_pool;
 mod timestep;
+mod visibility_cache;
 mod voltage_context;
 mod voltage_files;
+mod voltage_mmap;
+mod voltage_prefetch;
+mod voltage_unpack;
 
 /// The MWA's latitude on Earth in radians. This is -26d42m11.94986s.
 pub const MWA_LATITUDE_RADIANS: f64 = -0.4660608448386394;
@@ -47,15 +63,30 @@ pub mod built_info {
 pub use antenna::Antenna;
 pub use baseline::Baseline;
 pub use coarse_channel::CoarseChannel;
-pub use correlator_context::CorrelatorContext;
+pub use correlator_context::{CorrelatorContext, CorrelatorContextBuilder};
+pub use data_source::{
+    DataSource, DataSourceError, DataSources, FileRangeSource, MemorySource, TarArchive, TarMember,
+};
+pub use direct_io::{AlignedBuffer, DIRECT_IO_ALIGNMENT};
 pub use error::MwalibError;
+pub use fits_handle_cache::DEFAULT_MAX_OPEN_FITS_FILES;
 pub use fits_read::*;
 pub use metafits_context::{GeometricDelaysApplied, MWAMode, MWAVersion, MetafitsContext, VisPol};
 pub use misc::*;
+pub use prefetch::{PrefetchedTimestep, ReadOrder, TimestepPrefetchIterator};
+pub use read_stats::ReadStats;
 pub use rfinput::{Pol, Rfinput};
+pub use thread_pool::error::ThreadPoolError;
 pub use timestep::TimeStep;
-pub use voltage_context::VoltageContext;
+pub use visibility_cache::{VisibilityCache, VisibilityCacheError};
+pub use voltage_context::{VoltageContext, VoltageContextBuilder};
+pub use voltage_mmap::{VoltageFileMmap, VoltageSecondsMmap};
+pub use voltage_prefetch::{GpsSecondPrefetchIterator, PrefetchedGpsSeconds};
+pub use voltage_unpack::VoltageSample;
 
 // So that callers don't use a different version of fitsio, export them here.
 pub use fitsio;
 pub use fitsio_sys;
+
+// So that callers can build a thread pool for mwalib with the same version of rayon.
+pub use rayon;
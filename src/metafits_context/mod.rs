@@ -7,7 +7,11 @@ The main interface to MWA data.
  */
 use chrono::{DateTime, Duration, FixedOffset};
 use num_derive::FromPrimitive;
+use std::collections::HashMap;
 use std::fmt;
+use std::path::PathBuf;
+use std::sync::{Arc, Mutex, Weak};
+use std::time::SystemTime;
 
 use crate::antenna::*;
 use crate::baseline::*;
@@ -21,7 +25,7 @@ mod test;
 /// Enum for all of the known variants of file format based on Correlator version
 ///
 #[repr(C)]
-#[derive(Debug, PartialEq, Clone, Copy)]
+#[derive(Debug, PartialEq, Eq, Hash, Clone, Copy)]
 pub enum MWAVersion {
     /// MWA correlator (v1.0), having data files without any batch numbers.
     CorrOldLegacy = 1,
@@ -377,6 +381,36 @@ pub struct MetafitsContext {
     pub num_visibility_pols: usize,
     /// Filename of the metafits we were given
     pub metafits_filename: String,
+    /// C representations of the antennas and rf_inputs, built the first time they are requested
+    /// through the FFI borrowed accessors
+    pub(crate) ffi_metadata_cache: ffi::FfiMetadataCache,
+    /// The MWAVersion the metafits coarse channels and timesteps were populated for, or None if
+    /// they have not been populated
+    pub(crate) mwa_version: Option<MWAVersion>,
+    /// Lookups of antenna indices by tile name / tile id, and of baselines by antenna pair
+    pub(crate) baseline_lookup: BaselineLookup,
+    /// Receiver channel numbers from the metafits CHANNELS key, kept so the coarse channels can be
+    /// repopulated for another MWAVersion without reopening the metafits file
+    pub(crate) metafits_coarse_chan_vec: Vec<usize>,
+}
+
+/// Key of the process-wide cache of shared metafits contexts. A metafits file which has been
+/// modified since it was cached gets a new key, so stale contexts are never returned.
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+struct SharedMetafitsKey {
+    /// Canonical path of the metafits file
+    path: PathBuf,
+    /// Modification time of the metafits file
+    modified: SystemTime,
+    /// The MWAVersion the context was populated for
+    mwa_version: MWAVersion,
+}
+
+lazy_static::lazy_static! {
+    /// Metafits contexts created by `MetafitsContext::new_shared`. Only weak references are held,
+    /// so a context is freed once every correlator / voltage context using it has been dropped.
+    static ref SHARED_METAFITS_CONTEXTS: Mutex<HashMap<SharedMetafitsKey, Weak<MetafitsContext>>> =
+        Mutex::new(HashMap::new());
 }
 
 impl MetafitsContext {
@@ -409,6 +443,133 @@ impl MetafitsContext {
         Ok(new_context)
     }
 
+    /// As per `new`, but returning a shared context from a process-wide cache. The cache is keyed
+    /// by the metafits path, its modification time and `mwa_version`, so opening many correlator
+    /// or voltage contexts for the same observation only parses the metafits file once. If the
+    /// observation is already cached for a different `mwa_version`, the parsed antennas, rf_inputs
+    /// and baselines are reused and only the coarse channels and timesteps are repopulated.
+    ///
+    /// The returned context can be passed to `CorrelatorContext::new_from_metafits_context` or
+    /// `VoltageContext::new_from_metafits_context`. The cache does not keep contexts alive: a
+    /// context is reused while something still holds it, and is parsed again once every `Arc` to
+    /// it has been dropped. Entries for dropped contexts (or for a metafits file which has since
+    /// been modified) are removed whenever `new_shared` opens the same file.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_filename` - filename of metafits file as a path or string.
+    ///
+    /// * `mwa_version` - the MWAVersion to populate the coarse channels and timesteps for.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a shared, populated MetafitsContext if Ok.
+    ///
+    ///
+    pub fn new_shared<T: AsRef<std::path::Path>>(
+        metafits: &T,
+        mwa_version: MWAVersion,
+    ) -> Result<Arc<Self>, MwalibError> {
+        // If we can't stat the file, don't cache anything and let `new` report the error
+        let modified = match std::fs::metadata(metafits).and_then(|m| m.modified()) {
+            Ok(modified) => modified,
+            Err(_) => return Ok(Arc::new(Self::new(metafits, mwa_version)?)),
+        };
+        let path = std::fs::canonicalize(metafits).unwrap_or_else(|_| metafits.as_ref().into());
+        let key = SharedMetafitsKey {
+            path,
+            modified,
+            mwa_version,
+        };
+
+        // Look for this version, or any other version of the same file we can repopulate
+        let existing = {
+            let mut cache = match SHARED_METAFITS_CONTEXTS.lock() {
+                Ok(cache) => cache,
+                Err(poisoned) => poisoned.into_inner(),
+            };
+
+            if let Some(context) = cache.get(&key).and_then(Weak::upgrade) {
+                return Ok(context);
+            }
+
+            // Drop entries for contexts which have been freed, or for an older version of this file
+            cache.retain(|k, context| {
+                context.strong_count() > 0 && (k.path != key.path || k.modified == key.modified)
+            });
+
+            cache
+                .iter()
+                .filter(|(k, _)| k.path == key.path)
+                .find_map(|(_, context)| context.upgrade())
+        };
+
+        // Parse (or repopulate) without holding the lock, so other files can be opened meanwhile
+        let context = match existing {
+            Some(context) => Self::populated_for_version(context, mwa_version)?,
+            None => Arc::new(Self::new(metafits, mwa_version)?),
+        };
+
+        let mut cache = match SHARED_METAFITS_CONTEXTS.lock() {
+            Ok(cache) => cache,
+            Err(poisoned) => poisoned.into_inner(),
+        };
+
+        // If another thread got here first, use its context so there is only ever one
+        if let Some(existing) = cache.get(&key).and_then(Weak::upgrade) {
+            return Ok(existing);
+        }
+        cache.insert(key, Arc::downgrade(&context));
+
+        Ok(context)
+    }
+
+    /// Empty the process-wide cache of contexts created by `new_shared`, so the next call parses
+    /// the metafits file again. Contexts already handed out are unaffected.
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn clear_shared_cache() {
+        match SHARED_METAFITS_CONTEXTS.lock() {
+            Ok(mut cache) => cache.clear(),
+            Err(poisoned) => poisoned.into_inner().clear(),
+        }
+    }
+
+    /// Returns a shared context whose coarse channels and timesteps are populated for
+    /// `mwa_version`. If `metafits_context` already is, it is returned as is. Otherwise it is
+    /// repopulated, cloning it first if it is shared, without reading the metafits file again.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - a (possibly shared) populated or unpopulated MetafitsContext.
+    ///
+    /// * `mwa_version` - the MWAVersion the coarse channels and timesteps are needed for.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing the populated MetafitsContext if Ok.
+    ///
+    ///
+    pub(crate) fn populated_for_version(
+        mut metafits_context: Arc<Self>,
+        mwa_version: MWAVersion,
+    ) -> Result<Arc<Self>, MwalibError> {
+        if metafits_context.mwa_version != Some(mwa_version) {
+            let context = Arc::make_mut(&mut metafits_context);
+            context.metafits_coarse_chans.clear();
+            context.metafits_timesteps.clear();
+            context.populate_expected_coarse_channels(mwa_version)?;
+            context.populate_expected_timesteps(mwa_version)?;
+        }
+
+        Ok(metafits_context)
+    }
+
     /// From a path to a metafits file, create a `MetafitsContext`.
     ///
     /// # Arguments
@@ -477,6 +638,7 @@ impl MetafitsContext {
 
         // Populate baselines
         let baselines = Baseline::populate_baselines(num_antennas);
+        let baseline_lookup = BaselineLookup::new(&antennas);
 
         // Populate the pols that come out of the correlator
         let num_visibility_pols = 4; // no easy way to get the count of enum variants
@@ -700,11 +862,16 @@ impl MetafitsContext {
             num_baselines,
             baselines,
             num_visibility_pols,
+            ffi_metadata_cache: ffi::FfiMetadataCache::default(),
+            mwa_version: None,
+            baseline_lookup,
+            metafits_coarse_chan_vec,
         })
     }
 
     /// Given a hint at the expected `MWAVersion`, populate the coarse_channel vector with the expected
-    /// coarse channels for an existing populated MetafitsContext.
+    /// coarse channels for an existing populated MetafitsContext. The receiver channels read from
+    /// the metafits when the context was created are used, so the file is not reopened.
     ///
     /// # Arguments    
     ///
@@ -720,24 +887,12 @@ impl MetafitsContext {
         &mut self,
         mwa_version: MWAVersion,
     ) -> Result<(), MwalibError> {
-        // Reopen metafits
-        let mut metafits_fptr = fits_open!(&self.metafits_filename)?;
-        let metafits_hdu = fits_open_hdu!(&mut metafits_fptr, 0)?;
-
-        // Get metafits info
-        let (metafits_coarse_chan_vec, metafits_coarse_chan_width_hz) =
-            CoarseChannel::get_metafits_coarse_channel_info(
-                &mut metafits_fptr,
-                &metafits_hdu,
-                self.obs_bandwidth_hz,
-            )?;
-
         // Populate coarse chans from the metafits info.
         self.metafits_coarse_chans.extend(
             CoarseChannel::populate_coarse_channels(
                 mwa_version,
-                &metafits_coarse_chan_vec,
-                metafits_coarse_chan_width_hz,
+                &self.metafits_coarse_chan_vec,
+                self.coarse_chan_width_hz,
                 None,
                 None,
             )?
@@ -780,9 +935,97 @@ impl MetafitsContext {
         );
 
         self.num_metafits_timesteps = self.metafits_timesteps.len();
+        self.mwa_version = Some(mwa_version);
 
         Ok(())
     }
+
+    /// Get the index (within `antennas`) of the antenna with a tile name, without searching.
+    ///
+    /// # Arguments
+    ///
+    /// * `tile_name` - the tile name, e.g. "Tile011".
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the antenna index, or None if no antenna has this tile name.
+    ///
+    pub fn get_antenna_index_from_tile_name(&self, tile_name: &str) -> Option<usize> {
+        self.baseline_lookup
+            .get_antenna_index_from_tile_name(tile_name)
+    }
+
+    /// Get the index (within `antennas`) of the antenna with a tile id, without searching.
+    ///
+    /// # Arguments
+    ///
+    /// * `tile_id` - the tile id, e.g. 11.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the antenna index, or None if no antenna has this tile id.
+    ///
+    pub fn get_antenna_index_from_tile_id(&self, tile_id: u32) -> Option<usize> {
+        self.baseline_lookup.get_antenna_index_from_tile_id(tile_id)
+    }
+
+    /// Get the index (within `baselines`) of the baseline between two antennas, from the
+    /// precomputed baseline table.
+    ///
+    /// # Arguments
+    ///
+    /// * `ant1_index` - index within `antennas` of antenna1.
+    ///
+    /// * `ant2_index` - index within `antennas` of antenna2.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the baseline index, or None if either index is out of range or ant1_index > ant2_index.
+    ///
+    pub fn get_baseline_index(&self, ant1_index: usize, ant2_index: usize) -> Option<usize> {
+        self.baseline_lookup
+            .get_baseline_index(ant1_index, ant2_index)
+    }
+
+    /// Get the index (within `baselines`) of the baseline between two tiles, without searching.
+    ///
+    /// # Arguments
+    ///
+    /// * `ant1_tile_name` - tile name of antenna1.
+    ///
+    /// * `ant2_tile_name` - tile name of antenna2.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the baseline index, or None if either tile is not found or antenna1 comes after antenna2.
+    ///
+    pub fn get_baseline_index_from_tile_names(
+        &self,
+        ant1_tile_name: &str,
+        ant2_tile_name: &str,
+    ) -> Option<usize> {
+        self.get_baseline_index(
+            self.get_antenna_index_from_tile_name(ant1_tile_name)?,
+            self.get_antenna_index_from_tile_name(ant2_tile_name)?,
+        )
+    }
+
+    /// Get the precomputed baseline table, of `num_ants * num_ants` baseline indices. The baseline
+    /// between antennas ant1_index and ant2_index is at `[ant1_index * num_ants + ant2_index]`.
+    /// Only the upper triangle holds baselines; entries with ant1_index > ant2_index are
+    /// `u32::MAX` (the baseline is at `[ant2_index * num_ants + ant1_index]`, conjugated).
+    ///
+    /// # Returns
+    ///
+    /// * A slice of `num_ants * num_ants` baseline indices
+    ///
+    pub fn get_baseline_table(&self) -> &[u32] {
+        self.baseline_lookup.baseline_table()
+    }
 }
 
 /// Implements fmt::Display for MetafitsContext struct
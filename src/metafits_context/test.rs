@@ -478,3 +478,204 @@ fn test_mode_enum() {
     assert!(MWAMode::from_str("MWAX_VCS").is_ok());
     assert!(MWAMode::from_str("something invalid").is_err());
 }
+
+#[cfg(test)]
+/// Helper to get the gps times of the metafits timesteps of a context, for comparisons.
+fn timestep_gps_times(context: &MetafitsContext) -> Vec<u64> {
+    context
+        .metafits_timesteps
+        .iter()
+        .map(|t| t.gps_time_ms)
+        .collect()
+}
+
+#[cfg(test)]
+/// Helper to get the corr, rec and gpubox numbers of the metafits coarse chans of a context, for comparisons.
+fn coarse_chan_numbers(context: &MetafitsContext) -> Vec<(usize, usize, usize)> {
+    context
+        .metafits_coarse_chans
+        .iter()
+        .map(|c| (c.corr_chan_number, c.rec_chan_number, c.gpubox_number))
+        .collect()
+}
+
+#[test]
+fn test_metafits_context_new_shared() {
+    let metafits_filename = "test_files/1244973688_1_timestep/1244973688.metafits";
+
+    let context1 = MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrMWAXv2)
+        .expect("Failed to create shared MetafitsContext");
+    let context2 = MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrMWAXv2)
+        .expect("Failed to create shared MetafitsContext");
+
+    // The same context is handed out twice, and matches an unshared one
+    assert!(Arc::ptr_eq(&context1, &context2));
+    let unshared = MetafitsContext::new(&metafits_filename, MWAVersion::CorrMWAXv2).unwrap();
+    assert_eq!(context1.obs_id, unshared.obs_id);
+    assert_eq!(context1.rf_inputs, unshared.rf_inputs);
+    assert_eq!(timestep_gps_times(&context1), timestep_gps_times(&unshared));
+    assert_eq!(
+        coarse_chan_numbers(&context1),
+        coarse_chan_numbers(&unshared)
+    );
+    assert_eq!(context1.mwa_version, Some(MWAVersion::CorrMWAXv2));
+
+    // A different MWAVersion is a different context
+    let vcs_context = MetafitsContext::new_shared(&metafits_filename, MWAVersion::VCSMWAXv2)
+        .expect("Failed to create shared MetafitsContext");
+    assert!(!Arc::ptr_eq(&context1, &vcs_context));
+    assert_eq!(vcs_context.mwa_version, Some(MWAVersion::VCSMWAXv2));
+    let unshared = MetafitsContext::new(&metafits_filename, MWAVersion::VCSMWAXv2).unwrap();
+    assert_eq!(
+        timestep_gps_times(&vcs_context),
+        timestep_gps_times(&unshared)
+    );
+
+    // A missing file is an error, just like `new`
+    assert!(MetafitsContext::new_shared(&"invalid.metafits", MWAVersion::CorrMWAXv2).is_err());
+}
+
+#[test]
+fn test_metafits_context_clear_shared_cache() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+
+    let context1 = MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrLegacy)
+        .expect("Failed to create shared MetafitsContext");
+    MetafitsContext::clear_shared_cache();
+    let context2 = MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrLegacy)
+        .expect("Failed to create shared MetafitsContext");
+
+    // Once cleared, the metafits file is parsed again
+    assert!(!Arc::ptr_eq(&context1, &context2));
+    assert_eq!(context1.rf_inputs, context2.rf_inputs);
+}
+
+#[test]
+fn test_metafits_context_shared_cache_does_not_keep_contexts_alive() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+
+    let context = MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrLegacy)
+        .expect("Failed to create shared MetafitsContext");
+    let weak = Arc::downgrade(&context);
+    drop(context);
+
+    // Nothing else holds the context, so the cache must not either
+    assert!(weak.upgrade().is_none());
+
+    // ...and it is parsed again on the next call
+    let context = MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrLegacy)
+        .expect("Failed to create shared MetafitsContext");
+    assert_eq!(context.num_metafits_coarse_chans, 24);
+}
+
+#[test]
+fn test_metafits_context_populate_coarse_chans_does_not_reopen_metafits() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+
+    let mut context = MetafitsContext::new_internal(&metafits_filename).unwrap();
+    context.metafits_filename = String::from("invalid.metafits");
+
+    // The CHANNELS read when the context was created are used, so the missing file is not an error
+    context
+        .populate_expected_coarse_channels(MWAVersion::CorrLegacy)
+        .expect("Failed to populate coarse channels");
+    assert_eq!(context.num_metafits_coarse_chans, 24);
+    assert_eq!(
+        coarse_chan_numbers(&context),
+        coarse_chan_numbers(
+            &MetafitsContext::new(&metafits_filename, MWAVersion::CorrLegacy).unwrap()
+        )
+    );
+}
+
+#[test]
+fn test_metafits_context_populated_for_version() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+
+    let unpopulated = Arc::new(MetafitsContext::new_internal(&metafits_filename).unwrap());
+    assert_eq!(unpopulated.mwa_version, None);
+    assert_eq!(unpopulated.num_metafits_coarse_chans, 0);
+
+    // Populating an unshared context does not copy it
+    let unpopulated_ptr = Arc::as_ptr(&unpopulated);
+    let legacy = MetafitsContext::populated_for_version(unpopulated, MWAVersion::CorrLegacy)
+        .expect("Failed to populate MetafitsContext");
+    assert_eq!(Arc::as_ptr(&legacy), unpopulated_ptr);
+    assert_eq!(legacy.mwa_version, Some(MWAVersion::CorrLegacy));
+    assert_eq!(legacy.num_metafits_coarse_chans, 24);
+
+    // Already populated for this version, so it is returned as is
+    let same = MetafitsContext::populated_for_version(Arc::clone(&legacy), MWAVersion::CorrLegacy)
+        .unwrap();
+    assert!(Arc::ptr_eq(&legacy, &same));
+
+    // A shared context is copied, leaving the original alone
+    let mwax = MetafitsContext::populated_for_version(Arc::clone(&legacy), MWAVersion::CorrMWAXv2)
+        .unwrap();
+    assert!(!Arc::ptr_eq(&legacy, &mwax));
+    assert_eq!(legacy.mwa_version, Some(MWAVersion::CorrLegacy));
+    assert_eq!(legacy.metafits_coarse_chans[0].corr_chan_number, 0);
+    assert_eq!(mwax.mwa_version, Some(MWAVersion::CorrMWAXv2));
+    assert_eq!(mwax.num_metafits_coarse_chans, 24);
+    assert_eq!(
+        coarse_chan_numbers(&mwax),
+        coarse_chan_numbers(
+            &MetafitsContext::new(&metafits_filename, MWAVersion::CorrMWAXv2).unwrap()
+        )
+    );
+}
+
+#[test]
+fn test_metafits_context_baseline_lookups() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let context = MetafitsContext::new(&metafits_filename, MWAVersion::CorrLegacy)
+        .expect("Failed to create MetafitsContext");
+
+    for (index, antenna) in context.antennas.iter().enumerate() {
+        assert_eq!(
+            context.get_antenna_index_from_tile_name(&antenna.tile_name),
+            Some(index)
+        );
+        assert_eq!(
+            context.get_antenna_index_from_tile_id(antenna.tile_id),
+            Some(index)
+        );
+    }
+    assert_eq!(context.get_antenna_index_from_tile_name("NoSuchTile"), None);
+    assert_eq!(context.get_antenna_index_from_tile_id(u32::MAX), None);
+
+    // The table agrees with the baselines, in both directions
+    let table = context.get_baseline_table();
+    assert_eq!(table.len(), context.num_ants * context.num_ants);
+    for (index, baseline) in context.baselines.iter().enumerate() {
+        assert_eq!(
+            context.get_baseline_index(baseline.ant1_index, baseline.ant2_index),
+            Some(index)
+        );
+        assert_eq!(
+            table[baseline.ant1_index * context.num_ants + baseline.ant2_index] as usize,
+            index
+        );
+    }
+    assert_eq!(
+        table.iter().filter(|b| **b != u32::MAX).count(),
+        context.num_baselines
+    );
+    assert_eq!(context.get_baseline_index(1, 0), None);
+    assert_eq!(context.get_baseline_index(0, context.num_ants), None);
+
+    let ant1 = &context.antennas[1];
+    let ant2 = &context.antennas[5];
+    assert_eq!(
+        context.get_baseline_index_from_tile_names(&ant1.tile_name, &ant2.tile_name),
+        get_baseline_from_antennas(1, 5, context.num_ants)
+    );
+    assert_eq!(
+        context.get_baseline_index_from_tile_names(&ant2.tile_name, &ant1.tile_name),
+        None
+    );
+    assert_eq!(
+        context.get_baseline_index_from_tile_names(&ant1.tile_name, "NoSuchTile"),
+        None
+    );
+}
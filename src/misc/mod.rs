@@ -6,7 +6,9 @@
 General helper/utility methods
 */
 use crate::antenna;
-use std::{mem, slice};
+use std::ops::{Deref, DerefMut};
+use std::sync::Mutex;
+use std::{fmt, mem, slice};
 
 #[cfg(test)]
 pub(crate) mod test;
@@ -83,21 +85,27 @@ pub fn get_baseline_count(antennas: usize) -> usize {
 /// * An Option containing antenna1 index and antenna2 index if baseline exists, or None if doesn't exist.
 ///
 pub fn get_antennas_from_baseline(baseline: usize, num_antennas: usize) -> Option<(usize, usize)> {
-    let ant1 = (-0.5
-        * ((4 * num_antennas * num_antennas + 4 * num_antennas - 8 * baseline + 1) as f32).sqrt()
-        + num_antennas as f32
-        + 1. / 2.) as usize;
-
-    let ant2 = baseline - (ant1 * num_antennas - (ant1 * ant1 + ant1) / 2);
+    if baseline >= get_baseline_count(num_antennas) {
+        return None;
+    }
 
-    if ant1 > num_antennas - 1 || ant2 > num_antennas - 1 {
-        None
-    } else {
-        Some((ant1, ant2))
+    // Solve for the row of the upper triangle, then correct for any floating point rounding
+    let row_start = |ant1: usize| ant1 * (2 * num_antennas + 1 - ant1) / 2;
+    let n = num_antennas as f64 + 0.5;
+    let mut ant1 =
+        ((n - (n * n - 2. * baseline as f64).max(0.).sqrt()) as usize).min(num_antennas - 1);
+    while row_start(ant1) > baseline {
+        ant1 -= 1;
+    }
+    while ant1 + 1 < num_antennas && row_start(ant1 + 1) <= baseline {
+        ant1 += 1;
     }
+
+    Some((ant1, ant1 + baseline - row_start(ant1)))
 }
 
-/// Given two antenna indicies, return the baseline index.
+/// Given two antenna indicies, return the baseline index. This is computed directly, so it
+/// takes the same (constant) time for any baseline.
 ///
 /// # Arguments
 ///
@@ -110,28 +118,24 @@ pub fn get_antennas_from_baseline(baseline: usize, num_antennas: usize) -> Optio
 ///
 /// # Returns
 ///
-/// * An Option containing a baseline index if baseline exists, or None if doesn't exist.
+/// * An Option containing a baseline index if baseline exists, or None if doesn't exist (an antenna is out of range, or antenna1 > antenna2).
 ///
 pub fn get_baseline_from_antennas(
     antenna1: usize,
     antenna2: usize,
     num_antennas: usize,
 ) -> Option<usize> {
-    let mut baseline_index = 0;
-    for ant1 in 0..num_antennas {
-        for ant2 in ant1..num_antennas {
-            if ant1 == antenna1 && ant2 == antenna2 {
-                return Some(baseline_index);
-            }
-            baseline_index += 1;
-        }
+    if antenna1 > antenna2 || antenna2 >= num_antennas {
+        return None;
     }
 
-    // Baseline was not found at all
-    None
+    // The baselines before row antenna1 of the upper triangle, then along the row
+    Some(antenna1 * (2 * num_antennas + 1 - antenna1) / 2 + (antenna2 - antenna1))
 }
 
 /// Given two antenna names and the vector of Antenna structs from metafits, return the baseline index.
+/// This searches `antennas` for the names, so when looking up many baselines use
+/// `MetafitsContext::get_baseline_index_from_tile_names` instead.
 ///
 /// # Arguments
 ///
@@ -144,35 +148,21 @@ pub fn get_baseline_from_antennas(
 ///
 /// # Returns
 ///
-/// * An Option containing a baseline index if baseline exists, or None if doesn't exist.
+/// * An Option containing a baseline index if baseline exists, or None if doesn't exist (either tile name is not found, or antenna1 comes after antenna2).
 ///
 pub fn get_baseline_from_antenna_names(
     antenna1_tile_name: String,
     antenna2_tile_name: String,
     antennas: &[antenna::Antenna],
-) -> usize {
-    let mut baseline_index = 0;
-
+) -> Option<usize> {
     let antenna1_index = antennas
         .iter()
-        .position(|a| a.tile_name == antenna1_tile_name)
-        .unwrap();
+        .position(|a| a.tile_name == antenna1_tile_name)?;
     let antenna2_index = antennas
         .iter()
-        .position(|a| a.tile_name == antenna2_tile_name)
-        .unwrap();
+        .position(|a| a.tile_name == antenna2_tile_name)?;
 
-    for ant1 in 0..antennas.len() {
-        for ant2 in ant1..antennas.len() {
-            if ant1 == antenna1_index && ant2 == antenna2_index {
-                return baseline_index;
-            }
-            baseline_index += 1;
-        }
-    }
-
-    // Baseline was not found at all
-    unreachable!("Baseline was not found")
+    get_baseline_from_antennas(antenna1_index, antenna2_index, antennas.len())
 }
 
 /// Returns a UNIX time given a GPStime
@@ -249,3 +239,117 @@ pub fn convert_unixtime_to_gpstime(
         }
     }
 }
+
+/// A thread-safe pool of reusable scratch buffers.
+///
+/// Readers which need a temporary buffer (e.g. to hold a HDU before it is reordered) take one
+/// from the pool and it is handed back automatically when they are done with it, so in a steady
+/// read loop no memory is allocated (or zeroed) after the first read. The pool holds at most as
+/// many buffers as there have been concurrent readers.
+pub(crate) struct ScratchBufferPool<T> {
+    buffers: Mutex<Vec<Vec<T>>>,
+}
+
+impl<T: Copy + Default> ScratchBufferPool<T> {
+    /// Creates a new, empty pool.
+    ///
+    /// # Returns
+    ///
+    /// * An empty ScratchBufferPool
+    ///
+    pub(crate) fn new() -> Self {
+        Self {
+            buffers: Mutex::new(Vec::new()),
+        }
+    }
+
+    /// Takes a buffer of exactly `len` elements out of the pool, allocating one if the pool is
+    /// empty. The contents of a reused buffer are whatever was last written to it.
+    ///
+    /// # Arguments
+    ///
+    /// * `len` - number of elements the buffer must hold.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A ScratchBuffer which is returned to the pool when dropped.
+    ///
+    pub(crate) fn take(&self, len: usize) -> ScratchBuffer<'_, T> {
+        let buffer = match self.buffers.lock() {
+            Ok(mut buffers) => buffers.pop(),
+            Err(poisoned) => poisoned.into_inner().pop(),
+        };
+
+        let buffer = match buffer {
+            Some(mut b) => {
+                b.resize(len, T::default());
+                b
+            }
+            None => vec![T::default(); len],
+        };
+
+        ScratchBuffer { pool: self, buffer }
+    }
+
+    /// Returns the number of idle buffers currently held by the pool.
+    #[cfg(test)]
+    pub(crate) fn len(&self) -> usize {
+        self.buffers.lock().unwrap().len()
+    }
+}
+
+/// Implements fmt::Debug for ScratchBufferPool struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl<T> fmt::Debug for ScratchBufferPool<T> {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        let num_buffers = match self.buffers.lock() {
+            Ok(buffers) => buffers.len(),
+            Err(poisoned) => poisoned.into_inner().len(),
+        };
+
+        write!(f, "ScratchBufferPool {{ idle buffers: {} }}", num_buffers)
+    }
+}
+
+/// A buffer borrowed from a `ScratchBufferPool`. It dereferences to a slice and goes back into
+/// the pool when dropped.
+pub(crate) struct ScratchBuffer<'a, T> {
+    pool: &'a ScratchBufferPool<T>,
+    buffer: Vec<T>,
+}
+
+impl<'a, T> Deref for ScratchBuffer<'a, T> {
+    type Target = [T];
+
+    fn deref(&self) -> &[T] {
+        &self.buffer
+    }
+}
+
+impl<'a, T> DerefMut for ScratchBuffer<'a, T> {
+    fn deref_mut(&mut self) -> &mut [T] {
+        &mut self.buffer
+    }
+}
+
+impl<'a, T> Drop for ScratchBuffer<'a, T> {
+    fn drop(&mut self) {
+        let buffer = mem::take(&mut self.buffer);
+
+        match self.pool.buffers.lock() {
+            Ok(mut buffers) => buffers.push(buffer),
+            Err(poisoned) => poisoned.into_inner().push(buffer),
+        }
+    }
+}
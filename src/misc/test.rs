@@ -85,6 +85,34 @@ fn test_get_baseline_from_antennas() {
     assert_eq!(Some(128), get_baseline_from_antennas(1, 1, 128));
     assert_eq!(Some(8255), get_baseline_from_antennas(127, 127, 128));
     assert_eq!(None, get_baseline_from_antennas(128, 128, 128));
+    assert_eq!(None, get_baseline_from_antennas(1, 0, 128));
+    assert_eq!(None, get_baseline_from_antennas(0, 0, 0));
+}
+
+#[test]
+fn test_baseline_antennas_round_trip() {
+    // Every baseline (in the order of the upper triangle) must map to its antennas and back
+    for num_antennas in [1, 2, 3, 128, 256, 1024].iter() {
+        let mut baseline = 0;
+        for ant1 in 0..*num_antennas {
+            for ant2 in ant1..*num_antennas {
+                assert_eq!(
+                    get_baseline_from_antennas(ant1, ant2, *num_antennas),
+                    Some(baseline)
+                );
+                assert_eq!(
+                    get_antennas_from_baseline(baseline, *num_antennas),
+                    Some((ant1, ant2))
+                );
+                baseline += 1;
+            }
+        }
+        assert_eq!(baseline, get_baseline_count(*num_antennas));
+        assert_eq!(get_antennas_from_baseline(baseline, *num_antennas), None);
+    }
+
+    assert_eq!(get_antennas_from_baseline(0, 0), None);
+    assert_eq!(get_antennas_from_baseline(usize::MAX, 128), None);
 }
 
 #[test]
@@ -231,34 +259,38 @@ fn test_get_baseline_from_antenna_names1() {
 
     // Now do some tests!
     assert_eq!(
-        0,
+        Some(0),
         get_baseline_from_antenna_names(String::from("tile101"), String::from("tile101"), &ants),
         "Baseline from antenna names test 1 is wrong"
     );
     assert_eq!(
-        1,
+        Some(1),
         get_baseline_from_antenna_names(String::from("tile101"), String::from("tile102"), &ants),
         "Baseline from antenna names test 2 is wrong"
     );
     assert_eq!(
-        7,
+        Some(7),
         get_baseline_from_antenna_names(String::from("tile101"), String::from("tile108"), &ants),
         "Baseline from antenna names test 3 is wrong"
     );
     assert_eq!(
-        8,
+        Some(8),
         get_baseline_from_antenna_names(String::from("tile102"), String::from("tile102"), &ants),
         "Baseline from antenna names test 4 is wrong"
     );
     assert_eq!(
-        14,
+        Some(14),
         get_baseline_from_antenna_names(String::from("tile102"), String::from("tile108"), &ants),
         "Baseline from antenna names test 5 is wrong"
     );
+    assert_eq!(
+        None,
+        get_baseline_from_antenna_names(String::from("tile108"), String::from("tile101"), &ants),
+        "Baseline from antenna names test 6 is wrong"
+    );
 }
 
 #[test]
-#[should_panic]
 fn test_get_baseline_from_antenna_names_ant1_not_valid() {
     // Create a small antenna vector
     let mut ants: Vec<Antenna> = Vec::new();
@@ -329,12 +361,13 @@ fn test_get_baseline_from_antenna_names_ant1_not_valid() {
     });
 
     // Now do some tests!
-    let _panic_result =
-        get_baseline_from_antenna_names(String::from("tile110"), String::from("tile102"), &ants);
+    assert_eq!(
+        None,
+        get_baseline_from_antenna_names(String::from("tile110"), String::from("tile102"), &ants)
+    );
 }
 
 #[test]
-#[should_panic]
 fn test_get_baseline_from_antenna_names_ant2_not_valid() {
     // Create a small antenna vector
     let mut ants: Vec<Antenna> = Vec::new();
@@ -405,8 +438,10 @@ fn test_get_baseline_from_antenna_names_ant2_not_valid() {
     });
 
     // Now do some tests!
-    let _panic_result =
-        get_baseline_from_antenna_names(String::from("tile101"), String::from("tile112"), &ants);
+    assert_eq!(
+        None,
+        get_baseline_from_antenna_names(String::from("tile101"), String::from("tile112"), &ants)
+    );
 }
 
 #[test]
@@ -441,3 +476,38 @@ fn test_dms_to_degrees_large() {
         test
     );
 }
+
+#[test]
+fn test_scratch_buffer_pool_reuses_buffers() {
+    let pool: ScratchBufferPool<f32> = ScratchBufferPool::new();
+    assert_eq!(pool.len(), 0);
+
+    {
+        let mut buffer = pool.take(4);
+        assert_eq!(buffer.len(), 4);
+        assert_eq!(&buffer[..], &[0., 0., 0., 0.]);
+        buffer[0] = 1.;
+        // Buffer is in use - nothing in the pool
+        assert_eq!(pool.len(), 0);
+    }
+
+    // Buffer has been returned to the pool when dropped
+    assert_eq!(pool.len(), 1);
+
+    {
+        // The same buffer is handed out again (contents are not cleared)
+        let buffer = pool.take(4);
+        assert_eq!(buffer[0], 1.);
+        assert_eq!(pool.len(), 0);
+
+        // A second concurrent user gets a new buffer
+        let buffer2 = pool.take(2);
+        assert_eq!(buffer2.len(), 2);
+    }
+
+    assert_eq!(pool.len(), 2);
+
+    // Buffers are resized as needed
+    let buffer = pool.take(8);
+    assert_eq!(buffer.len(), 8);
+}
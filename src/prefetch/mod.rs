@@ -0,0 +1,392 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+A streaming iterator over the timesteps of a CorrelatorContext, which reads ahead on a
+background thread so that I/O overlaps with the caller's processing of each timestep.
+ */
+use std::collections::HashMap;
+use std::fmt;
+use std::mem;
+use std::ops::Deref;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{self, Receiver, Sender, SyncSender};
+use std::sync::Arc;
+use std::thread::{self, JoinHandle};
+
+use fitsio::FitsFile;
+use rayon::ThreadPool;
+
+use crate::convert::*;
+use crate::gpubox_files::GpuboxError;
+use crate::read_stats::*;
+use crate::thread_pool;
+use crate::*;
+
+#[cfg(test)]
+mod test;
+
+/// The order visibilities are returned in by a read.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum ReadOrder {
+    /// [baseline][frequency][pol][r][i], as per `CorrelatorContext::read_by_baseline`
+    ByBaseline,
+    /// [frequency][baseline][pol][r][i], as per `CorrelatorContext::read_by_frequency`
+    ByFrequency,
+}
+
+/// One timestep of visibilities produced by a `TimestepPrefetchIterator`. It dereferences to
+/// the data, which is in [coarse_chan][HDU] order, where coarse_chan is in the order supplied to
+/// `CorrelatorContext::iter_common_good_timesteps` and each HDU is in the requested `ReadOrder`.
+///
+/// The buffer is handed back to the iterator to be reused once this is dropped. Items may be
+/// held on to (e.g. collected), in which case the iterator allocates new buffers as it needs them.
+pub struct PrefetchedTimestep {
+    /// Index within the CorrelatorContext timestep array of this timestep.
+    pub corr_timestep_index: usize,
+    buffer: Vec<f32>,
+    recycle: Sender<Vec<f32>>,
+}
+
+impl Deref for PrefetchedTimestep {
+    type Target = [f32];
+
+    fn deref(&self) -> &[f32] {
+        &self.buffer
+    }
+}
+
+impl Drop for PrefetchedTimestep {
+    fn drop(&mut self) {
+        // If the iterator has gone away there is nobody to reuse the buffer, which is fine.
+        let _ = self.recycle.send(mem::take(&mut self.buffer));
+    }
+}
+
+/// Implements fmt::Debug for PrefetchedTimestep struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for PrefetchedTimestep {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "PrefetchedTimestep {{ corr_timestep_index: {}, floats: {} }}",
+            self.corr_timestep_index,
+            self.buffer.len()
+        )
+    }
+}
+
+/// The gpubox file and HDU to read for each coarse channel of a timestep.
+pub(crate) struct TimestepReadPlan {
+    /// Index within the CorrelatorContext timestep array.
+    pub corr_timestep_index: usize,
+    /// The fits filename and hdu index of each requested coarse channel.
+    pub hdus: Vec<(String, usize)>,
+}
+
+/// Everything the background thread needs to read and reorder HDUs, owned so that it does not
+/// borrow the CorrelatorContext.
+pub(crate) struct HduReader {
+    /// Correlator version of the observation.
+    pub mwa_version: MWAVersion,
+    /// Order to produce visibilities in.
+    pub order: ReadOrder,
+    /// Copy of the CorrelatorContext's legacy conversion table (empty for MWAX).
+    pub legacy_conversion_table: Arc<Vec<LegacyConversionBaseline>>,
+    /// Number of baselines in the observation.
+    pub num_baselines: usize,
+    /// Number of fine channels per coarse channel.
+    pub num_fine_chans: usize,
+    /// Number of visibility pols (always 4 for MWA).
+    pub num_visibility_pols: usize,
+    /// Number of floats in one HDU.
+    pub hdu_floats: usize,
+    /// Read stats of the CorrelatorContext.
+    pub read_counters: Arc<ReadCounters>,
+    /// Thread pool of the CorrelatorContext, which the reordering is spread over.
+    pub thread_pool: Option<Arc<ThreadPool>>,
+    /// Where the CorrelatorContext reads gpubox files from, if not the filesystem.
+    pub data_sources: DataSources,
+}
+
+impl HduReader {
+    /// Read and reorder one HDU.
+    ///
+    /// # Arguments
+    ///
+    /// * `fptr` - the open gpubox file to read from.
+    ///
+    /// * `hdu_index` - the index of the HDU to read.
+    ///
+    /// * `temp_buffer` - buffer to hold the HDU before reordering. It is resized as required.
+    ///
+    /// * `buffer` - Float buffer as a slice which will be filled with data in the requested order.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a GpuboxError on failure.
+    ///
+    fn read_hdu(
+        &self,
+        fptr: &mut FitsFile,
+        hdu_index: usize,
+        temp_buffer: &mut Vec<f32>,
+        buffer: &mut [f32],
+    ) -> Result<(), GpuboxError> {
+        self.read_counters.add_hdu_seek();
+        let hdu = fits_open_hdu!(fptr, hdu_index)?;
+
+        let is_legacy = self.mwa_version == MWAVersion::CorrOldLegacy
+            || self.mwa_version == MWAVersion::CorrLegacy;
+
+        // MWAX by baseline is already in the order we want
+        if !is_legacy && self.order == ReadOrder::ByBaseline {
+            self.read_counters.time(ReadTimer::FitsRead, || {
+                get_fits_float_image_into_buffer!(fptr, &hdu, buffer)
+            })?;
+            self.read_counters
+                .add_bytes_read(buffer.len() * mem::size_of::<f32>());
+            return Ok(());
+        }
+
+        temp_buffer.resize(self.hdu_floats, 0.);
+        self.read_counters.time(ReadTimer::FitsRead, || {
+            get_fits_float_image_into_buffer!(fptr, &hdu, temp_buffer)
+        })?;
+        self.read_counters
+            .add_bytes_read(temp_buffer.len() * mem::size_of::<f32>());
+
+        self.read_counters.time(ReadTimer::Convert, || {
+            thread_pool::install(self.thread_pool.as_ref(), || {
+                match (is_legacy, self.order) {
+                    (true, ReadOrder::ByBaseline) => convert_legacy_hdu_to_mwax_baseline_order(
+                        &self.legacy_conversion_table,
+                        temp_buffer,
+                        buffer,
+                        self.num_fine_chans,
+                    ),
+                    (true, ReadOrder::ByFrequency) => convert_legacy_hdu_to_mwax_frequency_order(
+                        &self.legacy_conversion_table,
+                        temp_buffer,
+                        buffer,
+                        self.num_fine_chans,
+                    ),
+                    (false, _) => convert_mwax_hdu_to_frequency_order(
+                        temp_buffer,
+                        buffer,
+                        self.num_baselines,
+                        self.num_fine_chans,
+                        self.num_visibility_pols,
+                    ),
+                }
+            })
+        });
+
+        Ok(())
+    }
+}
+
+/// An iterator over timesteps which reads up to `prefetch_depth` timesteps ahead of the caller
+/// on a background thread. Create one with `CorrelatorContext::iter_common_good_timesteps`.
+///
+/// The background thread waits once `prefetch_depth` timesteps are ready and not yet taken by
+/// the caller. Buffers of dropped `PrefetchedTimestep`s are reused, and a new buffer is only
+/// allocated when every buffer is still held by the caller. If a read fails, the error is returned by the iterator and iteration stops.
+pub struct TimestepPrefetchIterator {
+    receiver: Option<Receiver<Result<PrefetchedTimestep, GpuboxError>>>,
+    cancelled: Arc<AtomicBool>,
+    worker: Option<JoinHandle<()>>,
+}
+
+impl TimestepPrefetchIterator {
+    /// Start reading timesteps on a background thread.
+    ///
+    /// # Arguments
+    ///
+    /// * `reader` - owned reader describing how to read and reorder each HDU.
+    ///
+    /// * `plans` - the HDUs to read for each timestep, in iteration order.
+    ///
+    /// * `prefetch_depth` - number of timesteps to read ahead. A value of 0 is treated as 1.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A TimestepPrefetchIterator
+    ///
+    pub(crate) fn new(
+        reader: HduReader,
+        plans: Vec<TimestepReadPlan>,
+        prefetch_depth: usize,
+    ) -> Self {
+        let prefetch_depth = prefetch_depth.max(1);
+        let (sender, receiver) = mpsc::sync_channel(prefetch_depth);
+        let cancelled = Arc::new(AtomicBool::new(false));
+
+        let worker_cancelled = Arc::clone(&cancelled);
+        let worker =
+            thread::spawn(move || prefetch_timesteps(reader, plans, sender, worker_cancelled));
+
+        Self {
+            receiver: Some(receiver),
+            cancelled,
+            worker: Some(worker),
+        }
+    }
+}
+
+impl Iterator for TimestepPrefetchIterator {
+    type Item = Result<PrefetchedTimestep, GpuboxError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        // The background thread hangs up once it has sent everything (or an error)
+        self.receiver.as_ref()?.recv().ok()
+    }
+}
+
+impl Drop for TimestepPrefetchIterator {
+    fn drop(&mut self) {
+        // Stop the background thread. Dropping the receiver unblocks it if it is waiting to
+        // hand over a timestep, and the flag stops it before it starts reading another.
+        self.cancelled.store(true, Ordering::Relaxed);
+        self.receiver = None;
+
+        if let Some(worker) = self.worker.take() {
+            let _ = worker.join();
+        }
+    }
+}
+
+/// Implements fmt::Debug for TimestepPrefetchIterator struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for TimestepPrefetchIterator {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "TimestepPrefetchIterator {{ finished: {} }}",
+            self.receiver.is_none()
+        )
+    }
+}
+
+/// The body of the background thread of a `TimestepPrefetchIterator`.
+///
+/// # Arguments
+///
+/// * `reader` - owned reader describing how to read and reorder each HDU.
+///
+/// * `plans` - the HDUs to read for each timestep, in iteration order.
+///
+/// * `sender` - channel to send each timestep (or an error) to the iterator on.
+///
+/// * `cancelled` - set when the iterator has been dropped.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+fn prefetch_timesteps(
+    reader: HduReader,
+    plans: Vec<TimestepReadPlan>,
+    sender: SyncSender<Result<PrefetchedTimestep, GpuboxError>>,
+    cancelled: Arc<AtomicBool>,
+) {
+    let (recycle_sender, recycle_receiver) = mpsc::channel();
+
+    // Each gpubox file is opened once and kept open for the life of the iterator
+    let mut open_files: HashMap<String, FitsFile> = HashMap::new();
+    let mut temp_buffer: Vec<f32> = Vec::new();
+
+    for plan in plans {
+        if cancelled.load(Ordering::Relaxed) {
+            return;
+        }
+        let timestep_floats = plan.hdus.len() * reader.hdu_floats;
+
+        let mut buffer = take_recycled_buffer(&recycle_receiver, || vec![0.; timestep_floats]);
+        buffer.resize(timestep_floats, 0.);
+
+        let mut result = Ok(());
+        for ((fits_filename, hdu_index), hdu_buffer) in plan
+            .hdus
+            .iter()
+            .zip(buffer.chunks_exact_mut(reader.hdu_floats))
+        {
+            if !open_files.contains_key(fits_filename) {
+                match reader.data_sources.open_fits(fits_filename) {
+                    Ok(f) => {
+                        reader.read_counters.add_file_open();
+                        open_files.insert(fits_filename.clone(), f);
+                    }
+                    Err(e) => {
+                        result = Err(GpuboxError::from(e));
+                        break;
+                    }
+                }
+            }
+
+            // We can unwrap here as we just ensured the file is open
+            let fptr = open_files.get_mut(fits_filename).unwrap();
+            result = reader.read_hdu(fptr, *hdu_index, &mut temp_buffer, hdu_buffer);
+            if result.is_err() {
+                break;
+            }
+        }
+
+        let stop = result.is_err();
+        let message = result.map(|_| PrefetchedTimestep {
+            corr_timestep_index: plan.corr_timestep_index,
+            buffer,
+            recycle: recycle_sender.clone(),
+        });
+
+        // If the iterator has been dropped there is no-one left to read for
+        if sender.send(message).is_err() || stop {
+            return;
+        }
+    }
+}
+
+/// Take a buffer the caller of a prefetching iterator has handed back, or allocate a new one if
+/// the caller still holds every buffer. This never waits: how far the iterator reads ahead is
+/// limited by the channel items are sent on, not by the number of buffers.
+///
+/// # Arguments
+///
+/// * `recycle_receiver` - channel buffers are handed back on.
+///
+/// * `new_buffer` - allocates a new buffer.
+///
+///
+/// # Returns
+///
+/// * A recycled or new buffer.
+///
+pub(crate) fn take_recycled_buffer<T, F: FnOnce() -> T>(
+    recycle_receiver: &Receiver<T>,
+    new_buffer: F,
+) -> T {
+    recycle_receiver.try_recv().unwrap_or_else(|_| new_buffer())
+}
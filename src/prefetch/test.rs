@@ -0,0 +1,205 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for the prefetching timestep iterator
+*/
+#[cfg(test)]
+use super::*;
+use fitsio::images::{ImageDescription, ImageType};
+
+#[cfg(test)]
+/// Helper to write legacy gpubox files for obs 1101503312 (gpubox01 and gpubox02) with
+/// `num_timesteps` HDUs each, 2 seconds apart from the start of the observation. The values of
+/// each timestep of each gpubox file differ from those of every other.
+fn generate_legacy_gpubox_files(temp_dir: &tempdir::TempDir, num_timesteps: usize) -> Vec<String> {
+    // 128 fine channels of 8256 baselines * 4 pols * 2 (r, i)
+    let image_description = ImageDescription {
+        data_type: ImageType::Float,
+        dimensions: &[128, 66048],
+    };
+
+    (1..=2)
+        .map(|gpubox_number: usize| {
+            let filename = temp_dir.path().join(format!(
+                "1101503312_20141201210818_gpubox{:02}_00.fits",
+                gpubox_number
+            ));
+            let mut fptr = FitsFile::create(&filename).open().unwrap();
+            let primary_hdu = fptr.primary_hdu().unwrap();
+            primary_hdu
+                .write_key(&mut fptr, "OBSID", 1_101_503_312)
+                .unwrap();
+
+            for timestep in 0..num_timesteps {
+                let hdu = fptr
+                    .create_image("EXTNAME".to_string(), &image_description)
+                    .unwrap();
+                hdu.write_key(&mut fptr, "TIME", 1_417_468_096 + 2 * timestep as u64)
+                    .unwrap();
+                hdu.write_key(&mut fptr, "MILLITIM", 0).unwrap();
+
+                let data: Vec<f32> = (0..128 * 66048)
+                    .map(|i| (timestep * 100_000 + gpubox_number * 10_000 + i % 1000) as f32)
+                    .collect();
+                hdu.write_image(&mut fptr, &data).unwrap();
+            }
+
+            filename.to_str().unwrap().to_string()
+        })
+        .collect()
+}
+
+#[test]
+fn test_iter_common_good_timesteps_matches_reads() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    for &(order, depth) in &[(ReadOrder::ByBaseline, 1), (ReadOrder::ByFrequency, 3)] {
+        let items: Vec<PrefetchedTimestep> = context
+            .iter_common_good_timesteps(&[0], order, depth)
+            .unwrap()
+            .collect::<Result<Vec<PrefetchedTimestep>, GpuboxError>>()
+            .unwrap();
+
+        assert_eq!(items.len(), context.num_common_good_timesteps);
+
+        for (item, &corr_timestep_index) in items
+            .iter()
+            .zip(context.common_good_timestep_indices.iter())
+        {
+            assert_eq!(item.corr_timestep_index, corr_timestep_index);
+
+            let expected = match order {
+                ReadOrder::ByBaseline => context.read_by_baseline(corr_timestep_index, 0),
+                ReadOrder::ByFrequency => context.read_by_frequency(corr_timestep_index, 0),
+            }
+            .unwrap();
+            assert_eq!(&item[..], &expected[..]);
+        }
+    }
+}
+
+#[test]
+fn test_iter_common_good_timesteps_items_held() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let temp_dir = tempdir::TempDir::new("prefetch_test").unwrap();
+    // The first timestep is within the quack time, so 4 timesteps are good
+    let gpuboxfiles = generate_legacy_gpubox_files(&temp_dir, 5);
+    let context = CorrelatorContext::new(&metafits_filename.to_string(), &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+    assert_eq!(context.num_common_good_timesteps, 4);
+
+    // Both coarse channels, in the opposite order to the context
+    let coarse_chan_indices: Vec<usize> = context
+        .provided_coarse_chan_indices
+        .iter()
+        .rev()
+        .cloned()
+        .collect();
+    assert_eq!(coarse_chan_indices.len(), 2);
+
+    let check_item = |item: &PrefetchedTimestep, corr_timestep_index: usize, order: ReadOrder| {
+        assert_eq!(item.corr_timestep_index, corr_timestep_index);
+
+        for (chunk, &coarse_chan_index) in item
+            .chunks_exact(context.num_timestep_coarse_chan_floats)
+            .zip(coarse_chan_indices.iter())
+        {
+            let expected = match order {
+                ReadOrder::ByBaseline => {
+                    context.read_by_baseline(corr_timestep_index, coarse_chan_index)
+                }
+                ReadOrder::ByFrequency => {
+                    context.read_by_frequency(corr_timestep_index, coarse_chan_index)
+                }
+            }
+            .unwrap();
+            assert_eq!(chunk, &expected[..]);
+        }
+    };
+
+    for &order in &[ReadOrder::ByBaseline, ReadOrder::ByFrequency] {
+        // Collecting more timesteps than the prefetch depth (+ 1) does not hang
+        let items: Vec<PrefetchedTimestep> = context
+            .iter_common_good_timesteps(&coarse_chan_indices, order, 1)
+            .unwrap()
+            .collect::<Result<Vec<PrefetchedTimestep>, GpuboxError>>()
+            .unwrap();
+        assert_eq!(items.len(), 4);
+        for (item, &corr_timestep_index) in items
+            .iter()
+            .zip(context.common_good_timestep_indices.iter())
+        {
+            check_item(item, corr_timestep_index, order);
+        }
+        drop(items);
+
+        // Hold two items at a time and then drop them, so buffers are recycled
+        let mut iter = context
+            .iter_common_good_timesteps(&coarse_chan_indices, order, 1)
+            .unwrap();
+        for pair in context.common_good_timestep_indices.chunks(2) {
+            let held: Vec<PrefetchedTimestep> = (0..pair.len())
+                .map(|_| iter.next().unwrap().unwrap())
+                .collect();
+            for (item, &corr_timestep_index) in held.iter().zip(pair.iter()) {
+                check_item(item, corr_timestep_index, order);
+            }
+        }
+        assert!(iter.next().is_none());
+    }
+
+    // A depth greater than the number of timesteps
+    let mut num_items = 0;
+    for (item, &corr_timestep_index) in context
+        .iter_common_good_timesteps(&coarse_chan_indices, ReadOrder::ByBaseline, 10)
+        .unwrap()
+        .zip(context.common_good_timestep_indices.iter())
+    {
+        check_item(&item.unwrap(), corr_timestep_index, ReadOrder::ByBaseline);
+        num_items += 1;
+    }
+    assert_eq!(num_items, 4);
+}
+
+#[test]
+fn test_iter_common_good_timesteps_no_data() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // Only coarse channel 0 was provided, so this fails before any reading starts
+    let result = context.iter_common_good_timesteps(&[0, 1], ReadOrder::ByBaseline, 2);
+    assert!(matches!(
+        result,
+        Err(GpuboxError::NoDataForTimeStepCoarseChannel { .. })
+    ));
+}
+
+#[test]
+fn test_iter_dropped_early_does_not_hang() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let gpubox_filename =
+        "test_files/1101503312_1_timestep/1101503312_20141201210818_gpubox01_00.fits";
+    let gpuboxfiles = vec![gpubox_filename];
+    let context = CorrelatorContext::new(&metafits_filename, &gpuboxfiles)
+        .expect("Failed to create CorrelatorContext");
+
+    // Hold on to the first item (so the background thread may be waiting to send another) and drop
+    // the iterator; this must not deadlock.
+    let mut iter = context
+        .iter_common_good_timesteps(&[0], ReadOrder::ByBaseline, 1)
+        .unwrap();
+    let first = iter.next();
+    drop(iter);
+    assert!(first.unwrap().is_ok());
+}
@@ -0,0 +1,197 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Counters and timings of the I/O and reordering done by a context's reads.
+
+Each context owns a set of atomic counters, which its reads (including those on prefetch threads)
+add to without taking any locks. Collection is off by default, as reading the clock around every
+HDU read is not free (see `CorrelatorContext::set_stats_enabled`), except for the time taken to
+examine the data files when the context is created, which is always recorded.
+ */
+use std::fmt;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::time::{Duration, Instant};
+
+#[cfg(test)]
+mod test;
+
+/// A snapshot of the counters of a `CorrelatorContext` or `VoltageContext`, returned by
+/// `get_stats`. All times are the sum over every read, so with reads on many threads they can
+/// add up to more than the elapsed time.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct ReadStats {
+    /// Number of bytes read from gpubox or voltage data files (memory mapped reads are not counted)
+    pub bytes_read: u64,
+    /// Number of times a gpubox or voltage data file was opened for a read
+    pub file_opens: u64,
+    /// Number of times a gpubox HDU was moved to (always 0 for voltage contexts)
+    pub hdu_seeks: u64,
+    /// Nanoseconds spent reading HDUs with cfitsio (always 0 for voltage contexts)
+    pub fits_read_time_ns: u64,
+    /// Nanoseconds spent reordering visibilities, or decoding voltage samples for the unpacked reads
+    pub convert_time_ns: u64,
+    /// Nanoseconds spent examining the data files and building the time map when the context was created
+    pub time_map_time_ns: u64,
+}
+
+/// Which timing a duration is added to. See `ReadCounters::time`.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) enum ReadTimer {
+    /// Reading HDUs with cfitsio.
+    FitsRead,
+    /// Reordering (or decoding) data once it has been read.
+    Convert,
+}
+
+/// Lock-free counters behind `ReadStats`.
+pub(crate) struct ReadCounters {
+    /// true if reads should update the counters.
+    enabled: AtomicBool,
+    bytes_read: AtomicU64,
+    file_opens: AtomicU64,
+    hdu_seeks: AtomicU64,
+    fits_read_time_ns: AtomicU64,
+    convert_time_ns: AtomicU64,
+    time_map_time_ns: AtomicU64,
+}
+
+impl ReadCounters {
+    /// Creates a new set of counters, all zero and with collection disabled.
+    ///
+    /// # Arguments
+    ///
+    /// None
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A ReadCounters
+    ///
+    pub(crate) fn new() -> Self {
+        Self {
+            enabled: AtomicBool::new(false),
+            bytes_read: AtomicU64::new(0),
+            file_opens: AtomicU64::new(0),
+            hdu_seeks: AtomicU64::new(0),
+            fits_read_time_ns: AtomicU64::new(0),
+            convert_time_ns: AtomicU64::new(0),
+            time_map_time_ns: AtomicU64::new(0),
+        }
+    }
+
+    /// Turn collection on or off. The counters keep their values either way.
+    pub(crate) fn set_enabled(&self, enabled: bool) {
+        self.enabled.store(enabled, Ordering::Relaxed);
+    }
+
+    /// Returns true if collection is on.
+    pub(crate) fn is_enabled(&self) -> bool {
+        self.enabled.load(Ordering::Relaxed)
+    }
+
+    /// Add to a counter, if collection is on.
+    fn add(&self, counter: &AtomicU64, value: u64) {
+        if self.is_enabled() {
+            counter.fetch_add(value, Ordering::Relaxed);
+        }
+    }
+
+    /// Count bytes read from a data file.
+    pub(crate) fn add_bytes_read(&self, bytes: usize) {
+        self.add(&self.bytes_read, bytes as u64);
+    }
+
+    /// Count a data file being opened.
+    pub(crate) fn add_file_open(&self) {
+        self.add(&self.file_opens, 1);
+    }
+
+    /// Count a move to a HDU.
+    pub(crate) fn add_hdu_seek(&self) {
+        self.add(&self.hdu_seeks, 1);
+    }
+
+    /// Run a function, adding the time it takes to one of the timings if collection is on.
+    ///
+    /// # Arguments
+    ///
+    /// * `timer` - which timing to add to.
+    ///
+    /// * `f` - the function to run.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The result of `f`
+    ///
+    pub(crate) fn time<R, F: FnOnce() -> R>(&self, timer: ReadTimer, f: F) -> R {
+        if !self.is_enabled() {
+            return f();
+        }
+
+        let start = Instant::now();
+        let result = f();
+        let counter = match timer {
+            ReadTimer::FitsRead => &self.fits_read_time_ns,
+            ReadTimer::Convert => &self.convert_time_ns,
+        };
+        counter.fetch_add(start.elapsed().as_nanos() as u64, Ordering::Relaxed);
+
+        result
+    }
+
+    /// Record the time taken to build the time map. This happens while the context is created
+    /// (before collection can be turned on), so it is always recorded.
+    pub(crate) fn add_time_map_time(&self, elapsed: Duration) {
+        self.time_map_time_ns
+            .fetch_add(elapsed.as_nanos() as u64, Ordering::Relaxed);
+    }
+
+    /// Returns the current value of every counter.
+    pub(crate) fn snapshot(&self) -> ReadStats {
+        ReadStats {
+            bytes_read: self.bytes_read.load(Ordering::Relaxed),
+            file_opens: self.file_opens.load(Ordering::Relaxed),
+            hdu_seeks: self.hdu_seeks.load(Ordering::Relaxed),
+            fits_read_time_ns: self.fits_read_time_ns.load(Ordering::Relaxed),
+            convert_time_ns: self.convert_time_ns.load(Ordering::Relaxed),
+            time_map_time_ns: self.time_map_time_ns.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Set the read counters back to zero. The time map time describes the context's creation
+    /// rather than its reads, so it is kept.
+    pub(crate) fn reset(&self) {
+        self.bytes_read.store(0, Ordering::Relaxed);
+        self.file_opens.store(0, Ordering::Relaxed);
+        self.hdu_seeks.store(0, Ordering::Relaxed);
+        self.fits_read_time_ns.store(0, Ordering::Relaxed);
+        self.convert_time_ns.store(0, Ordering::Relaxed);
+    }
+}
+
+/// Implements fmt::Debug for ReadCounters struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for ReadCounters {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "ReadCounters {{ enabled: {}, {:?} }}",
+            self.is_enabled(),
+            self.snapshot()
+        )
+    }
+}
@@ -0,0 +1,94 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for read statistics counters
+*/
+#[cfg(test)]
+use super::*;
+
+#[test]
+fn test_read_counters_disabled_by_default() {
+    let counters = ReadCounters::new();
+    assert!(!counters.is_enabled());
+
+    counters.add_bytes_read(100);
+    counters.add_file_open();
+    counters.add_hdu_seek();
+    assert_eq!(counters.time(ReadTimer::Convert, || 42), 42);
+
+    assert_eq!(counters.snapshot(), ReadStats::default());
+}
+
+#[test]
+fn test_read_counters_enabled() {
+    let counters = ReadCounters::new();
+    counters.set_enabled(true);
+
+    counters.add_bytes_read(100);
+    counters.add_bytes_read(28);
+    counters.add_file_open();
+    counters.add_hdu_seek();
+    counters.add_hdu_seek();
+    counters.time(ReadTimer::FitsRead, || {
+        std::thread::sleep(std::time::Duration::from_millis(1))
+    });
+
+    let stats = counters.snapshot();
+    assert_eq!(stats.bytes_read, 128);
+    assert_eq!(stats.file_opens, 1);
+    assert_eq!(stats.hdu_seeks, 2);
+    assert!(stats.fits_read_time_ns >= 1_000_000);
+    assert_eq!(stats.convert_time_ns, 0);
+
+    // Turning collection off keeps the values
+    counters.set_enabled(false);
+    counters.add_file_open();
+    assert_eq!(counters.snapshot(), stats);
+}
+
+#[test]
+fn test_read_counters_reset_keeps_time_map_time() {
+    let counters = ReadCounters::new();
+    // The time map time is recorded even with collection disabled
+    counters.add_time_map_time(std::time::Duration::from_nanos(500));
+    counters.set_enabled(true);
+    counters.add_bytes_read(10);
+    counters.time(ReadTimer::Convert, || ());
+
+    counters.reset();
+
+    assert_eq!(
+        counters.snapshot(),
+        ReadStats {
+            time_map_time_ns: 500,
+            ..Default::default()
+        }
+    );
+}
+
+#[test]
+fn test_read_counters_concurrent_updates() {
+    let counters = std::sync::Arc::new(ReadCounters::new());
+    counters.set_enabled(true);
+
+    let handles: Vec<_> = (0..8)
+        .map(|_| {
+            let counters = std::sync::Arc::clone(&counters);
+            std::thread::spawn(move || {
+                for _ in 0..1000 {
+                    counters.add_bytes_read(4);
+                    counters.add_hdu_seek();
+                }
+            })
+        })
+        .collect();
+    for handle in handles {
+        handle.join().unwrap();
+    }
+
+    let stats = counters.snapshot();
+    assert_eq!(stats.bytes_read, 32_000);
+    assert_eq!(stats.hdu_seeks, 8_000);
+}
@@ -0,0 +1,14 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Errors associated with configuring mwalib's thread pool.
+*/
+use thiserror::Error;
+
+#[derive(Error, Debug)]
+pub enum ThreadPoolError {
+    #[error("Could not create a thread pool of {0} threads: {1}")]
+    Build(usize, String),
+}
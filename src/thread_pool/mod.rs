@@ -0,0 +1,140 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Configuration of the rayon thread pool which mwalib does its parallel work on (scanning gpubox
+files, reordering visibilities, batched reads and voltage reads).
+
+By default this is rayon's global pool. An application which needs mwalib to stay within a fixed
+core budget can instead give the whole library a dedicated pool with `set_num_threads` or
+`set_thread_pool`, or give a single context its own pool with `CorrelatorContext::set_thread_pool`
+or `VoltageContext::set_thread_pool`, which takes precedence over the library pool.
+ */
+pub mod error;
+use error::ThreadPoolError;
+use lazy_static::lazy_static;
+use rayon::{ThreadPool, ThreadPoolBuilder};
+use std::sync::{Arc, RwLock};
+
+#[cfg(test)]
+mod test;
+
+lazy_static! {
+    /// The library-wide thread pool, or None to use rayon's global pool.
+    static ref LIBRARY_THREAD_POOL: RwLock<Option<Arc<ThreadPool>>> = RwLock::new(None);
+}
+
+#[cfg(test)]
+lazy_static! {
+    /// Held by tests which change the library-wide thread pool, as it is shared by every test.
+    pub(crate) static ref LIBRARY_THREAD_POOL_TEST_LOCK: std::sync::Mutex<()> =
+        std::sync::Mutex::new(());
+}
+
+/// Give mwalib a dedicated thread pool of `num_threads` threads, which all contexts without a
+/// pool of their own will use from then on. Work already running on the previous pool finishes
+/// there.
+///
+/// # Arguments
+///
+/// * `num_threads` - number of threads in the new pool, or 0 to go back to using rayon's global pool.
+///
+///
+/// # Returns
+///
+/// * A Result of Ok on success, or a ThreadPoolError if the pool could not be created.
+///
+pub fn set_num_threads(num_threads: usize) -> Result<(), ThreadPoolError> {
+    if num_threads == 0 {
+        set_thread_pool(None);
+        return Ok(());
+    }
+
+    let thread_pool = ThreadPoolBuilder::new()
+        .num_threads(num_threads)
+        .thread_name(|index| format!("mwalib-{}", index))
+        .build()
+        .map_err(|e| ThreadPoolError::Build(num_threads, e.to_string()))?;
+
+    set_thread_pool(Some(Arc::new(thread_pool)));
+
+    Ok(())
+}
+
+/// Give mwalib an existing thread pool (e.g. one shared with the rest of an application), which
+/// all contexts without a pool of their own will use from then on.
+///
+/// # Arguments
+///
+/// * `thread_pool` - the pool to use, or None to go back to using rayon's global pool.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+pub fn set_thread_pool(thread_pool: Option<Arc<ThreadPool>>) {
+    // The lock only guards swapping an Arc, so a poisoned lock is simply recovered.
+    let mut library_thread_pool = match LIBRARY_THREAD_POOL.write() {
+        Ok(guard) => guard,
+        Err(poisoned) => poisoned.into_inner(),
+    };
+    *library_thread_pool = thread_pool;
+}
+
+/// Returns the library-wide thread pool, if one has been set.
+fn get_library_thread_pool() -> Option<Arc<ThreadPool>> {
+    match LIBRARY_THREAD_POOL.read() {
+        Ok(guard) => guard.clone(),
+        Err(poisoned) => poisoned.into_inner().clone(),
+    }
+}
+
+/// Returns the number of threads mwalib's parallel work is spread over, when a context has no
+/// pool of its own.
+///
+/// # Arguments
+///
+/// None
+///
+///
+/// # Returns
+///
+/// * The number of threads in the library-wide pool, or in rayon's global pool if none has been set.
+///
+pub fn get_num_threads() -> usize {
+    match get_library_thread_pool() {
+        Some(thread_pool) => thread_pool.current_num_threads(),
+        None => rayon::current_num_threads(),
+    }
+}
+
+/// Run a function on the thread pool mwalib should use, so that any rayon parallel iterators
+/// inside it are spread over that pool's threads. This is the context's own pool if it has one,
+/// otherwise the library-wide pool, otherwise rayon's global pool (where `f` is simply called).
+///
+/// # Arguments
+///
+/// * `context_thread_pool` - the thread pool of the context doing the work, if it has one.
+///
+/// * `f` - the function to run.
+///
+///
+/// # Returns
+///
+/// * The result of `f`
+///
+pub(crate) fn install<R, F>(context_thread_pool: Option<&Arc<ThreadPool>>, f: F) -> R
+where
+    R: Send,
+    F: FnOnce() -> R + Send,
+{
+    match context_thread_pool {
+        Some(thread_pool) => thread_pool.install(f),
+        None => match get_library_thread_pool() {
+            Some(thread_pool) => thread_pool.install(f),
+            None => f(),
+        },
+    }
+}
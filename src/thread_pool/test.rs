@@ -0,0 +1,36 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for thread pool configuration
+*/
+#[cfg(test)]
+use super::*;
+
+#[test]
+fn test_install_uses_context_thread_pool() {
+    let thread_pool = Arc::new(ThreadPoolBuilder::new().num_threads(2).build().unwrap());
+
+    assert!(install(Some(&thread_pool), || thread_pool
+        .current_thread_index()
+        .is_some()));
+    assert!(thread_pool.current_thread_index().is_none());
+}
+
+#[test]
+fn test_set_num_threads() {
+    let _lock = LIBRARY_THREAD_POOL_TEST_LOCK.lock();
+
+    set_num_threads(3).unwrap();
+    assert_eq!(get_num_threads(), 3);
+    assert_eq!(install(None, rayon::current_num_threads), 3);
+
+    // A context's own pool takes precedence
+    let thread_pool = Arc::new(ThreadPoolBuilder::new().num_threads(2).build().unwrap());
+    assert_eq!(install(Some(&thread_pool), rayon::current_num_threads), 2);
+
+    set_num_threads(0).unwrap();
+    assert!(get_library_thread_pool().is_none());
+    assert_eq!(get_num_threads(), rayon::current_num_threads());
+}
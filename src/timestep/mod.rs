@@ -18,6 +18,7 @@ mod test;
 /// This is a struct for our timesteps
 /// NOTE: correlator timesteps use unix time, voltage timesteps use gpstime, but we convert the two depending on what we are given
 #[derive(Clone)]
+#[repr(C)]
 pub struct TimeStep {
     /// UNIX time (in milliseconds to avoid floating point inaccuracy)
     pub unix_time_ms: u64,
@@ -0,0 +1,26 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Errors associated with visibility cache files.
+*/
+use thiserror::Error;
+
+use crate::gpubox_files::error::GpuboxError;
+
+#[derive(Error, Debug)]
+pub enum VisibilityCacheError {
+    #[error("Error reading or writing visibility cache {0}: {1}")]
+    Io(String, String),
+
+    #[error("{0} is not a valid visibility cache: {1}")]
+    Invalid(String, String),
+
+    #[error("Visibility cache {0} does not match this observation ({1}). Write it again with CorrelatorContext::write_visibility_cache")]
+    Mismatch(String, String),
+
+    /// An error derived from `GpuboxError`.
+    #[error("{0}")]
+    Gpubox(#[from] GpuboxError),
+}
@@ -0,0 +1,601 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+A cache file of already reordered visibilities, so that repeated passes over an observation (e.g.
+calibration) do not decode every HDU with cfitsio and reorder it again.
+
+A cache file holds every timestep and coarse channel of an observation which has data, converted
+to one `ReadOrder`, as one contiguous cube of little-endian floats. Each (timestep, coarse
+channel) is one chunk of `num_timestep_coarse_chan_floats` floats, and the chunks start on a page
+boundary so the cube can be memory mapped and handed out as slices without copying. The header
+in front of the cube records the observation (obsid, correlator version, dimensions, timesteps,
+coarse channels and which chunks are present) and a fingerprint of the gpubox files it was made
+from, so that a cache is only used with the observation it was written from.
+ */
+use std::fmt;
+use std::fs::{self, File};
+use std::io::{self, BufWriter, Read, Write};
+use std::path::Path;
+use std::slice;
+use std::time::UNIX_EPOCH;
+
+use crate::data_source::{DataSource, DataSources, FileRangeSource};
+use crate::gpubox_files::error::GpuboxError;
+use crate::prefetch::ReadOrder;
+use crate::MWAVersion;
+
+pub mod error;
+pub use error::VisibilityCacheError;
+
+#[cfg(test)]
+mod test;
+
+/// First bytes of every cache file.
+const CACHE_MAGIC: &[u8; 8] = b"MWALIBVC";
+
+/// Version of the cache file format. Bump this whenever the format changes so that old caches
+/// are rejected rather than misread.
+const CACHE_VERSION: u32 = 1;
+
+/// Size of the fixed part of the header, before the timestep, coarse channel and chunk tables.
+const CACHE_FIXED_HEADER_SIZE: usize = 88;
+
+/// The cube of visibilities starts on a multiple of this many bytes, so that it can be mapped
+/// directly on any common page size.
+const CACHE_DATA_ALIGNMENT: u64 = 65536;
+
+/// Value of a chunk table entry for a timestep and coarse channel with no data.
+const CACHE_NO_CHUNK: u64 = u64::MAX;
+
+/// Everything a cache file records about the observation it was written from.
+#[derive(Debug, Clone, PartialEq)]
+pub(crate) struct VisibilityCacheHeader {
+    /// Order of the visibilities within each chunk.
+    pub order: ReadOrder,
+    /// Correlator version of the observation.
+    pub mwa_version: MWAVersion,
+    /// Obsid of the observation.
+    pub obs_id: u32,
+    /// Number of baselines in each chunk.
+    pub num_baselines: usize,
+    /// Number of fine channels in each chunk.
+    pub num_fine_chans: usize,
+    /// Number of visibility pols in each chunk.
+    pub num_visibility_pols: usize,
+    /// Fingerprint of the gpubox files the cache was written from, see `fingerprint_gpubox_files`.
+    pub source_fingerprint: u64,
+    /// UNIX time (ms) of each timestep of the observation.
+    pub timestep_unix_times_ms: Vec<u64>,
+    /// Receiver channel number of each coarse channel of the observation.
+    pub coarse_chan_rec_numbers: Vec<usize>,
+    /// Index of the chunk holding each timestep and coarse channel, or None if it has no data.
+    /// Structured: `chunk_indices[timestep_index * num_coarse_chans + coarse_chan_index]`.
+    pub chunk_indices: Vec<Option<usize>>,
+}
+
+impl VisibilityCacheHeader {
+    /// Returns the number of floats in each chunk.
+    fn chunk_floats(&self) -> usize {
+        self.num_baselines * self.num_fine_chans * self.num_visibility_pols * 2
+    }
+
+    /// Returns the number of chunks (timesteps and coarse channels with data) in the cache.
+    fn num_chunks(&self) -> usize {
+        self.chunk_indices.iter().filter(|c| c.is_some()).count()
+    }
+
+    /// Returns the offset of the cube of visibilities from the start of the file.
+    fn data_offset(&self) -> u64 {
+        let header_size = CACHE_FIXED_HEADER_SIZE
+            + 8 * (self.timestep_unix_times_ms.len()
+                + self.coarse_chan_rec_numbers.len()
+                + self.chunk_indices.len());
+
+        (header_size as u64 + CACHE_DATA_ALIGNMENT - 1) / CACHE_DATA_ALIGNMENT
+            * CACHE_DATA_ALIGNMENT
+    }
+
+    /// Encode the header, padded to the start of the cube of visibilities. All values are
+    /// little-endian:
+    ///
+    /// ```text
+    /// magic "MWALIBVC", version u32, order u32, mwa_version u32, obs_id u32,
+    /// num_timesteps u64, num_coarse_chans u64, num_baselines u64, num_fine_chans u64,
+    /// num_visibility_pols u64, source_fingerprint u64, data_offset u64, num_chunks u64,
+    /// unix_time_ms u64 * num_timesteps, rec_chan_number u64 * num_coarse_chans,
+    /// chunk index (or u64::MAX) u64 * num_timesteps * num_coarse_chans, zero padding
+    /// ```
+    ///
+    /// # Returns
+    ///
+    /// * A vector of bytes containing the encoded header
+    ///
+    fn encode(&self) -> Vec<u8> {
+        let mut bytes: Vec<u8> = Vec::with_capacity(self.data_offset() as usize);
+
+        bytes.extend_from_slice(CACHE_MAGIC);
+        bytes.extend_from_slice(&CACHE_VERSION.to_le_bytes());
+        let order: u32 = match self.order {
+            ReadOrder::ByBaseline => 0,
+            ReadOrder::ByFrequency => 1,
+        };
+        bytes.extend_from_slice(&order.to_le_bytes());
+        bytes.extend_from_slice(&(self.mwa_version as u32).to_le_bytes());
+        bytes.extend_from_slice(&self.obs_id.to_le_bytes());
+
+        for value in &[
+            self.timestep_unix_times_ms.len() as u64,
+            self.coarse_chan_rec_numbers.len() as u64,
+            self.num_baselines as u64,
+            self.num_fine_chans as u64,
+            self.num_visibility_pols as u64,
+            self.source_fingerprint,
+            self.data_offset(),
+            self.num_chunks() as u64,
+        ] {
+            bytes.extend_from_slice(&value.to_le_bytes());
+        }
+
+        for unix_time_ms in &self.timestep_unix_times_ms {
+            bytes.extend_from_slice(&unix_time_ms.to_le_bytes());
+        }
+        for rec_chan_number in &self.coarse_chan_rec_numbers {
+            bytes.extend_from_slice(&(*rec_chan_number as u64).to_le_bytes());
+        }
+        for chunk_index in &self.chunk_indices {
+            let chunk_index = chunk_index.map_or(CACHE_NO_CHUNK, |c| c as u64);
+            bytes.extend_from_slice(&chunk_index.to_le_bytes());
+        }
+
+        bytes.resize(self.data_offset() as usize, 0);
+
+        bytes
+    }
+
+    /// Decode a header written by `encode`, reading no more of the file than the header.
+    ///
+    /// # Arguments
+    ///
+    /// * `reader` - where to read the header from, positioned at the start of the file.
+    ///
+    /// * `file_size` - size of the whole file in bytes, used to reject corrupt table sizes before allocating for them.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the header, or a description of why it is not a valid header.
+    ///
+    fn decode<R: Read>(reader: &mut R, file_size: u64) -> Result<Self, String> {
+        let mut fixed = [0u8; CACHE_FIXED_HEADER_SIZE];
+        reader
+            .read_exact(&mut fixed)
+            .map_err(|_| String::from("the file is too small to hold a header"))?;
+
+        if &fixed[0..8] != CACHE_MAGIC {
+            return Err(String::from(
+                "the file does not start with the cache magic bytes",
+            ));
+        }
+        let get_u32 = |offset: usize| {
+            let mut value = [0u8; 4];
+            value.copy_from_slice(&fixed[offset..offset + 4]);
+            u32::from_le_bytes(value)
+        };
+        let get_u64 = |offset: usize| {
+            let mut value = [0u8; 8];
+            value.copy_from_slice(&fixed[offset..offset + 8]);
+            u64::from_le_bytes(value)
+        };
+
+        let version = get_u32(8);
+        if version != CACHE_VERSION {
+            return Err(format!(
+                "format version {} is not supported (expected {})",
+                version, CACHE_VERSION
+            ));
+        }
+        let order = match get_u32(12) {
+            0 => ReadOrder::ByBaseline,
+            1 => ReadOrder::ByFrequency,
+            o => return Err(format!("unknown visibility order {}", o)),
+        };
+        let mwa_version = match get_u32(16) {
+            1 => MWAVersion::CorrOldLegacy,
+            2 => MWAVersion::CorrLegacy,
+            3 => MWAVersion::CorrMWAXv2,
+            v => return Err(format!("unknown correlator version {}", v)),
+        };
+        let obs_id = get_u32(20);
+        let num_timesteps = get_u64(24);
+        let num_coarse_chans = get_u64(32);
+        let data_offset = get_u64(72);
+        let num_chunks = get_u64(80);
+
+        // The tables must fit in the file before we allocate anything for them
+        let num_table_entries = num_timesteps
+            .checked_mul(num_coarse_chans)
+            .and_then(|n| n.checked_add(num_timesteps))
+            .and_then(|n| n.checked_add(num_coarse_chans))
+            .filter(|n| n.saturating_mul(8) <= file_size)
+            .ok_or_else(|| String::from("the timestep and coarse channel tables are truncated"))?;
+
+        let mut table_bytes = vec![0u8; num_table_entries as usize * 8];
+        reader
+            .read_exact(&mut table_bytes)
+            .map_err(|_| String::from("the timestep and coarse channel tables are truncated"))?;
+        let mut table = table_bytes.chunks_exact(8).map(|b| {
+            let mut value = [0u8; 8];
+            value.copy_from_slice(b);
+            u64::from_le_bytes(value)
+        });
+
+        let header = Self {
+            order,
+            mwa_version,
+            obs_id,
+            num_baselines: get_u64(40) as usize,
+            num_fine_chans: get_u64(48) as usize,
+            num_visibility_pols: get_u64(56) as usize,
+            source_fingerprint: get_u64(64),
+            timestep_unix_times_ms: table.by_ref().take(num_timesteps as usize).collect(),
+            coarse_chan_rec_numbers: table
+                .by_ref()
+                .take(num_coarse_chans as usize)
+                .map(|r| r as usize)
+                .collect(),
+            chunk_indices: table
+                .map(|c| match c {
+                    CACHE_NO_CHUNK => None,
+                    c => Some(c as usize),
+                })
+                .collect(),
+        };
+
+        // Chunks must be numbered 0..num_chunks in the order of the chunk table
+        let num_present = header.num_chunks();
+        if num_present as u64 != num_chunks
+            || header
+                .chunk_indices
+                .iter()
+                .flatten()
+                .enumerate()
+                .any(|(i, c)| i != *c)
+        {
+            return Err(String::from("the chunk table is inconsistent"));
+        }
+        if data_offset != header.data_offset() {
+            return Err(format!(
+                "the visibilities start at offset {} (expected {})",
+                data_offset,
+                header.data_offset()
+            ));
+        }
+
+        Ok(header)
+    }
+
+    /// Check that a cache header describes the same observation as another, ignoring the order
+    /// of the visibilities.
+    ///
+    /// # Arguments
+    ///
+    /// * `expected` - the header describing the observation the cache is to be used with.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if they match, or a description of the first difference.
+    ///
+    fn check_matches(&self, expected: &Self) -> Result<(), String> {
+        if self.obs_id != expected.obs_id {
+            return Err(format!("obsid {} != {}", self.obs_id, expected.obs_id));
+        }
+        if self.mwa_version != expected.mwa_version {
+            return Err(format!(
+                "correlator version {} != {}",
+                self.mwa_version, expected.mwa_version
+            ));
+        }
+        if (
+            self.num_baselines,
+            self.num_fine_chans,
+            self.num_visibility_pols,
+        ) != (
+            expected.num_baselines,
+            expected.num_fine_chans,
+            expected.num_visibility_pols,
+        ) {
+            return Err(format!(
+                "{} baselines, {} fine chans and {} pols != {}, {} and {}",
+                self.num_baselines,
+                self.num_fine_chans,
+                self.num_visibility_pols,
+                expected.num_baselines,
+                expected.num_fine_chans,
+                expected.num_visibility_pols
+            ));
+        }
+        if self.timestep_unix_times_ms != expected.timestep_unix_times_ms {
+            return Err(String::from("the timesteps differ"));
+        }
+        if self.coarse_chan_rec_numbers != expected.coarse_chan_rec_numbers {
+            return Err(String::from("the coarse channels differ"));
+        }
+        if self.chunk_indices != expected.chunk_indices {
+            return Err(String::from(
+                "the timesteps and coarse channels with data differ",
+            ));
+        }
+        if self.source_fingerprint != expected.source_fingerprint {
+            return Err(String::from(
+                "the gpubox files have changed since the cache was written",
+            ));
+        }
+
+        Ok(())
+    }
+}
+
+/// An open visibility cache file, with its cube of visibilities mapped read-only into memory.
+/// Create one with `CorrelatorContext::enable_visibility_cache`.
+pub struct VisibilityCache {
+    /// Filename of the cache file.
+    filename: String,
+    /// The header of the cache file.
+    header: VisibilityCacheHeader,
+    /// The mapped cube of visibilities.
+    data: FileRangeSource,
+}
+
+impl VisibilityCache {
+    /// Open a cache file and check that it was written from the observation described by
+    /// `expected`.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - filename of the cache file.
+    ///
+    /// * `expected` - a header describing the observation the cache is to be used with (its order is ignored).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the opened cache, or a VisibilityCacheError if it cannot be read or does not match.
+    ///
+    pub(crate) fn open<P: AsRef<Path>>(
+        filename: &P,
+        expected: &VisibilityCacheHeader,
+    ) -> Result<Self, VisibilityCacheError> {
+        let filename = filename.as_ref().display().to_string();
+        let to_error = |e: io::Error| VisibilityCacheError::Io(filename.clone(), e.to_string());
+
+        // The cube is handed out as native floats
+        if cfg!(target_endian = "big") {
+            return Err(VisibilityCacheError::Invalid(
+                filename,
+                String::from("visibility caches can only be used on little-endian machines"),
+            ));
+        }
+
+        let mut file = File::open(&filename).map_err(to_error)?;
+        let file_size = file.metadata().map_err(to_error)?.len();
+        let header = VisibilityCacheHeader::decode(&mut file, file_size)
+            .map_err(|e| VisibilityCacheError::Invalid(filename.clone(), e))?;
+        header
+            .check_matches(expected)
+            .map_err(|e| VisibilityCacheError::Mismatch(filename.clone(), e))?;
+
+        let data_size = (header.num_chunks() * header.chunk_floats() * 4) as u64;
+        let data = FileRangeSource::new(&filename, header.data_offset(), data_size)
+            .map_err(|e| VisibilityCacheError::Invalid(filename.clone(), e.to_string()))?;
+
+        Ok(Self {
+            filename,
+            header,
+            data,
+        })
+    }
+
+    /// Returns the filename of the cache file.
+    pub fn filename(&self) -> &str {
+        &self.filename
+    }
+
+    /// Returns the order of the visibilities in the cache.
+    pub fn order(&self) -> ReadOrder {
+        self.header.order
+    }
+
+    /// Get the cached visibilities of a timestep and coarse channel, in place in the mapped file.
+    ///
+    /// # Arguments
+    ///
+    /// * `corr_timestep_index` - index within the CorrelatorContext timestep array for the desired timestep.
+    ///
+    /// * `corr_coarse_chan_index` - index within the CorrelatorContext coarse_chan array for the desired coarse channel.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing `num_timestep_coarse_chan_floats` floats in the order of the cache (see `order`), or None if the indices are out of range or there is no data for them.
+    ///
+    pub fn visibilities(
+        &self,
+        corr_timestep_index: usize,
+        corr_coarse_chan_index: usize,
+    ) -> Option<&[f32]> {
+        let num_coarse_chans = self.header.coarse_chan_rec_numbers.len();
+        if corr_coarse_chan_index >= num_coarse_chans {
+            return None;
+        }
+        let chunk_index = (*self
+            .header
+            .chunk_indices
+            .get(corr_timestep_index * num_coarse_chans + corr_coarse_chan_index)?)?;
+
+        let chunk_floats = self.header.chunk_floats();
+        let bytes = self.data.as_bytes()?;
+        let chunk_bytes =
+            &bytes[chunk_index * chunk_floats * 4..(chunk_index + 1) * chunk_floats * 4];
+
+        // The cube starts on a page boundary, so every chunk is aligned for f32
+        debug_assert_eq!(
+            chunk_bytes.as_ptr() as usize % std::mem::align_of::<f32>(),
+            0
+        );
+        Some(unsafe { slice::from_raw_parts(chunk_bytes.as_ptr() as *const f32, chunk_floats) })
+    }
+}
+
+/// Implements fmt::Debug for VisibilityCache struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for VisibilityCache {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "VisibilityCache {{ filename: {}, order: {:?}, chunks: {} }}",
+            self.filename,
+            self.header.order,
+            self.header.num_chunks()
+        )
+    }
+}
+
+/// Write a cache file, replacing any existing file. The cache is written to a temporary file
+/// first and then renamed, so a cache which is in use (or being read by another process) is never
+/// seen partially written.
+///
+/// # Arguments
+///
+/// * `filename` - filename of the cache file.
+///
+/// * `header` - the header of the cache, describing the observation and which chunks to write.
+///
+/// * `read_chunk` - function which reads one timestep and coarse channel, in the order of the header, into a chunk sized buffer.
+///
+///
+/// # Returns
+///
+/// * A Result of Ok if the cache was written, or a VisibilityCacheError on failure.
+///
+pub(crate) fn write_visibility_cache<P, F>(
+    filename: &P,
+    header: &VisibilityCacheHeader,
+    mut read_chunk: F,
+) -> Result<(), VisibilityCacheError>
+where
+    P: AsRef<Path>,
+    F: FnMut(usize, usize, &mut [f32]) -> Result<(), GpuboxError>,
+{
+    let filename = filename.as_ref();
+    let mut temp_filename = filename.as_os_str().to_owned();
+    temp_filename.push(format!(".{}.tmp", std::process::id()));
+    let to_error =
+        |e: io::Error| VisibilityCacheError::Io(filename.display().to_string(), e.to_string());
+
+    let result = (|| {
+        let mut writer = BufWriter::new(File::create(&temp_filename).map_err(to_error)?);
+        writer.write_all(&header.encode()).map_err(to_error)?;
+
+        let num_coarse_chans = header.coarse_chan_rec_numbers.len();
+        let mut chunk: Vec<f32> = vec![0.; header.chunk_floats()];
+        let mut chunk_bytes: Vec<u8> = Vec::with_capacity(chunk.len() * 4);
+
+        // Chunks are numbered in the order of the chunk table, so write them in that order
+        for (slot, _) in header
+            .chunk_indices
+            .iter()
+            .enumerate()
+            .filter(|(_, c)| c.is_some())
+        {
+            read_chunk(slot / num_coarse_chans, slot % num_coarse_chans, &mut chunk)?;
+
+            chunk_bytes.clear();
+            for value in &chunk {
+                chunk_bytes.extend_from_slice(&value.to_le_bytes());
+            }
+            writer.write_all(&chunk_bytes).map_err(to_error)?;
+        }
+
+        writer.flush().map_err(to_error)?;
+        fs::rename(&temp_filename, filename).map_err(to_error)
+    })();
+
+    if result.is_err() {
+        let _ = fs::remove_file(&temp_filename);
+    }
+
+    result
+}
+
+/// Fingerprint a set of gpubox files by name, size and modification time, so that a cache written
+/// from them is not used once any of them changes. Files in `data_sources` are fingerprinted by
+/// name and size only.
+///
+/// # Arguments
+///
+/// * `gpubox_filenames` - filenames of the gpubox files, in batch order.
+///
+/// * `data_sources` - where the gpubox files are read from, if not the filesystem.
+///
+///
+/// # Returns
+///
+/// * A 64 bit FNV-1a hash of the names (without their directories), sizes and modification times of the files
+///
+pub(crate) fn fingerprint_gpubox_files<'a, I>(
+    gpubox_filenames: I,
+    data_sources: &DataSources,
+) -> u64
+where
+    I: IntoIterator<Item = &'a str>,
+{
+    const FNV_OFFSET_BASIS: u64 = 0xcbf2_9ce4_8422_2325;
+    const FNV_PRIME: u64 = 0x0000_0100_0000_01b3;
+
+    let mut hash = FNV_OFFSET_BASIS;
+    let mut add = |bytes: &[u8]| {
+        for b in bytes {
+            hash ^= u64::from(*b);
+            hash = hash.wrapping_mul(FNV_PRIME);
+        }
+    };
+
+    for filename in gpubox_filenames {
+        let (file_size, modified_ns) = match data_sources.get(filename) {
+            Some(source) => (source.size().unwrap_or(0), 0),
+            None => fs::metadata(filename)
+                .map(|m| {
+                    let modified_ns = m
+                        .modified()
+                        .ok()
+                        .and_then(|t| t.duration_since(UNIX_EPOCH).ok())
+                        .map_or(0, |d| d.as_nanos());
+                    (m.len(), modified_ns)
+                })
+                .unwrap_or((0, 0)),
+        };
+
+        let name = Path::new(filename)
+            .file_name()
+            .map_or(filename.into(), |n| n.to_string_lossy());
+        add(name.as_bytes());
+        add(&[0]);
+        add(&file_size.to_le_bytes());
+        add(&modified_ns.to_le_bytes());
+    }
+
+    hash
+}
@@ -0,0 +1,223 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for the visibility cache
+*/
+#[cfg(test)]
+use super::*;
+use std::io::Cursor;
+
+/// Helper to make the header of a small cache: 2 timesteps and 3 coarse channels, with no data
+/// for the second coarse channel of the first timestep.
+fn make_header() -> VisibilityCacheHeader {
+    VisibilityCacheHeader {
+        order: ReadOrder::ByBaseline,
+        mwa_version: MWAVersion::CorrMWAXv2,
+        obs_id: 1_244_973_688,
+        num_baselines: 3,
+        num_fine_chans: 2,
+        num_visibility_pols: 4,
+        source_fingerprint: 0x0123_4567_89ab_cdef,
+        timestep_unix_times_ms: vec![1_560_938_470_000, 1_560_938_470_500],
+        coarse_chan_rec_numbers: vec![109, 110, 111],
+        chunk_indices: vec![Some(0), None, Some(1), Some(2), Some(3), Some(4)],
+    }
+}
+
+/// Helper to fill a chunk with values identifying its timestep and coarse channel.
+fn fill_chunk(timestep_index: usize, coarse_chan_index: usize, buffer: &mut [f32]) {
+    for (i, value) in buffer.iter_mut().enumerate() {
+        *value = (timestep_index * 1000 + coarse_chan_index * 100 + i) as f32;
+    }
+}
+
+#[test]
+fn test_visibility_cache_header_encode_decode_round_trip() {
+    let mut header = make_header();
+
+    for order in [ReadOrder::ByBaseline, ReadOrder::ByFrequency].iter() {
+        header.order = *order;
+        let encoded = header.encode();
+        assert_eq!(encoded.len() as u64, header.data_offset());
+        assert_eq!(encoded.len() as u64 % CACHE_DATA_ALIGNMENT, 0);
+
+        let decoded =
+            VisibilityCacheHeader::decode(&mut Cursor::new(&encoded), encoded.len() as u64)
+                .unwrap();
+        assert_eq!(decoded, header);
+    }
+}
+
+#[test]
+fn test_visibility_cache_header_decode_invalid() {
+    let encoded = make_header().encode();
+    let decode =
+        |bytes: &[u8]| VisibilityCacheHeader::decode(&mut Cursor::new(bytes), bytes.len() as u64);
+
+    // Empty and truncated files
+    assert!(decode(&[]).is_err());
+    assert!(decode(&encoded[..CACHE_FIXED_HEADER_SIZE + 8]).is_err());
+
+    // Wrong magic
+    let mut bad = encoded.clone();
+    bad[0] = b'X';
+    assert!(decode(&bad).is_err());
+
+    // A future version of the format
+    let mut bad = encoded.clone();
+    bad[8..12].copy_from_slice(&(CACHE_VERSION + 1).to_le_bytes());
+    assert!(decode(&bad).is_err());
+
+    // Unknown order and correlator version (voltage versions are not allowed)
+    let mut bad = encoded.clone();
+    bad[12..16].copy_from_slice(&2u32.to_le_bytes());
+    assert!(decode(&bad).is_err());
+    let mut bad = encoded.clone();
+    bad[16..20].copy_from_slice(&(MWAVersion::VCSMWAXv2 as u32).to_le_bytes());
+    assert!(decode(&bad).is_err());
+
+    // A huge number of timesteps must not be allocated for
+    let mut bad = encoded.clone();
+    bad[24..32].copy_from_slice(&u64::MAX.to_le_bytes());
+    assert!(decode(&bad).is_err());
+
+    // Chunks out of order
+    let mut header = make_header();
+    header.chunk_indices.swap(0, 2);
+    assert!(decode(&header.encode()).is_err());
+}
+
+#[test]
+fn test_visibility_cache_header_check_matches() {
+    let header = make_header();
+
+    // The order does not need to match
+    let mut other = make_header();
+    other.order = ReadOrder::ByFrequency;
+    assert!(header.check_matches(&other).is_ok());
+
+    let mut other = make_header();
+    other.obs_id += 1;
+    assert!(header.check_matches(&other).is_err());
+
+    let mut other = make_header();
+    other.mwa_version = MWAVersion::CorrLegacy;
+    assert!(header.check_matches(&other).is_err());
+
+    let mut other = make_header();
+    other.num_fine_chans = 4;
+    assert!(header.check_matches(&other).is_err());
+
+    let mut other = make_header();
+    other.timestep_unix_times_ms[1] += 500;
+    assert!(header.check_matches(&other).is_err());
+
+    let mut other = make_header();
+    other.chunk_indices = vec![Some(0), Some(1), Some(2), Some(3), Some(4), Some(5)];
+    assert!(header.check_matches(&other).is_err());
+
+    let mut other = make_header();
+    other.source_fingerprint += 1;
+    assert!(header.check_matches(&other).is_err());
+}
+
+#[test]
+fn test_write_and_open_visibility_cache() {
+    let temp_dir = tempdir::TempDir::new("visibility_cache_test").unwrap();
+    let cache_filename = temp_dir.path().join("test.cache");
+    let header = make_header();
+
+    let mut chunks_read: Vec<(usize, usize)> = Vec::new();
+    write_visibility_cache(&cache_filename, &header, |t, c, buffer| {
+        chunks_read.push((t, c));
+        fill_chunk(t, c, buffer);
+        Ok(())
+    })
+    .unwrap();
+    assert_eq!(chunks_read, vec![(0, 0), (0, 2), (1, 0), (1, 1), (1, 2)]);
+    assert_eq!(
+        fs::metadata(&cache_filename).unwrap().len(),
+        header.data_offset() + 5 * 48 * 4
+    );
+
+    let cache = VisibilityCache::open(&cache_filename, &header).unwrap();
+    assert_eq!(cache.order(), ReadOrder::ByBaseline);
+    assert_eq!(cache.filename(), cache_filename.to_str().unwrap());
+
+    let mut expected = vec![0f32; 48];
+    for &(t, c) in &chunks_read {
+        fill_chunk(t, c, &mut expected);
+        assert_eq!(cache.visibilities(t, c).unwrap(), expected.as_slice());
+    }
+    assert!(cache.visibilities(0, 1).is_none());
+    assert!(cache.visibilities(2, 0).is_none());
+    assert!(cache.visibilities(0, 3).is_none());
+
+    // A cache for a different observation is rejected
+    let mut other = make_header();
+    other.source_fingerprint += 1;
+    assert!(matches!(
+        VisibilityCache::open(&cache_filename, &other).unwrap_err(),
+        VisibilityCacheError::Mismatch(_, _)
+    ));
+
+    // As is a truncated cache (unmap it first)
+    drop(cache);
+    let file = fs::OpenOptions::new()
+        .write(true)
+        .open(&cache_filename)
+        .unwrap();
+    file.set_len(header.data_offset() + 100).unwrap();
+    assert!(matches!(
+        VisibilityCache::open(&cache_filename, &header).unwrap_err(),
+        VisibilityCacheError::Invalid(_, _)
+    ));
+
+    assert!(matches!(
+        VisibilityCache::open(&temp_dir.path().join("missing.cache"), &header).unwrap_err(),
+        VisibilityCacheError::Io(_, _)
+    ));
+}
+
+#[test]
+fn test_write_visibility_cache_read_error() {
+    let temp_dir = tempdir::TempDir::new("visibility_cache_test").unwrap();
+    let cache_filename = temp_dir.path().join("test.cache");
+
+    // A failed read leaves no cache (or temporary file) behind
+    let result = write_visibility_cache(&cache_filename, &make_header(), |_, _, _| {
+        Err(GpuboxError::NoGpuboxes)
+    });
+    assert!(matches!(
+        result.unwrap_err(),
+        VisibilityCacheError::Gpubox(GpuboxError::NoGpuboxes)
+    ));
+    assert_eq!(fs::read_dir(temp_dir.path()).unwrap().count(), 0);
+}
+
+#[test]
+fn test_fingerprint_gpubox_files() {
+    let temp_dir = tempdir::TempDir::new("visibility_cache_test").unwrap();
+    let filename = temp_dir
+        .path()
+        .join("1244973688_20190619100110_ch114_000.fits");
+    fs::write(&filename, vec![0u8; 100]).unwrap();
+    let filename = filename.to_str().unwrap();
+    let data_sources = DataSources::new();
+
+    let fingerprint = fingerprint_gpubox_files(vec![filename], &data_sources);
+    assert_eq!(
+        fingerprint,
+        fingerprint_gpubox_files(vec![filename], &data_sources)
+    );
+    assert_ne!(fingerprint, fingerprint_gpubox_files(vec![], &data_sources));
+
+    // Changing the file changes the fingerprint
+    fs::write(&filename, vec![0u8; 101]).unwrap();
+    assert_ne!(
+        fingerprint,
+        fingerprint_gpubox_files(vec![filename], &data_sources)
+    );
+}
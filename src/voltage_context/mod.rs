@@ -6,15 +6,26 @@
 The main interface to MWA voltage data.
  */
 use crate::coarse_channel::*;
+use crate::direct_io::*;
 use crate::error::*;
+use crate::file_io;
 use crate::metafits_context::*;
+use crate::read_stats::*;
+use crate::thread_pool;
 use crate::timestep::*;
 use crate::voltage_files::*;
+use crate::voltage_mmap::*;
+use crate::voltage_prefetch::*;
+use crate::voltage_unpack::*;
 use crate::*;
+use rayon::prelude::*;
+use rayon::ThreadPool;
+use std::collections::HashMap;
 use std::fmt;
 use std::fs::File;
-use std::io::BufReader;
-use std::io::{Read, Seek, SeekFrom};
+use std::ops::Range;
+use std::sync::Arc;
+use std::time::Instant;
 
 #[cfg(test)]
 pub(crate) mod test; // It's pub crate because I reuse some test code in the ffi tests.
@@ -25,7 +36,7 @@ pub(crate) mod test; // It's pub crate because I reuse some test code in the ffi
 #[derive(Debug)]
 pub struct VoltageContext {
     /// Observation Metadata obtained from the metafits file
-    pub metafits_context: MetafitsContext,
+    pub metafits_context: Arc<MetafitsContext>,
     /// MWA version, derived from the files passed in
     pub mwa_version: MWAVersion,
 
@@ -126,6 +137,11 @@ pub struct VoltageContext {
     /// (e.g. `voltage_hdu_limits`). Structured:
     /// `voltage_batches[batch][filename]`.
     pub(crate) voltage_batches: Vec<VoltageFileBatch>,
+    /// Where the data file for each timestep and coarse channel is, resolved from
+    /// `voltage_batches` when the context is created. Structured:
+    /// `voltage_file_locations[timestep_index * num_coarse_chans + coarse_chan_index]`, with None
+    /// where we have no data file.
+    pub(crate) voltage_file_locations: Vec<Option<VoltageFileLocation>>,
 
     /// We assume as little as possible about the data layout in the voltage
     /// files; here, a `BTreeMap` contains each unique GPS time from every
@@ -134,6 +150,131 @@ pub struct VoltageContext {
     /// number, batch number and HDU index are everything needed to find the
     /// correct HDU out of all voltage files.
     pub(crate) voltage_time_map: VoltageFileTimeMap,
+
+    /// If true, reads bypass (or at least do not fill) the page cache. See `set_direct_io`.
+    pub(crate) direct_io: bool,
+    /// Counters and timings of the reads of this context, see `get_stats`.
+    pub(crate) read_counters: Arc<ReadCounters>,
+    /// The thread pool for this context's parallel reads, see `set_thread_pool`.
+    pub(crate) thread_pool: Option<Arc<ThreadPool>>,
+    /// Where the voltage data files are read from, if not the filesystem (see `VoltageContextBuilder::with_data_sources`).
+    pub(crate) data_sources: DataSources,
+}
+
+/// Options for creating a `VoltageContext`, for when `VoltageContext::new` and its variants are
+/// not enough. Create one with `new`, set options with the `with_` methods and then create
+/// contexts with `build` or `build_from_metafits_context`.
+#[derive(Clone, Debug, Default)]
+pub struct VoltageContextBuilder {
+    /// See `with_lazy_validation`.
+    lazy_validation: bool,
+    /// See `with_data_sources`.
+    data_sources: DataSources,
+}
+
+impl VoltageContextBuilder {
+    /// Creates a builder with the default options, i.e. those of `VoltageContext::new`.
+    ///
+    /// # Arguments
+    ///
+    /// None
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A VoltageContextBuilder
+    ///
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Enable or disable lazy validation. Normally the size of every voltage file is read (and
+    /// checked to be the same) when the context is created. With lazy validation, only the size
+    /// of the first voltage file is, and the other files are only checked when they are read
+    /// (every read already checks the size of the file it reads, returning
+    /// `VoltageFileError::InvalidVoltageFileSize` if it does not match).
+    ///
+    /// # Arguments
+    ///
+    /// * `lazy_validation` - true to enable lazy validation, false to check every voltage file up front (the default).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The updated VoltageContextBuilder
+    ///
+    pub fn with_lazy_validation(mut self, lazy_validation: bool) -> Self {
+        self.lazy_validation = lazy_validation;
+        self
+    }
+
+    /// Read voltage data files from data sources rather than the filesystem, e.g. from memory or
+    /// from within a tar archive (see `TarArchive::data_sources`). Any voltage file given to
+    /// `build` which has a source is read from it, reading only the byte ranges needed. Direct
+    /// I/O does not apply to these files, and they cannot be memory mapped with `mmap_file` or
+    /// `mmap_second`.
+    ///
+    /// # Arguments
+    ///
+    /// * `data_sources` - the sources of the voltage files, by filename.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The updated VoltageContextBuilder
+    ///
+    pub fn with_data_sources(mut self, data_sources: DataSources) -> Self {
+        self.data_sources = data_sources;
+        self
+    }
+
+    /// From a path to a metafits file and paths to voltage files, create a `VoltageContext` with
+    /// these options.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_filename` - filename of metafits file as a path or string.
+    ///
+    /// * `voltage_filenames` - slice of filenames of voltage files as paths or strings.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated VoltageContext object if Ok.
+    ///
+    pub fn build<T: AsRef<std::path::Path>>(
+        &self,
+        metafits_filename: &T,
+        voltage_filenames: &[T],
+    ) -> Result<VoltageContext, MwalibError> {
+        VoltageContext::new_internal(
+            Arc::new(MetafitsContext::new_internal(metafits_filename)?),
+            voltage_filenames,
+            self,
+        )
+    }
+
+    /// As per `build`, but using an existing (possibly shared) `MetafitsContext`, as per
+    /// `VoltageContext::new_from_metafits_context`.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the MetafitsContext of the observation.
+    ///
+    /// * `voltage_filenames` - slice of filenames of voltage files as paths or strings.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated VoltageContext object if Ok.
+    ///
+    pub fn build_from_metafits_context<T: AsRef<std::path::Path>>(
+        &self,
+        metafits_context: Arc<MetafitsContext>,
+        voltage_filenames: &[T],
+    ) -> Result<VoltageContext, MwalibError> {
+        VoltageContext::new_internal(metafits_context, voltage_filenames, self)
+    }
 }
 
 impl VoltageContext {
@@ -157,20 +298,75 @@ impl VoltageContext {
         metafits_filename: &T,
         voltage_filenames: &[T],
     ) -> Result<Self, MwalibError> {
-        let mut metafits_context = MetafitsContext::new_internal(metafits_filename)?;
+        VoltageContextBuilder::new().build(metafits_filename, voltage_filenames)
+    }
+
+    /// As per `new`, but using an existing (possibly shared) `MetafitsContext` rather than
+    /// parsing the metafits file again, e.g. one from `MetafitsContext::new_shared` or from
+    /// another context of the same observation. If it was populated for a different MWAVersion
+    /// than the voltage files are (or, for legacy observations, its rf_inputs are not in VCS
+    /// order), a copy with the correct coarse channels, timesteps and rf_input order is made.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the MetafitsContext of the observation.
+    ///
+    /// * `voltage_filenames` - slice of filenames of voltage files as paths or strings.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated VoltageContext object if Ok.
+    ///
+    ///
+    pub fn new_from_metafits_context<T: AsRef<std::path::Path>>(
+        metafits_context: Arc<MetafitsContext>,
+        voltage_filenames: &[T],
+    ) -> Result<Self, MwalibError> {
+        VoltageContextBuilder::new()
+            .build_from_metafits_context(metafits_context, voltage_filenames)
+    }
 
+    /// Create a `VoltageContext` from a (populated or unpopulated) `MetafitsContext`, with the
+    /// options of a `VoltageContextBuilder`.
+    ///
+    /// # Arguments
+    ///
+    /// * `metafits_context` - the MetafitsContext of the observation.
+    ///
+    /// * `voltage_filenames` - slice of filenames of voltage files as paths or strings.
+    ///
+    /// * `options` - the options to create the context with.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Result containing a populated VoltageContext object if Ok.
+    ///
+    ///
+    fn new_internal<T: AsRef<std::path::Path>>(
+        metafits_context: Arc<MetafitsContext>,
+        voltage_filenames: &[T],
+        options: &VoltageContextBuilder,
+    ) -> Result<Self, MwalibError> {
         // Do voltage stuff only if we have voltage files.
         if voltage_filenames.is_empty() {
             return Err(MwalibError::Voltage(VoltageFileError::NoVoltageFiles));
         }
-        let voltage_info = examine_voltage_files(&metafits_context, &voltage_filenames)?;
+        let read_counters = Arc::new(ReadCounters::new());
+        let time_map_start = Instant::now();
+        let voltage_info = examine_voltage_files(
+            &metafits_context,
+            &voltage_filenames,
+            options.lazy_validation,
+            &options.data_sources,
+        )?;
+        read_counters.add_time_map_time(time_map_start.elapsed());
 
         // Populate metafits coarse channels and timesteps now that we know what MWA Version we are dealing with
-        // Populate the coarse channels
-        metafits_context.populate_expected_coarse_channels(voltage_info.mwa_version)?;
-
-        // Populate the timesteps
-        metafits_context.populate_expected_timesteps(voltage_info.mwa_version)?;
+        // (if the metafits context was not already populated for it)
+        let mut metafits_context =
+            MetafitsContext::populated_for_version(metafits_context, voltage_info.mwa_version)?;
 
         // We can unwrap here because the `voltage_time_map` can't be empty if
         // `voltages` isn't empty.
@@ -398,7 +594,16 @@ impl VoltageContext {
         // The rf inputs should be sorted depending on the CorrVersion
         match voltage_info.mwa_version {
             MWAVersion::VCSLegacyRecombined => {
-                metafits_context.rf_inputs.sort_by_key(|k| k.vcs_order);
+                // Only copy a shared metafits context if it is not already in this order
+                if !metafits_context
+                    .rf_inputs
+                    .windows(2)
+                    .all(|w| w[0].vcs_order <= w[1].vcs_order)
+                {
+                    Arc::make_mut(&mut metafits_context)
+                        .rf_inputs
+                        .sort_by_key(|k| k.vcs_order);
+                }
             }
             MWAVersion::VCSMWAXv2 => {}
             _ => {
@@ -408,6 +613,13 @@ impl VoltageContext {
             }
         }
 
+        // Resolve where every timestep/coarse channel is up front, so reads don't need to search
+        let voltage_file_locations = build_voltage_file_location_table(
+            &voltage_info.gpstime_batches,
+            &timesteps,
+            &coarse_chans,
+        );
+
         Ok(VoltageContext {
             metafits_context,
             mwa_version: voltage_info.mwa_version,
@@ -451,11 +663,48 @@ impl VoltageContext {
             delay_block_size_bytes,
             data_file_header_size_bytes,
             expected_voltage_data_file_size_bytes,
+            voltage_file_locations,
             voltage_batches: voltage_info.gpstime_batches,
             voltage_time_map: voltage_info.time_map,
+            direct_io: false,
+            read_counters,
+            thread_pool: None,
+            data_sources: options.data_sources.clone(),
         })
     }
 
+    /// Returns the filename of the data file for a timestep and coarse channel. The indices must
+    /// already have been validated.
+    ///
+    /// # Arguments
+    ///
+    /// * `timestep_index` - index within the timestep array for the desired timestep.
+    ///
+    /// * `coarse_chan_index` - index within the coarse_chan array for the desired coarse channel.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the filename, or a VoltageFileError if we have no data file for this timestep and coarse channel.
+    ///
+    fn get_voltage_filename(
+        &self,
+        timestep_index: usize,
+        coarse_chan_index: usize,
+    ) -> Result<&str, VoltageFileError> {
+        match self.voltage_file_locations
+            [timestep_index * self.num_coarse_chans + coarse_chan_index]
+        {
+            Some(location) => Ok(&self.voltage_batches[location.batch_index].voltage_files
+                [location.file_index]
+                .filename),
+            None => Err(VoltageFileError::NoDataForTimeStepCoarseChannel {
+                timestep_index,
+                coarse_chan_index,
+            }),
+        }
+    }
+
     /// Validates gps time start and gps seconds count, and returns the end gps time or an Error.
     /// The gps end second is the START time of the end second, not the END of the second.
     /// e.g gpstart = 100, count = 1, therefore gpsend = 100.
@@ -572,8 +821,6 @@ impl VoltageContext {
                 self.num_coarse_chans - 1,
             ));
         }
-        // Determine the channel identifier, which we will use later to find the correct data file
-        let channel_identifier = self.coarse_chans[coarse_chan_index].gpubox_number;
 
         // Validate the gpstime
         let gps_second_end = VoltageContext::validate_gps_time_parameters(
@@ -583,16 +830,8 @@ impl VoltageContext {
         )?;
 
         // Determine which timestep(s) we need to cover the start and end gps times.
-        // NOTE: mwax has 8 gps seconds per timestep, legacy vcs has 1
-        let timestep_index_start: usize = (((gps_second_start * 1000)
-            - self.timesteps[0].gps_time_ms) as f64
-            / self.timestep_duration_ms as f64)
-            .floor() as usize;
-        // Get end timestep which includes the end gps time
-        let timestep_index_end: usize =
-            ((((gps_second_end * 1000) - self.timesteps[0].gps_time_ms) as f64 + 1.)
-                / self.timestep_duration_ms as f64)
-                .floor() as usize;
+        let timestep_indices =
+            self.get_timestep_indices_for_gps_seconds(gps_second_start, gps_second_end);
 
         // Check output buffer is big enough
         let expected_buffer_size = (self.voltage_block_size_bytes
@@ -616,90 +855,38 @@ impl VoltageContext {
         // Work out how much to read at once
         let chunk_size: usize = self.voltage_block_size_bytes as usize; // This will be the size of a voltage block
 
-        // Variables to keep track of where in the buffer we are writing to
+        // Keep track of where in the buffer we are writing to
         let mut start_pos: usize = 0;
-        let mut end_pos: usize = chunk_size as usize;
 
         // Loop through the timesteps / files
-        for timestep_index in timestep_index_start..timestep_index_end + 1 {
-            // Find the batch relating to the timestep index or None if we don't have any data files for that timestep
-            let batch = &self
-                .voltage_batches
-                .iter()
-                .find(|f| f.gps_time_seconds * 1000 == self.timesteps[timestep_index].gps_time_ms);
-
-            // find the filename if the timestep/coarse chan combo exists
-            let filename_result = match batch {
-                Some(b) => b
-                    .voltage_files
-                    .iter()
-                    .find(|f| f.channel_identifier == channel_identifier),
-                None => None,
-            };
-
+        //
+        // in mwax 1 file	= 8 gps seconds broken into 20 voltage blocks per sec
+        // in legacy 1 file	= 1 gps seconds
+        //
+        for timestep_index in timestep_indices {
             // Get the filename for this timestep and coarse channel
-            let filename: &String = match filename_result {
-                Some(f) => &f.filename,
-                None => {
-                    return Err(VoltageFileError::NoDataForTimeStepCoarseChannel {
-                        timestep_index,
-                        coarse_chan_index,
-                    });
-                }
-            };
-
-            // Open the file
-            let file_handle = File::open(&filename).expect("no file found");
-
-            // Obtain metadata
-            let metadata = std::fs::metadata(&filename).expect("unable to read metadata");
-
-            // Check file is as big as we expect
-            if metadata.len() != calc_file_size {
-                return Err(VoltageFileError::InvalidVoltageFileSize(
-                    metadata.len(),
-                    String::from(filename),
-                    calc_file_size,
-                ));
-            }
-
-            // Open a buffer reader
-            let mut reader = BufReader::with_capacity(chunk_size, file_handle);
-
-            // Loop until all data is read into our buffer
-            //
-            // in mwax 1 file	= 8 gps seconds broken into 20 voltage blocks per sec
-            // in legacy 1 file	= 1 gps seconds
-            //
-            for block_index in 0..self.num_voltage_blocks_per_timestep {
-                // We may only be reading a portion of this file, so determine if we want to read this block
-                // i.e. is it part of second we care about?
-                let current_gps_time = (self.timesteps[timestep_index].gps_time_ms / 1000)
-                    + (block_index as f64 / self.num_voltage_blocks_per_second as f64).floor()
-                        as u64;
-
-                if current_gps_time >= gps_second_start && current_gps_time <= gps_second_end {
-                    // Skip bytes in the file to this block
-                    // We skip the header, delays and any intervening voltage blocks
-                    reader
-                        .by_ref()
-                        .seek(SeekFrom::Start(
-                            self.data_file_header_size_bytes
-                                + self.delay_block_size_bytes
-                                + (block_index * chunk_size as u64),
-                        ))
-                        .expect("Unable to seek to next data block in voltage file");
-
-                    let chunk = &mut buffer[start_pos..end_pos];
-                    let bytes_read = reader.by_ref().read(chunk).expect("Error");
-
-                    assert_eq!(bytes_read, chunk_size);
-
-                    // Set new start and end pos
-                    start_pos = end_pos;
-                    end_pos = start_pos + chunk_size;
-                }
-            }
+            let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+
+            // We may only be reading a portion of this file, and the blocks we want are contiguous,
+            // so read them with one positional read (skipping the header, delays and any earlier blocks)
+            let blocks = self.get_voltage_block_range_for_gps_seconds(
+                timestep_index,
+                gps_second_start,
+                gps_second_end,
+            );
+            let end_pos = start_pos + blocks.len() * chunk_size;
+
+            self.read_voltage_file_at(
+                filename,
+                calc_file_size,
+                self.data_file_header_size_bytes
+                    + self.delay_block_size_bytes
+                    + (blocks.start * chunk_size) as u64,
+                &mut buffer[start_pos..end_pos],
+            )?;
+
+            // Set new start pos
+            start_pos = end_pos;
         }
         Ok(())
     }
@@ -779,54 +966,9 @@ impl VoltageContext {
                 self.num_coarse_chans - 1,
             ));
         }
-        // Determine the channel identifier, which we will use later to find the correct data file
-        let channel_identifier = self.coarse_chans[coarse_chan_index].gpubox_number;
-
-        // Work out how much to read at once
-        let chunk_size: usize = self.voltage_block_size_bytes as usize; // This will be the size of a voltage block
-
-        // Find the batch relating to the timestep index or None if we don't have any data files for that timestep
-        let batch = &self
-            .voltage_batches
-            .iter()
-            .find(|f| f.gps_time_seconds * 1000 == self.timesteps[timestep_index].gps_time_ms);
-
-        // find the filename if the timestep/coarse chan combo exists
-        let filename_result = match batch {
-            Some(b) => b
-                .voltage_files
-                .iter()
-                .find(|f| f.channel_identifier == channel_identifier),
-            None => None,
-        };
 
         // Get the filename for this timestep and coarse channel
-        let filename: &String = match filename_result {
-            Some(f) => &f.filename,
-            None => {
-                return Err(VoltageFileError::NoDataForTimeStepCoarseChannel {
-                    timestep_index,
-                    coarse_chan_index,
-                });
-            }
-        };
-
-        // Open the file
-        let file_handle = File::open(&filename).expect("no file found");
-
-        // Obtain metadata
-        let metadata = std::fs::metadata(&filename).expect("unable to read metadata");
-
-        // Check file is as big as we expect
-        // normally we would compare the file len to context.expected_voltage_data_file_size_bytes,
-        // but in our tests we override the voltage_block_size_bytes because our test files only have 1 tile
-        // TODO: This should be an Error type
-        assert_eq!(
-            metadata.len(),
-            self.data_file_header_size_bytes
-                + self.delay_block_size_bytes
-                + (self.voltage_block_size_bytes * self.num_voltage_blocks_per_timestep)
-        );
+        let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
 
         // Check buffer is big enough
         let expected_buffer_size =
@@ -839,35 +981,1134 @@ impl VoltageContext {
             ));
         }
 
-        // Open a buffer reader
-        let mut reader = BufReader::with_capacity(chunk_size, file_handle);
+        // Check file is as big as we expect, and read all of the voltage blocks (which are
+        // contiguous, after the header and delay block) in one go.
+        // normally we would compare the file len to context.expected_voltage_data_file_size_bytes,
+        // but in our tests we override the voltage_block_size_bytes because our test files only have 1 tile
+        self.read_voltage_file_at(
+            filename,
+            self.data_file_header_size_bytes
+                + self.delay_block_size_bytes
+                + (self.voltage_block_size_bytes * self.num_voltage_blocks_per_timestep),
+            self.data_file_header_size_bytes + self.delay_block_size_bytes,
+            buffer,
+        )
+    }
 
-        // Skip header
-        reader
-            .by_ref()
-            .seek(SeekFrom::Start(
-                self.data_file_header_size_bytes + self.delay_block_size_bytes,
-            ))
-            .expect("Unable to seek to data in voltage file");
+    /// Enable or disable direct I/O for `read_file`, `read_second` and `read_second_multi_chan`.
+    /// This is for observations which are processed in a single pass, where caching the data
+    /// only evicts more useful pages from the page cache.
+    ///
+    /// When enabled, reads whose buffer address, length and file offset are all multiples of
+    /// `DIRECT_IO_ALIGNMENT` bypass the page cache using O_DIRECT (see `AlignedBuffer` for
+    /// allocating aligned buffers). MWAX voltage blocks, delay blocks and headers are all aligned,
+    /// so whole-second and whole-file reads qualify. Other reads, and reads on platforms or
+    /// filesystems without O_DIRECT, are done normally but with hints to the kernel to read ahead
+    /// and then drop the data from the page cache.
+    ///
+    /// # Arguments
+    ///
+    /// * `direct_io` - true to enable direct I/O, false to read through the page cache as normal (the default).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn set_direct_io(&mut self, direct_io: bool) {
+        self.direct_io = direct_io;
+    }
 
-        // Read the data into the final output buffer in blocks, spaced out with delay blocks (possibly)
-        let mut start_pos: usize = 0;
-        let mut end_pos: usize = chunk_size as usize;
+    /// Start or stop collecting read stats (see `get_stats`). Collection is off by default. While
+    /// it is on, every read (including those on prefetch threads) adds to the bytes read and file
+    /// opens counters, and the unpacked reads add the time spent decoding samples. This can be
+    /// called at any time, from any thread.
+    ///
+    /// # Arguments
+    ///
+    /// * `enabled` - true to collect read stats, false to stop. The counters keep their values either way.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn set_stats_enabled(&self, enabled: bool) {
+        self.read_counters.set_enabled(enabled);
+    }
 
-        // Loop until all data is read into our buffer
-        for _ in 0..self.num_voltage_blocks_per_timestep {
-            let chunk = &mut buffer[start_pos..end_pos];
-            let bytes_read = reader.by_ref().read(chunk).expect("Error");
+    /// Get the read stats collected so far. `time_map_time_ns` (the time taken to examine the
+    /// voltage files and build the time map when this context was created) is always recorded;
+    /// the other counters are only updated while collection is enabled with `set_stats_enabled`.
+    ///
+    /// # Returns
+    ///
+    /// * A ReadStats struct containing a snapshot of the counters
+    ///
+    pub fn get_stats(&self) -> ReadStats {
+        self.read_counters.snapshot()
+    }
 
-            assert_eq!(bytes_read, chunk_size);
+    /// Set the read stats counters back to zero (apart from `time_map_time_ns`).
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn reset_stats(&self) {
+        self.read_counters.reset();
+    }
 
-            // Set new start and end pos
-            start_pos = end_pos;
-            end_pos = start_pos + chunk_size;
+    /// Give this context its own rayon thread pool, which its multi-file reads (e.g.
+    /// `read_second_multi_chan`) are then spread over instead of the library-wide pool (see
+    /// `thread_pool::set_num_threads`). Several contexts may share one pool.
+    ///
+    /// # Arguments
+    ///
+    /// * `thread_pool` - the pool to use, or None to use the library-wide pool (the default).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    pub fn set_thread_pool(&mut self, thread_pool: Option<Arc<ThreadPool>>) {
+        self.thread_pool = thread_pool;
+    }
+
+    /// Run a function on this context's thread pool (see `set_thread_pool`).
+    fn install<R, F>(&self, f: F) -> R
+    where
+        R: Send,
+        F: FnOnce() -> R + Send,
+    {
+        thread_pool::install(self.thread_pool.as_ref(), f)
+    }
+
+    /// Memory map the voltage data file for a single timestep / coarse channel, rather than
+    /// copying it into a buffer as `read_file` does. The returned `VoltageFileMmap` gives
+    /// borrowed access to the header, delay block and voltage blocks of the file, which are in
+    /// the same format as described for `read_file`. The file is unmapped when it is dropped.
+    ///
+    /// # Arguments
+    ///
+    /// * `timestep_index` - index within the timestep array for the desired timestep. This corresponds
+    ///                      to the element within VoltageContext.timesteps. For mwa legacy each index
+    ///                      represents 1 second increments, for mwax it is 8 second increments.
+    ///
+    /// * `coarse_chan_index` - index within the coarse_chan array for the desired coarse channel. This corresponds
+    ///                      to the element within VoltageContext.coarse_chans.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the mapped voltage file, if Ok.
+    ///
+    ///
+    pub fn mmap_file(
+        &self,
+        timestep_index: usize,
+        coarse_chan_index: usize,
+    ) -> Result<VoltageFileMmap, VoltageFileError> {
+        if self.voltage_batches.is_empty() {
+            return Err(VoltageFileError::NoVoltageFiles);
         }
 
-        Ok(())
+        // Validate the timestep
+        if timestep_index > self.num_timesteps - 1 {
+            return Err(VoltageFileError::InvalidTimeStepIndex(
+                self.num_timesteps - 1,
+            ));
+        }
+
+        // Validate the coarse chan
+        if coarse_chan_index > self.num_coarse_chans - 1 {
+            return Err(VoltageFileError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+
+        self.check_can_mmap(filename)?;
+        let mmap = VoltageFileMmap::new(
+            filename,
+            self.data_file_header_size_bytes as usize,
+            self.delay_block_size_bytes as usize,
+            self.voltage_block_size_bytes as usize,
+            self.num_voltage_blocks_per_timestep as usize,
+        )?;
+        self.read_counters.add_file_open();
+
+        Ok(mmap)
     }
+
+    /// Memory map the voltage data for a range of GPS seconds for a single coarse channel, rather
+    /// than copying it into a buffer as `read_second` does. The requested seconds may span more
+    /// than one data file, so one `VoltageSecondsMmap` is returned per data file, in time order.
+    /// Concatenating `data()` of each gives the same bytes as `read_second`.
+    ///
+    /// # Arguments
+    ///
+    /// * `gps_second_start` - GPS second which to start getting data at.
+    ///
+    /// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+    ///
+    /// * `coarse_chan_index` - index within the coarse_chan array for the desired coarse channel. This corresponds
+    ///                      to the element within VoltageContext.coarse_chans.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the mapped voltage files and the voltage blocks within each which are in the requested GPS seconds, if Ok.
+    ///
+    ///
+    pub fn mmap_second(
+        &self,
+        gps_second_start: u64,
+        gps_second_count: usize,
+        coarse_chan_index: usize,
+    ) -> Result<Vec<VoltageSecondsMmap>, VoltageFileError> {
+        if self.voltage_batches.is_empty() {
+            return Err(VoltageFileError::NoVoltageFiles);
+        }
+
+        // Validate the coarse chan
+        if coarse_chan_index > self.num_coarse_chans - 1 {
+            return Err(VoltageFileError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        // Validate the gpstime
+        let gps_second_end = VoltageContext::validate_gps_time_parameters(
+            &self,
+            gps_second_start,
+            gps_second_count,
+        )?;
+
+        let mut mmaps = Vec::new();
+
+        for timestep_index in
+            self.get_timestep_indices_for_gps_seconds(gps_second_start, gps_second_end)
+        {
+            let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+
+            self.check_can_mmap(filename)?;
+            let mmap = VoltageFileMmap::new(
+                filename,
+                self.data_file_header_size_bytes as usize,
+                self.delay_block_size_bytes as usize,
+                self.voltage_block_size_bytes as usize,
+                self.num_voltage_blocks_per_timestep as usize,
+            )?;
+            self.read_counters.add_file_open();
+
+            mmaps.push(VoltageSecondsMmap {
+                mmap,
+                voltage_blocks: self.get_voltage_block_range_for_gps_seconds(
+                    timestep_index,
+                    gps_second_start,
+                    gps_second_end,
+                ),
+            });
+        }
+
+        Ok(mmaps)
+    }
+
+    /// Read the same GPS seconds of voltage data for many coarse channels at once. The blocks
+    /// needed from each data file are contiguous, so each data file is read with a single
+    /// positional read, and the reads for all files are issued in parallel.
+    /// The output data are in [coarse_chan][data] order, where coarse_chan is in the order of
+    /// `coarse_chan_indices` and each coarse channel's data is as returned by `read_second`.
+    ///
+    /// # Arguments
+    ///
+    /// * `gps_second_start` - GPS second which to start getting data at.
+    ///
+    /// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+    ///
+    /// * `coarse_chan_indices` - indices within the coarse_chan array of the desired coarse channels.
+    ///
+    /// * `buffer` - a mutable reference to an already exitsing, initialised slice `[u8]` which will be filled
+    ///              with the data. Its length must be `coarse_chan_indices.len()` times the buffer size needed by
+    ///              `read_second`.
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a VoltageFileError on failure.
+    ///
+    ///
+    pub fn read_second_multi_chan(
+        &self,
+        gps_second_start: u64,
+        gps_second_count: usize,
+        coarse_chan_indices: &[usize],
+        buffer: &mut [u8],
+    ) -> Result<(), VoltageFileError> {
+        if self.voltage_batches.is_empty() {
+            return Err(VoltageFileError::NoVoltageFiles);
+        }
+
+        // Validate the coarse chans
+        if coarse_chan_indices
+            .iter()
+            .any(|&c| c > self.num_coarse_chans - 1)
+        {
+            return Err(VoltageFileError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        // Validate the gpstime
+        let gps_second_end = VoltageContext::validate_gps_time_parameters(
+            &self,
+            gps_second_start,
+            gps_second_count,
+        )?;
+
+        // Check output buffer is big enough
+        let coarse_chan_buffer_size = (self.voltage_block_size_bytes
+            * self.num_voltage_blocks_per_second) as usize
+            * gps_second_count;
+        let expected_buffer_size = coarse_chan_buffer_size * coarse_chan_indices.len();
+
+        if buffer.len() != expected_buffer_size {
+            return Err(VoltageFileError::InvalidBufferSize(
+                buffer.len(),
+                expected_buffer_size,
+            ));
+        }
+
+        let calc_file_size = self.data_file_header_size_bytes
+            + self.delay_block_size_bytes
+            + (self.voltage_block_size_bytes * self.num_voltage_blocks_per_timestep);
+
+        // Work out every read we need to do (so that any missing data is reported before we do
+        // any I/O), giving each a disjoint part of the output buffer.
+        let timestep_indices =
+            self.get_timestep_indices_for_gps_seconds(gps_second_start, gps_second_end);
+        let mut reads: Vec<(&str, u64, &mut [u8])> = Vec::new();
+
+        for (&coarse_chan_index, coarse_chan_buffer) in coarse_chan_indices
+            .iter()
+            .zip(buffer.chunks_exact_mut(coarse_chan_buffer_size))
+        {
+            let mut remaining = coarse_chan_buffer;
+
+            for timestep_index in timestep_indices.clone() {
+                let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+                let blocks = self.get_voltage_block_range_for_gps_seconds(
+                    timestep_index,
+                    gps_second_start,
+                    gps_second_end,
+                );
+
+                let offset = self.data_file_header_size_bytes
+                    + self.delay_block_size_bytes
+                    + blocks.start as u64 * self.voltage_block_size_bytes;
+                let (read_buffer, rest) =
+                    remaining.split_at_mut(blocks.len() * self.voltage_block_size_bytes as usize);
+                remaining = rest;
+
+                reads.push((filename, offset, read_buffer));
+            }
+        }
+
+        self.install(|| {
+            reads
+                .into_par_iter()
+                .try_for_each(|(filename, offset, read_buffer)| {
+                    self.read_voltage_file_at(filename, calc_file_size, offset, read_buffer)
+                })
+        })
+    }
+
+    /// Iterate over a range of GPS seconds for a set of coarse channels, reading upcoming
+    /// seconds on a background thread while the caller processes the current ones.
+    ///
+    /// Each item is a `PrefetchedGpsSeconds` of `gps_seconds_per_item` seconds (the last may be
+    /// shorter), which dereferences to the data in the same order as `read_second_multi_chan`.
+    /// All of the file lookups and validation are done once, up front, and each data file is
+    /// opened once and kept open until its last second has been read. While the caller works on
+    /// one item, the kernel is asked to start reading the next, including when it is in the next
+    /// data file. Buffers are recycled once each `PrefetchedGpsSeconds` is dropped, and the
+    /// background thread never reads more than `prefetch_depth` items ahead. Direct I/O (see
+    /// `set_direct_io`) is honoured.
+    ///
+    /// # Arguments
+    ///
+    /// * `gps_second_start` - GPS second which to start getting data at.
+    ///
+    /// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+    ///
+    /// * `gps_seconds_per_item` - How many GPS seconds of data in each item. A value of 0 is treated as 1.
+    ///
+    /// * `coarse_chan_indices` - indices within the coarse_chan array of the desired coarse channels.
+    ///
+    /// * `prefetch_depth` - number of items to read ahead. A value of 0 is treated as 1.
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the iterator, or a VoltageFileError if the parameters are invalid or any of the data files are missing.
+    ///
+    pub fn iter_gps_seconds(
+        &self,
+        gps_second_start: u64,
+        gps_second_count: usize,
+        gps_seconds_per_item: usize,
+        coarse_chan_indices: &[usize],
+        prefetch_depth: usize,
+    ) -> Result<GpsSecondPrefetchIterator, VoltageFileError> {
+        if self.voltage_batches.is_empty() {
+            return Err(VoltageFileError::NoVoltageFiles);
+        }
+
+        // Validate the coarse chans
+        if coarse_chan_indices
+            .iter()
+            .any(|&c| c > self.num_coarse_chans - 1)
+        {
+            return Err(VoltageFileError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        // Validate the gpstime
+        let gps_second_end = VoltageContext::validate_gps_time_parameters(
+            &self,
+            gps_second_start,
+            gps_second_count,
+        )?;
+
+        // Work out every read up front, so any missing data is reported now
+        let gps_seconds_per_item = gps_seconds_per_item.max(1) as u64;
+        let mut filenames: Vec<String> = Vec::new();
+        let mut file_indices: HashMap<&str, usize> = HashMap::new();
+        let mut plans: Vec<GpsSecondsReadPlan> = Vec::new();
+
+        let mut item_start = gps_second_start;
+        while item_start <= gps_second_end {
+            let item_end = (item_start + gps_seconds_per_item - 1).min(gps_second_end);
+            let mut reads: Vec<VoltageRead> = Vec::new();
+            let mut buffer_offset: usize = 0;
+
+            for &coarse_chan_index in coarse_chan_indices {
+                for timestep_index in
+                    self.get_timestep_indices_for_gps_seconds(item_start, item_end)
+                {
+                    let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+                    let file_index = *file_indices.entry(filename).or_insert_with(|| {
+                        filenames.push(filename.to_string());
+                        filenames.len() - 1
+                    });
+
+                    let blocks = self.get_voltage_block_range_for_gps_seconds(
+                        timestep_index,
+                        item_start,
+                        item_end,
+                    );
+                    let len = blocks.len() * self.voltage_block_size_bytes as usize;
+
+                    reads.push(VoltageRead {
+                        file_index,
+                        file_offset: self.data_file_header_size_bytes
+                            + self.delay_block_size_bytes
+                            + blocks.start as u64 * self.voltage_block_size_bytes,
+                        buffer_offset,
+                        len,
+                    });
+                    buffer_offset += len;
+                }
+            }
+
+            plans.push(GpsSecondsReadPlan {
+                gps_second_start: item_start,
+                gps_second_count: (item_end - item_start + 1) as usize,
+                len: buffer_offset,
+                reads,
+            });
+            item_start = item_end + 1;
+        }
+
+        // Every read starts on a voltage block boundary in the file and in the (aligned) buffer
+        let alignment = DIRECT_IO_ALIGNMENT as u64;
+        let reader = VoltageFileReader {
+            filenames,
+            expected_file_size: self.data_file_header_size_bytes
+                + self.delay_block_size_bytes
+                + (self.voltage_block_size_bytes * self.num_voltage_blocks_per_timestep),
+            direct_io: self.direct_io,
+            try_o_direct: (self.data_file_header_size_bytes + self.delay_block_size_bytes)
+                % alignment
+                == 0
+                && self.voltage_block_size_bytes % alignment == 0,
+            read_counters: Arc::clone(&self.read_counters),
+            data_sources: self.data_sources.clone(),
+        };
+
+        Ok(GpsSecondPrefetchIterator::new(
+            reader,
+            plans,
+            prefetch_depth,
+        ))
+    }
+
+    /// Read a single timestep / coarse channel worth of data, as `read_file` does, but decode
+    /// each complex sample into a real/imaginary pair of `T` (`i8` or `f32`). The file is read a
+    /// chunk at a time and each chunk is decoded while it is still in cache.
+    ///
+    /// For legacy VCS each byte holds a 4 bit real (high nibble) and 4 bit imaginary (low nibble)
+    /// value, so the buffer must hold twice as many values as `read_file` returns bytes. For MWAX
+    /// each 8 bit real and imaginary byte is converted, so the buffer holds as many values as
+    /// `read_file` returns bytes. The order of the samples is as described for `read_file`.
+    ///
+    /// # Arguments
+    ///
+    /// * `timestep_index` - index within the timestep array for the desired timestep. This corresponds
+    ///                      to the element within VoltageContext.timesteps. For mwa legacy each index
+    ///                      represents 1 second increments, for mwax it is 8 second increments.
+    ///
+    /// * `coarse_chan_index` - index within the coarse_chan array for the desired coarse channel. This corresponds
+    ///                      to the element within VoltageContext.coarse_chans.
+    ///
+    /// * `buffer` - a mutable reference to an already exitsing, initialised slice `[T]` which will be filled with the decoded data from one VCS data file.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a VoltageFileError on failure.
+    ///
+    ///
+    pub fn read_file_unpacked<T: VoltageSample>(
+        &self,
+        timestep_index: usize,
+        coarse_chan_index: usize,
+        buffer: &mut [T],
+    ) -> Result<(), VoltageFileError> {
+        if self.voltage_batches.is_empty() {
+            return Err(VoltageFileError::NoVoltageFiles);
+        }
+
+        // Validate the timestep
+        if timestep_index > self.num_timesteps - 1 {
+            return Err(VoltageFileError::InvalidTimeStepIndex(
+                self.num_timesteps - 1,
+            ));
+        }
+
+        // Validate the coarse chan
+        if coarse_chan_index > self.num_coarse_chans - 1 {
+            return Err(VoltageFileError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        // Check buffer is big enough
+        let expected_buffer_size = (self.voltage_block_size_bytes
+            * self.num_voltage_blocks_per_timestep) as usize
+            * values_per_byte(self.mwa_version);
+
+        if buffer.len() != expected_buffer_size {
+            return Err(VoltageFileError::InvalidUnpackedBufferSize(
+                buffer.len(),
+                expected_buffer_size,
+            ));
+        }
+
+        let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+
+        self.read_and_unpack_voltage_file_at(
+            filename,
+            self.data_file_header_size_bytes
+                + self.delay_block_size_bytes
+                + (self.voltage_block_size_bytes * self.num_voltage_blocks_per_timestep),
+            self.data_file_header_size_bytes + self.delay_block_size_bytes,
+            buffer,
+        )
+    }
+
+    /// Read a range of GPS seconds for a single coarse channel, as `read_second` does, but decode
+    /// each complex sample into a real/imaginary pair of `T` (`i8` or `f32`). See
+    /// `read_file_unpacked` for the size of the buffer (relative to `read_second`) and the
+    /// decoding. The data files needed are read in parallel.
+    ///
+    /// # Arguments
+    ///
+    /// * `gps_second_start` - GPS second which to start getting data at.
+    ///
+    /// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+    ///
+    /// * `coarse_chan_index` - index within the coarse_chan array for the desired coarse channel. This corresponds
+    ///                      to the element within VoltageContext.coarse_chans.
+    ///
+    /// * `buffer` - a mutable reference to an already exitsing, initialised slice `[T]` which will be filled with the decoded data.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a VoltageFileError on failure.
+    ///
+    ///
+    pub fn read_second_unpacked<T: VoltageSample>(
+        &self,
+        gps_second_start: u64,
+        gps_second_count: usize,
+        coarse_chan_index: usize,
+        buffer: &mut [T],
+    ) -> Result<(), VoltageFileError> {
+        if self.voltage_batches.is_empty() {
+            return Err(VoltageFileError::NoVoltageFiles);
+        }
+
+        // Validate the coarse chan
+        if coarse_chan_index > self.num_coarse_chans - 1 {
+            return Err(VoltageFileError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        // Validate the gpstime
+        let gps_second_end = VoltageContext::validate_gps_time_parameters(
+            &self,
+            gps_second_start,
+            gps_second_count,
+        )?;
+
+        // Check output buffer is big enough
+        let values_per_byte = values_per_byte(self.mwa_version);
+        let expected_buffer_size = (self.voltage_block_size_bytes
+            * self.num_voltage_blocks_per_second) as usize
+            * gps_second_count
+            * values_per_byte;
+
+        if buffer.len() != expected_buffer_size {
+            return Err(VoltageFileError::InvalidUnpackedBufferSize(
+                buffer.len(),
+                expected_buffer_size,
+            ));
+        }
+
+        let calc_file_size = self.data_file_header_size_bytes
+            + self.delay_block_size_bytes
+            + (self.voltage_block_size_bytes * self.num_voltage_blocks_per_timestep);
+
+        // Work out every read up front, giving each a disjoint part of the output buffer
+        let mut reads: Vec<(&str, u64, &mut [T])> = Vec::new();
+        let mut remaining = buffer;
+
+        for timestep_index in
+            self.get_timestep_indices_for_gps_seconds(gps_second_start, gps_second_end)
+        {
+            let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+            let blocks = self.get_voltage_block_range_for_gps_seconds(
+                timestep_index,
+                gps_second_start,
+                gps_second_end,
+            );
+
+            let offset = self.data_file_header_size_bytes
+                + self.delay_block_size_bytes
+                + blocks.start as u64 * self.voltage_block_size_bytes;
+            let (read_buffer, rest) = remaining.split_at_mut(
+                blocks.len() * self.voltage_block_size_bytes as usize * values_per_byte,
+            );
+            remaining = rest;
+
+            reads.push((filename, offset, read_buffer));
+        }
+
+        self.install(|| {
+            reads
+                .into_par_iter()
+                .try_for_each(|(filename, offset, read_buffer)| {
+                    self.read_and_unpack_voltage_file_at(
+                        filename,
+                        calc_file_size,
+                        offset,
+                        read_buffer,
+                    )
+                })
+        })
+    }
+
+    /// Read part of a voltage data file, a chunk at a time, decoding each chunk into the output
+    /// buffer (see `read_file_unpacked`) after checking the file is the expected size. If direct
+    /// I/O is enabled the reads bypass (or at least do not fill) the page cache.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the voltage data file to read.
+    ///
+    /// * `expected_file_size` - the size the file must be.
+    ///
+    /// * `offset` - the offset in the file to read from.
+    ///
+    /// * `buffer` - the buffer to fill with decoded values. Its length determines how much is read.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a VoltageFileError on failure.
+    ///
+    fn read_and_unpack_voltage_file_at<T: VoltageSample>(
+        &self,
+        filename: &str,
+        expected_file_size: u64,
+        offset: u64,
+        buffer: &mut [T],
+    ) -> Result<(), VoltageFileError> {
+        let values_per_byte = values_per_byte(self.mwa_version);
+        let read_size_bytes = buffer.len() / values_per_byte;
+
+        // The chunk size is aligned, so if the whole read is aligned so is every chunk
+        let alignment = DIRECT_IO_ALIGNMENT as u64;
+        let file = OpenVoltageFile::open(
+            filename,
+            expected_file_size,
+            self.direct_io,
+            offset % alignment == 0 && read_size_bytes as u64 % alignment == 0,
+            &self.data_sources,
+        )?;
+        self.read_counters.add_file_open();
+
+        let mut chunk_buffer = AlignedBuffer::new(UNPACK_CHUNK_BYTES.min(read_size_bytes));
+        let mut chunk_offset = offset;
+
+        for values in buffer.chunks_mut(UNPACK_CHUNK_BYTES * values_per_byte) {
+            let chunk = &mut chunk_buffer[..values.len() / values_per_byte];
+            file.read_exact_at(chunk, chunk_offset).map_err(|e| {
+                VoltageFileError::VoltageFileError(filename.to_string(), e.to_string())
+            })?;
+            self.read_counters.add_bytes_read(chunk.len());
+
+            self.read_counters.time(ReadTimer::Convert, || {
+                unpack_voltage_samples(self.mwa_version, chunk, values)
+            });
+            chunk_offset += chunk.len() as u64;
+        }
+
+        Ok(())
+    }
+
+    /// Returns the indices within `metafits_context.rf_inputs` of the X and Y rf_inputs of each
+    /// of the given antennas, for use with `read_second_rf_input_subset`.
+    ///
+    /// # Arguments
+    ///
+    /// * `antenna_indices` - indices within `metafits_context.antennas` of the desired antennas.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the rf_input indices (X then Y for each antenna, in the order given), or a VoltageFileError if an antenna index is invalid.
+    ///
+    pub fn get_rf_input_indices_for_antennas(
+        &self,
+        antenna_indices: &[usize],
+    ) -> Result<Vec<usize>, VoltageFileError> {
+        let antennas = &self.metafits_context.antennas;
+        let rf_inputs = &self.metafits_context.rf_inputs;
+        let mut rf_input_indices: Vec<usize> = Vec::with_capacity(antenna_indices.len() * 2);
+
+        for &antenna_index in antenna_indices {
+            let antenna = antennas
+                .get(antenna_index)
+                .ok_or_else(|| VoltageFileError::InvalidAntennaIndex(antennas.len() - 1))?;
+
+            for input in &[antenna.rfinput_x.input, antenna.rfinput_y.input] {
+                // We can unwrap here as every antenna's rf_inputs are in rf_inputs
+                rf_input_indices.push(rf_inputs.iter().position(|r| r.input == *input).unwrap());
+            }
+        }
+
+        Ok(rf_input_indices)
+    }
+
+    /// Returns the indices within `metafits_context.rf_inputs` of the X and Y rf_inputs of each
+    /// of the given tiles, for use with `read_second_rf_input_subset`.
+    ///
+    /// # Arguments
+    ///
+    /// * `tile_names` - names of the desired tiles, e.g. "Tile011".
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the rf_input indices (X then Y for each tile, in the order given), or a VoltageFileError if a tile name is not in this observation.
+    ///
+    pub fn get_rf_input_indices_for_tile_names<T: AsRef<str>>(
+        &self,
+        tile_names: &[T],
+    ) -> Result<Vec<usize>, VoltageFileError> {
+        let antenna_indices = tile_names
+            .iter()
+            .map(|name| {
+                self.metafits_context
+                    .antennas
+                    .iter()
+                    .position(|a| a.tile_name == name.as_ref())
+                    .ok_or_else(|| VoltageFileError::InvalidTileName(name.as_ref().to_string()))
+            })
+            .collect::<Result<Vec<usize>, VoltageFileError>>()?;
+
+        self.get_rf_input_indices_for_antennas(&antenna_indices)
+    }
+
+    /// Read a range of GPS seconds for a single coarse channel, as `read_second` does, but only
+    /// for some of the rf_inputs. This is only supported for MWAX, where each rf_input is a
+    /// contiguous run of samples within each voltage block, so only those runs are read from
+    /// disk (reading 4 of 128 tiles costs about 3% of the I/O of `read_second`). Adjacent
+    /// rf_inputs (such as the X and Y of a tile) are read together.
+    ///
+    /// The output data are in [voltage_block][rf_input][sample][real|imag] order, where rf_input is in
+    /// the order of `rf_input_indices` and the voltage blocks are in time order.
+    ///
+    /// # Arguments
+    ///
+    /// * `gps_second_start` - GPS second which to start getting data at.
+    ///
+    /// * `gps_second_count` - How many GPS seconds of data to get (inclusive).
+    ///
+    /// * `coarse_chan_index` - index within the coarse_chan array for the desired coarse channel. This corresponds
+    ///                      to the element within VoltageContext.coarse_chans.
+    ///
+    /// * `rf_input_indices` - indices within `metafits_context.rf_inputs` of the desired rf_inputs. See
+    ///                        `get_rf_input_indices_for_antennas` and `get_rf_input_indices_for_tile_names`.
+    ///
+    /// * `buffer` - a mutable reference to an already exitsing, initialised slice `[u8]` which will be filled with the data.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a VoltageFileError on failure.
+    ///
+    ///
+    pub fn read_second_rf_input_subset(
+        &self,
+        gps_second_start: u64,
+        gps_second_count: usize,
+        coarse_chan_index: usize,
+        rf_input_indices: &[usize],
+        buffer: &mut [u8],
+    ) -> Result<(), VoltageFileError> {
+        // Legacy voltage blocks interleave every rf_input in every sample
+        if self.mwa_version != MWAVersion::VCSMWAXv2 {
+            return Err(VoltageFileError::InvalidMwaVersion {
+                mwa_version: self.mwa_version,
+            });
+        }
+
+        if self.voltage_batches.is_empty() {
+            return Err(VoltageFileError::NoVoltageFiles);
+        }
+
+        // Validate the coarse chan
+        if coarse_chan_index > self.num_coarse_chans - 1 {
+            return Err(VoltageFileError::InvalidCoarseChanIndex(
+                self.num_coarse_chans - 1,
+            ));
+        }
+
+        // Validate the rf_inputs against the layout of the voltage blocks
+        let rf_input_size_bytes = self.num_samples_per_voltage_block
+            * self.num_fine_chans_per_coarse as u64
+            * self.sample_size_bytes;
+        let num_rf_inputs_per_block =
+            (self.voltage_block_size_bytes / rf_input_size_bytes) as usize;
+
+        if rf_input_indices
+            .iter()
+            .any(|&r| r > num_rf_inputs_per_block - 1)
+        {
+            return Err(VoltageFileError::InvalidRfInputIndex(
+                num_rf_inputs_per_block - 1,
+            ));
+        }
+
+        // Validate the gpstime
+        let gps_second_end = VoltageContext::validate_gps_time_parameters(
+            &self,
+            gps_second_start,
+            gps_second_count,
+        )?;
+
+        // Check output buffer is big enough
+        let block_subset_size_bytes = rf_input_indices.len() * rf_input_size_bytes as usize;
+        let expected_buffer_size = self.num_voltage_blocks_per_second as usize
+            * gps_second_count
+            * block_subset_size_bytes;
+
+        if buffer.len() != expected_buffer_size {
+            return Err(VoltageFileError::InvalidBufferSize(
+                buffer.len(),
+                expected_buffer_size,
+            ));
+        }
+
+        let calc_file_size = self.data_file_header_size_bytes
+            + self.delay_block_size_bytes
+            + (self.voltage_block_size_bytes * self.num_voltage_blocks_per_timestep);
+
+        // The (file offset, length) of each run of rf_inputs, relative to the start of a block
+        let runs: Vec<(u64, usize)> = get_rf_input_runs(rf_input_indices)
+            .iter()
+            .map(|&(first, count)| {
+                (
+                    first as u64 * rf_input_size_bytes,
+                    count * rf_input_size_bytes as usize,
+                )
+            })
+            .collect();
+
+        // Work out which blocks to read from each file up front, giving each file a disjoint part
+        // of the output buffer
+        let mut reads: Vec<(&str, Range<usize>, &mut [u8])> = Vec::new();
+        let mut remaining = buffer;
+
+        for timestep_index in
+            self.get_timestep_indices_for_gps_seconds(gps_second_start, gps_second_end)
+        {
+            let filename = self.get_voltage_filename(timestep_index, coarse_chan_index)?;
+            let blocks = self.get_voltage_block_range_for_gps_seconds(
+                timestep_index,
+                gps_second_start,
+                gps_second_end,
+            );
+
+            let (read_buffer, rest) =
+                remaining.split_at_mut(blocks.len() * block_subset_size_bytes);
+            remaining = rest;
+
+            reads.push((filename, blocks, read_buffer));
+        }
+
+        self.install(|| {
+            reads
+                .into_par_iter()
+                .try_for_each(|(filename, blocks, read_buffer)| {
+                    // Only the runs are read, so stop the kernel reading ahead into the rest of the
+                    // file. Direct I/O is not possible (the runs are not aligned), so with direct
+                    // I/O we instead drop each run from the page cache once it has been read.
+                    let file = OpenVoltageFile::open(
+                        filename,
+                        calc_file_size,
+                        false,
+                        false,
+                        &self.data_sources,
+                    )?;
+                    self.read_counters.add_file_open();
+                    file.advise(0, 0, Advice::Random);
+
+                    let mut remaining = read_buffer;
+                    for block_index in blocks {
+                        let block_offset = self.data_file_header_size_bytes
+                            + self.delay_block_size_bytes
+                            + block_index as u64 * self.voltage_block_size_bytes;
+
+                        for &(run_offset, run_len) in &runs {
+                            let (chunk, rest) = remaining.split_at_mut(run_len);
+                            remaining = rest;
+
+                            file.read_exact_at(chunk, block_offset + run_offset)
+                                .map_err(|e| {
+                                    VoltageFileError::VoltageFileError(
+                                        filename.to_string(),
+                                        e.to_string(),
+                                    )
+                                })?;
+                            self.read_counters.add_bytes_read(run_len);
+
+                            if self.direct_io {
+                                file.advise(block_offset + run_offset, run_len, Advice::DontNeed);
+                            }
+                        }
+                    }
+
+                    Ok(())
+                })
+        })
+    }
+
+    /// Check a voltage data file is on the filesystem, as only those can be memory mapped.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the voltage data file to map.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if the file can be mapped, or a VoltageFileError if it is read from a data source.
+    ///
+    fn check_can_mmap(&self, filename: &str) -> Result<(), VoltageFileError> {
+        match self.data_sources.get(filename) {
+            Some(_) => Err(VoltageFileError::VoltageFileError(
+                filename.to_string(),
+                String::from("voltage files read from a data source cannot be memory mapped"),
+            )),
+            None => Ok(()),
+        }
+    }
+
+    /// Read part of a voltage data file with a single positional read, after checking the file
+    /// is the expected size. If direct I/O is enabled the read bypasses (or at least does not
+    /// fill) the page cache. Files with a data source are read from it instead.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the voltage data file to read.
+    ///
+    /// * `expected_file_size` - the size the file must be.
+    ///
+    /// * `offset` - the offset in the file to read from.
+    ///
+    /// * `buffer` - the buffer to fill.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result of Ok if success or a VoltageFileError on failure.
+    ///
+    fn read_voltage_file_at(
+        &self,
+        filename: &str,
+        expected_file_size: u64,
+        offset: u64,
+        buffer: &mut [u8],
+    ) -> Result<(), VoltageFileError> {
+        let to_error = |e: std::io::Error| {
+            VoltageFileError::VoltageFileError(filename.to_string(), e.to_string())
+        };
+
+        // Check file is as big as we expect
+        let check_file_size = |file: &File| {
+            let file_size = file.metadata().map_err(to_error)?.len();
+            if file_size != expected_file_size {
+                return Err(VoltageFileError::InvalidVoltageFileSize(
+                    file_size,
+                    filename.to_string(),
+                    expected_file_size,
+                ));
+            }
+            Ok(())
+        };
+
+        if let Some(source) = self.data_sources.get(filename) {
+            self.read_counters.add_file_open();
+            let file_size = source.size().map_err(to_error)?;
+            if file_size != expected_file_size {
+                return Err(VoltageFileError::InvalidVoltageFileSize(
+                    file_size,
+                    filename.to_string(),
+                    expected_file_size,
+                ));
+            }
+            source.read_exact_at(buffer, offset).map_err(to_error)?;
+        } else if self.direct_io {
+            // O_DIRECT reads must be aligned, otherwise we fall back to reading with cache hints
+            let file = UncachedFile::open(filename, is_direct_io_aligned(buffer, offset))
+                .map_err(to_error)?;
+            self.read_counters.add_file_open();
+            check_file_size(&file.file)?;
+            file.read_exact_at(buffer, offset).map_err(to_error)?;
+        } else {
+            let file = File::open(filename).map_err(to_error)?;
+            self.read_counters.add_file_open();
+            check_file_size(&file)?;
+            file_io::read_exact_at(&file, buffer, offset).map_err(to_error)?;
+        }
+        self.read_counters.add_bytes_read(buffer.len());
+
+        Ok(())
+    }
+
+    /// Returns the range of voltage blocks within the data file of a timestep which are within
+    /// the given (already validated) GPS seconds.
+    ///
+    /// # Arguments
+    ///
+    /// * `timestep_index` - index within the timestep array of the data file.
+    ///
+    /// * `gps_second_start` - the first GPS second.
+    ///
+    /// * `gps_second_end` - the last GPS second (inclusive).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The range of voltage block indices within the data file
+    ///
+    fn get_voltage_block_range_for_gps_seconds(
+        &self,
+        timestep_index: usize,
+        gps_second_start: u64,
+        gps_second_end: u64,
+    ) -> Range<usize> {
+        let timestep_gps_second = self.timesteps[timestep_index].gps_time_ms / 1000;
+        let first_second = gps_second_start.max(timestep_gps_second) - timestep_gps_second;
+        let last_second = gps_second_end - timestep_gps_second;
+
+        let first_block = (first_second * self.num_voltage_blocks_per_second) as usize;
+        let end_block = ((last_second + 1) * self.num_voltage_blocks_per_second)
+            .min(self.num_voltage_blocks_per_timestep) as usize;
+
+        first_block..end_block
+    }
+
+    /// Returns the range of timestep indices which contain any of the given (already validated)
+    /// GPS seconds. NOTE: mwax has 8 gps seconds per timestep, legacy vcs has 1.
+    ///
+    /// # Arguments
+    ///
+    /// * `gps_second_start` - the first GPS second.
+    ///
+    /// * `gps_second_end` - the last GPS second (inclusive).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * The range of timestep indices
+    ///
+    fn get_timestep_indices_for_gps_seconds(
+        &self,
+        gps_second_start: u64,
+        gps_second_end: u64,
+    ) -> Range<usize> {
+        let timestep_index_start = ((gps_second_start * 1000 - self.timesteps[0].gps_time_ms)
+            / self.timestep_duration_ms) as usize;
+        // Get end timestep which includes the end gps time
+        let timestep_index_end = ((gps_second_end * 1000 - self.timesteps[0].gps_time_ms + 1)
+            / self.timestep_duration_ms) as usize;
+
+        timestep_index_start..timestep_index_end + 1
+    }
+}
+
+/// Group rf_input indices into runs of consecutive indices, so that rf_inputs which are next to
+/// each other in a voltage block can be read together.
+///
+/// # Arguments
+///
+/// * `rf_input_indices` - the rf_input indices, in output order.
+///
+///
+/// # Returns
+///
+/// * A vector of the first rf_input index and number of rf_inputs in each run, in output order.
+///
+fn get_rf_input_runs(rf_input_indices: &[usize]) -> Vec<(usize, usize)> {
+    let mut runs: Vec<(usize, usize)> = Vec::new();
+
+    for &rf_input_index in rf_input_indices {
+        match runs.last_mut() {
+            Some((first, count)) if *first + *count == rf_input_index => *count += 1,
+            _ => runs.push((rf_input_index, 1)),
+        }
+    }
+
+    runs
 }
 
 /// Implements fmt::Display for VoltageContext struct
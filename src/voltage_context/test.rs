@@ -400,6 +400,73 @@ fn test_context_legacy_v1() {
     assert_eq!(&rf_input_copy, &context.metafits_context.rf_inputs);
 }
 
+#[test]
+fn test_context_builder_lazy_validation() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+
+    for mwa_version in [MWAVersion::VCSLegacyRecombined, MWAVersion::VCSMWAXv2].iter() {
+        let generated_filenames = get_test_voltage_files(*mwa_version);
+        let test_filenames: Vec<&str> = generated_filenames.iter().map(String::as_str).collect();
+
+        let context = VoltageContext::new(&metafits_filename, &test_filenames)
+            .expect("Failed to create VoltageContext");
+        let lazy_context = VoltageContextBuilder::new()
+            .with_lazy_validation(true)
+            .build(&metafits_filename, &test_filenames)
+            .expect("Failed to create VoltageContext with lazy validation");
+
+        assert_eq!(lazy_context.mwa_version, context.mwa_version);
+        assert_eq!(lazy_context.voltage_time_map, context.voltage_time_map);
+        assert_eq!(lazy_context.num_timesteps, context.num_timesteps);
+        assert_eq!(
+            lazy_context.provided_coarse_chan_indices,
+            context.provided_coarse_chan_indices
+        );
+        assert_eq!(
+            lazy_context.common_timestep_indices,
+            context.common_timestep_indices
+        );
+    }
+}
+
+#[test]
+fn test_context_new_from_metafits_context() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let generated_filenames = get_test_voltage_files(MWAVersion::VCSLegacyRecombined);
+    let test_filenames: Vec<&str> = generated_filenames.iter().map(String::as_str).collect();
+
+    let context = VoltageContext::new(&metafits_filename, &test_filenames)
+        .expect("Failed to create VoltageContext");
+
+    // A metafits context from a correlator (or any other) MWAVersion is repopulated, and its rf_inputs put in VCS order
+    let metafits_context =
+        MetafitsContext::new_shared(&metafits_filename, MWAVersion::CorrLegacy).unwrap();
+    let shared_context =
+        VoltageContext::new_from_metafits_context(Arc::clone(&metafits_context), &test_filenames)
+            .expect("Failed to create VoltageContext from MetafitsContext");
+    assert!(!Arc::ptr_eq(
+        &shared_context.metafits_context,
+        &metafits_context
+    ));
+    assert_eq!(
+        shared_context.metafits_context.rf_inputs,
+        context.metafits_context.rf_inputs
+    );
+    assert_eq!(shared_context.num_timesteps, context.num_timesteps);
+    assert_eq!(shared_context.num_coarse_chans, context.num_coarse_chans);
+
+    // Another context of the same observation can then share it without any copying
+    let second_context = VoltageContext::new_from_metafits_context(
+        Arc::clone(&shared_context.metafits_context),
+        &test_filenames,
+    )
+    .expect("Failed to create VoltageContext from MetafitsContext");
+    assert!(Arc::ptr_eq(
+        &second_context.metafits_context,
+        &shared_context.metafits_context
+    ));
+}
+
 #[test]
 fn test_context_legacy_v1_read_file_no_data_for_timestep() {
     // Open a context and load in a test metafits and gpubox file
@@ -745,6 +812,98 @@ fn test_context_mwaxv2_read_file_no_data_for_timestep() {
     );
 }
 
+#[test]
+fn test_context_read_file_invalid_data_file_size() {
+    // Leave voltage_block_size_bytes as it is, so the context expects the 'real'/full file size.
+    // This used to panic, which would abort a multi-threaded host process.
+    for mwa_version in [MWAVersion::VCSLegacyRecombined, MWAVersion::VCSMWAXv2].iter() {
+        let context = get_test_voltage_context(*mwa_version);
+
+        let mut buffer: Vec<u8> = vec![
+            0;
+            (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep)
+                as usize
+        ];
+        let read_result: Result<(), VoltageFileError> = context.read_file(0, 14, &mut buffer);
+
+        let error = read_result.unwrap_err();
+        assert!(
+            matches!(error, VoltageFileError::InvalidVoltageFileSize(_, _, _)),
+            "Error was {:?}",
+            error
+        );
+    }
+}
+
+#[test]
+fn test_context_read_file_from_data_sources() {
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+    let generated_filenames = get_test_voltage_files(MWAVersion::VCSMWAXv2);
+
+    // Register each voltage file in memory, under a name which is not on disk
+    let mut data_sources = DataSources::new();
+    let source_filenames: Vec<String> = generated_filenames
+        .iter()
+        .map(|f| {
+            let source_filename = format!(
+                "archive/{}",
+                std::path::Path::new(f)
+                    .file_name()
+                    .unwrap()
+                    .to_str()
+                    .unwrap()
+            );
+            data_sources.insert(
+                source_filename.clone(),
+                Arc::new(MemorySource::new(std::fs::read(f).unwrap())),
+            );
+            source_filename
+        })
+        .collect();
+
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    let mut source_context = VoltageContextBuilder::new()
+        .with_data_sources(data_sources)
+        .build(&metafits_filename.to_string(), &source_filenames)
+        .expect("Failed to create VoltageContext from data sources");
+    assert_eq!(source_context.num_timesteps, context.num_timesteps);
+    assert_eq!(
+        source_context.voltage_time_map.len(),
+        context.voltage_time_map.len()
+    );
+
+    // In order for our smaller voltage files to work with this test we need to reset the voltage_block_size_bytes
+    context.voltage_block_size_bytes /= 128;
+    source_context.voltage_block_size_bytes /= 128;
+    let buffer_len =
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep) as usize;
+    let mut buffer = vec![0u8; buffer_len];
+    let mut source_buffer = vec![0u8; buffer_len];
+
+    context.read_file(0, 14, &mut buffer).unwrap();
+    source_context.read_file(0, 14, &mut source_buffer).unwrap();
+    assert_eq!(source_buffer, buffer);
+
+    let gps_second = source_context.timesteps[0].gps_time_ms / 1000;
+    let mut buffer = vec![
+        0u8;
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_second)
+            as usize
+    ];
+    let mut source_buffer = vec![0u8; buffer.len()];
+    context.read_second(gps_second, 1, 14, &mut buffer).unwrap();
+    source_context
+        .read_second(gps_second, 1, 14, &mut source_buffer)
+        .unwrap();
+    assert_eq!(source_buffer, buffer);
+
+    // Data source files cannot be memory mapped
+    assert!(matches!(
+        source_context.mmap_file(0, 14).unwrap_err(),
+        VoltageFileError::VoltageFileError(_, _)
+    ));
+}
+
 #[test]
 fn test_context_mwax_v2_read_file() {
     // Create voltage context
@@ -1537,3 +1696,565 @@ fn test_context_read_second_mwaxv2_valid() {
         185
     );
 }
+
+#[test]
+fn test_context_mwax_v2_mmap_file_matches_read_file() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+
+    //
+    // In order for our smaller voltage files to work with this test we need to reset the voltage_block_size_bytes
+    //
+    context.voltage_block_size_bytes /= 128;
+
+    let mut buffer: Vec<u8> = vec![
+        0;
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep)
+            as usize
+    ];
+    context.read_file(0, 14, &mut buffer).unwrap();
+
+    let mmap = context.mmap_file(0, 14).unwrap();
+    assert_eq!(mmap.data(), &buffer[..]);
+    assert_eq!(
+        mmap.header().len(),
+        context.data_file_header_size_bytes as usize
+    );
+    assert_eq!(
+        mmap.delay_block().len(),
+        context.delay_block_size_bytes as usize
+    );
+}
+
+#[test]
+fn test_context_mwax_v2_mmap_file_no_data_for_timestep() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    // No data for timestep index 10
+    let result = context.mmap_file(10, 14);
+
+    assert!(matches!(
+        result.unwrap_err(),
+        VoltageFileError::NoDataForTimeStepCoarseChannel {
+            timestep_index: 10,
+            coarse_chan_index: 14
+        }
+    ));
+}
+
+#[test]
+fn test_context_mwax_v2_mmap_second_matches_read_second() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    // Span the last 2 seconds of file 0 and the first 2 seconds of file 1
+    let gps_second_start = 1_101_503_318;
+    let gps_second_count: usize = 4;
+    let coarse_chan_index = 14;
+
+    let mut buffer: Vec<u8> = vec![
+        0;
+        (context.voltage_block_size_bytes
+            * context.num_voltage_blocks_per_second
+            * gps_second_count as u64) as usize
+    ];
+    context
+        .read_second(
+            gps_second_start,
+            gps_second_count,
+            coarse_chan_index,
+            &mut buffer,
+        )
+        .unwrap();
+
+    let mmaps = context
+        .mmap_second(gps_second_start, gps_second_count, coarse_chan_index)
+        .unwrap();
+    assert_eq!(mmaps.len(), 2);
+    assert_eq!(mmaps[0].voltage_blocks, 120..160);
+    assert_eq!(mmaps[1].voltage_blocks, 0..40);
+
+    let mapped: Vec<u8> = mmaps
+        .iter()
+        .flat_map(|m| m.data().iter().copied())
+        .collect();
+    assert_eq!(mapped, buffer);
+}
+
+#[test]
+fn test_context_mwax_v2_read_second_multi_chan_matches_read_second() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    // Span the last 2 seconds of file 0 and the first 2 seconds of file 1, for both coarse
+    // channels (in reverse order)
+    let gps_second_start = 1_101_503_318;
+    let gps_second_count: usize = 4;
+    let coarse_chan_indices = vec![15, 14];
+
+    let coarse_chan_buffer_size = (context.voltage_block_size_bytes
+        * context.num_voltage_blocks_per_second
+        * gps_second_count as u64) as usize;
+
+    let mut buffer: Vec<u8> = vec![0; coarse_chan_buffer_size * coarse_chan_indices.len()];
+    context
+        .read_second_multi_chan(
+            gps_second_start,
+            gps_second_count,
+            &coarse_chan_indices,
+            &mut buffer,
+        )
+        .unwrap();
+
+    for (coarse_chan_index, multi_chan_buffer) in coarse_chan_indices
+        .iter()
+        .zip(buffer.chunks_exact(coarse_chan_buffer_size))
+    {
+        let mut single_chan_buffer: Vec<u8> = vec![0; coarse_chan_buffer_size];
+        context
+            .read_second(
+                gps_second_start,
+                gps_second_count,
+                *coarse_chan_index,
+                &mut single_chan_buffer,
+            )
+            .unwrap();
+
+        assert_eq!(multi_chan_buffer, &single_chan_buffer[..]);
+    }
+}
+
+#[test]
+fn test_context_read_second_multi_chan_invalid_inputs() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    let gps_second_start = 1_101_503_318;
+    let gps_second_count: usize = 1;
+    let coarse_chan_buffer_size = (context.voltage_block_size_bytes
+        * context.num_voltage_blocks_per_second
+        * gps_second_count as u64) as usize;
+
+    // Invalid coarse channel
+    let mut buffer: Vec<u8> = vec![0; coarse_chan_buffer_size * 2];
+    let result =
+        context.read_second_multi_chan(gps_second_start, gps_second_count, &[14, 100], &mut buffer);
+    assert!(matches!(
+        result.unwrap_err(),
+        VoltageFileError::InvalidCoarseChanIndex(23)
+    ));
+
+    // Buffer only big enough for one of two coarse channels
+    let mut buffer: Vec<u8> = vec![0; coarse_chan_buffer_size];
+    let result =
+        context.read_second_multi_chan(gps_second_start, gps_second_count, &[14, 15], &mut buffer);
+    assert!(matches!(
+        result.unwrap_err(),
+        VoltageFileError::InvalidBufferSize(_, _)
+    ));
+}
+
+#[test]
+fn test_context_mwax_v2_direct_io_matches_cached_reads() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    let file_buffer_size =
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep) as usize;
+    let gps_second_start = 1_101_503_318;
+    let gps_second_count: usize = 4;
+    let second_buffer_size = (context.voltage_block_size_bytes
+        * context.num_voltage_blocks_per_second
+        * gps_second_count as u64) as usize;
+
+    let mut cached_file: Vec<u8> = vec![0; file_buffer_size];
+    context.read_file(0, 14, &mut cached_file).unwrap();
+    let mut cached_second: Vec<u8> = vec![0; second_buffer_size];
+    context
+        .read_second(gps_second_start, gps_second_count, 14, &mut cached_second)
+        .unwrap();
+
+    context.set_direct_io(true);
+
+    // Both an aligned and an unaligned buffer should give the same data
+    let mut direct_file = AlignedBuffer::new(file_buffer_size);
+    context.read_file(0, 14, &mut direct_file).unwrap();
+    assert_eq!(&direct_file[..], &cached_file[..]);
+
+    let mut direct_second: Vec<u8> = vec![0; second_buffer_size];
+    context
+        .read_second(gps_second_start, gps_second_count, 14, &mut direct_second)
+        .unwrap();
+    assert_eq!(direct_second, cached_second);
+
+    // Errors are the same as without direct I/O
+    let mut small_buffer: Vec<u8> = vec![0; file_buffer_size / 2];
+    assert!(matches!(
+        context.read_file(0, 14, &mut small_buffer).unwrap_err(),
+        VoltageFileError::InvalidBufferSize(_, _)
+    ));
+}
+
+#[test]
+fn test_context_mwax_v2_iter_gps_seconds_matches_read_second_multi_chan() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    // 6 seconds in 4 second items, which crosses from file 0 into file 1 within the first item
+    let gps_second_start = 1_101_503_317;
+    let gps_second_count: usize = 6;
+    let coarse_chan_indices = vec![15, 14];
+
+    let items: Vec<PrefetchedGpsSeconds> = context
+        .iter_gps_seconds(
+            gps_second_start,
+            gps_second_count,
+            4,
+            &coarse_chan_indices,
+            2,
+        )
+        .unwrap()
+        .collect::<Result<Vec<PrefetchedGpsSeconds>, VoltageFileError>>()
+        .unwrap();
+
+    assert_eq!(items.len(), 2);
+    assert_eq!(items[0].gps_second_start, gps_second_start);
+    assert_eq!(items[0].gps_second_count, 4);
+    assert_eq!(items[1].gps_second_start, gps_second_start + 4);
+    assert_eq!(items[1].gps_second_count, 2);
+
+    for item in &items {
+        let mut buffer: Vec<u8> = vec![
+            0;
+            (context.voltage_block_size_bytes * context.num_voltage_blocks_per_second)
+                as usize
+                * item.gps_second_count
+                * coarse_chan_indices.len()
+        ];
+        context
+            .read_second_multi_chan(
+                item.gps_second_start,
+                item.gps_second_count,
+                &coarse_chan_indices,
+                &mut buffer,
+            )
+            .unwrap();
+
+        assert_eq!(&item[..], &buffer[..]);
+    }
+}
+
+#[test]
+fn test_context_iter_gps_seconds_invalid_inputs() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    assert!(matches!(
+        context
+            .iter_gps_seconds(1_101_503_318, 1, 1, &[14, 100], 1)
+            .unwrap_err(),
+        VoltageFileError::InvalidCoarseChanIndex(23)
+    ));
+
+    assert!(matches!(
+        context
+            .iter_gps_seconds(1_101_503_000, 1, 1, &[14], 1)
+            .unwrap_err(),
+        VoltageFileError::InvalidGpsSecondStart(_, _)
+    ));
+
+    // We only have data files for 2 of the coarse channels
+    assert!(matches!(
+        context
+            .iter_gps_seconds(1_101_503_318, 1, 1, &[0], 1)
+            .unwrap_err(),
+        VoltageFileError::NoDataForTimeStepCoarseChannel { .. }
+    ));
+}
+
+#[test]
+fn test_context_read_file_unpacked_matches_read_file() {
+    for &mwa_version in &[MWAVersion::VCSLegacyRecombined, MWAVersion::VCSMWAXv2] {
+        let mut context = get_test_voltage_context(mwa_version);
+        context.voltage_block_size_bytes /= 128;
+
+        let mut raw: Vec<u8> = vec![
+            0;
+            (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep)
+                as usize
+        ];
+        context.read_file(0, 14, &mut raw).unwrap();
+
+        let values_per_byte = if mwa_version == MWAVersion::VCSLegacyRecombined {
+            2
+        } else {
+            1
+        };
+        let mut unpacked_i8: Vec<i8> = vec![0; raw.len() * values_per_byte];
+        let mut unpacked_f32: Vec<f32> = vec![0.; raw.len() * values_per_byte];
+        let mut expected: Vec<i8> = vec![0; raw.len() * values_per_byte];
+        context.read_file_unpacked(0, 14, &mut unpacked_i8).unwrap();
+        context
+            .read_file_unpacked(0, 14, &mut unpacked_f32)
+            .unwrap();
+        unpack_voltage_samples(mwa_version, &raw, &mut expected);
+
+        assert_eq!(unpacked_i8, expected);
+        assert!(unpacked_f32
+            .iter()
+            .zip(expected.iter())
+            .all(|(&f, &i)| f == i as f32));
+    }
+}
+
+#[test]
+fn test_context_mwax_v2_read_second_unpacked_matches_read_second() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    // Span the last 2 seconds of file 0 and the first 2 seconds of file 1
+    let gps_second_start = 1_101_503_318;
+    let gps_second_count: usize = 4;
+    let buffer_size = (context.voltage_block_size_bytes
+        * context.num_voltage_blocks_per_second
+        * gps_second_count as u64) as usize;
+
+    let mut raw: Vec<u8> = vec![0; buffer_size];
+    context
+        .read_second(gps_second_start, gps_second_count, 14, &mut raw)
+        .unwrap();
+
+    let mut unpacked: Vec<f32> = vec![0.; buffer_size];
+    context
+        .read_second_unpacked(gps_second_start, gps_second_count, 14, &mut unpacked)
+        .unwrap();
+
+    assert!(unpacked
+        .iter()
+        .zip(raw.iter())
+        .all(|(&f, &b)| f == (b as i8) as f32));
+
+    // The buffer is sized in values, not bytes
+    let mut too_small: Vec<f32> = vec![0.; buffer_size / 2];
+    assert!(matches!(
+        context
+            .read_second_unpacked(gps_second_start, gps_second_count, 14, &mut too_small)
+            .unwrap_err(),
+        VoltageFileError::InvalidUnpackedBufferSize(_, _)
+    ));
+}
+
+#[test]
+fn test_get_rf_input_runs() {
+    assert_eq!(get_rf_input_runs(&[]), vec![]);
+    assert_eq!(get_rf_input_runs(&[4, 5, 6, 7]), vec![(4, 4)]);
+    assert_eq!(
+        get_rf_input_runs(&[0, 1, 10, 11, 3, 2]),
+        vec![(0, 2), (10, 2), (3, 1), (2, 1)]
+    );
+}
+
+#[test]
+fn test_context_mwax_v2_read_second_rf_input_subset_matches_read_second() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    // Span the last 2 seconds of file 0 and the first 2 seconds of file 1
+    let gps_second_start = 1_101_503_318;
+    let gps_second_count: usize = 4;
+    let num_blocks = context.num_voltage_blocks_per_second as usize * gps_second_count;
+    // Our test files only have 2 rf_inputs
+    let rf_input_size = context.voltage_block_size_bytes as usize / 2;
+
+    let mut full: Vec<u8> = vec![0; num_blocks * context.voltage_block_size_bytes as usize];
+    context
+        .read_second(gps_second_start, gps_second_count, 14, &mut full)
+        .unwrap();
+
+    for rf_input_indices in &[vec![1], vec![1, 0], vec![0, 1]] {
+        let mut subset: Vec<u8> = vec![0; num_blocks * rf_input_indices.len() * rf_input_size];
+        context
+            .read_second_rf_input_subset(
+                gps_second_start,
+                gps_second_count,
+                14,
+                rf_input_indices,
+                &mut subset,
+            )
+            .unwrap();
+
+        let expected: Vec<u8> = full
+            .chunks_exact(context.voltage_block_size_bytes as usize)
+            .flat_map(|block| {
+                rf_input_indices
+                    .iter()
+                    .flat_map(move |&r| block[r * rf_input_size..(r + 1) * rf_input_size].iter())
+            })
+            .copied()
+            .collect();
+
+        assert_eq!(subset, expected);
+    }
+}
+
+#[test]
+fn test_context_read_second_rf_input_subset_invalid_inputs() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+    context.voltage_block_size_bytes /= 128;
+
+    let mut buffer: Vec<u8> = vec![0; 10];
+    assert!(matches!(
+        context
+            .read_second_rf_input_subset(1_101_503_318, 1, 14, &[2], &mut buffer)
+            .unwrap_err(),
+        VoltageFileError::InvalidRfInputIndex(1)
+    ));
+    assert!(matches!(
+        context
+            .read_second_rf_input_subset(1_101_503_318, 1, 14, &[0], &mut buffer)
+            .unwrap_err(),
+        VoltageFileError::InvalidBufferSize(10, _)
+    ));
+
+    let mut context = get_test_voltage_context(MWAVersion::VCSLegacyRecombined);
+    context.voltage_block_size_bytes /= 128;
+    assert!(matches!(
+        context
+            .read_second_rf_input_subset(1_101_503_312, 1, 14, &[0], &mut buffer)
+            .unwrap_err(),
+        VoltageFileError::InvalidMwaVersion { .. }
+    ));
+}
+
+#[test]
+fn test_context_get_rf_input_indices_for_antennas_and_tile_names() {
+    let context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+
+    let antenna = &context.metafits_context.antennas[3];
+    let rf_input_indices = context.get_rf_input_indices_for_antennas(&[3]).unwrap();
+    assert_eq!(rf_input_indices.len(), 2);
+    assert_eq!(
+        context.metafits_context.rf_inputs[rf_input_indices[0]].input,
+        antenna.rfinput_x.input
+    );
+    assert_eq!(
+        context.metafits_context.rf_inputs[rf_input_indices[1]].input,
+        antenna.rfinput_y.input
+    );
+
+    assert_eq!(
+        context
+            .get_rf_input_indices_for_tile_names(&[antenna.tile_name.as_str()])
+            .unwrap(),
+        rf_input_indices
+    );
+
+    assert!(matches!(
+        context
+            .get_rf_input_indices_for_antennas(&[100_000])
+            .unwrap_err(),
+        VoltageFileError::InvalidAntennaIndex(_)
+    ));
+    assert!(matches!(
+        context
+            .get_rf_input_indices_for_tile_names(&["NotATile"])
+            .unwrap_err(),
+        VoltageFileError::InvalidTileName(_)
+    ));
+}
+
+#[test]
+fn test_context_is_send_and_sync() {
+    // The read methods take &self, so one context can be shared by many threads (this is also
+    // what makes the FFI read functions safe to call concurrently)
+    fn assert_send_sync<T: Send + Sync>() {}
+    assert_send_sync::<VoltageContext>();
+}
+
+#[test]
+fn test_context_mwax_v2_concurrent_reads_match_single_reads() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSMWAXv2);
+
+    //
+    // In order for our smaller voltage files to work with this test we need to reset the voltage_block_size_bytes
+    //
+    context.voltage_block_size_bytes /= 128;
+
+    let gps_second_start = 1_101_503_318; // Spans both test data files
+    let gps_second_count: usize = 3;
+
+    let mut expected_file: Vec<u8> = vec![
+        0;
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep)
+            as usize
+    ];
+    context.read_file(0, 14, &mut expected_file).unwrap();
+
+    let mut expected_second: Vec<u8> = vec![
+        0;
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_second)
+            as usize
+            * gps_second_count
+    ];
+    context
+        .read_second(gps_second_start, gps_second_count, 14, &mut expected_second)
+        .unwrap();
+
+    let context = std::sync::Arc::new(context);
+    let threads: Vec<_> = (0..8)
+        .map(|_| {
+            let context = context.clone();
+            let file_len = expected_file.len();
+            let second_len = expected_second.len();
+            std::thread::spawn(move || {
+                let mut file_buffer = vec![0u8; file_len];
+                let mut second_buffer = vec![0u8; second_len];
+                for _ in 0..4 {
+                    context.read_file(0, 14, &mut file_buffer).unwrap();
+                    context
+                        .read_second(gps_second_start, gps_second_count, 14, &mut second_buffer)
+                        .unwrap();
+                }
+                (file_buffer, second_buffer)
+            })
+        })
+        .collect();
+
+    for thread in threads {
+        let (file_buffer, second_buffer) = thread.join().unwrap();
+        assert_eq!(file_buffer, expected_file);
+        assert_eq!(second_buffer, expected_second);
+    }
+}
+
+#[test]
+fn test_context_read_stats() {
+    let mut context = get_test_voltage_context(MWAVersion::VCSLegacyRecombined);
+
+    //
+    // In order for our smaller voltage files to work with this test we need to reset the voltage_block_size_bytes
+    //
+    context.voltage_block_size_bytes /= 128;
+
+    let mut buffer: Vec<u8> = vec![
+        0;
+        (context.voltage_block_size_bytes * context.num_voltage_blocks_per_timestep)
+            as usize
+    ];
+
+    // Reads are not counted until collection is enabled
+    context.read_file(0, 14, &mut buffer).unwrap();
+    assert_eq!(context.get_stats().bytes_read, 0);
+
+    context.set_stats_enabled(true);
+    context.read_file(0, 14, &mut buffer).unwrap();
+    context.read_file(0, 15, &mut buffer).unwrap();
+    let stats = context.get_stats();
+    assert_eq!(stats.bytes_read, 2 * buffer.len() as u64);
+    assert_eq!(stats.file_opens, 2);
+    assert_eq!(stats.hdu_seeks, 0);
+    assert_eq!(stats.fits_read_time_ns, 0);
+
+    context.reset_stats();
+    assert_eq!(context.get_stats().file_opens, 0);
+}
@@ -22,6 +22,18 @@ pub enum VoltageFileError {
     #[error("Provided buffer of {0} bytes is not the correct size (should be {1} bytes)")]
     InvalidBufferSize(usize, usize),
 
+    #[error("Provided buffer of {0} values is not the correct size (should be {1} values)")]
+    InvalidUnpackedBufferSize(usize, usize),
+
+    #[error("Invalid rf_input index provided. The rf_input index must be between 0 and {0}")]
+    InvalidRfInputIndex(usize),
+
+    #[error("Invalid antenna index provided. The antenna index must be between 0 and {0}")]
+    InvalidAntennaIndex(usize),
+
+    #[error("No antenna with tile name {0} exists in this observation")]
+    InvalidTileName(String),
+
     #[error("Invalid gps_second_start (should be between {0} and {1} inclusive)")]
     InvalidGpsSecondStart(u64, u64),
 
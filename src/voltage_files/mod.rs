@@ -136,6 +136,16 @@ lazy_static::lazy_static! {
 /// 1065880134: {120: "1065880128_1065880134_ch120.dat"}
 pub(crate) type VoltageFileTimeMap = BTreeMap<u64, BTreeMap<usize, String>>;
 
+/// Where the data file for one (timestep, coarse channel) is, fully resolved so that no
+/// searching is needed when reading.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) struct VoltageFileLocation {
+    /// Index into `voltage_batches`.
+    pub batch_index: usize,
+    /// Index into `voltage_batches[batch_index].voltage_files`.
+    pub file_index: usize,
+}
+
 /// A little struct to help us not get confused when dealing with the returned
 /// values from complex functions.
 #[derive(Debug)]
@@ -370,6 +380,9 @@ fn determine_voltage_file_gpstime_batches<T: AsRef<Path>>(
 /// * the number of files in each batch of gpstimes is not equal;
 /// * the amount of data in each file is not equal.
 ///
+/// With `lazy_validation` only the size of the first voltage file is read, and the other files
+/// are only checked when they are read (every read checks the size of the file it reads).
+///
 ///
 /// # Arguments
 ///
@@ -378,6 +391,10 @@ fn determine_voltage_file_gpstime_batches<T: AsRef<Path>>(
 /// * `voltage_filenames` - A vector or slice of strings or references to strings
 ///                         containing all of the voltage filenames provided by the client.
 ///
+/// * `lazy_validation` - true to only read the size of the first voltage file.
+///
+/// * `data_sources` - Where to read voltage files from, if not the filesystem.
+///
 ///
 /// # Returns
 ///
@@ -389,6 +406,8 @@ fn determine_voltage_file_gpstime_batches<T: AsRef<Path>>(
 pub(crate) fn examine_voltage_files<T: AsRef<Path>>(
     metafits_context: &MetafitsContext,
     voltage_filenames: &[T],
+    lazy_validation: bool,
+    data_sources: &DataSources,
 ) -> Result<VoltageFileInfo, VoltageFileError> {
     let (temp_voltage_files, mwa_version, _, voltage_file_interval_ms) =
         determine_voltage_file_gpstime_batches(
@@ -398,33 +417,36 @@ pub(crate) fn examine_voltage_files<T: AsRef<Path>>(
 
     let time_map = create_time_map(&temp_voltage_files);
 
-    let mut gpstime_batches: HashMap<u64, VoltageFileBatch> =
+    let gpstime_batches: HashMap<u64, VoltageFileBatch> =
         convert_temp_voltage_files(temp_voltage_files);
 
-    // Determine the size of each voltage file. mwalib will throw an
-    // error if this size is not consistent for all voltage files.
+    // Determine the size of each voltage file (or just the first, with lazy validation). mwalib
+    // will throw an error if this size is not consistent for all voltage files.
+    let num_files_to_check = if lazy_validation { 1 } else { usize::MAX };
     let mut voltage_file_size: Option<u64> = None;
-    for b in gpstime_batches.values_mut() {
-        for v in &mut b.voltage_files {
-            let this_size;
-            let metadata = std::fs::metadata(&v.filename);
-            match metadata {
-                Ok(m) => {
-                    this_size = m.len();
-                }
-                Err(e) => {
-                    return Err(VoltageFileError::VoltageFileError(
-                        (*v.filename).to_string(),
-                        format!("{}", e),
-                    ));
-                }
-            };
-            match voltage_file_size {
-                None => voltage_file_size = Some(this_size),
-                Some(s) => {
-                    if s != this_size {
-                        return Err(VoltageFileError::UnequalFileSizes);
-                    }
+    for v in gpstime_batches
+        .values()
+        .flat_map(|b| b.voltage_files.iter())
+        .take(num_files_to_check)
+    {
+        let this_size;
+        let file_size = data_sources.file_size(&v.filename);
+        match file_size {
+            Ok(s) => {
+                this_size = s;
+            }
+            Err(e) => {
+                return Err(VoltageFileError::VoltageFileError(
+                    (*v.filename).to_string(),
+                    format!("{}", e),
+                ));
+            }
+        };
+        match voltage_file_size {
+            None => voltage_file_size = Some(this_size),
+            Some(s) => {
+                if s != this_size {
+                    return Err(VoltageFileError::UnequalFileSizes);
                 }
             }
         }
@@ -473,6 +495,55 @@ fn create_time_map(voltage_file_batches: &[TempVoltageFile]) -> VoltageFileTimeM
     voltage_time_map
 }
 
+/// Build a dense table of where the data file for every (timestep, coarse channel) is, so that
+/// reads need only index into it rather than search the batches. The table is indexed by
+/// `timestep_index * volt_coarse_chans.len() + coarse_chan_index`, and contains None for each
+/// timestep/coarse channel we have no data file for.
+///
+/// # Arguments
+///
+/// * `voltage_batches` - the voltage file batches we were supplied by the client.
+///
+/// * `volt_timesteps` - Vector of Voltage Context TimeStep structs.
+///
+/// * `volt_coarse_chans` - Vector of Voltage Context CoarseChannel structs.
+///
+/// # Returns
+///
+/// * A vector of num_timesteps * num_coarse_chans optional data file locations
+///
+///
+pub(crate) fn build_voltage_file_location_table(
+    voltage_batches: &[VoltageFileBatch],
+    volt_timesteps: &[TimeStep],
+    volt_coarse_chans: &[CoarseChannel],
+) -> Vec<Option<VoltageFileLocation>> {
+    let mut table = Vec::with_capacity(volt_timesteps.len() * volt_coarse_chans.len());
+
+    for timestep in volt_timesteps {
+        let batch_index = voltage_batches
+            .iter()
+            .position(|b| b.gps_time_seconds * 1000 == timestep.gps_time_ms);
+
+        for coarse_chan in volt_coarse_chans {
+            let location = batch_index.and_then(|batch_index| {
+                voltage_batches[batch_index]
+                    .voltage_files
+                    .iter()
+                    .position(|f| f.channel_identifier == coarse_chan.gpubox_number)
+                    .map(|file_index| VoltageFileLocation {
+                        batch_index,
+                        file_index,
+                    })
+            });
+
+            table.push(location);
+        }
+    }
+
+    table
+}
+
 /// Returns a vector of timestep indicies which exist in the VoltageFileTimeMap (i.e. the user has provided at least some data files for these timesteps)
 ///
 /// # Arguments
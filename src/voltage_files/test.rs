@@ -573,7 +573,7 @@ fn test_examine_voltage_files_valid() {
     for f in voltage_filenames.iter() {
         temp_filenames.push(generate_test_voltage_file(&temp_dir, f, 2, 256).unwrap());
     }
-    let result = examine_voltage_files(&context, &temp_filenames);
+    let result = examine_voltage_files(&context, &temp_filenames, false, &DataSources::new());
 
     assert!(
         result.is_ok(),
@@ -621,7 +621,7 @@ fn test_examine_voltage_files_error_mismatched_sizes() {
         generate_test_voltage_file(&temp_dir, "1101503312_1101503328_124.sub", 1, 256).unwrap(),
     );
 
-    let result = examine_voltage_files(&context, &temp_filenames);
+    let result = examine_voltage_files(&context, &temp_filenames, false, &DataSources::new());
 
     assert!(result.is_err());
 
@@ -631,6 +631,44 @@ fn test_examine_voltage_files_error_mismatched_sizes() {
     ));
 }
 
+#[test]
+fn test_examine_voltage_files_lazy_validation() {
+    // Get a metafits context
+    // Open the metafits file
+    let metafits_filename = "test_files/1101503312_1_timestep/1101503312.metafits";
+
+    //
+    // Read the observation using mwalib
+    //
+    // Open a context and load in a test metafits
+    let context = MetafitsContext::new(&metafits_filename, MWAVersion::VCSMWAXv2)
+        .expect("Failed to create MetafitsContext");
+
+    // Create a temp dir for the temp files
+    // Once out of scope the temp dir and it's contents will be deleted
+    let temp_dir = tempdir::TempDir::new("voltage_test").unwrap();
+
+    // Two batches, the second of which is a different size
+    let temp_filenames: Vec<String> = vec![
+        generate_test_voltage_file(&temp_dir, "1101503312_1101503312_123.sub", 2, 256).unwrap(),
+        generate_test_voltage_file(&temp_dir, "1101503312_1101503312_124.sub", 2, 256).unwrap(),
+        generate_test_voltage_file(&temp_dir, "1101503312_1101503320_123.sub", 1, 256).unwrap(),
+        generate_test_voltage_file(&temp_dir, "1101503312_1101503320_124.sub", 1, 256).unwrap(),
+    ];
+
+    // With lazy validation only one file is checked, so the unequal sizes are not noticed
+    // (until the files are read)
+    let voltage_info = examine_voltage_files(&context, &temp_filenames, true, &DataSources::new())
+        .expect("Failed to examine voltage files lazily");
+    assert_eq!(voltage_info.gpstime_batches.len(), 2);
+    assert!(voltage_info.file_size == 2 * 256 * 2 * 4 || voltage_info.file_size == 256 * 2 * 4);
+
+    assert!(matches!(
+        examine_voltage_files(&context, &temp_filenames, false, &DataSources::new()).unwrap_err(),
+        VoltageFileError::UnequalFileSizes
+    ));
+}
+
 #[test]
 fn test_examine_voltage_files_error_gpstime_gaps() {
     // Get a metafits context
@@ -663,7 +701,7 @@ fn test_examine_voltage_files_error_gpstime_gaps() {
         temp_filenames.push(generate_test_voltage_file(&temp_dir, f, 2, 256).unwrap());
     }
 
-    let result = examine_voltage_files(&context, &temp_filenames);
+    let result = examine_voltage_files(&context, &temp_filenames, false, &DataSources::new());
 
     assert!(result.is_err());
 
@@ -697,7 +735,7 @@ fn test_examine_voltage_files_error_file_not_found() {
         String::from("test_files_invalid/1101503312_1101503320_124.sub"),
     ];
 
-    let result = examine_voltage_files(&context, &voltage_filenames);
+    let result = examine_voltage_files(&context, &voltage_filenames, false, &DataSources::new());
 
     assert!(result.is_err());
 
@@ -706,3 +744,58 @@ fn test_examine_voltage_files_error_file_not_found() {
         VoltageFileError::VoltageFileError(_, _)
     ));
 }
+
+#[test]
+fn test_build_voltage_file_location_table() {
+    // Batch 1065880129 has 2 coarse channels (not in coarse channel order), 1065880130 has one
+    let mut batch1 = VoltageFileBatch::new(1065880129);
+    batch1.voltage_files.push(VoltageFile {
+        filename: String::from("1065880128_1065880129_ch122.dat"),
+        channel_identifier: 122,
+    });
+    batch1.voltage_files.push(VoltageFile {
+        filename: String::from("1065880128_1065880129_ch121.dat"),
+        channel_identifier: 121,
+    });
+    let mut batch2 = VoltageFileBatch::new(1065880130);
+    batch2.voltage_files.push(VoltageFile {
+        filename: String::from("1065880128_1065880130_ch121.dat"),
+        channel_identifier: 121,
+    });
+    let voltage_batches = vec![batch1, batch2];
+
+    let timesteps = vec![
+        TimeStep::new(1_381_844_912_000, 1_065_880_128_000),
+        TimeStep::new(1_381_844_913_000, 1_065_880_129_000),
+        TimeStep::new(1_381_844_914_000, 1_065_880_130_000),
+    ];
+
+    let coarse_chans = vec![
+        CoarseChannel::new(121, 121, 121, 1_280_000),
+        CoarseChannel::new(122, 122, 122, 1_280_000),
+    ];
+
+    let table = build_voltage_file_location_table(&voltage_batches, &timesteps, &coarse_chans);
+
+    let location = |batch_index, file_index| {
+        Some(VoltageFileLocation {
+            batch_index,
+            file_index,
+        })
+    };
+
+    assert_eq!(
+        table,
+        vec![
+            // 1065880128
+            None,
+            None,
+            // 1065880129
+            location(0, 1),
+            location(0, 0),
+            // 1065880130
+            location(1, 0),
+            None,
+        ]
+    );
+}
@@ -0,0 +1,202 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Read-only memory mapped access to voltage data files, so that callers can use the data in place
+rather than have it copied into their own buffers. On platforms without `mmap` the file is read
+into memory instead (see `FileMap`).
+ */
+use std::fmt;
+use std::fs::File;
+use std::ops::Range;
+
+use crate::file_io::FileMap;
+use crate::voltage_files::VoltageFileError;
+
+#[cfg(test)]
+mod test;
+
+/// A voltage data file mapped read-only into memory. The slices returned by its methods borrow
+/// the mapping, which is unmapped when this is dropped.
+pub struct VoltageFileMmap {
+    /// Filename of the mapped voltage file.
+    filename: String,
+    /// The mapping of the whole file.
+    map: FileMap,
+    /// Size of the header at the start of the file in bytes.
+    header_size_bytes: usize,
+    /// Size of the delay block which follows the header in bytes.
+    delay_block_size_bytes: usize,
+    /// Size of each voltage block in bytes.
+    voltage_block_size_bytes: usize,
+    /// Number of voltage blocks in the file.
+    num_voltage_blocks: usize,
+}
+
+impl VoltageFileMmap {
+    /// Map a voltage data file into memory, after checking it is the expected size.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - filename of the voltage data file.
+    ///
+    /// * `header_size_bytes` - size of the header at the start of the file.
+    ///
+    /// * `delay_block_size_bytes` - size of the delay block which follows the header.
+    ///
+    /// * `voltage_block_size_bytes` - size of each voltage block.
+    ///
+    /// * `num_voltage_blocks` - number of voltage blocks in the file.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the mapped file, or a VoltageFileError on failure.
+    ///
+    pub(crate) fn new(
+        filename: &str,
+        header_size_bytes: usize,
+        delay_block_size_bytes: usize,
+        voltage_block_size_bytes: usize,
+        num_voltage_blocks: usize,
+    ) -> Result<Self, VoltageFileError> {
+        let file = File::open(filename)
+            .map_err(|e| VoltageFileError::VoltageFileError(filename.to_string(), e.to_string()))?;
+
+        let file_size = file
+            .metadata()
+            .map_err(|e| VoltageFileError::VoltageFileError(filename.to_string(), e.to_string()))?
+            .len();
+
+        let expected_file_size = header_size_bytes
+            + delay_block_size_bytes
+            + voltage_block_size_bytes * num_voltage_blocks;
+
+        if file_size != expected_file_size as u64 {
+            return Err(VoltageFileError::InvalidVoltageFileSize(
+                file_size,
+                filename.to_string(),
+                expected_file_size as u64,
+            ));
+        }
+
+        // Voltage data is almost always consumed front to back, so let the kernel read ahead.
+        let map = FileMap::new(&file, 0, expected_file_size, true)
+            .map_err(|e| VoltageFileError::VoltageFileError(filename.to_string(), e.to_string()))?;
+
+        // The file can be closed now; the mapping keeps its own reference to it.
+        Ok(Self {
+            filename: filename.to_string(),
+            map,
+            header_size_bytes,
+            delay_block_size_bytes,
+            voltage_block_size_bytes,
+            num_voltage_blocks,
+        })
+    }
+
+    /// Returns the filename of the mapped voltage file.
+    pub fn filename(&self) -> &str {
+        &self.filename
+    }
+
+    /// Returns the number of voltage blocks in the mapped file.
+    pub fn num_voltage_blocks(&self) -> usize {
+        self.num_voltage_blocks
+    }
+
+    /// Returns the whole mapped file.
+    pub fn as_bytes(&self) -> &[u8] {
+        self.map.as_bytes()
+    }
+
+    /// Returns the header at the start of the file (empty for legacy VCS).
+    pub fn header(&self) -> &[u8] {
+        &self.as_bytes()[..self.header_size_bytes]
+    }
+
+    /// Returns the delay block which follows the header (empty for legacy VCS).
+    pub fn delay_block(&self) -> &[u8] {
+        &self.as_bytes()[self.header_size_bytes..self.data_offset()]
+    }
+
+    /// Returns all of the voltage blocks in the file. This contains the same bytes as
+    /// `VoltageContext::read_file` would have copied into its buffer.
+    pub fn data(&self) -> &[u8] {
+        &self.as_bytes()[self.data_offset()..]
+    }
+
+    /// Returns a contiguous range of voltage blocks.
+    ///
+    /// # Arguments
+    ///
+    /// * `voltage_blocks` - range of voltage block indices within this file.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * An Option containing the voltage blocks, or None if the range is outside of the file.
+    ///
+    pub fn voltage_blocks(&self, voltage_blocks: Range<usize>) -> Option<&[u8]> {
+        if voltage_blocks.start > voltage_blocks.end || voltage_blocks.end > self.num_voltage_blocks
+        {
+            return None;
+        }
+
+        let start = self.data_offset() + voltage_blocks.start * self.voltage_block_size_bytes;
+        let end = self.data_offset() + voltage_blocks.end * self.voltage_block_size_bytes;
+
+        Some(&self.as_bytes()[start..end])
+    }
+
+    /// Byte offset of the first voltage block within the file.
+    fn data_offset(&self) -> usize {
+        self.header_size_bytes + self.delay_block_size_bytes
+    }
+}
+
+/// Implements fmt::Debug for VoltageFileMmap struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for VoltageFileMmap {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "VoltageFileMmap {{ filename: {}, bytes: {}, voltage_blocks: {} }}",
+            self.filename,
+            self.as_bytes().len(),
+            self.num_voltage_blocks
+        )
+    }
+}
+
+/// The part of one mapped voltage file which falls within a requested range of GPS seconds,
+/// as returned by `VoltageContext::mmap_second`.
+#[derive(Debug)]
+pub struct VoltageSecondsMmap {
+    /// The mapped voltage file.
+    pub mmap: VoltageFileMmap,
+    /// The range of voltage blocks within `mmap` which fall within the requested GPS seconds.
+    pub voltage_blocks: Range<usize>,
+}
+
+impl VoltageSecondsMmap {
+    /// Returns the voltage blocks which fall within the requested GPS seconds. Concatenating this
+    /// for each returned `VoltageSecondsMmap` gives the same bytes as `VoltageContext::read_second`.
+    pub fn data(&self) -> &[u8] {
+        // We can unwrap here as voltage_blocks is always within the file
+        self.mmap
+            .voltage_blocks(self.voltage_blocks.clone())
+            .unwrap()
+    }
+}
@@ -0,0 +1,89 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for memory mapped voltage files
+*/
+#[cfg(test)]
+use super::*;
+#[cfg(test)]
+use std::io::Write;
+
+#[cfg(test)]
+/// Helper to write a small voltage-like file: a 4 byte header of 0xFF, a 2 byte delay block of
+/// 0xEE and then 3 voltage blocks of 8 bytes, where every byte of block n is n.
+fn generate_test_mmap_file(temp_dir: &tempdir::TempDir) -> String {
+    let filename = temp_dir.path().join("1101503312_1101503312_ch123.dat");
+    let mut file = File::create(&filename).unwrap();
+
+    file.write_all(&[0xFF; 4]).unwrap();
+    file.write_all(&[0xEE; 2]).unwrap();
+    for block in 0..3u8 {
+        file.write_all(&[block; 8]).unwrap();
+    }
+
+    filename.to_str().unwrap().to_string()
+}
+
+#[test]
+fn test_voltage_file_mmap_regions() {
+    let temp_dir = tempdir::TempDir::new("voltage_mmap_test").unwrap();
+    let filename = generate_test_mmap_file(&temp_dir);
+
+    let mmap = VoltageFileMmap::new(&filename, 4, 2, 8, 3).unwrap();
+
+    assert_eq!(mmap.filename(), filename);
+    assert_eq!(mmap.num_voltage_blocks(), 3);
+    assert_eq!(mmap.as_bytes().len(), 30);
+    assert_eq!(mmap.header(), &[0xFF; 4]);
+    assert_eq!(mmap.delay_block(), &[0xEE; 2]);
+    assert_eq!(mmap.data().len(), 24);
+    assert_eq!(mmap.data()[0], 0);
+    assert_eq!(mmap.data()[23], 2);
+
+    let blocks = mmap.voltage_blocks(1..3).unwrap();
+    assert_eq!(blocks.len(), 16);
+    assert_eq!(blocks[0], 1);
+    assert_eq!(blocks[15], 2);
+
+    assert_eq!(mmap.voltage_blocks(3..3).unwrap().len(), 0);
+    assert!(mmap.voltage_blocks(2..4).is_none());
+}
+
+#[test]
+fn test_voltage_seconds_mmap_data() {
+    let temp_dir = tempdir::TempDir::new("voltage_mmap_test").unwrap();
+    let filename = generate_test_mmap_file(&temp_dir);
+
+    let seconds = VoltageSecondsMmap {
+        mmap: VoltageFileMmap::new(&filename, 4, 2, 8, 3).unwrap(),
+        voltage_blocks: 2..3,
+    };
+
+    assert_eq!(seconds.data(), &[2; 8]);
+}
+
+#[test]
+fn test_voltage_file_mmap_invalid_size() {
+    let temp_dir = tempdir::TempDir::new("voltage_mmap_test").unwrap();
+    let filename = generate_test_mmap_file(&temp_dir);
+
+    // Expecting 4 voltage blocks, but the file only has 3
+    let result = VoltageFileMmap::new(&filename, 4, 2, 8, 4);
+
+    assert!(matches!(
+        result.unwrap_err(),
+        VoltageFileError::InvalidVoltageFileSize(30, _, 38)
+    ));
+}
+
+#[test]
+fn test_voltage_file_mmap_missing_file() {
+    let result = VoltageFileMmap::new("test_files/does_not_exist.dat", 4, 2, 8, 3);
+
+    assert!(matches!(
+        result.unwrap_err(),
+        VoltageFileError::VoltageFileError(_, _)
+    ));
+}
@@ -0,0 +1,461 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+A streaming iterator over the GPS seconds of a VoltageContext, which reads ahead on a background
+thread so that I/O overlaps with the caller's processing of each second (or chunk of seconds).
+ */
+use std::collections::HashMap;
+use std::fmt;
+use std::fs::File;
+use std::io;
+use std::ops::Deref;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{self, Receiver, Sender, SyncSender};
+use std::sync::Arc;
+use std::thread::{self, JoinHandle};
+
+use crate::data_source::{DataSource, DataSources};
+use crate::direct_io::*;
+use crate::file_io;
+use crate::prefetch::take_recycled_buffer;
+use crate::read_stats::ReadCounters;
+use crate::voltage_files::VoltageFileError;
+
+#[cfg(test)]
+mod test;
+
+/// One or more consecutive GPS seconds of voltage data produced by a `GpsSecondPrefetchIterator`.
+/// It dereferences to the data, which is in [coarse_chan][data] order, where coarse_chan is in
+/// the order supplied to `VoltageContext::iter_gps_seconds` and each coarse channel's data is as
+/// returned by `VoltageContext::read_second`.
+///
+/// The buffer is handed back to the iterator to be reused once this is dropped. Items may be
+/// held on to (e.g. collected), in which case the iterator allocates new buffers as it needs them.
+pub struct PrefetchedGpsSeconds {
+    /// The first GPS second of data.
+    pub gps_second_start: u64,
+    /// The number of GPS seconds of data.
+    pub gps_second_count: usize,
+    len: usize,
+    /// Only None once this has been dropped.
+    buffer: Option<AlignedBuffer>,
+    recycle: Sender<AlignedBuffer>,
+}
+
+impl Deref for PrefetchedGpsSeconds {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        // We can unwrap here as the buffer is only taken when this is dropped
+        &self.buffer.as_ref().unwrap()[..self.len]
+    }
+}
+
+impl Drop for PrefetchedGpsSeconds {
+    fn drop(&mut self) {
+        // If the iterator has gone away there is nobody to reuse the buffer, which is fine.
+        if let Some(buffer) = self.buffer.take() {
+            let _ = self.recycle.send(buffer);
+        }
+    }
+}
+
+/// Implements fmt::Debug for PrefetchedGpsSeconds struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for PrefetchedGpsSeconds {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "PrefetchedGpsSeconds {{ gps_second_start: {}, gps_second_count: {}, bytes: {} }}",
+            self.gps_second_start, self.gps_second_count, self.len
+        )
+    }
+}
+
+/// One contiguous read from a voltage data file into an item's buffer.
+#[derive(Debug, Clone, PartialEq)]
+pub(crate) struct VoltageRead {
+    /// Index within `VoltageFileReader::filenames` of the file to read.
+    pub file_index: usize,
+    /// Offset in the file to read from.
+    pub file_offset: u64,
+    /// Offset in the item's buffer to read to.
+    pub buffer_offset: usize,
+    /// Number of bytes to read.
+    pub len: usize,
+}
+
+/// The reads needed to produce one item of a `GpsSecondPrefetchIterator`.
+#[derive(Debug, Clone, PartialEq)]
+pub(crate) struct GpsSecondsReadPlan {
+    /// The first GPS second of the item.
+    pub gps_second_start: u64,
+    /// The number of GPS seconds in the item.
+    pub gps_second_count: usize,
+    /// Total number of bytes in the item.
+    pub len: usize,
+    /// The reads which fill the item, in buffer order.
+    pub reads: Vec<VoltageRead>,
+}
+
+/// Everything the background thread needs to open and read voltage data files, owned so that it
+/// does not borrow the VoltageContext.
+#[derive(Debug)]
+pub(crate) struct VoltageFileReader {
+    /// Every voltage data file referred to by the read plans.
+    pub filenames: Vec<String>,
+    /// The size every voltage data file must be.
+    pub expected_file_size: u64,
+    /// Read without filling the page cache (see `VoltageContext::set_direct_io`).
+    pub direct_io: bool,
+    /// Every read is aligned, so files can be opened with O_DIRECT (only used with `direct_io`).
+    pub try_o_direct: bool,
+    /// Read stats of the VoltageContext.
+    pub read_counters: Arc<ReadCounters>,
+    /// Where the VoltageContext reads voltage data files from, if not the filesystem.
+    pub data_sources: DataSources,
+}
+
+/// An open voltage data file, which is read either normally or without filling the page cache,
+/// or a voltage data file read from a data source.
+pub(crate) enum OpenVoltageFile {
+    Cached(File),
+    Uncached(UncachedFile),
+    Source(Arc<dyn DataSource>),
+}
+
+impl OpenVoltageFile {
+    /// Open a voltage data file and check it is the expected size.
+    ///
+    /// # Arguments
+    ///
+    /// * `filename` - the voltage data file to open.
+    ///
+    /// * `expected_file_size` - the size the file must be.
+    ///
+    /// * `direct_io` - read without filling the page cache (see `VoltageContext::set_direct_io`).
+    ///
+    /// * `try_o_direct` - every read will be aligned, so the file can be opened with O_DIRECT (only used with `direct_io`).
+    ///
+    /// * `data_sources` - where to read the file from, if not the filesystem (`direct_io` does not apply to data sources).
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the open file, or a VoltageFileError on failure.
+    ///
+    pub(crate) fn open(
+        filename: &str,
+        expected_file_size: u64,
+        direct_io: bool,
+        try_o_direct: bool,
+        data_sources: &DataSources,
+    ) -> Result<Self, VoltageFileError> {
+        let to_error =
+            |e: io::Error| VoltageFileError::VoltageFileError(filename.to_string(), e.to_string());
+
+        let file = if let Some(source) = data_sources.get(filename) {
+            OpenVoltageFile::Source(Arc::clone(source))
+        } else if direct_io {
+            OpenVoltageFile::Uncached(UncachedFile::open(filename, try_o_direct).map_err(to_error)?)
+        } else {
+            OpenVoltageFile::Cached(File::open(filename).map_err(to_error)?)
+        };
+
+        let file_size = match &file {
+            OpenVoltageFile::Cached(f) => f.metadata().map(|m| m.len()),
+            OpenVoltageFile::Uncached(f) => f.file.metadata().map(|m| m.len()),
+            OpenVoltageFile::Source(s) => s.size(),
+        }
+        .map_err(to_error)?;
+
+        if file_size != expected_file_size {
+            return Err(VoltageFileError::InvalidVoltageFileSize(
+                file_size,
+                filename.to_string(),
+                expected_file_size,
+            ));
+        }
+
+        Ok(file)
+    }
+
+    /// Read exactly `buffer.len()` bytes from `offset`.
+    pub(crate) fn read_exact_at(&self, buffer: &mut [u8], offset: u64) -> io::Result<()> {
+        match self {
+            OpenVoltageFile::Cached(f) => file_io::read_exact_at(f, buffer, offset),
+            OpenVoltageFile::Uncached(f) => f.read_exact_at(buffer, offset),
+            OpenVoltageFile::Source(s) => s.read_exact_at(buffer, offset),
+        }
+    }
+
+    /// Give the kernel a hint about how a range of the file will be used (a `len` of 0 means
+    /// to the end of the file). This does nothing for files opened with O_DIRECT, as they do not
+    /// use the page cache, or for data sources.
+    pub(crate) fn advise(&self, offset: u64, len: usize, advice: Advice) {
+        match self {
+            OpenVoltageFile::Cached(f) => advise(f, offset, len, advice),
+            OpenVoltageFile::Uncached(f) if !f.is_direct() => advise(&f.file, offset, len, advice),
+            OpenVoltageFile::Uncached(_) | OpenVoltageFile::Source(_) => {}
+        }
+    }
+}
+
+impl VoltageFileReader {
+    /// Open a voltage data file and check it is the expected size.
+    ///
+    /// # Arguments
+    ///
+    /// * `file_index` - index within `filenames` of the file to open.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A Result containing the open file, or a VoltageFileError on failure.
+    ///
+    fn open(&self, file_index: usize) -> Result<OpenVoltageFile, VoltageFileError> {
+        let file = OpenVoltageFile::open(
+            &self.filenames[file_index],
+            self.expected_file_size,
+            self.direct_io,
+            self.try_o_direct,
+            &self.data_sources,
+        )?;
+        self.read_counters.add_file_open();
+
+        Ok(file)
+    }
+}
+
+/// An iterator over GPS seconds of voltage data which reads up to `prefetch_depth` items ahead
+/// of the caller on a background thread. Create one with `VoltageContext::iter_gps_seconds`.
+///
+/// Each voltage data file is opened (and its size checked) once, shortly before it is first
+/// needed, and stays open until its last second has been read. The background thread waits once
+/// `prefetch_depth` items are ready and not yet taken by the caller. Buffers of dropped
+/// `PrefetchedGpsSeconds` are reused, and a new buffer is only allocated when every buffer is
+/// still held by the caller. If a read fails, the error is
+/// returned by the iterator and iteration stops.
+pub struct GpsSecondPrefetchIterator {
+    receiver: Option<Receiver<Result<PrefetchedGpsSeconds, VoltageFileError>>>,
+    cancelled: Arc<AtomicBool>,
+    worker: Option<JoinHandle<()>>,
+}
+
+impl GpsSecondPrefetchIterator {
+    /// Start reading GPS seconds on a background thread.
+    ///
+    /// # Arguments
+    ///
+    /// * `reader` - owned reader describing how to open each voltage data file.
+    ///
+    /// * `plans` - the reads for each item, in iteration order.
+    ///
+    /// * `prefetch_depth` - number of items to read ahead. A value of 0 is treated as 1.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * A GpsSecondPrefetchIterator
+    ///
+    pub(crate) fn new(
+        reader: VoltageFileReader,
+        plans: Vec<GpsSecondsReadPlan>,
+        prefetch_depth: usize,
+    ) -> Self {
+        let prefetch_depth = prefetch_depth.max(1);
+        let (sender, receiver) = mpsc::sync_channel(prefetch_depth);
+        let cancelled = Arc::new(AtomicBool::new(false));
+
+        let worker_cancelled = Arc::clone(&cancelled);
+        let worker =
+            thread::spawn(move || prefetch_gps_seconds(reader, plans, sender, worker_cancelled));
+
+        Self {
+            receiver: Some(receiver),
+            cancelled,
+            worker: Some(worker),
+        }
+    }
+}
+
+impl Iterator for GpsSecondPrefetchIterator {
+    type Item = Result<PrefetchedGpsSeconds, VoltageFileError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        // The background thread hangs up once it has sent everything (or an error)
+        self.receiver.as_ref()?.recv().ok()
+    }
+}
+
+impl Drop for GpsSecondPrefetchIterator {
+    fn drop(&mut self) {
+        // Stop the background thread. Dropping the receiver unblocks it if it is waiting to
+        // hand over an item, and the flag stops it before it starts reading another.
+        self.cancelled.store(true, Ordering::Relaxed);
+        self.receiver = None;
+
+        if let Some(worker) = self.worker.take() {
+            let _ = worker.join();
+        }
+    }
+}
+
+/// Implements fmt::Debug for GpsSecondPrefetchIterator struct
+///
+/// # Arguments
+///
+/// * `f` - A fmt::Formatter
+///
+///
+/// # Returns
+///
+/// * `fmt::Result` - Result of this method
+///
+///
+impl fmt::Debug for GpsSecondPrefetchIterator {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "GpsSecondPrefetchIterator {{ finished: {} }}",
+            self.receiver.is_none()
+        )
+    }
+}
+
+/// Returns an open voltage data file, opening it first if needed.
+///
+/// # Arguments
+///
+/// * `reader` - reader describing how to open each voltage data file.
+///
+/// * `open_files` - the files which are currently open, keyed by file index.
+///
+/// * `file_index` - index within `reader.filenames` of the file.
+///
+///
+/// # Returns
+///
+/// * A Result containing the open file, or a VoltageFileError if it could not be opened.
+///
+fn get_open_file<'a>(
+    reader: &VoltageFileReader,
+    open_files: &'a mut HashMap<usize, OpenVoltageFile>,
+    file_index: usize,
+) -> Result<&'a OpenVoltageFile, VoltageFileError> {
+    if !open_files.contains_key(&file_index) {
+        open_files.insert(file_index, reader.open(file_index)?);
+    }
+
+    // We can unwrap here as we just ensured the file is open
+    Ok(open_files.get(&file_index).unwrap())
+}
+
+/// The body of the background thread of a `GpsSecondPrefetchIterator`.
+///
+/// # Arguments
+///
+/// * `reader` - owned reader describing how to open each voltage data file.
+///
+/// * `plans` - the reads for each item, in iteration order.
+///
+/// * `sender` - channel to send each item (or an error) to the iterator on.
+///
+/// * `cancelled` - set when the iterator has been dropped.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+fn prefetch_gps_seconds(
+    reader: VoltageFileReader,
+    plans: Vec<GpsSecondsReadPlan>,
+    sender: SyncSender<Result<PrefetchedGpsSeconds, VoltageFileError>>,
+    cancelled: Arc<AtomicBool>,
+) {
+    let (recycle_sender, recycle_receiver) = mpsc::channel();
+    // Every buffer is allocated at the largest item size, so any buffer can be used for any item
+    let buffer_len = plans.iter().map(|p| p.len).max().unwrap_or(0);
+
+    // The last item which reads from each file, so each file can be closed once we are done with it
+    let mut last_plan_index: Vec<usize> = vec![0; reader.filenames.len()];
+    for (plan_index, plan) in plans.iter().enumerate() {
+        for read in &plan.reads {
+            last_plan_index[read.file_index] = plan_index;
+        }
+    }
+
+    let mut open_files: HashMap<usize, OpenVoltageFile> = HashMap::new();
+
+    for (plan_index, plan) in plans.iter().enumerate() {
+        if cancelled.load(Ordering::Relaxed) {
+            return;
+        }
+
+        let mut buffer = take_recycled_buffer(&recycle_receiver, || AlignedBuffer::new(buffer_len));
+
+        let mut result = Ok(());
+        for read in &plan.reads {
+            result = get_open_file(&reader, &mut open_files, read.file_index).and_then(|file| {
+                file.read_exact_at(
+                    &mut buffer[read.buffer_offset..read.buffer_offset + read.len],
+                    read.file_offset,
+                )
+                .map_err(|e| {
+                    VoltageFileError::VoltageFileError(
+                        reader.filenames[read.file_index].clone(),
+                        e.to_string(),
+                    )
+                })
+            });
+            if result.is_ok() {
+                reader.read_counters.add_bytes_read(read.len);
+            }
+            if result.is_err() {
+                break;
+            }
+        }
+
+        if result.is_ok() {
+            open_files.retain(|&file_index, _| last_plan_index[file_index] > plan_index);
+
+            // Start the kernel reading the next item, opening its files now if need be. This
+            // hides the cost of moving on to a new data file. Errors are left to be reported
+            // when the item is actually read.
+            if let Some(next_plan) = plans.get(plan_index + 1) {
+                for read in &next_plan.reads {
+                    if let Ok(file) = get_open_file(&reader, &mut open_files, read.file_index) {
+                        file.advise(read.file_offset, read.len, Advice::WillNeed);
+                    }
+                }
+            }
+        }
+
+        let stop = result.is_err();
+        let message = result.map(|_| PrefetchedGpsSeconds {
+            gps_second_start: plan.gps_second_start,
+            gps_second_count: plan.gps_second_count,
+            len: plan.len,
+            buffer: Some(buffer),
+            recycle: recycle_sender.clone(),
+        });
+
+        // If the iterator has been dropped there is no-one left to read for
+        if sender.send(message).is_err() || stop {
+            return;
+        }
+    }
+}
@@ -0,0 +1,193 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for the prefetching GPS second iterator
+*/
+#[cfg(test)]
+use super::*;
+#[cfg(test)]
+use std::io::Write;
+
+#[cfg(test)]
+/// Helper to write `num_files` voltage-like files, each with a 4 byte header and then 4 voltage
+/// blocks of 8 bytes, where every byte of block n of file f is f * 16 + n.
+fn generate_test_files(temp_dir: &tempdir::TempDir, num_files: usize) -> Vec<String> {
+    (0..num_files)
+        .map(|f| {
+            let filename = temp_dir.path().join(format!("voltage_prefetch_{}.sub", f));
+            let mut file = File::create(&filename).unwrap();
+            file.write_all(&[0xFF; 4]).unwrap();
+            for block in 0..4 {
+                file.write_all(&[(f * 16 + block) as u8; 8]).unwrap();
+            }
+            filename.to_str().unwrap().to_string()
+        })
+        .collect()
+}
+
+#[cfg(test)]
+/// Helper to make a plan which reads `blocks` (file index, block index) into consecutive blocks
+/// of the buffer.
+fn make_plan(gps_second_start: u64, blocks: &[(usize, u64)]) -> GpsSecondsReadPlan {
+    GpsSecondsReadPlan {
+        gps_second_start,
+        gps_second_count: 1,
+        len: blocks.len() * 8,
+        reads: blocks
+            .iter()
+            .enumerate()
+            .map(|(i, &(file_index, block))| VoltageRead {
+                file_index,
+                file_offset: 4 + block * 8,
+                buffer_offset: i * 8,
+                len: 8,
+            })
+            .collect(),
+    }
+}
+
+#[test]
+fn test_gps_second_prefetch_iterator_reads_across_files() {
+    let temp_dir = tempdir::TempDir::new("voltage_prefetch_test").unwrap();
+
+    for &(direct_io, prefetch_depth) in &[(false, 1), (true, 3)] {
+        let read_counters = Arc::new(ReadCounters::new());
+        read_counters.set_enabled(true);
+        let reader = VoltageFileReader {
+            filenames: generate_test_files(&temp_dir, 2),
+            expected_file_size: 36,
+            direct_io,
+            try_o_direct: false,
+            read_counters: Arc::clone(&read_counters),
+            data_sources: DataSources::new(),
+        };
+        // The second item spans the boundary between the two files, and the last is shorter
+        let plans = vec![
+            make_plan(100, &[(0, 0), (0, 1)]),
+            make_plan(101, &[(0, 3), (1, 0)]),
+            make_plan(102, &[(1, 2)]),
+        ];
+
+        // Each item is checked and dropped before the next, so buffers are recycled
+        let expected: Vec<(u64, Vec<u8>)> = vec![
+            (100, [[0u8; 8], [1; 8]].concat()),
+            (101, [[3u8; 8], [16; 8]].concat()),
+            (102, vec![18u8; 8]),
+        ];
+        let mut num_items = 0;
+
+        for (item, (gps_second_start, data)) in
+            GpsSecondPrefetchIterator::new(reader, plans, prefetch_depth).zip(expected.iter())
+        {
+            let item = item.unwrap();
+            assert_eq!(item.gps_second_start, *gps_second_start);
+            assert_eq!(&item[..], &data[..]);
+            num_items += 1;
+        }
+
+        assert_eq!(num_items, 3);
+
+        // Prefetch threads add to the context's read stats
+        let stats = read_counters.snapshot();
+        assert_eq!(stats.bytes_read, 5 * 8);
+        assert!(stats.file_opens >= 2);
+    }
+}
+
+#[test]
+fn test_gps_second_prefetch_iterator_items_held() {
+    let temp_dir = tempdir::TempDir::new("voltage_prefetch_test").unwrap();
+    let reader = VoltageFileReader {
+        filenames: generate_test_files(&temp_dir, 1),
+        expected_file_size: 36,
+        direct_io: false,
+        try_o_direct: false,
+        read_counters: Arc::new(ReadCounters::new()),
+        data_sources: DataSources::new(),
+    };
+    let plans = (0..4).map(|b| make_plan(100 + b, &[(0, b)])).collect();
+
+    // Holding on to more items than the prefetch depth must not stop the iterator
+    let items: Vec<PrefetchedGpsSeconds> = GpsSecondPrefetchIterator::new(reader, plans, 1)
+        .collect::<Result<Vec<PrefetchedGpsSeconds>, VoltageFileError>>()
+        .unwrap();
+
+    assert_eq!(items.len(), 4);
+    for (block, item) in items.iter().enumerate() {
+        assert_eq!(item.gps_second_start, 100 + block as u64);
+        assert_eq!(&item[..], &[block as u8; 8]);
+    }
+}
+
+#[test]
+fn test_gps_second_prefetch_iterator_invalid_file_size() {
+    let temp_dir = tempdir::TempDir::new("voltage_prefetch_test").unwrap();
+    let reader = VoltageFileReader {
+        filenames: generate_test_files(&temp_dir, 1),
+        expected_file_size: 100,
+        direct_io: false,
+        try_o_direct: false,
+        read_counters: Arc::new(ReadCounters::new()),
+        data_sources: DataSources::new(),
+    };
+
+    let mut iter = GpsSecondPrefetchIterator::new(reader, vec![make_plan(100, &[(0, 0)])], 1);
+
+    assert!(matches!(
+        iter.next().unwrap().unwrap_err(),
+        VoltageFileError::InvalidVoltageFileSize(36, _, 100)
+    ));
+    assert!(iter.next().is_none());
+}
+
+#[test]
+fn test_gps_second_prefetch_iterator_missing_file() {
+    // The missing file is first needed by the second item, which is when the error is returned
+    let temp_dir = tempdir::TempDir::new("voltage_prefetch_test").unwrap();
+    let mut filenames = generate_test_files(&temp_dir, 1);
+    filenames.push(String::from("test_files/does_not_exist.sub"));
+    let reader = VoltageFileReader {
+        filenames,
+        expected_file_size: 36,
+        direct_io: false,
+        try_o_direct: false,
+        read_counters: Arc::new(ReadCounters::new()),
+        data_sources: DataSources::new(),
+    };
+
+    let mut iter = GpsSecondPrefetchIterator::new(
+        reader,
+        vec![make_plan(100, &[(0, 0)]), make_plan(101, &[(1, 0)])],
+        1,
+    );
+
+    assert!(iter.next().unwrap().is_ok());
+    assert!(matches!(
+        iter.next().unwrap().unwrap_err(),
+        VoltageFileError::VoltageFileError(_, _)
+    ));
+    assert!(iter.next().is_none());
+}
+
+#[test]
+fn test_gps_second_prefetch_iterator_dropped_early_does_not_hang() {
+    let temp_dir = tempdir::TempDir::new("voltage_prefetch_test").unwrap();
+    let reader = VoltageFileReader {
+        filenames: generate_test_files(&temp_dir, 1),
+        expected_file_size: 36,
+        direct_io: false,
+        try_o_direct: false,
+        read_counters: Arc::new(ReadCounters::new()),
+        data_sources: DataSources::new(),
+    };
+    let plans = (0..4).map(|b| make_plan(100 + b, &[(0, b)])).collect();
+
+    // Hold on to the first item (so the background thread may be waiting to send another) and drop
+    // the iterator; this must not deadlock.
+    let mut iter = GpsSecondPrefetchIterator::new(reader, plans, 1);
+    let first = iter.next();
+    drop(iter);
+    assert_eq!(&first.unwrap().unwrap()[..], &[0u8; 8]);
+}
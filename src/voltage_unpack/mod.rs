@@ -0,0 +1,185 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Decoding of raw voltage samples into signed real/imaginary pairs.
+
+MWA Legacy Recombined VCS packs each complex sample into one byte: the real part is the high
+nibble and the imaginary part is the low nibble, each a 4 bit two's complement integer (-8..7).
+MWAX VCS stores each complex sample as two bytes: an 8 bit two's complement real part followed
+by an 8 bit two's complement imaginary part.
+
+The kernels here are branch-free and work on fixed size tiles, so the compiler can vectorise
+them (the nibble expansion is just two shifts of each byte).
+ */
+use crate::MWAVersion;
+
+#[cfg(test)]
+mod test;
+
+/// Number of raw bytes decoded per tile by the unpacking kernels.
+const UNPACK_TILE_BYTES: usize = 64;
+
+/// Number of raw bytes read from a voltage data file at a time by the unpacked reads. Each chunk
+/// is small enough to still be in cache when it is decoded, and is a multiple of the direct I/O
+/// alignment.
+pub(crate) const UNPACK_CHUNK_BYTES: usize = 256 * 1024;
+
+/// A type which raw voltage samples can be decoded into, for `VoltageContext::read_file_unpacked`
+/// and `VoltageContext::read_second_unpacked`. Each complex sample becomes two values, real then
+/// imaginary. This is implemented for `i8` and `f32`.
+pub trait VoltageSample: Copy + Default + Send + Sync {
+    /// Decode MWA Legacy Recombined VCS samples (one byte per complex sample).
+    ///
+    /// # Arguments
+    ///
+    /// * `input` - the raw bytes.
+    ///
+    /// * `output` - the decoded values. Must be twice the length of `input`.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    fn unpack_legacy(input: &[u8], output: &mut [Self]);
+
+    /// Decode MWAX VCS samples (two bytes per complex sample).
+    ///
+    /// # Arguments
+    ///
+    /// * `input` - the raw bytes.
+    ///
+    /// * `output` - the decoded values. Must be the same length as `input`.
+    ///
+    ///
+    /// # Returns
+    ///
+    /// * Nothing
+    ///
+    fn unpack_mwax(input: &[u8], output: &mut [Self]);
+}
+
+/// Returns the real part (high nibble) of a packed legacy sample, sign extended.
+#[inline(always)]
+fn legacy_real(sample: u8) -> i8 {
+    (sample as i8) >> 4
+}
+
+/// Returns the imaginary part (low nibble) of a packed legacy sample, sign extended.
+#[inline(always)]
+fn legacy_imag(sample: u8) -> i8 {
+    ((sample << 4) as i8) >> 4
+}
+
+/// Decode legacy samples with the given conversion, a tile at a time so the loop vectorises.
+///
+/// # Arguments
+///
+/// * `input` - the raw bytes.
+///
+/// * `output` - the decoded values. Must be twice the length of `input`.
+///
+/// * `convert` - conversion from the sign extended nibble to the output type.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+#[inline(always)]
+fn unpack_legacy_with<T: Copy>(input: &[u8], output: &mut [T], convert: impl Fn(i8) -> T) {
+    assert_eq!(output.len(), input.len() * 2);
+
+    let mut in_tiles = input.chunks_exact(UNPACK_TILE_BYTES);
+    let mut out_tiles = output.chunks_exact_mut(UNPACK_TILE_BYTES * 2);
+
+    for (in_tile, out_tile) in (&mut in_tiles).zip(&mut out_tiles) {
+        for (&sample, out) in in_tile.iter().zip(out_tile.chunks_exact_mut(2)) {
+            out[0] = convert(legacy_real(sample));
+            out[1] = convert(legacy_imag(sample));
+        }
+    }
+
+    for (&sample, out) in in_tiles
+        .remainder()
+        .iter()
+        .zip(out_tiles.into_remainder().chunks_exact_mut(2))
+    {
+        out[0] = convert(legacy_real(sample));
+        out[1] = convert(legacy_imag(sample));
+    }
+}
+
+impl VoltageSample for i8 {
+    fn unpack_legacy(input: &[u8], output: &mut [i8]) {
+        unpack_legacy_with(input, output, |v| v)
+    }
+
+    fn unpack_mwax(input: &[u8], output: &mut [i8]) {
+        assert_eq!(output.len(), input.len());
+
+        for (out, &value) in output.iter_mut().zip(input.iter()) {
+            *out = value as i8;
+        }
+    }
+}
+
+impl VoltageSample for f32 {
+    fn unpack_legacy(input: &[u8], output: &mut [f32]) {
+        unpack_legacy_with(input, output, f32::from)
+    }
+
+    fn unpack_mwax(input: &[u8], output: &mut [f32]) {
+        assert_eq!(output.len(), input.len());
+
+        for (out, &value) in output.iter_mut().zip(input.iter()) {
+            *out = f32::from(value as i8);
+        }
+    }
+}
+
+/// Decode raw voltage samples of the given VCS version.
+///
+/// # Arguments
+///
+/// * `mwa_version` - the VCS version the samples are from.
+///
+/// * `input` - the raw bytes.
+///
+/// * `output` - the decoded values. Must be `values_per_byte(mwa_version)` times the length of `input`.
+///
+///
+/// # Returns
+///
+/// * Nothing
+///
+pub(crate) fn unpack_voltage_samples<T: VoltageSample>(
+    mwa_version: MWAVersion,
+    input: &[u8],
+    output: &mut [T],
+) {
+    match mwa_version {
+        MWAVersion::VCSLegacyRecombined => T::unpack_legacy(input, output),
+        _ => T::unpack_mwax(input, output),
+    }
+}
+
+/// Returns how many decoded values each raw byte of a VCS version becomes.
+///
+/// # Arguments
+///
+/// * `mwa_version` - the VCS version.
+///
+///
+/// # Returns
+///
+/// * 2 for legacy (a complex sample per byte), 1 for MWAX (a complex sample per 2 bytes).
+///
+pub(crate) fn values_per_byte(mwa_version: MWAVersion) -> usize {
+    match mwa_version {
+        MWAVersion::VCSLegacyRecombined => 2,
+        _ => 1,
+    }
+}
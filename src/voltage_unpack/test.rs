@@ -0,0 +1,70 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/*!
+Unit tests for decoding raw voltage samples
+*/
+#[cfg(test)]
+use super::*;
+
+#[test]
+fn test_unpack_legacy_nibbles() {
+    // 0x7F: real 7, imag -1. 0x80: real -8, imag 0. 0x18: real 1, imag -8.
+    let input: Vec<u8> = vec![0x7F, 0x80, 0x18, 0x00, 0xFF];
+    let mut output_i8: Vec<i8> = vec![0; input.len() * 2];
+    let mut output_f32: Vec<f32> = vec![0.; input.len() * 2];
+
+    i8::unpack_legacy(&input, &mut output_i8);
+    f32::unpack_legacy(&input, &mut output_f32);
+
+    assert_eq!(output_i8, vec![7, -1, -8, 0, 1, -8, 0, 0, -1, -1]);
+    assert_eq!(
+        output_f32,
+        vec![7., -1., -8., 0., 1., -8., 0., 0., -1., -1.]
+    );
+}
+
+#[test]
+fn test_unpack_legacy_all_values_and_tile_remainder() {
+    // Every byte value, plus some more so the input is not a whole number of tiles
+    let input: Vec<u8> = (0..UNPACK_TILE_BYTES * 4 + 7)
+        .map(|i| (i % 256) as u8)
+        .collect();
+    let mut output: Vec<i8> = vec![0; input.len() * 2];
+
+    i8::unpack_legacy(&input, &mut output);
+
+    for (&sample, pair) in input.iter().zip(output.chunks_exact(2)) {
+        let real = (sample >> 4) as i8;
+        let imag = (sample & 0x0F) as i8;
+        assert_eq!(pair[0], if real > 7 { real - 16 } else { real });
+        assert_eq!(pair[1], if imag > 7 { imag - 16 } else { imag });
+    }
+}
+
+#[test]
+fn test_unpack_mwax() {
+    let input: Vec<u8> = vec![0x00, 0x01, 0x7F, 0x80, 0xFF, 0xFE];
+    let mut output_i8: Vec<i8> = vec![0; input.len()];
+    let mut output_f32: Vec<f32> = vec![0.; input.len()];
+
+    unpack_voltage_samples(MWAVersion::VCSMWAXv2, &input, &mut output_i8);
+    unpack_voltage_samples(MWAVersion::VCSMWAXv2, &input, &mut output_f32);
+
+    assert_eq!(output_i8, vec![0, 1, 127, -128, -1, -2]);
+    assert_eq!(output_f32, vec![0., 1., 127., -128., -1., -2.]);
+}
+
+#[test]
+fn test_values_per_byte() {
+    assert_eq!(values_per_byte(MWAVersion::VCSLegacyRecombined), 2);
+    assert_eq!(values_per_byte(MWAVersion::VCSMWAXv2), 1);
+}
+
+#[test]
+#[should_panic]
+fn test_unpack_legacy_wrong_output_size() {
+    let mut output: Vec<f32> = vec![0.; 3];
+    f32::unpack_legacy(&[0, 1], &mut output);
+}